@@ -98,6 +98,8 @@ class Simple():
 
         Arguments:
         data -- The output buffer with channels in interleaved format.
+                A writable memoryview of format 'f' is passed to
+                PulseAudio without copying.
 
         Exceptions:
         PulseAudioError -- Raised if the PulseAudio call fails.
@@ -110,8 +112,16 @@ class Simple():
                     ' by expected channel count {}'.format(
                         len(data), self._channels))
         frame_count = len(data) // self._channels
-        cdata = (ctypes.c_float * (frame_count * self._channels))()
-        cdata[:] = data
+        cdata_type = ctypes.c_float * (frame_count * self._channels)
+        if (isinstance(data, memoryview) and
+                (data.format == 'f') and
+                data.c_contiguous and
+                not data.readonly):
+            # Pass the caller's buffer without copying
+            cdata = cdata_type.from_buffer(data)
+        else:
+            cdata = cdata_type()
+            cdata[:] = data
         bytes_per_frame = 4 * self._channels
         error = ctypes.c_int(0)
         if _simple.pa_simple_write(self._connection,
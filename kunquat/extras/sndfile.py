@@ -347,6 +347,21 @@ class _SndFileWBase(_SndFileBase):
 
         _sndfile.sf_writef_float(self._sf, cdata, frame_count)
 
+    def write_interleaved(self, buf):
+        """Write interleaved audio data without conversion.
+
+        Arguments:
+        buf -- A writable buffer of 32-bit floating-point values with
+               interleaved channels, such as array.array('f').
+
+        """
+        if len(buf) % self._channels != 0:
+            raise ValueError('Data length {} is not divisible by expected'
+                    ' number of channels {}'.format(len(buf), self._channels))
+        frame_count = len(buf) // self._channels
+        cdata = (ctypes.c_float * len(buf)).from_buffer(buf)
+        _sndfile.sf_writef_float(self._sf, cdata, frame_count)
+
 
 class SndFileW(_SndFileWBase):
 
@@ -36,6 +36,7 @@ import json
 import os
 import select
 import signal
+import struct
 
 __all__ = ['Kunquat',
            'KunquatError', 'KunquatArgumentError',
@@ -49,9 +50,13 @@ class Kunquat():
 
     Public methods:
     set_data     -- Set composition data.
+    set_data_float -- Set a floating-point processor parameter.
     get_duration -- Calculate the length of a track.
+    get_time_at_position -- Get the time at which a position is reached.
+    get_position_at_time -- Get the position played at a given time.
     play         -- Play audio.
     get_audio    -- Get audio data.
+    get_audio_view -- Get audio data without copying.
     fire         -- Fire an event.
 
     Public instance variables:
@@ -102,6 +107,26 @@ class Kunquat():
             raise KunquatArgumentError('Audio rate must be positive')
         self.audio_rate = audio_rate
 
+    def share(self):
+        """Create a Kunquat instance that plays the same composition.
+
+        The new instance shares all composition data with this
+        instance but has its own playback state.  The composition
+        cannot be modified while it is shared.
+
+        Return value:
+        The new Kunquat instance.
+
+        """
+        handle = _kunquat.kqt_new_Handle_sharing(self._handle)
+        if not handle:
+            error_str = str(_kunquat.kqt_Handle_get_error(0), encoding='utf-8')
+            raise _get_error(json.loads(error_str))
+        shared = Kunquat.__new__(Kunquat)
+        shared._handle = handle
+        Kunquat.__init__(shared, self.audio_rate)
+        return shared
+
     def set_data(self, key, value):
         """Set data in the Kunquat instance.
 
@@ -135,6 +160,26 @@ class Kunquat():
                 ctypes.cast(cdata, ctypes.POINTER(ctypes.c_ubyte)),
                 len(data))
 
+    def set_data_float(self, key, value):
+        """Set a floating-point processor parameter.
+
+        This is equivalent to setting [0, value] with set_data, but
+        does not require validation if the processor already exists.
+
+        Arguments:
+        key --   The key of a floating-point processor parameter, e.g.
+                 'au_00/proc_00/c/p_f_volume.json'.
+        value -- The new value.
+
+        Exceptions:
+        KunquatArgumentError -- The key is not a floating-point
+                                processor parameter or the value is
+                                not finite.
+
+        """
+        _kunquat.kqt_Handle_set_data_float(
+                self._handle, bytes(key, encoding='utf-8'), value)
+
     def validate(self):
         """Validate data in the Kunquat instance.
 
@@ -201,6 +246,30 @@ class Kunquat():
         """
         _kunquat.kqt_Handle_set_loader_thread_count(self._handle, value)
 
+    def set_sample_streaming(self, preload_frames, cache_dir=None):
+        """Stream long samples from a cache file during playback.
+
+        Only the first preload_frames frames of samples loaded after this
+        call are kept in memory. A preload_frames value of 0 disables
+        streaming. The cache file is created in cache_dir, or as a
+        temporary file if cache_dir is None.
+
+        """
+        cache_dir_arg = cache_dir.encode('utf-8') if cache_dir != None else None
+        _kunquat.kqt_Handle_set_sample_streaming(
+                self._handle, preload_frames, cache_dir_arg)
+
+    def set_cache_dir(self, cache_dir):
+        """Set the directory of the persistent sample data cache.
+
+        Decoded samples and generated PADsynth tables are stored in
+        cache_dir and reused when identical data is loaded again. The
+        value None disables the cache.
+
+        """
+        cache_dir_arg = cache_dir.encode('utf-8') if cache_dir != None else None
+        _kunquat.kqt_Handle_set_cache_dir(self._handle, cache_dir_arg)
+
     def get_player_thread_count(self):
         """Get the number of threads used for audio rendering."""
         return _kunquat.kqt_Handle_get_player_thread_count(self._handle)
@@ -214,6 +283,18 @@ class Kunquat():
         """
         _kunquat.kqt_Handle_set_player_thread_count(self._handle, value)
 
+    def set_cpu_budget(self, budget):
+        """Set the CPU budget of audio rendering.
+
+        The budget is the maximum acceptable ratio of rendering time to
+        the duration of the rendered audio, e.g. 0.7 allows rendering to
+        use 70 % of real time. When the budget is exceeded, polyphony is
+        reduced by stopping the quietest voices. The value 0 disables the
+        budget.
+
+        """
+        _kunquat.kqt_Handle_set_cpu_budget(self._handle, budget)
+
 
     @property
     def audio_rate(self):
@@ -266,6 +347,55 @@ class Kunquat():
             track = -1
         return _kunquat.kqt_Handle_get_duration(self._handle, track)
 
+    def get_time_at_position(self, track, system, row):
+        """Get the time at which a position is played for the first time.
+
+        Arguments:
+        track  -- The track number.
+        system -- The system number.
+        row    -- The pattern position as a pair [beats, remainder].
+
+        Return value:
+        The time in nanoseconds, or None if the position is not played.
+
+        Exceptions:
+        KunquatArgumentError -- The position is not valid.
+
+        """
+        beats, rem = row
+        ns = _kunquat.kqt_Handle_get_time_at_position(
+                self._handle, track, system, beats, rem)
+        return ns if ns >= 0 else None
+
+    def get_position_at_time(self, track, nanoseconds):
+        """Get the position played at a given time.
+
+        Arguments:
+        track       -- The track number.
+        nanoseconds -- The time from the start of the track.
+
+        Return value:
+        A pair (system, [beats, remainder]), or None if nanoseconds is
+        beyond the end of the track.
+
+        Exceptions:
+        KunquatArgumentError -- The track or time is not valid.
+
+        """
+        system = ctypes.c_int(0)
+        beats = ctypes.c_longlong(0)
+        rem = ctypes.c_long(0)
+        found = _kunquat.kqt_Handle_get_position_at_time(
+                self._handle,
+                track,
+                nanoseconds,
+                ctypes.byref(system),
+                ctypes.byref(beats),
+                ctypes.byref(rem))
+        if not found:
+            return None
+        return (system.value, [beats.value, rem.value])
+
     def play(self, frame_count=None):
         """Play audio according to the state of the handle.
 
@@ -282,6 +412,19 @@ class Kunquat():
         _kunquat.kqt_Handle_play(self._handle, frame_count)
         self._nanoseconds = _kunquat.kqt_Handle_get_position(self._handle)
 
+    def set_input_audio(self, port, data):
+        """Set audio input for the next call of play.
+
+        Arguments:
+        port -- The input port of the master.
+        data -- A sequence of floating-point values, one for each frame
+                from the start of the next call of play.  The
+                remaining frames are silent.
+
+        """
+        cdata = (ctypes.c_float * len(data))(*data)
+        _kunquat.kqt_Handle_set_input_audio(self._handle, port, len(data), cdata)
+
     def has_stopped(self):
         """Return True if playback has stopped."""
         return _kunquat.kqt_Handle_has_stopped(self._handle)
@@ -298,6 +441,50 @@ class Kunquat():
         cbuf = _kunquat.kqt_Handle_get_audio(self._handle)
         return cbuf[:frames_available * 2]
 
+    def get_bus_count(self):
+        """Get the number of output buses.
+
+        Each pair of master output ports forms a bus.  Bus 0 is the
+        main output returned by get_audio.
+
+        """
+        return _kunquat.kqt_Handle_get_bus_count(self._handle)
+
+    def get_bus_audio(self, bus):
+        """Get audio data of an output bus.
+
+        Arguments:
+        bus -- The bus number.
+
+        Returns:
+        A list of floating-point values in interleaved 2-channel
+        format.
+
+        """
+        frames_available = _kunquat.kqt_Handle_get_frames_available(self._handle)
+        cbuf = _kunquat.kqt_Handle_get_bus_audio(self._handle, bus)
+        return cbuf[:frames_available * 2]
+
+    def get_audio_view(self):
+        """Get audio data without copying.
+
+        Returns:
+        A memoryview of format 'f' over the internal audio buffer,
+        containing floating-point values in interleaved 2-channel
+        format.  The view supports the buffer protocol and can be
+        passed directly to audio output.
+
+        Note that the contents of the view are only valid until the
+        next call of play.  Use get_audio or copy the data if it needs
+        to be retained.
+
+        """
+        frames_available = _kunquat.kqt_Handle_get_frames_available(self._handle)
+        cbuf = _kunquat.kqt_Handle_get_audio(self._handle)
+        carray_type = ctypes.c_float * (frames_available * 2)
+        carray = carray_type.from_address(ctypes.addressof(cbuf.contents))
+        return memoryview(carray).cast('B').cast('f')
+
     def set_channel_mute(self, channel, mute):
         """Set channel mute.
 
@@ -325,6 +512,112 @@ class Kunquat():
         event_data = bytes(json.dumps(event), encoding='utf-8')
         _kunquat.kqt_Handle_fire_event(self._handle, channel, event_data)
 
+    def fire_event_at(self, frame_offset, channel, event):
+        """Fire an event at a frame offset of the next call of play.
+
+        Arguments:
+        frame_offset -- The offset in frames from the start of the
+                        next call of play.
+        channel      -- The channel where the event takes place.  The
+                        channel number is >= 0 and < 64.
+        event        -- The event description in the same format as
+                        with fire_event.
+
+        """
+        event_data = bytes(json.dumps(event), encoding='utf-8')
+        _kunquat.kqt_Handle_fire_event_at(
+                self._handle, frame_offset, channel, event_data)
+
+    def queue_event(self, frame_offset, channel, event):
+        """Queue an event to be fired during playback.
+
+        This method may be called from any thread while another
+        thread is calling play.
+
+        Arguments:
+        frame_offset -- The offset in frames from the start of the
+                        next call of play.
+        channel      -- The channel where the event takes place.  The
+                        channel number is >= 0 and < 64.
+        event        -- The event description as a pair of event name
+                        and numeric argument (or None).
+
+        """
+        name, arg = event
+        event_id = _kunquat.kqt_Handle_get_event_id(
+                self._handle, bytes(name, encoding='utf-8'))
+        arg_value = float(arg) if arg != None else 0.0
+        _kunquat.kqt_Handle_queue_event(
+                self._handle, frame_offset, channel, event_id, arg_value)
+
+    def queue_channel_mute(self, frame_offset, channel, mute):
+        """Queue a change of channel mute setting.
+
+        Arguments:
+        frame_offset -- The offset in frames from the start of the
+                        next call of play.
+        channel      -- The channel whose mute status is to be updated.
+        mute         -- True to mute the channel, False to unmute.
+
+        """
+        _kunquat.kqt_Handle_queue_channel_mute(
+                self._handle, frame_offset, channel, int(mute))
+
+    def add_automation_lane(self, au_path, stream_name):
+        """Add an automation lane for a stream of an audio unit.
+
+        Arguments:
+        au_path     -- The path of the audio unit, e.g. 'au_00' or
+                       'au_00/au_01'.
+        stream_name -- The name of the stream.  The target processor
+                       must process mixed signals.
+
+        Return value:
+        The lane number.
+
+        """
+        return _kunquat.kqt_Handle_add_automation_lane(
+                self._handle,
+                bytes(au_path, encoding='utf-8'),
+                bytes(stream_name, encoding='utf-8'))
+
+    def remove_automation_lane(self, lane):
+        """Remove an automation lane.
+
+        Arguments:
+        lane -- The lane number.
+
+        """
+        _kunquat.kqt_Handle_remove_automation_lane(self._handle, lane)
+
+    def set_automation_values(self, lane, values):
+        """Set values of an automation lane for the next call of play.
+
+        Arguments:
+        lane   -- The lane number.
+        values -- A sequence of values, one for each frame from the
+                  start of the next call of play.
+
+        """
+        cvalues = (ctypes.c_float * len(values))(*values)
+        _kunquat.kqt_Handle_set_automation_values(
+                self._handle, lane, len(values), cvalues)
+
+    def add_automation_point(self, lane, frame_offset, value):
+        """Add a breakpoint to an automation lane for the next call of play.
+
+        Arguments:
+        lane         -- The lane number.
+        frame_offset -- The offset in frames from the start of the
+                        next call of play.
+        value        -- The value at the breakpoint.  The values
+                        before the breakpoint are interpolated
+                        linearly.
+
+        """
+        _kunquat.kqt_Handle_add_automation_point(
+                self._handle, lane, frame_offset, value)
+
     def receive_events(self):
         """Receive outgoing events.
 
@@ -342,6 +635,63 @@ class Kunquat():
             el = json.loads(str(raw_el_data, encoding='utf-8'))
         return all_events
 
+    def receive_events_binary(self):
+        """Receive outgoing events without JSON decoding.
+
+        Return value:
+        A list of events in the same format as returned by
+        receive_events.  Timestamps and pattern instance references
+        are returned as lists of two integers.
+
+        """
+        all_events = []
+        size = ctypes.c_long(0)
+        data = _kunquat.kqt_Handle_receive_events_binary(
+                self._handle, ctypes.byref(size))
+        while size.value > 0:
+            all_events += decode_binary_events(ctypes.string_at(data, size.value))
+            data = _kunquat.kqt_Handle_receive_events_binary(
+                    self._handle, ctypes.byref(size))
+        return all_events
+
+    def render_audio_unit(self, au_index, events, frame_count):
+        """Render the output of an audio unit without affecting playback.
+
+        Arguments:
+        au_index -- The audio unit index.  The audio unit must be
+                    connected to a control.
+        events -- A list of events as [frame, [name, argument]] pairs
+                  in non-decreasing order of frame position.  The
+                  arguments must be numeric or None.
+        frame_count -- The number of frames to be rendered.
+
+        Return value:
+        A list of floating-point values in interleaved 2-channel
+        format.
+
+        """
+        event_count = len(events)
+        frames = (ctypes.c_long * max(1, event_count))()
+        ids = (ctypes.c_int * max(1, event_count))()
+        args = (ctypes.c_double * max(1, event_count))()
+        for i, (frame, (name, arg)) in enumerate(events):
+            frames[i] = frame
+            ids[i] = _kunquat.kqt_Handle_get_event_id(
+                    self._handle, bytes(name, encoding='utf-8'))
+            args[i] = float(arg) if arg != None else 0.0
+
+        dest = (ctypes.c_float * (frame_count * 2))()
+        _kunquat.kqt_Handle_render_audio_unit(
+                self._handle,
+                au_index,
+                event_count,
+                frames,
+                ids,
+                args,
+                frame_count,
+                dest)
+        return dest[:]
+
     def get_handle(self):
         """Get the internal Kunquat Handle.
 
@@ -404,6 +754,71 @@ def get_limit_info():
     return limit_info
 
 
+_EVENT_ARG_NONE = 0
+_EVENT_ARG_BOOL = 1
+_EVENT_ARG_INT = 2
+_EVENT_ARG_FLOAT = 3
+_EVENT_ARG_TSTAMP = 4
+_EVENT_ARG_STRING = 5
+_EVENT_ARG_PAT_INST_REF = 6
+
+_event_header = struct.Struct('=BBBB')
+_event_int = struct.Struct('=q')
+_event_float = struct.Struct('=d')
+_event_tstamp = struct.Struct('=qi')
+_event_pat_inst_ref = struct.Struct('=ii')
+
+_event_names = {}
+
+
+def decode_binary_events(data):
+    """Decode events returned by kqt_Handle_receive_events_binary.
+
+    Arguments:
+    data -- The event data as a bytes-like object.
+
+    Return value:
+    A list of events as [channel, [name, argument]] pairs.
+
+    """
+    events = []
+    pos = 0
+    data_len = len(data)
+    header_size = _event_header.size
+    while pos < data_len:
+        ch, arg_type, name_len, arg_len = _event_header.unpack_from(data, pos)
+        pos += header_size
+
+        raw_name = bytes(data[pos:pos + name_len])
+        name = _event_names.get(raw_name)
+        if name is None:
+            name = str(raw_name, encoding='utf-8')
+            _event_names[raw_name] = name
+        pos += name_len
+
+        if arg_type == _EVENT_ARG_NONE:
+            arg = None
+        elif arg_type == _EVENT_ARG_BOOL:
+            arg = data[pos] != 0
+        elif arg_type == _EVENT_ARG_INT:
+            arg = _event_int.unpack_from(data, pos)[0]
+        elif arg_type == _EVENT_ARG_FLOAT:
+            arg = _event_float.unpack_from(data, pos)[0]
+        elif arg_type == _EVENT_ARG_TSTAMP:
+            arg = list(_event_tstamp.unpack_from(data, pos))
+        elif arg_type == _EVENT_ARG_STRING:
+            arg = str(bytes(data[pos:pos + arg_len]), encoding='utf-8')
+        elif arg_type == _EVENT_ARG_PAT_INST_REF:
+            arg = list(_event_pat_inst_ref.unpack_from(data, pos))
+        else:
+            raise ValueError('Unknown event argument type: {}'.format(arg_type))
+        pos += arg_len
+
+        events.append([ch, [name, arg]])
+
+    return events
+
+
 def _get_error(obj):
     if obj['type'] == 'ArgumentError':
         return KunquatArgumentError(obj)
@@ -426,6 +841,15 @@ def _error_check(result, func, arguments):
     raise _get_error(json.loads(error_str))
 
 
+def _queue_check(result, func, arguments):
+    # The queue functions do not set the error of the Handle
+    if result < 0:
+        raise KunquatArgumentError('Invalid arguments: {}'.format(arguments[1:]))
+    elif result == 0:
+        raise KunquatResourceError('Command queue is full')
+    return result
+
+
 class KunquatError(Exception):
 
     """Base class for errors in Kunquat."""
@@ -543,6 +967,8 @@ kqt_Handle = ctypes.c_int
 
 _kunquat.kqt_new_Handle.argtypes = []
 _kunquat.kqt_new_Handle.restype = kqt_Handle
+_kunquat.kqt_new_Handle_sharing.argtypes = [kqt_Handle]
+_kunquat.kqt_new_Handle_sharing.restype = kqt_Handle
 _kunquat.kqt_del_Handle.argtypes = [kqt_Handle]
 _kunquat.kqt_del_Handle.restype = None
 
@@ -562,14 +988,31 @@ _kunquat.kqt_Handle_get_loader_thread_count.argtypes = [kqt_Handle]
 _kunquat.kqt_Handle_get_loader_thread_count.restype = ctypes.c_int
 _kunquat.kqt_Handle_get_loader_thread_count.errcheck = _error_check
 
+_kunquat.kqt_Handle_set_sample_streaming.argtypes = [
+        kqt_Handle, ctypes.c_long, ctypes.c_char_p]
+_kunquat.kqt_Handle_set_sample_streaming.restype = ctypes.c_int
+_kunquat.kqt_Handle_set_sample_streaming.errcheck = _error_check
+_kunquat.kqt_Handle_set_cache_dir.argtypes = [kqt_Handle, ctypes.c_char_p]
+_kunquat.kqt_Handle_set_cache_dir.restype = ctypes.c_int
+_kunquat.kqt_Handle_set_cache_dir.errcheck = _error_check
+
 _kunquat.kqt_Handle_set_data.argtypes = [
         kqt_Handle, ctypes.c_char_p, ctypes.POINTER(ctypes.c_ubyte), ctypes.c_long]
 _kunquat.kqt_Handle_set_data.restype = ctypes.c_int
 _kunquat.kqt_Handle_set_data.errcheck = _error_check
 
+_kunquat.kqt_Handle_set_data_float.argtypes = [
+        kqt_Handle, ctypes.c_char_p, ctypes.c_double]
+_kunquat.kqt_Handle_set_data_float.restype = ctypes.c_int
+_kunquat.kqt_Handle_set_data_float.errcheck = _error_check
+
 _kunquat.kqt_Handle_play.argtypes = [kqt_Handle, ctypes.c_long]
 _kunquat.kqt_Handle_play.restype = ctypes.c_int
 _kunquat.kqt_Handle_play.errcheck = _error_check
+_kunquat.kqt_Handle_set_input_audio.argtypes = [
+        kqt_Handle, ctypes.c_int, ctypes.c_long, ctypes.POINTER(ctypes.c_float)]
+_kunquat.kqt_Handle_set_input_audio.restype = ctypes.c_int
+_kunquat.kqt_Handle_set_input_audio.errcheck = _error_check
 _kunquat.kqt_Handle_has_stopped.argtypes = [kqt_Handle]
 _kunquat.kqt_Handle_has_stopped.restype = ctypes.c_int
 _kunquat.kqt_Handle_has_stopped.errcheck = _error_check
@@ -581,12 +1024,22 @@ _kunquat.kqt_Handle_get_audio.argtypes = [kqt_Handle]
 _kunquat.kqt_Handle_get_audio.restype = ctypes.POINTER(ctypes.c_float)
 _kunquat.kqt_Handle_get_audio.errcheck = _error_check
 
+_kunquat.kqt_Handle_get_bus_count.argtypes = [kqt_Handle]
+_kunquat.kqt_Handle_get_bus_count.restype = ctypes.c_int
+_kunquat.kqt_Handle_get_bus_count.errcheck = _error_check
+_kunquat.kqt_Handle_get_bus_audio.argtypes = [kqt_Handle, ctypes.c_int]
+_kunquat.kqt_Handle_get_bus_audio.restype = ctypes.POINTER(ctypes.c_float)
+_kunquat.kqt_Handle_get_bus_audio.errcheck = _error_check
+
 _kunquat.kqt_Handle_set_player_thread_count.argtypes = [kqt_Handle, ctypes.c_int]
 _kunquat.kqt_Handle_set_player_thread_count.restype = ctypes.c_int
 _kunquat.kqt_Handle_set_player_thread_count.errcheck = _error_check
 _kunquat.kqt_Handle_get_player_thread_count.argtypes = [kqt_Handle]
 _kunquat.kqt_Handle_get_player_thread_count.restype = ctypes.c_int
 _kunquat.kqt_Handle_get_player_thread_count.errcheck = _error_check
+_kunquat.kqt_Handle_set_cpu_budget.argtypes = [kqt_Handle, ctypes.c_double]
+_kunquat.kqt_Handle_set_cpu_budget.restype = ctypes.c_int
+_kunquat.kqt_Handle_set_cpu_budget.errcheck = _error_check
 
 _kunquat.kqt_Handle_set_audio_rate.argtypes = [kqt_Handle, ctypes.c_long]
 _kunquat.kqt_Handle_set_audio_rate.restype = ctypes.c_int
@@ -605,6 +1058,19 @@ _kunquat.kqt_Handle_get_audio_buffer_size.errcheck = _error_check
 _kunquat.kqt_Handle_get_duration.argtypes = [kqt_Handle, ctypes.c_int]
 _kunquat.kqt_Handle_get_duration.restype = ctypes.c_longlong
 _kunquat.kqt_Handle_get_duration.errcheck = _error_check
+_kunquat.kqt_Handle_get_time_at_position.argtypes = [
+        kqt_Handle, ctypes.c_int, ctypes.c_int, ctypes.c_longlong, ctypes.c_long]
+_kunquat.kqt_Handle_get_time_at_position.restype = ctypes.c_longlong
+_kunquat.kqt_Handle_get_time_at_position.errcheck = _error_check
+_kunquat.kqt_Handle_get_position_at_time.argtypes = [
+        kqt_Handle,
+        ctypes.c_int,
+        ctypes.c_longlong,
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_longlong),
+        ctypes.POINTER(ctypes.c_long)]
+_kunquat.kqt_Handle_get_position_at_time.restype = ctypes.c_int
+_kunquat.kqt_Handle_get_position_at_time.errcheck = _error_check
 _kunquat.kqt_Handle_set_position.argtypes = [kqt_Handle, ctypes.c_int, ctypes.c_longlong]
 _kunquat.kqt_Handle_set_position.restype = ctypes.c_int
 _kunquat.kqt_Handle_set_position.errcheck = _error_check
@@ -619,10 +1085,61 @@ _kunquat.kqt_Handle_set_channel_mute.errcheck = _error_check
 _kunquat.kqt_Handle_fire_event.argtypes = [kqt_Handle, ctypes.c_int, ctypes.c_char_p]
 _kunquat.kqt_Handle_fire_event.restype = ctypes.c_int
 _kunquat.kqt_Handle_fire_event.errcheck = _error_check
+_kunquat.kqt_Handle_fire_event_at.argtypes = [
+        kqt_Handle, ctypes.c_long, ctypes.c_int, ctypes.c_char_p]
+_kunquat.kqt_Handle_fire_event_at.restype = ctypes.c_int
+_kunquat.kqt_Handle_fire_event_at.errcheck = _error_check
+
+_kunquat.kqt_Handle_queue_event.argtypes = [
+        kqt_Handle, ctypes.c_long, ctypes.c_int, ctypes.c_int, ctypes.c_double]
+_kunquat.kqt_Handle_queue_event.restype = ctypes.c_int
+_kunquat.kqt_Handle_queue_event.errcheck = _queue_check
+_kunquat.kqt_Handle_queue_channel_mute.argtypes = [
+        kqt_Handle, ctypes.c_long, ctypes.c_int, ctypes.c_int]
+_kunquat.kqt_Handle_queue_channel_mute.restype = ctypes.c_int
+_kunquat.kqt_Handle_queue_channel_mute.errcheck = _queue_check
+
+_kunquat.kqt_Handle_add_automation_lane.argtypes = [
+        kqt_Handle, ctypes.c_char_p, ctypes.c_char_p]
+_kunquat.kqt_Handle_add_automation_lane.restype = ctypes.c_int
+_kunquat.kqt_Handle_add_automation_lane.errcheck = _error_check
+
+_kunquat.kqt_Handle_remove_automation_lane.argtypes = [kqt_Handle, ctypes.c_int]
+_kunquat.kqt_Handle_remove_automation_lane.restype = ctypes.c_int
+_kunquat.kqt_Handle_remove_automation_lane.errcheck = _error_check
+
+_kunquat.kqt_Handle_set_automation_values.argtypes = [
+        kqt_Handle, ctypes.c_int, ctypes.c_long, ctypes.POINTER(ctypes.c_float)]
+_kunquat.kqt_Handle_set_automation_values.restype = ctypes.c_int
+_kunquat.kqt_Handle_set_automation_values.errcheck = _error_check
+
+_kunquat.kqt_Handle_add_automation_point.argtypes = [
+        kqt_Handle, ctypes.c_int, ctypes.c_long, ctypes.c_double]
+_kunquat.kqt_Handle_add_automation_point.restype = ctypes.c_int
+_kunquat.kqt_Handle_add_automation_point.errcheck = _error_check
 
 _kunquat.kqt_Handle_receive_events.argtypes = [kqt_Handle]
 _kunquat.kqt_Handle_receive_events.restype = ctypes.c_char_p
 _kunquat.kqt_Handle_receive_events.errcheck = _error_check
+_kunquat.kqt_Handle_receive_events_binary.argtypes = [
+        kqt_Handle, ctypes.POINTER(ctypes.c_long)]
+_kunquat.kqt_Handle_receive_events_binary.restype = ctypes.POINTER(ctypes.c_ubyte)
+_kunquat.kqt_Handle_receive_events_binary.errcheck = _error_check
+
+_kunquat.kqt_Handle_get_event_id.argtypes = [kqt_Handle, ctypes.c_char_p]
+_kunquat.kqt_Handle_get_event_id.restype = ctypes.c_int
+_kunquat.kqt_Handle_get_event_id.errcheck = _error_check
+_kunquat.kqt_Handle_render_audio_unit.argtypes = [
+        kqt_Handle,
+        ctypes.c_int,
+        ctypes.c_long,
+        ctypes.POINTER(ctypes.c_long),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_double),
+        ctypes.c_long,
+        ctypes.POINTER(ctypes.c_float)]
+_kunquat.kqt_Handle_render_audio_unit.restype = ctypes.c_int
+_kunquat.kqt_Handle_render_audio_unit.errcheck = _error_check
 
 _kunquat.kqt_get_event_names.argtypes = []
 _kunquat.kqt_get_event_names.restype = ctypes.POINTER(ctypes.c_char_p)
@@ -15,7 +15,6 @@
 import time
 import math
 from collections import deque
-from itertools import islice
 
 from kunquat.kunquat.kunquat import Kunquat, KunquatError, KunquatFormatError
 from kunquat.kunquat.file import KqtFile, KQTFILE_KEEP_ALL_DATA
@@ -64,10 +63,10 @@ class AudioEngine():
     def _get_audio_levels(self, audio_data):
         levels = []
 
-        lslice = islice(audio_data, 0, None, 2)
-        rslice = islice(audio_data, 1, None, 2)
+        lslice = audio_data[0::2]
+        rslice = audio_data[1::2]
         for ch in (lslice, rslice):
-            max_level = max(abs(item) for item in ch)
+            max_level = max(max(ch), -min(ch))
             levels.append(max_level)
 
         return tuple(levels)
@@ -131,8 +130,8 @@ class AudioEngine():
             attempt_count = 16
             for _ in range(attempt_count):
                 self._rendering_engine.play(nframes)
-                audio_data = self._rendering_engine.get_audio()
-                event_data = self._rendering_engine.receive_events()
+                audio_data = self._rendering_engine.get_audio_view()
+                event_data = self._rendering_engine.receive_events_binary()
                 self._process_events(event_data, CONTEXT_MIX)
                 self._process_post_actions()
                 frame_count = len(audio_data) // 2
@@ -65,6 +65,9 @@ class Pulseaudio():
 
     def put_audio(self, audio):
         assert self._started
+        # Audio views are only valid until the next rendering call
+        if isinstance(audio, memoryview):
+            audio = audio.tolist()
         self._buffer.put(audio)
         self._acks.get()
         self._audio_source.acknowledge_audio()
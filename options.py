@@ -39,6 +39,12 @@ enable_python_tests = True
 # enable multithreading (requires with_pthread)
 enable_threads = True
 
+# allocate rendering buffers from memory arenas owned by each rendering thread
+enable_thread_arenas = True
+
+# request transparent huge pages for rendering thread memory arenas
+enable_huge_pages = False
+
 # enable kunquat-player (requires Python bindings)
 enable_player = True
 
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+#
+# Author: Tomi Jylhä-Ollila, Finland 2019
+#
+# This file is part of Kunquat.
+#
+# CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+#
+# To the extent possible under law, Kunquat Affirmers have waived all
+# copyright and related or neighboring rights to Kunquat.
+#
+
+# Measures how audio rendering throughput scales with the number of player
+# threads. Run from the repository root after building, e.g.
+#
+#   LD_LIBRARY_PATH=build/src/lib PYTHONPATH=. \
+#       scripts/benchmark_player_threads.py examples/Asturias.kqt
+
+import argparse
+import os
+import sys
+import time
+
+from kunquat.kunquat.file import KqtFile
+from kunquat.kunquat.kunquat import Kunquat
+
+
+def load_handle(path, rate, buffer_size):
+    handle = Kunquat(rate)
+    handle.set_loader_thread_count(os.cpu_count() or 1)
+    f = KqtFile(handle)
+    f.load(path)
+    handle.validate()
+    handle.audio_buffer_size = buffer_size
+    return handle
+
+
+def render(handle, track, frame_count):
+    handle.track = track
+    start = time.perf_counter()
+    rendered = 0
+    while rendered < frame_count and not handle.has_stopped():
+        handle.play()
+        rendered += handle.audio_buffer_size
+    return rendered, time.perf_counter() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(
+            description='Measure rendering speed with different thread counts.')
+    parser.add_argument('path', help='Kunquat music file (.kqt)')
+    parser.add_argument('--max-threads', type=int, default=os.cpu_count() or 1)
+    parser.add_argument('--seconds', type=float, default=30.0,
+            help='length of audio rendered per thread count')
+    parser.add_argument('--rate', type=int, default=48000)
+    parser.add_argument('--buffer-size', type=int, default=2048)
+    parser.add_argument('--track', type=int, default=0)
+    parser.add_argument('--repeats', type=int, default=3,
+            help='number of runs per thread count, the fastest is reported')
+    args = parser.parse_args()
+
+    handle = load_handle(args.path, args.rate, args.buffer_size)
+    frame_count = int(args.seconds * args.rate)
+
+    # Warm up caches and lazily initialised state
+    render(handle, args.track, min(frame_count, args.rate))
+
+    print('threads  frames/s  x realtime  speedup')
+    base_speed = None
+    for thread_count in range(1, args.max_threads + 1):
+        handle.set_player_thread_count(thread_count)
+        actual_count = handle.get_player_thread_count()
+        if actual_count != thread_count:
+            print('Could not use {} threads'.format(thread_count), file=sys.stderr)
+            break
+
+        best_speed = 0
+        for _ in range(args.repeats):
+            rendered, elapsed = render(handle, args.track, frame_count)
+            best_speed = max(best_speed, rendered / max(elapsed, 1e-9))
+
+        if base_speed is None:
+            base_speed = best_speed
+
+        print('{:7d}  {:8.0f}  {:10.1f}  {:7.2f}'.format(
+            thread_count,
+            best_speed,
+            best_speed / args.rate,
+            best_speed / base_speed))
+
+
+if __name__ == '__main__':
+    main()
+
+
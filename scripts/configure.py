@@ -47,6 +47,11 @@ def test_add_common_external_deps(builder, options, cc):
 def test_add_libkunquat_external_deps(builder, options, cc):
     conf_errors = []
 
+    # Required for POSIX file functions such as fseeko and fileno
+    cc.add_define('_XOPEN_SOURCE', 700)
+
+    has_mman = _test_header(builder, cc, 'sys/mman.h')
+
     if options.enable_threads:
         if not _test_header(builder, cc, 'stdatomic.h'):
             conf_errors.append('Multithreading support was requested'
@@ -56,7 +61,6 @@ def test_add_libkunquat_external_deps(builder, options, cc):
             if _test_header(builder, cc, 'pthread.h'):
                 cc.add_compile_flag('-pthread')
                 cc.add_link_flag('-pthread')
-                cc.add_define('_XOPEN_SOURCE', 700)
                 cc.add_define('WITH_PTHREAD')
             else:
                 conf_errors.append(
@@ -67,6 +71,20 @@ def test_add_libkunquat_external_deps(builder, options, cc):
                     ' threading implementation specified.')
         cc.add_define('ENABLE_THREADS')
 
+        if options.enable_thread_arenas:
+            if has_mman:
+                cc.add_define('ENABLE_THREAD_ARENAS')
+                # Required for anonymous memory mappings
+                cc.add_define('_DEFAULT_SOURCE')
+                if options.enable_huge_pages:
+                    cc.add_define('ENABLE_HUGE_PAGES')
+            else:
+                print('Warning: sys/mman.h was not found,'
+                        ' disabling rendering thread memory arenas.', file=sys.stderr)
+
+    if has_mman:
+        cc.add_define('WITH_MMAP')
+
     if options.with_sndfile:
         if _test_add_lib_with_header(builder, cc, 'sndfile', 'sndfile.h'):
             cc.add_define('WITH_SNDFILE')
@@ -236,7 +254,7 @@ def _test_header(builder, cc, header_name):
     command.make_dirs(builder, out_dir, echo='')
 
     print('Checking for header {}... '.format(header_name), end='')
-    name_base = header_name[:header_name.rindex('.')]
+    name_base = header_name[:header_name.rindex('.')].replace('/', '_')
     out_base = os.path.join(out_dir, name_base)
     _write_external_header_test(builder, out_base, header_name)
     try:
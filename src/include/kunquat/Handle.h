@@ -67,6 +67,26 @@ typedef int kqt_Handle;
 kqt_Handle kqt_new_Handle(void);
 
 
+/**
+ * Create a Kunquat Handle that plays the composition of another Handle.
+ *
+ * The new Handle shares the composition data of \a source, including all
+ * samples and generated tables, but has its own playback state. Memory usage
+ * of each additional Handle is therefore independent of the size of the
+ * composition. The Handles may be used and destroyed in any order.
+ *
+ * The composition cannot be modified with kqt_Handle_set_data or
+ * kqt_Handle_set_sample_streaming while it is shared by more than one Handle.
+ *
+ * \param source   The Handle whose composition is shared -- should be valid
+ *                 and validated.
+ *
+ * \return   The new Kunquat Handle if successful, otherwise \c 0
+ *           (check kqt_Handle_get_error(\c 0) for error message).
+ */
+kqt_Handle kqt_new_Handle_sharing(kqt_Handle source);
+
+
 /**
  * Set the number of threads used by the Kunquat Handle for loading operations.
  *
@@ -95,6 +115,52 @@ int kqt_Handle_set_loader_thread_count(kqt_Handle handle, int count);
 int kqt_Handle_get_loader_thread_count(kqt_Handle handle);
 
 
+/**
+ * Set up streaming of long samples from a cache file.
+ *
+ * When enabled, only the first \a preload_frames frames of each subsequently
+ * loaded sample are kept in memory. The remaining frames are written to a
+ * cache file and read back by a background I/O thread during playback. The
+ * preload length should cover the time needed for the first disk read;
+ * frames that are not read in time are rendered as silence.
+ *
+ * The streaming settings cannot be changed while streamed samples exist.
+ *
+ * NOTE: Only WavPack samples are streamed.
+ *
+ * \param handle           The Handle -- should be valid.
+ * \param preload_frames   The number of frames kept in memory for each
+ *                         sample -- should be >= \c 0. \c 0 disables
+ *                         streaming.
+ * \param cache_dir        The directory where the cache file is created, or
+ *                         \c NULL to use a temporary file.
+ *
+ * \return   \c 1 if successful, otherwise \c 0.
+ */
+int kqt_Handle_set_sample_streaming(
+        kqt_Handle handle, long preload_frames, const char* cache_dir);
+
+
+/**
+ * Set the directory of the persistent sample data cache.
+ *
+ * When enabled, decoded sample data and generated PADsynth tables are stored
+ * in \a dir, identified by a checksum of the source data and parameters.
+ * Subsequent loads of identical data read the stored result instead of
+ * repeating the work. The directory may be shared between Handles and
+ * processes. Stored entries are never removed by libkunquat. Failures to
+ * read or write the cache are not reported; the data is then processed as
+ * if the cache were disabled.
+ *
+ * \param handle   The Handle -- should be valid.
+ * \param dir      The existing cache directory, or \c NULL or an empty
+ *                 string to disable caching.
+ *
+ * \return   \c 1 if successful, otherwise \c 0.
+ */
+int kqt_Handle_set_cache_dir(kqt_Handle handle, const char* dir);
+
+
 /**
  * Set data of the Kunquat Handle associated with the given key.
  *
@@ -121,6 +187,27 @@ int kqt_Handle_set_data(
         kqt_Handle handle, const char* key, const void* data, long length);
 
 
+/**
+ * Set a floating-point processor parameter of the Kunquat Handle.
+ *
+ * This is equivalent to calling kqt_Handle_set_data with the data
+ * <code>[0, value]</code> but avoids formatting and parsing the value.
+ * In addition, if the processor of \a key already exists, the handle is not
+ * set as not validated, which makes this function suitable for changing
+ * parameters during playback.
+ *
+ * \param handle   The Kunquat Handle -- should be valid.
+ * \param key      The key of the processor parameter -- should not be
+ *                 \c NULL. The key must be inside the i/ or c/ directory of
+ *                 a processor and its last component must start with \c p_f_.
+ * \param value    The new value -- should be finite.
+ *
+ * \return   \c 1 if successful. Otherwise, \c 0 is returned and the Kunquat
+ *           Handle error is set accordingly.
+ */
+int kqt_Handle_set_data_float(kqt_Handle handle, const char* key, double value);
+
+
 /**
  * Get error description from the Kunquat Handle.
  *
@@ -77,6 +77,31 @@ extern "C" {
 int kqt_Handle_play(kqt_Handle handle, long nframes);
 
 
+/**
+ * Set audio input for the next call of kqt_Handle_play.
+ *
+ * The input is sent to the connection graph from an input port of the
+ * master, which appears as the source "in_XX" in the top-level
+ * connections. The input port must be declared in the composition with the
+ * key "in_XX/p_manifest.json". Frames beyond \a frame_count are silent, and
+ * the input is discarded after the call of kqt_Handle_play. This function
+ * may not be called while another thread is calling kqt_Handle_play on the
+ * same Handle.
+ *
+ * \param handle        The Handle -- should be valid.
+ * \param port          The input port -- should be >= \c 0 and
+ *                      < \c KQT_DEVICE_PORTS_MAX.
+ * \param frame_count   The number of frames in \a data -- should be >= \c 0
+ *                      and not greater than the audio buffer size.
+ * \param data          The input audio data -- should not be \c NULL if
+ *                      \a frame_count > \c 0.
+ *
+ * \return   \c 1 if successful, or \c 0 if an error occurred.
+ */
+int kqt_Handle_set_input_audio(
+        kqt_Handle handle, int port, long frame_count, const float* data);
+
+
 /**
  * Find out if playback has stopped in the Kunquat Handle.
  *
@@ -121,6 +146,39 @@ long kqt_Handle_get_frames_available(kqt_Handle handle);
 const float* kqt_Handle_get_audio(kqt_Handle handle);
 
 
+/**
+ * Get the number of output buses in the Kunquat Handle.
+ *
+ * Each pair of master output ports "out_XX" forms a stereo bus, so that
+ * bus n consists of the ports 2n and 2n + 1. Bus \c 0 is the main output
+ * returned by kqt_Handle_get_audio. The other buses can be used to render
+ * stems of the composition in a single pass. The number of buses is updated
+ * when the Handle is validated.
+ *
+ * \param handle   The Handle -- should be valid.
+ *
+ * \return   The number of buses, or \c 0 if an error occurred.
+ */
+int kqt_Handle_get_bus_count(kqt_Handle handle);
+
+
+/**
+ * Get the audio buffer of an output bus from the Kunquat Handle.
+ *
+ * When called after a successful call of kqt_Handle_play, this function
+ * returns the rendered audio of the bus as 2-channel interleaved data in
+ * the same format as kqt_Handle_get_audio. The master volume and the mixing
+ * volume are applied to every bus.
+ *
+ * \param handle   The Handle -- should be valid.
+ * \param bus      The bus number -- should be >= \c 0 and less than the
+ *                 number of buses.
+ *
+ * \return   The buffer, or \c NULL if an error occurred.
+ */
+const float* kqt_Handle_get_bus_audio(kqt_Handle handle, int bus);
+
+
 /**
  * Set the number of threads used by the Kunquat Handle for audio rendering.
  *
@@ -148,6 +206,32 @@ int kqt_Handle_set_player_thread_count(kqt_Handle handle, int count);
 int kqt_Handle_get_player_thread_count(kqt_Handle handle);
 
 
+/**
+ * Set the CPU budget of audio rendering in the Kunquat Handle.
+ *
+ * The budget is the maximum acceptable ratio of the time spent in
+ * kqt_Handle_play to the duration of the rendered audio. When rendering
+ * exceeds the budget, the Handle lowers its polyphony limit and stops the
+ * quietest Voices, preferring Voices that have already been released. The
+ * limit is raised again gradually once rendering fits the budget.
+ *
+ * While the budget is enabled, the Handle reports the following events
+ * through kqt_Handle_receive_events:
+ *
+ * - ["Aoverload", load] when a call of kqt_Handle_play exceeded the budget.
+ * - ["Apolyphony", limit] when the polyphony limit has changed.
+ * - ["Avsteal", count] when Voice groups have been stopped to make room
+ *   for new Voices or to meet the polyphony limit.
+ *
+ * \param handle   The Handle -- should be valid.
+ * \param budget   The CPU budget -- should be >= \c 0 and <= \c 1. Value
+ *                 \c 0 disables the budget, which is the default.
+ *
+ * \return   \c 1 if successful, otherwise \c 0.
+ */
+int kqt_Handle_set_cpu_budget(kqt_Handle handle, double budget);
+
+
 /**
  * Set the audio rate of the Kunquat Handle.
  *
@@ -225,6 +309,56 @@ long kqt_Handle_get_audio_buffer_size(kqt_Handle handle);
 long long kqt_Handle_get_duration(kqt_Handle handle, int track);
 
 
+/**
+ * Get the time at which a position in a track is played for the first time.
+ *
+ * The timing of the track is calculated on first use and kept until the
+ * composition data that affects playback order or tempo is changed.
+ *
+ * \param handle   The Handle -- should be valid.
+ * \param track    The track number -- should be >= \c 0 and
+ *                 < \c KQT_TRACKS_MAX.
+ * \param system   The system number -- should be >= \c 0.
+ * \param beats    The number of beats from the start of the pattern --
+ *                 should be >= \c 0.
+ * \param rem      The remainder of the beat -- should be >= \c 0 and
+ *                 < \c KQT_TSTAMP_BEAT.
+ *
+ * \return   The time in nanoseconds from the start of the track, or \c -1
+ *           if the position is not played within KQT_CALC_DURATION_MAX
+ *           nanoseconds or an error occurred.
+ */
+long long kqt_Handle_get_time_at_position(
+        kqt_Handle handle, int track, int system, long long beats, long rem);
+
+
+/**
+ * Get the position played in a track at a given time.
+ *
+ * \param handle        The Handle -- should be valid.
+ * \param track         The track number -- should be >= \c 0 and
+ *                      < \c KQT_TRACKS_MAX.
+ * \param nanoseconds   The number of nanoseconds from the start of the
+ *                      track -- should be >= \c 0.
+ * \param system        Destination for the system number -- should not be
+ *                      \c NULL.
+ * \param beats         Destination for the number of beats from the start of
+ *                      the pattern -- should not be \c NULL.
+ * \param rem           Destination for the remainder of the beat -- should
+ *                      not be \c NULL.
+ *
+ * \return   \c 1 if successful, or \c 0 if \a nanoseconds is beyond the
+ *           end of the track or an error occurred.
+ */
+int kqt_Handle_get_position_at_time(
+        kqt_Handle handle,
+        int track,
+        long long nanoseconds,
+        int* system,
+        long long* beats,
+        long* rem);
+
+
 /**
  * Set the position to be played.
  *
@@ -282,6 +416,285 @@ int kqt_Handle_set_channel_mute(kqt_Handle handle, int channel, int mute);
 int kqt_Handle_fire_event(kqt_Handle handle, int channel, const char* event);
 
 
+/**
+ * Fire an event at a frame offset of the next kqt_Handle_play call.
+ *
+ * The event is fired by kqt_Handle_play when rendering reaches
+ * \a frame_offset, which makes the timing of the event independent of the
+ * audio buffer size. Unlike the events queued with kqt_Handle_queue_event,
+ * the event may take any argument type but this function must not be
+ * called while another thread is using \a handle.
+ *
+ * \param handle         The Handle -- should be valid.
+ * \param frame_offset   The offset in frames from the start of the next
+ *                       kqt_Handle_play call -- should be >= \c 0. Events
+ *                       with offsets beyond the rendered frames are kept
+ *                       until later calls.
+ * \param channel        The channel where the event takes place -- should
+ *                       be >= \c 0 and < \c KQT_CHANNELS_MAX.
+ * \param event          The event description in JSON format -- should not
+ *                       be \c NULL. The description is in the same format
+ *                       as with kqt_Handle_fire_event.
+ *
+ * \return   \c 1 if the event was successfully scheduled, otherwise \c 0.
+ */
+int kqt_Handle_fire_event_at(
+        kqt_Handle handle, long frame_offset, int channel, const char* event);
+
+
+/**
+ * Get the identifier of an event name.
+ *
+ * The identifier can be passed to the kqt_Handle_fire_event_id* functions
+ * to fire events without parsing a JSON description. Identifiers remain
+ * valid for the lifetime of the library.
+ *
+ * \param handle       The Handle -- should be valid.
+ * \param event_name   The event name -- should not be \c NULL.
+ *
+ * \return   The event identifier (> \c 0) if successful, or \c 0 if
+ *           \a event_name is not a supported event.
+ */
+int kqt_Handle_get_event_id(kqt_Handle handle, const char* event_name);
+
+
+/**
+ * Fire an event that does not take an argument.
+ *
+ * \param handle     The Handle -- should be valid.
+ * \param channel    The channel where the event takes place -- should be
+ *                   >= \c 0 and < \c KQT_CHANNELS_MAX.
+ * \param event_id   The event identifier -- should be a value returned by
+ *                   kqt_Handle_get_event_id.
+ *
+ * \return   \c 1 if the event was successfully fired, otherwise \c 0.
+ */
+int kqt_Handle_fire_event_id(kqt_Handle handle, int channel, int event_id);
+
+
+/**
+ * Fire an event with a boolean argument.
+ *
+ * The argument is converted to the parameter type of the event where
+ * possible, as with JSON event descriptions.
+ *
+ * \param handle     The Handle -- should be valid.
+ * \param channel    The channel where the event takes place -- should be
+ *                   >= \c 0 and < \c KQT_CHANNELS_MAX.
+ * \param event_id   The event identifier -- should be a value returned by
+ *                   kqt_Handle_get_event_id.
+ * \param value      The argument, \c 0 for false and \c 1 for true.
+ *
+ * \return   \c 1 if the event was successfully fired, otherwise \c 0.
+ */
+int kqt_Handle_fire_event_id_bool(
+        kqt_Handle handle, int channel, int event_id, int value);
+
+
+/**
+ * Fire an event with an integer argument.
+ *
+ * \param handle     The Handle -- should be valid.
+ * \param channel    The channel where the event takes place -- should be
+ *                   >= \c 0 and < \c KQT_CHANNELS_MAX.
+ * \param event_id   The event identifier -- should be a value returned by
+ *                   kqt_Handle_get_event_id.
+ * \param value      The argument.
+ *
+ * \return   \c 1 if the event was successfully fired, otherwise \c 0.
+ */
+int kqt_Handle_fire_event_id_int(
+        kqt_Handle handle, int channel, int event_id, long long value);
+
+
+/**
+ * Fire an event with a floating-point argument.
+ *
+ * \param handle     The Handle -- should be valid.
+ * \param channel    The channel where the event takes place -- should be
+ *                   >= \c 0 and < \c KQT_CHANNELS_MAX.
+ * \param event_id   The event identifier -- should be a value returned by
+ *                   kqt_Handle_get_event_id.
+ * \param value      The argument -- should be finite.
+ *
+ * \return   \c 1 if the event was successfully fired, otherwise \c 0.
+ */
+int kqt_Handle_fire_event_id_float(
+        kqt_Handle handle, int channel, int event_id, double value);
+
+
+/**
+ * Fire an event with a timestamp argument.
+ *
+ * \param handle     The Handle -- should be valid.
+ * \param channel    The channel where the event takes place -- should be
+ *                   >= \c 0 and < \c KQT_CHANNELS_MAX.
+ * \param event_id   The event identifier -- should be a value returned by
+ *                   kqt_Handle_get_event_id.
+ * \param beats      The number of beats in the argument.
+ * \param rem        The beat remainder in the argument -- should be >= \c 0
+ *                   and < \c KQT_TSTAMP_BEAT.
+ *
+ * \return   \c 1 if the event was successfully fired, otherwise \c 0.
+ */
+int kqt_Handle_fire_event_id_tstamp(
+        kqt_Handle handle, int channel, int event_id, long long beats, long rem);
+
+
+/**
+ * Fire an event with a string argument.
+ *
+ * \param handle     The Handle -- should be valid.
+ * \param channel    The channel where the event takes place -- should be
+ *                   >= \c 0 and < \c KQT_CHANNELS_MAX.
+ * \param event_id   The event identifier -- should be a value returned by
+ *                   kqt_Handle_get_event_id.
+ * \param value      The argument -- should not be \c NULL and should not be
+ *                   longer than \c KQT_VAR_NAME_MAX characters.
+ *
+ * \return   \c 1 if the event was successfully fired, otherwise \c 0.
+ */
+int kqt_Handle_fire_event_id_string(
+        kqt_Handle handle, int channel, int event_id, const char* value);
+
+
+/**
+ * Queue an event to be fired during playback.
+ *
+ * Unlike the kqt_Handle_fire_event* functions, this function may be called
+ * from any thread while another thread is calling kqt_Handle_play on the
+ * same Handle. Queued events are fired by kqt_Handle_play at their frame
+ * offsets, so their timing is independent of the audio buffer size. The
+ * queue does not use locks and holds up to 1024 pending commands.
+ *
+ * \param handle         The Handle -- should be valid.
+ * \param frame_offset   The offset in frames from the start of the next
+ *                       kqt_Handle_play call -- should be >= \c 0. Events
+ *                       with offsets beyond the rendered frames are kept
+ *                       until later calls. Events with equal offsets are
+ *                       fired in the order they were queued.
+ * \param channel        The channel where the event takes place -- should
+ *                       be >= \c 0 and < \c KQT_CHANNELS_MAX.
+ * \param event_id       The event identifier -- should be a value returned
+ *                       by kqt_Handle_get_event_id. Events with string or
+ *                       timestamp arguments are not supported.
+ * \param arg            The event argument. This is ignored if the event
+ *                       does not take an argument.
+ *
+ * \return   \c 1 if the event was queued, \c 0 if the queue is full, or
+ *           \c -1 if an argument is invalid. This function does not set
+ *           the error returned by kqt_Handle_get_error.
+ */
+int kqt_Handle_queue_event(
+        kqt_Handle handle, long frame_offset, int channel, int event_id, double arg);
+
+
+/**
+ * Queue a change of channel mute setting.
+ *
+ * This function may be called from any thread, as with
+ * kqt_Handle_queue_event.
+ *
+ * \param handle         The Handle -- should be valid.
+ * \param frame_offset   The offset in frames from the start of the next
+ *                       kqt_Handle_play call -- should be >= \c 0.
+ * \param channel        The channel -- should be >= \c 0 and
+ *                       < \c KQT_CHANNELS_MAX.
+ * \param mute           \c 1 if \a channel should be muted, or \c 0 if
+ *                       unmuted.
+ *
+ * \return   \c 1 if the change was queued, \c 0 if the queue is full, or
+ *           \c -1 if an argument is invalid. This function does not set
+ *           the error returned by kqt_Handle_get_error.
+ */
+int kqt_Handle_queue_channel_mute(
+        kqt_Handle handle, long frame_offset, int channel, int mute);
+
+
+/**
+ * Add an automation lane for controlling a stream of an audio unit.
+ *
+ * An automation lane passes values from the application directly to the
+ * output of the stream processor without events. The values are written
+ * for the next call of kqt_Handle_play with kqt_Handle_set_automation_values
+ * or kqt_Handle_add_automation_point. The last written value is held until
+ * the end of the call and kept by the stream processor afterwards. Values
+ * beyond the rendered frames are discarded. If no values are written for a
+ * call, the stream processor is controlled by events as usual.
+ *
+ * The stream processor must process mixed signals. Lanes stay connected to
+ * their streams when the composition is changed and validated; lanes whose
+ * streams no longer exist are ignored. The lane functions may not be called
+ * while another thread is calling kqt_Handle_play on the same Handle.
+ *
+ * \param handle        The Handle -- should be valid.
+ * \param au_path       The path of the audio unit, e.g. "au_00" or
+ *                      "au_00/au_01" -- should not be \c NULL.
+ * \param stream_name   The name of the stream in the audio unit -- should
+ *                      not be \c NULL.
+ *
+ * \return   The lane number, or \c -1 if an error occurred. At most 1024
+ *           lanes can exist at the same time.
+ */
+int kqt_Handle_add_automation_lane(
+        kqt_Handle handle, const char* au_path, const char* stream_name);
+
+
+/**
+ * Remove an automation lane.
+ *
+ * \param handle   The Handle -- should be valid.
+ * \param lane     The lane number -- should be a value returned by
+ *                 kqt_Handle_add_automation_lane.
+ *
+ * \return   \c 1 if successful, otherwise \c 0.
+ */
+int kqt_Handle_remove_automation_lane(kqt_Handle handle, int lane);
+
+
+/**
+ * Set values of an automation lane for the next call of kqt_Handle_play.
+ *
+ * The values apply to the frames starting at the beginning of the call.
+ * Values and breakpoints previously written for the call are replaced.
+ *
+ * \param handle   The Handle -- should be valid.
+ * \param lane     The lane number -- should be a value returned by
+ *                 kqt_Handle_add_automation_lane.
+ * \param count    The number of values -- should be >= \c 0 and <= the
+ *                 audio buffer size.
+ * \param values   The values, one per frame -- should not be \c NULL if
+ *                 \a count > \c 0. All values should be finite.
+ *
+ * \return   \c 1 if successful, otherwise \c 0.
+ */
+int kqt_Handle_set_automation_values(
+        kqt_Handle handle, int lane, long count, const float* values);
+
+
+/**
+ * Add a breakpoint to an automation lane for the next call of
+ * kqt_Handle_play.
+ *
+ * The frames between the previous breakpoint or value and \a frame_offset
+ * are interpolated linearly. If nothing has been written for the call, the
+ * ramp starts from the current value of the stream.
+ *
+ * \param handle         The Handle -- should be valid.
+ * \param lane           The lane number -- should be a value returned by
+ *                       kqt_Handle_add_automation_lane.
+ * \param frame_offset   The offset in frames from the start of the next
+ *                       kqt_Handle_play call -- should be >= \c 0, less
+ *                       than the audio buffer size and after all frames
+ *                       already written for the call.
+ * \param value          The value at \a frame_offset -- should be finite.
+ *
+ * \return   \c 1 if successful, otherwise \c 0.
+ */
+int kqt_Handle_add_automation_point(
+        kqt_Handle handle, int lane, long frame_offset, double value);
+
+
 /**
  * Return a JSON list of events.
  *
@@ -297,6 +710,98 @@ int kqt_Handle_fire_event(kqt_Handle handle, int channel, const char* event);
 const char* kqt_Handle_receive_events(kqt_Handle handle);
 
 
+/**
+ * Argument type codes used by kqt_Handle_receive_events_binary.
+ */
+#define KQT_EVENT_ARG_NONE          0
+#define KQT_EVENT_ARG_BOOL          1
+#define KQT_EVENT_ARG_INT           2
+#define KQT_EVENT_ARG_FLOAT         3
+#define KQT_EVENT_ARG_TSTAMP        4
+#define KQT_EVENT_ARG_STRING        5
+#define KQT_EVENT_ARG_PAT_INST_REF  6
+
+
+/**
+ * Return events in a compact binary format.
+ *
+ * This is an alternative to kqt_Handle_receive_events for applications that
+ * want to avoid parsing JSON. The two functions return the same events and
+ * advance the same state, so an application should use only one of them.
+ *
+ * The data consists of consecutive records without padding. Each record
+ * starts with four bytes: the channel number, the argument type code
+ * (one of the KQT_EVENT_ARG_* values), the length of the event name and the
+ * length of the argument data. The header is followed by the event name
+ * (not null-terminated) and the argument data in native byte order:
+ *
+ * \li KQT_EVENT_ARG_NONE: no data
+ * \li KQT_EVENT_ARG_BOOL: one byte, \c 0 or \c 1
+ * \li KQT_EVENT_ARG_INT: 64-bit signed integer
+ * \li KQT_EVENT_ARG_FLOAT: 64-bit IEEE 754 floating-point value
+ * \li KQT_EVENT_ARG_TSTAMP: 64-bit beat count followed by 32-bit remainder
+ * \li KQT_EVENT_ARG_STRING: the characters of the string
+ * \li KQT_EVENT_ARG_PAT_INST_REF: 32-bit pattern number followed by 32-bit
+ *     instance number
+ *
+ * \param handle   The Handle -- should be valid.
+ * \param size     Destination for the size of the data in bytes -- should not
+ *                 be \c NULL.
+ *
+ * \return   The event data if successful, or \c NULL if an error occurred.
+ *           Size \c 0 indicates that all events have been returned. The data
+ *           is valid until the next call of a Handle function.
+ */
+const unsigned char* kqt_Handle_receive_events_binary(kqt_Handle handle, long* size);
+
+
+/**
+ * Render the output of an audio unit into a buffer.
+ *
+ * The audio unit is played on channel \c 0 of a private player that has no
+ * sequencer, so the state of the Kunquat Handle is not affected. Each event
+ * is fired exactly at its frame position. The audio unit is selected
+ * through the control mapped to it, and the output passes through the
+ * connections of the composition.
+ *
+ * This function may be called from several threads simultaneously as long
+ * as no other functions are called on \a handle at the same time.
+ *
+ * \param handle         The Handle -- should be valid.
+ * \param au_index       The audio unit index -- should be >= \c 0 and
+ *                       < \c KQT_AUDIO_UNITS_MAX. The audio unit should be
+ *                       connected to a control.
+ * \param event_count    The number of events -- should be >= \c 0.
+ * \param event_frames   The frame positions of the events -- should not be
+ *                       \c NULL if \a event_count > \c 0. The positions
+ *                       should be in non-decreasing order and
+ *                       < \a frame_count.
+ * \param event_ids      The event identifiers returned by
+ *                       kqt_Handle_get_event_id -- should not be \c NULL if
+ *                       \a event_count > \c 0. Events with string or
+ *                       timestamp arguments are not supported.
+ * \param event_args     The event arguments, or \c NULL if all arguments are
+ *                       \c 0. Arguments of events without a parameter are
+ *                       ignored.
+ * \param frame_count    The number of frames to be rendered -- should be
+ *                       > \c 0.
+ * \param dest           The destination buffer -- should not be \c NULL and
+ *                       should have space for \a frame_count interleaved
+ *                       stereo frames.
+ *
+ * \return   \c 1 if successful, otherwise \c 0.
+ */
+int kqt_Handle_render_audio_unit(
+        kqt_Handle handle,
+        int au_index,
+        long event_count,
+        const long* event_frames,
+        const int* event_ids,
+        const double* event_args,
+        long frame_count,
+        float* dest);
+
+
 /* \} */
 
 
@@ -68,6 +68,16 @@ extern "C" {
 #define KQT_CALC_DURATION_MAX 2592000000000000LL
 
 
+/**
+ * Maximum control period in frames.
+ *
+ * Control streams such as slides and oscillations may be evaluated at a lower
+ * rate than the audio rate. The control period specifies the number of frames
+ * between two consecutive evaluations.
+ */
+#define KQT_CONTROL_PERIOD_MAX 256
+
+
 /**
  * Maximum number of Voices used for mixing.
  */
@@ -17,10 +17,14 @@
 #include <debug/assert.h>
 #include <init/Connections.h>
 #include <init/devices/Audio_unit.h>
+#include <init/devices/Device_field.h>
 #include <init/Module.h>
 #include <init/Parse_manager.h>
+#include <init/Sample_streamer.h>
 #include <kunquat/limits.h>
 #include <memory.h>
+#include <player/Automation_lanes.h>
+#include <player/Timeline.h>
 #include <string/common.h>
 
 #include <stdlib.h>
@@ -105,7 +109,44 @@ kqt_Handle kqt_new_Handle(void)
         return 0;
     }
 
-    if (!Handle_init(handle))
+    if (!Handle_init(handle, NULL))
+    {
+        memory_free(handle);
+        return 0;
+    }
+
+    kqt_Handle id = add_handle(handle);
+    if (id == 0)
+    {
+        Handle_deinit(handle);
+        memory_free(handle);
+        return 0;
+    }
+
+    return id;
+}
+
+
+kqt_Handle kqt_new_Handle_sharing(kqt_Handle source)
+{
+    check_handle(source, 0);
+
+    Handle* src = get_handle(source);
+    if (!src->data_is_valid || !src->data_is_validated)
+    {
+        Handle_set_error(NULL, ERROR_ARGUMENT,
+                "Kunquat Handle %d does not contain validated data", source);
+        return 0;
+    }
+
+    Handle* handle = memory_alloc_item(Handle);
+    if (handle == NULL)
+    {
+        Handle_set_error(0, ERROR_MEMORY, "Couldn't allocate memory");
+        return 0;
+    }
+
+    if (!Handle_init(handle, src->module))
     {
         memory_free(handle);
         return 0;
@@ -161,6 +202,128 @@ int kqt_Handle_get_loader_thread_count(kqt_Handle handle)
 }
 
 
+int kqt_Handle_set_sample_streaming(
+        kqt_Handle handle, long preload_frames, const char* cache_dir)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    if (preload_frames < 0)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Preload length must be non-negative");
+        return 0;
+    }
+
+    if (Module_is_shared(h->module))
+    {
+        Handle_set_error(
+                h,
+                ERROR_ARGUMENT,
+                "Sample streaming cannot be changed while the module is shared");
+        return 0;
+    }
+
+    const Sample_streamer* old_streamer = Module_get_sample_streamer(h->module);
+    if ((old_streamer != NULL) && Sample_streamer_has_samples(old_streamer))
+    {
+        Handle_set_error(
+                h,
+                ERROR_ARGUMENT,
+                "Sample streaming cannot be changed while streamed samples exist");
+        return 0;
+    }
+
+    Background_loader_set_sample_streamer(h->bkg_loader, NULL);
+    Module_set_sample_streamer(h->module, NULL);
+
+    if (preload_frames == 0)
+        return 1;
+
+    Error* error = ERROR_AUTO;
+    Sample_streamer* streamer = new_Sample_streamer(preload_frames, cache_dir, error);
+    if (streamer == NULL)
+    {
+        Handle_set_error_from_Error(h, error);
+        return 0;
+    }
+
+    Module_set_sample_streamer(h->module, streamer);
+    Background_loader_set_sample_streamer(h->bkg_loader, streamer);
+
+    return 1;
+}
+
+
+int kqt_Handle_set_cache_dir(kqt_Handle handle, const char* dir)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    Background_loader_set_data_cache(h->bkg_loader, NULL);
+    del_Data_cache(h->data_cache);
+    h->data_cache = NULL;
+
+    if ((dir == NULL) || (strlen(dir) == 0))
+        return 1;
+
+    Error* error = ERROR_AUTO;
+    h->data_cache = new_Data_cache(dir, error);
+    if (h->data_cache == NULL)
+    {
+        Handle_set_error_from_Error(h, error);
+        return 0;
+    }
+
+    Background_loader_set_data_cache(h->bkg_loader, h->data_cache);
+
+    return 1;
+}
+
+
+static bool affects_timeline(const char* key)
+{
+    rassert(key != NULL);
+
+    static const char* prefixes[] =
+    {
+        "album/",
+        "song_",
+        "pat_",
+        "p_bind.json",
+        "p_environment.json",
+        "p_random_seed.json",
+    };
+
+    for (size_t i = 0; i < sizeof(prefixes) / sizeof(*prefixes); ++i)
+    {
+        if (string_has_prefix(key, prefixes[i]))
+            return true;
+    }
+
+    return false;
+}
+
+
+static void Handle_clear_timelines(Handle* handle)
+{
+    rassert(handle != NULL);
+
+    for (int i = 0; i < KQT_TRACKS_MAX; ++i)
+    {
+        del_Timeline(handle->timelines[i]);
+        handle->timelines[i] = NULL;
+    }
+
+    return;
+}
+
+
 int kqt_Handle_set_data(
         kqt_Handle handle, const char* key, const void* data, long length)
 {
@@ -170,6 +333,13 @@ int kqt_Handle_set_data(
     check_data_is_valid(h, 0);
     check_key(h, key, 0);
 
+    if (Module_is_shared(h->module))
+    {
+        Handle_set_error(
+                h, ERROR_ARGUMENT, "Data cannot be changed while the module is shared");
+        return 0;
+    }
+
     // Short-circuit if we have already got invalid data
     // TODO: Remove this if we decide to collect more error info
     if (Error_is_set(&h->validation_error))
@@ -195,13 +365,53 @@ int kqt_Handle_set_data(
     if (!parse_data(h, key, data, length))
         return 0;
 
+    if (affects_timeline(key))
+        Handle_clear_timelines(h);
+
     h->data_is_validated = false;
 
     return 1;
 }
 
 
-bool Handle_init(Handle* handle)
+int kqt_Handle_set_data_float(kqt_Handle handle, const char* key, double value)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_key(h, key, 0);
+
+    if (Module_is_shared(h->module))
+    {
+        Handle_set_error(
+                h, ERROR_ARGUMENT, "Data cannot be changed while the module is shared");
+        return 0;
+    }
+
+    if (Error_is_set(&h->validation_error))
+        return 1;
+
+    if (get_keyp_device_field_type(key) != DEVICE_FIELD_FLOAT)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Key %s is not of floating-point type", key);
+        return 0;
+    }
+
+    if (!isfinite(value))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Value of key %s is not finite", key);
+        return 0;
+    }
+
+    if (!parse_float_data(h, key, value))
+        return 0;
+
+    return 1;
+}
+
+
+bool Handle_init(Handle* handle, Module* module)
 {
     rassert(handle != NULL);
 
@@ -210,16 +420,27 @@ bool Handle_init(Handle* handle)
     handle->update_connections = false;
     handle->module = NULL;
     handle->bkg_loader = NULL;
+    handle->data_cache = NULL;
     handle->error = *ERROR_AUTO;
     handle->validation_error = *ERROR_AUTO;
     memset(handle->position, '\0', POSITION_LENGTH);
     handle->player = NULL;
     handle->length_counter = NULL;
+    for (int i = 0; i < KQT_TRACKS_MAX; ++i)
+        handle->timelines[i] = NULL;
 
 //    int buffer_count = SONG_DEFAULT_BUF_COUNT;
 //    int voice_count = 256;
 
-    handle->module = new_Module();
+    if (module != NULL)
+    {
+        Module_add_ref(module);
+        handle->module = module;
+    }
+    else
+    {
+        handle->module = new_Module();
+    }
     handle->bkg_loader = new_Background_loader();
     if ((handle->module == NULL) || (handle->bkg_loader == NULL))
     {
@@ -239,6 +460,8 @@ bool Handle_init(Handle* handle)
         return false;
     }
 
+    Player_set_sequencer_only(handle->length_counter, true);
+
     Player_reset(handle->player, -1);
 
     return true;
@@ -670,6 +893,11 @@ int kqt_Handle_validate(kqt_Handle handle)
     // Data is OK
     h->data_is_validated = true;
 
+    Automation_lanes_connect(
+            Player_get_automation_lanes(h->player),
+            h->module,
+            Player_get_device_states(h->player));
+
     // Update connections if needed
     if (h->update_connections)
     {
@@ -833,18 +1061,48 @@ Module* Handle_get_module(Handle* handle)
 }
 
 
+const Timeline* Handle_get_timeline(Handle* handle, int track)
+{
+    rassert(handle != NULL);
+    rassert(handle->data_is_validated);
+    rassert(track >= 0);
+    rassert(track < KQT_TRACKS_MAX);
+
+    if (handle->timelines[track] != NULL)
+        return handle->timelines[track];
+
+    Timeline* timeline = new_Timeline();
+    if ((timeline == NULL) ||
+            !Player_build_timeline(handle->length_counter, track, timeline))
+    {
+        del_Timeline(timeline);
+        Handle_set_error(handle, ERROR_MEMORY, "Couldn't allocate memory for timeline");
+        return NULL;
+    }
+
+    handle->timelines[track] = timeline;
+
+    return timeline;
+}
+
+
 void Handle_deinit(Handle* handle)
 {
     rassert(handle != NULL);
 
+    Handle_clear_timelines(handle);
+
     del_Player(handle->length_counter);
     handle->length_counter = NULL;
     del_Player(handle->player);
     handle->player = NULL;
 
     del_Background_loader(handle->bkg_loader);
+
     del_Module(handle->module);
     handle->module = NULL;
+    del_Data_cache(handle->data_cache);
+    handle->data_cache = NULL;
 
     return;
 }
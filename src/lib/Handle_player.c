@@ -16,16 +16,27 @@
 
 #include <debug/assert.h>
 #include <Error.h>
+#include <init/Au_table.h>
 #include <init/Env_var.h>
 #include <init/Module.h>
+#include <init/Sample_streamer.h>
 #include <kunquat/Player.h>
 #include <kunquat/limits.h>
 #include <mathnum/common.h>
+#include <mathnum/Tstamp.h>
+#include <player/Automation_lanes.h>
+#include <player/Command_queue.h>
+#include <player/Event_names.h>
+#include <player/Event_properties.h>
+#include <player/Event_type.h>
 #include <string/common.h>
+#include <string/var_name.h>
+#include <Value.h>
 
 #include <inttypes.h>
 #include <limits.h>
 #include <math.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -47,6 +58,48 @@ int kqt_Handle_play(kqt_Handle handle, long nframes)
 
     Player_play(h->player, (int32_t)min(nframes, KQT_AUDIO_BUFFER_SIZE_MAX));
 
+    Sample_streamer* streamer = Module_get_sample_streamer(h->module);
+    if (streamer != NULL)
+        Sample_streamer_refill(streamer);
+
+    return 1;
+}
+
+
+int kqt_Handle_set_input_audio(
+        kqt_Handle handle, int port, long frame_count, const float* data)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    if ((port < 0) || (port >= KQT_DEVICE_PORTS_MAX))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid input port: %d", port);
+        return 0;
+    }
+
+    if ((frame_count < 0) || (frame_count > Player_get_audio_buffer_size(h->player)))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid frame count: %ld", frame_count);
+        return 0;
+    }
+
+    if ((data == NULL) && (frame_count > 0))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "No input data given");
+        return 0;
+    }
+
+    if (!Player_set_input_audio(h->player, port, (int32_t)frame_count, data))
+    {
+        Handle_set_error(
+                h, ERROR_MEMORY, "Couldn't allocate memory for input audio");
+        return 0;
+    }
+
     return 1;
 }
 
@@ -119,6 +172,26 @@ int kqt_Handle_get_player_thread_count(kqt_Handle handle)
 }
 
 
+int kqt_Handle_set_cpu_budget(kqt_Handle handle, double budget)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    if (!(budget >= 0 && budget <= 1))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "CPU budget must be within [0, 1]");
+        return 0;
+    }
+
+    Player_set_cpu_budget(h->player, budget);
+
+    return 1;
+}
+
+
 int kqt_Handle_set_audio_rate(kqt_Handle handle, long rate)
 {
     check_handle(handle, 0);
@@ -234,6 +307,36 @@ const float* kqt_Handle_get_audio(kqt_Handle handle)
 }
 
 
+int kqt_Handle_get_bus_count(kqt_Handle handle)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    return Player_get_bus_count(h->player);
+}
+
+
+const float* kqt_Handle_get_bus_audio(kqt_Handle handle, int bus)
+{
+    check_handle(handle, NULL);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, NULL);
+    check_data_is_validated(h, NULL);
+
+    if ((bus < 0) || (bus >= Player_get_bus_count(h->player)))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid bus number: %d", bus);
+        return NULL;
+    }
+
+    return Player_get_bus_audio(h->player, bus);
+}
+
+
 long long kqt_Handle_get_duration(kqt_Handle handle, int track)
 {
     check_handle(handle, -1);
@@ -248,6 +351,15 @@ long long kqt_Handle_get_duration(kqt_Handle handle, int track)
         return -1;
     }
 
+    if (track >= 0)
+    {
+        const Timeline* timeline = Handle_get_timeline(h, track);
+        if (timeline == NULL)
+            return -1;
+
+        return Timeline_get_duration(timeline);
+    }
+
     Player_reset(h->length_counter, track);
     Player_skip(h->length_counter, KQT_CALC_DURATION_MAX);
 
@@ -255,6 +367,93 @@ long long kqt_Handle_get_duration(kqt_Handle handle, int track)
 }
 
 
+long long kqt_Handle_get_time_at_position(
+        kqt_Handle handle, int track, int system, long long beats, long rem)
+{
+    check_handle(handle, -1);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, -1);
+    check_data_is_validated(h, -1);
+
+    if (track < 0 || track >= KQT_TRACKS_MAX)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid track number: %d", track);
+        return -1;
+    }
+    if (system < 0 || system >= KQT_SYSTEMS_MAX)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid system number: %d", system);
+        return -1;
+    }
+    if (beats < 0)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "beats must be non-negative");
+        return -1;
+    }
+    if (rem < 0 || rem >= KQT_TSTAMP_BEAT)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid beat remainder: %ld", rem);
+        return -1;
+    }
+
+    const Timeline* timeline = Handle_get_timeline(h, track);
+    if (timeline == NULL)
+        return -1;
+
+    const Tstamp* pos = Tstamp_set(TSTAMP_AUTO, beats, (int32_t)rem);
+
+    return Timeline_get_time(timeline, system, pos);
+}
+
+
+int kqt_Handle_get_position_at_time(
+        kqt_Handle handle,
+        int track,
+        long long nanoseconds,
+        int* system,
+        long long* beats,
+        long* rem)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    if (track < 0 || track >= KQT_TRACKS_MAX)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid track number: %d", track);
+        return 0;
+    }
+    if (nanoseconds < 0)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "nanoseconds must be non-negative");
+        return 0;
+    }
+    if (system == NULL || beats == NULL || rem == NULL)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "No position destination given");
+        return 0;
+    }
+
+    const Timeline* timeline = Handle_get_timeline(h, track);
+    if (timeline == NULL)
+        return 0;
+
+    int found_system = 0;
+    Tstamp* pos = Tstamp_init(TSTAMP_AUTO);
+    if (!Timeline_get_position(timeline, nanoseconds, &found_system, pos))
+        return 0;
+
+    *system = found_system;
+    *beats = pos->beats;
+    *rem = pos->rem;
+
+    return 1;
+}
+
+
 int kqt_Handle_set_position(kqt_Handle handle, int track, long long nanoseconds)
 {
     check_handle(handle, 0);
@@ -324,7 +523,12 @@ int kqt_Handle_set_channel_mute(kqt_Handle handle, int channel, int mute)
 }
 
 
-int kqt_Handle_fire_event(kqt_Handle handle, int channel, const char* event)
+static int fire_event(
+        kqt_Handle handle,
+        bool is_scheduled,
+        long frame_offset,
+        int channel,
+        const char* event)
 {
     check_handle(handle, 0);
 
@@ -332,6 +536,11 @@ int kqt_Handle_fire_event(kqt_Handle handle, int channel, const char* event)
     check_data_is_valid(h, 0);
     check_data_is_validated(h, 0);
 
+    if (is_scheduled && (frame_offset < 0 || frame_offset > INT32_MAX))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid frame offset: %ld", frame_offset);
+        return 0;
+    }
     if (channel < 0 || channel >= KQT_COLUMNS_MAX)
     {
         Handle_set_error(h, ERROR_ARGUMENT, "Invalid channel number: %d", channel);
@@ -351,7 +560,10 @@ int kqt_Handle_fire_event(kqt_Handle handle, int channel, const char* event)
     }
 
     Streader* sr = Streader_init(STREADER_AUTO, event, (int64_t)length);
-    if (!Player_fire(h->player, channel, sr))
+    const bool success = is_scheduled
+        ? Player_fire_at(h->player, (int32_t)frame_offset, channel, sr)
+        : Player_fire(h->player, channel, sr);
+    if (!success)
     {
         rassert(Streader_is_error_set(sr));
         Handle_set_error(
@@ -366,6 +578,174 @@ int kqt_Handle_fire_event(kqt_Handle handle, int channel, const char* event)
 }
 
 
+int kqt_Handle_fire_event(kqt_Handle handle, int channel, const char* event)
+{
+    return fire_event(handle, false, 0, channel, event);
+}
+
+
+int kqt_Handle_fire_event_at(
+        kqt_Handle handle, long frame_offset, int channel, const char* event)
+{
+    return fire_event(handle, true, frame_offset, channel, event);
+}
+
+
+int kqt_Handle_get_event_id(kqt_Handle handle, const char* event_name)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+
+    if (event_name == NULL)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "No event name given");
+        return 0;
+    }
+
+    const Event_names* names =
+        Event_handler_get_names(Player_get_event_handler(h->player));
+    const Event_type type = Event_names_get(names, event_name);
+    if (type == Event_NONE)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Unsupported event type: %s", event_name);
+        return 0;
+    }
+
+    return (int)type;
+}
+
+
+static int fire_event_id(kqt_Handle handle, int channel, int event_id, Value* value)
+{
+    rassert(value != NULL);
+
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    if (channel < 0 || channel >= KQT_COLUMNS_MAX)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid channel number: %d", channel);
+        return 0;
+    }
+
+    const Event_type type = (Event_type)event_id;
+    if (!Event_is_valid(type))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid event identifier: %d", event_id);
+        return 0;
+    }
+
+    if (!Value_convert_to_field_type(value, Event_properties_get_param_type(type)))
+    {
+        Handle_set_error(
+                h,
+                ERROR_ARGUMENT,
+                "Invalid argument type for event %s",
+                Event_properties_get_name(type));
+        return 0;
+    }
+
+    Player_fire_by_type(h->player, channel, type, value);
+
+    return 1;
+}
+
+
+int kqt_Handle_fire_event_id(kqt_Handle handle, int channel, int event_id)
+{
+    Value* value = VALUE_AUTO;
+    return fire_event_id(handle, channel, event_id, value);
+}
+
+
+int kqt_Handle_fire_event_id_bool(
+        kqt_Handle handle, int channel, int event_id, int value)
+{
+    Value* arg = VALUE_AUTO;
+    arg->type = VALUE_TYPE_BOOL;
+    arg->value.bool_type = (value != 0);
+    return fire_event_id(handle, channel, event_id, arg);
+}
+
+
+int kqt_Handle_fire_event_id_int(
+        kqt_Handle handle, int channel, int event_id, long long value)
+{
+    Value* arg = VALUE_AUTO;
+    arg->type = VALUE_TYPE_INT;
+    arg->value.int_type = (int64_t)value;
+    return fire_event_id(handle, channel, event_id, arg);
+}
+
+
+int kqt_Handle_fire_event_id_float(
+        kqt_Handle handle, int channel, int event_id, double value)
+{
+    check_handle(handle, 0);
+
+    if (!isfinite(value))
+    {
+        Handle_set_error(
+                get_handle(handle), ERROR_ARGUMENT, "Event argument is not finite");
+        return 0;
+    }
+
+    Value* arg = VALUE_AUTO;
+    arg->type = VALUE_TYPE_FLOAT;
+    arg->value.float_type = value;
+    return fire_event_id(handle, channel, event_id, arg);
+}
+
+
+int kqt_Handle_fire_event_id_tstamp(
+        kqt_Handle handle, int channel, int event_id, long long beats, long rem)
+{
+    check_handle(handle, 0);
+
+    if (rem < 0 || rem >= KQT_TSTAMP_BEAT)
+    {
+        Handle_set_error(
+                get_handle(handle), ERROR_ARGUMENT, "Invalid beat remainder: %ld", rem);
+        return 0;
+    }
+
+    Value* arg = VALUE_AUTO;
+    arg->type = VALUE_TYPE_TSTAMP;
+    Tstamp_set(&arg->value.Tstamp_type, (int64_t)beats, (int32_t)rem);
+    return fire_event_id(handle, channel, event_id, arg);
+}
+
+
+int kqt_Handle_fire_event_id_string(
+        kqt_Handle handle, int channel, int event_id, const char* value)
+{
+    check_handle(handle, 0);
+
+    if (value == NULL)
+    {
+        Handle_set_error(get_handle(handle), ERROR_ARGUMENT, "No event argument given");
+        return 0;
+    }
+
+    if (strlen(value) > KQT_VAR_NAME_MAX)
+    {
+        Handle_set_error(
+                get_handle(handle), ERROR_ARGUMENT, "Event argument is too long");
+        return 0;
+    }
+
+    Value* arg = VALUE_AUTO;
+    arg->type = VALUE_TYPE_STRING;
+    strcpy(arg->value.string_type, value);
+    return fire_event_id(handle, channel, event_id, arg);
+}
+
+
 const char* kqt_Handle_receive_events(kqt_Handle handle)
 {
     check_handle(handle, 0);
@@ -378,3 +758,510 @@ const char* kqt_Handle_receive_events(kqt_Handle handle)
 }
 
 
+const unsigned char* kqt_Handle_receive_events_binary(kqt_Handle handle, long* size)
+{
+    check_handle(handle, NULL);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, NULL);
+    check_data_is_validated(h, NULL);
+
+    if (size == NULL)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "size must not be NULL");
+        return NULL;
+    }
+
+    int32_t bin_size = 0;
+    const unsigned char* events = Player_get_events_binary(h->player, &bin_size);
+    *size = bin_size;
+
+    return events;
+}
+
+
+static int get_au_control(const Module* module, int au_index)
+{
+    rassert(module != NULL);
+    rassert(au_index >= 0);
+    rassert(au_index < KQT_AUDIO_UNITS_MAX);
+
+    const Audio_unit* au = Au_table_get(Module_get_au_table(module), au_index);
+    if (au == NULL)
+        return -1;
+
+    for (int control = 0; control < KQT_CONTROLS_MAX; ++control)
+    {
+        if (Module_get_control(module, control) &&
+                (Module_get_au_from_input(module, control) == au))
+            return control;
+    }
+
+    return -1;
+}
+
+
+static bool make_event_value(Event_type type, double arg, Value* value)
+{
+    rassert(Event_is_valid(type));
+    rassert(value != NULL);
+
+    const Value_type param_type = Event_properties_get_param_type(type);
+    if (param_type == VALUE_TYPE_NONE)
+    {
+        value->type = VALUE_TYPE_NONE;
+        return true;
+    }
+
+    value->type = VALUE_TYPE_FLOAT;
+    value->value.float_type = arg;
+
+    return Value_convert_to_field_type(value, param_type);
+}
+
+
+int kqt_Handle_render_audio_unit(
+        kqt_Handle handle,
+        int au_index,
+        long event_count,
+        const long* event_frames,
+        const int* event_ids,
+        const double* event_args,
+        long frame_count,
+        float* dest)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    if (au_index < 0 || au_index >= KQT_AUDIO_UNITS_MAX)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid audio unit index: %d", au_index);
+        return 0;
+    }
+
+    if (event_count < 0)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Number of events must not be negative");
+        return 0;
+    }
+
+    if (event_count > 0 && (event_frames == NULL || event_ids == NULL))
+    {
+        Handle_set_error(
+                h, ERROR_ARGUMENT, "event_frames and event_ids must not be NULL");
+        return 0;
+    }
+
+    if (frame_count <= 0)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Number of frames must be positive.");
+        return 0;
+    }
+
+    if (dest == NULL)
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "dest must not be NULL");
+        return 0;
+    }
+
+    // Validate events before doing any work
+    for (long i = 0; i < event_count; ++i)
+    {
+        if (event_frames[i] < 0 || event_frames[i] >= frame_count ||
+                (i > 0 && event_frames[i] < event_frames[i - 1]))
+        {
+            Handle_set_error(
+                    h,
+                    ERROR_ARGUMENT,
+                    "Invalid frame position of event %ld: %ld",
+                    i, event_frames[i]);
+            return 0;
+        }
+
+        const Event_type type = (Event_type)event_ids[i];
+        if (!Event_is_valid(type))
+        {
+            Handle_set_error(
+                    h, ERROR_ARGUMENT, "Invalid event identifier: %d", event_ids[i]);
+            return 0;
+        }
+
+        Value* value = VALUE_AUTO;
+        const double arg = (event_args != NULL) ? event_args[i] : 0.0;
+        if (!make_event_value(type, arg, value))
+        {
+            Handle_set_error(
+                    h,
+                    ERROR_ARGUMENT,
+                    "Invalid argument type for event %s",
+                    Event_properties_get_name(type));
+            return 0;
+        }
+    }
+
+    const int control = get_au_control(h->module, au_index);
+    if (control < 0)
+    {
+        Handle_set_error(
+                h,
+                ERROR_ARGUMENT,
+                "Audio unit %d is not connected to a control",
+                au_index);
+        return 0;
+    }
+
+    if (Module_get_connections(h->module) == NULL)
+    {
+        memset(dest, 0, (size_t)frame_count * KQT_BUFFERS_MAX * sizeof(float));
+        return 1;
+    }
+
+    // Create a private Player for the loaded Module without a sequencer
+    static const int32_t event_buffer_size = 16384;
+    static const int voice_count = 256;
+    Player* player = new_Player(
+            h->module,
+            Player_get_audio_rate(h->player),
+            Player_get_audio_buffer_size(h->player),
+            event_buffer_size,
+            voice_count);
+    if (player == NULL)
+    {
+        Handle_set_error(h, ERROR_MEMORY, "Couldn't allocate memory");
+        return 0;
+    }
+
+    Player_reset(player, -1);
+    Player_stop(player);
+
+    {
+        Value* value = VALUE_AUTO;
+        value->type = VALUE_TYPE_INT;
+        value->value.int_type = control;
+        Player_fire_by_type(player, 0, Event_channel_set_au_input, value);
+    }
+
+    const int32_t buf_size = Player_get_audio_buffer_size(player);
+    Sample_streamer* streamer = Module_get_sample_streamer(h->module);
+
+    long rendered = 0;
+    long next_event = 0;
+    while (rendered < frame_count)
+    {
+        // Fire events at the current frame
+        while (next_event < event_count && event_frames[next_event] <= rendered)
+        {
+            const Event_type type = (Event_type)event_ids[next_event];
+            const double arg = (event_args != NULL) ? event_args[next_event] : 0.0;
+            Value* value = VALUE_AUTO;
+            make_event_value(type, arg, value);
+            Player_fire_by_type(player, 0, type, value);
+            ++next_event;
+        }
+
+        // Render up to the next event
+        long stop = frame_count;
+        if (next_event < event_count)
+            stop = event_frames[next_event];
+
+        const int32_t nframes = (int32_t)min(stop - rendered, (long)buf_size);
+        Player_play(player, nframes);
+
+        const int32_t frames_available = Player_get_frames_available(player);
+        if (frames_available <= 0)
+            break;
+
+        memcpy(dest + (rendered * KQT_BUFFERS_MAX),
+                Player_get_audio(player),
+                (size_t)frames_available * KQT_BUFFERS_MAX * sizeof(float));
+        rendered += frames_available;
+
+        if (streamer != NULL)
+            Sample_streamer_refill(streamer);
+    }
+
+    if (rendered < frame_count)
+        memset(dest + (rendered * KQT_BUFFERS_MAX),
+                0,
+                (size_t)(frame_count - rendered) * KQT_BUFFERS_MAX * sizeof(float));
+
+    del_Player(player);
+
+    return 1;
+}
+
+
+static Handle* get_queue_handle(kqt_Handle handle)
+{
+    // The queue functions are called from host threads, so they must not
+    // modify the error state of the Handle
+    if (!kqt_Handle_is_valid(handle))
+        return NULL;
+
+    Handle* h = get_handle(handle);
+    if (!h->data_is_valid || !h->data_is_validated)
+        return NULL;
+
+    return h;
+}
+
+
+static bool is_valid_queue_target(long frame_offset, int channel)
+{
+    return (frame_offset >= 0) &&
+        (frame_offset <= INT32_MAX) &&
+        (channel >= 0) &&
+        (channel < KQT_COLUMNS_MAX);
+}
+
+
+static int queue_command(Handle* h, const Command* command)
+{
+    rassert(h != NULL);
+    rassert(command != NULL);
+
+    return Command_queue_push(Player_get_command_queue(h->player), command) ? 1 : 0;
+}
+
+
+int kqt_Handle_queue_event(
+        kqt_Handle handle, long frame_offset, int channel, int event_id, double arg)
+{
+    Handle* h = get_queue_handle(handle);
+    if ((h == NULL) || !is_valid_queue_target(frame_offset, channel))
+        return -1;
+
+    const Event_type type = (Event_type)event_id;
+    if (!Event_is_valid(type))
+        return -1;
+
+    Command* command = &(Command)
+    {
+        .type = COMMAND_FIRE_EVENT,
+        .frame_offset = (int32_t)frame_offset,
+        .channel = channel,
+        .event_type = type,
+    };
+    if (!make_event_value(type, arg, &command->arg))
+        return -1;
+
+    return queue_command(h, command);
+}
+
+
+int kqt_Handle_queue_channel_mute(
+        kqt_Handle handle, long frame_offset, int channel, int mute)
+{
+    Handle* h = get_queue_handle(handle);
+    if ((h == NULL) || !is_valid_queue_target(frame_offset, channel))
+        return -1;
+
+    if (mute != 0 && mute != 1)
+        return -1;
+
+    Command* command = &(Command)
+    {
+        .type = COMMAND_SET_CHANNEL_MUTE,
+        .frame_offset = (int32_t)frame_offset,
+        .channel = channel,
+        .event_type = Event_NONE,
+        .arg = { .type = VALUE_TYPE_BOOL, .value.bool_type = (mute != 0) },
+    };
+
+    return queue_command(h, command);
+}
+
+
+static bool parse_au_path(const char* au_path, int* au_index, int* sub_au_index)
+{
+    rassert(au_path != NULL);
+    rassert(au_index != NULL);
+    rassert(sub_au_index != NULL);
+
+    *sub_au_index = -1;
+
+    const size_t len = strlen(au_path);
+    if (len == 5)
+    {
+        *au_index = string_extract_index(au_path, "au_", 2, "");
+        return (*au_index >= 0);
+    }
+    else if (len == 11)
+    {
+        *au_index = string_extract_index(au_path, "au_", 2, "/");
+        *sub_au_index = string_extract_index(au_path + 6, "au_", 2, "");
+        return (*au_index >= 0) && (*sub_au_index >= 0);
+    }
+
+    return false;
+}
+
+
+#define check_lane(h, lanes, lane, ret)                                   \
+    if (true)                                                             \
+    {                                                                     \
+        if (!Automation_lanes_has_lane((lanes), (lane)))                  \
+        {                                                                 \
+            Handle_set_error((h), ERROR_ARGUMENT,                         \
+                    "Invalid automation lane: %d", (lane));               \
+            return (ret);                                                 \
+        }                                                                 \
+    } else ignore(0)
+
+
+int kqt_Handle_add_automation_lane(
+        kqt_Handle handle, const char* au_path, const char* stream_name)
+{
+    check_handle(handle, -1);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, -1);
+    check_data_is_validated(h, -1);
+
+    int au_index = -1;
+    int sub_au_index = -1;
+    if ((au_path == NULL) || !parse_au_path(au_path, &au_index, &sub_au_index))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid audio unit path");
+        return -1;
+    }
+
+    if ((stream_name == NULL) || !is_valid_var_name(stream_name))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid stream name");
+        return -1;
+    }
+
+    Automation_lanes* lanes = Player_get_automation_lanes(h->player);
+    const int lane = Automation_lanes_add(
+            lanes,
+            au_index,
+            sub_au_index,
+            stream_name,
+            h->module,
+            Player_get_device_states(h->player));
+    if (lane < 0)
+    {
+        Handle_set_error(h, ERROR_MEMORY, "Could not allocate an automation lane");
+        return -1;
+    }
+
+    if (!Automation_lanes_is_connected(lanes, lane))
+    {
+        Automation_lanes_remove(lanes, lane);
+        Handle_set_error(
+                h,
+                ERROR_ARGUMENT,
+                "Audio unit %s has no stream %s that processes mixed signals",
+                au_path,
+                stream_name);
+        return -1;
+    }
+
+    return lane;
+}
+
+
+int kqt_Handle_remove_automation_lane(kqt_Handle handle, int lane)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+
+    Automation_lanes* lanes = Player_get_automation_lanes(h->player);
+    check_lane(h, lanes, lane, 0);
+
+    Automation_lanes_remove(lanes, lane);
+
+    return 1;
+}
+
+
+int kqt_Handle_set_automation_values(
+        kqt_Handle handle, int lane, long count, const float* values)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    Automation_lanes* lanes = Player_get_automation_lanes(h->player);
+    check_lane(h, lanes, lane, 0);
+
+    if ((count < 0) || (count > Player_get_audio_buffer_size(h->player)))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid value count: %ld", count);
+        return 0;
+    }
+
+    if ((values == NULL) && (count > 0))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "No values given");
+        return 0;
+    }
+
+    for (long i = 0; i < count; ++i)
+    {
+        if (!isfinite(values[i]))
+        {
+            Handle_set_error(h, ERROR_ARGUMENT, "Value %ld is not finite", i);
+            return 0;
+        }
+    }
+
+    Automation_lanes_set_values(lanes, lane, (int32_t)count, values);
+
+    return 1;
+}
+
+
+int kqt_Handle_add_automation_point(
+        kqt_Handle handle, int lane, long frame_offset, double value)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    Automation_lanes* lanes = Player_get_automation_lanes(h->player);
+    check_lane(h, lanes, lane, 0);
+
+    if ((frame_offset < 0) || (frame_offset >= Player_get_audio_buffer_size(h->player)))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Invalid frame offset: %ld", frame_offset);
+        return 0;
+    }
+
+    if (!isfinite(value))
+    {
+        Handle_set_error(h, ERROR_ARGUMENT, "Automation value is not finite");
+        return 0;
+    }
+
+    if (!Automation_lanes_add_point(
+                lanes,
+                lane,
+                (int32_t)frame_offset,
+                value,
+                Player_get_device_states(h->player)))
+    {
+        Handle_set_error(
+                h,
+                ERROR_ARGUMENT,
+                "Frame offset %ld precedes values already written",
+                frame_offset);
+        return 0;
+    }
+
+    return 1;
+}
+
+#undef check_lane
+
+
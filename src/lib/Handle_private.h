@@ -20,9 +20,11 @@
 
 #include <Error.h>
 #include <init/Background_loader.h>
+#include <init/Data_cache.h>
 #include <init/Module.h>
 #include <kunquat/Player.h>
 #include <player/Player.h>
+#include <player/Timeline.h>
 
 #include <stdbool.h>
 
@@ -46,12 +48,14 @@ typedef struct Handle
     bool update_connections;
     Module* module;
     Background_loader* bkg_loader;
+    Data_cache* data_cache;
     Error error;
     Error validation_error;
     char position[POSITION_LENGTH];
 
     Player* player;
     Player* length_counter;
+    Timeline* timelines[KQT_TRACKS_MAX];
 } Handle;
 
 
@@ -59,11 +63,13 @@ typedef struct Handle
  * Initialise a Kunquat Handle.
  *
  * \param handle   The Kunquat Handle -- must not be \c NULL.
+ * \param module   The Module to be played, or \c NULL if a new Module should
+ *                 be created. A reference is added to an existing Module.
  *
  * \return   \c true if successful. Otherwise, \c false is returned and Handle
  *           error is set to indicate the error.
  */
-bool Handle_init(Handle* handle);
+bool Handle_init(Handle* handle, Module* module);
 
 
 /**
@@ -237,6 +243,23 @@ bool Handle_refresh_env_states(Handle* handle);
 Module* Handle_get_module(Handle* handle);
 
 
+/**
+ * Get the Timeline of a track in the Kunquat Handle.
+ *
+ * The Timeline is built on first use and kept until data that affects
+ * playback order or tempo is changed.
+ *
+ * \param handle   The Kunquat Handle -- must not be \c NULL and must contain
+ *                 validated data.
+ * \param track    The track number -- must be >= \c 0 and
+ *                 < \c KQT_TRACKS_MAX.
+ *
+ * \return   The Timeline, or \c NULL if memory allocation failed. In that
+ *           case, the Handle error is set.
+ */
+const Timeline* Handle_get_timeline(Handle* handle, int track);
+
+
 #endif // KQT_HANDLE_PRIVATE_H
 
 
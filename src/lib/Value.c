@@ -19,7 +19,6 @@
 #include <string/serialise.h>
 
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -148,6 +147,40 @@ bool Value_convert(Value* dest, const Value* src, Value_type new_type)
 }
 
 
+bool Value_convert_to_field_type(Value* value, Value_type field_type)
+{
+    rassert(value != NULL);
+
+    switch (field_type)
+    {
+        case VALUE_TYPE_NONE:
+            return (value->type == VALUE_TYPE_NONE);
+
+        case VALUE_TYPE_REALTIME:
+            return Value_type_is_realtime(value->type);
+
+        case VALUE_TYPE_MAYBE_STRING:
+            return (value->type == VALUE_TYPE_NONE) ||
+                (value->type == VALUE_TYPE_STRING);
+
+        case VALUE_TYPE_MAYBE_REALTIME:
+            return (value->type == VALUE_TYPE_NONE) ||
+                Value_type_is_realtime(value->type);
+
+        default:
+            break;
+    }
+
+    rassert(field_type > VALUE_TYPE_NONE);
+    rassert(field_type < VALUE_TYPE_COUNT);
+
+    if (value->type == VALUE_TYPE_NONE)
+        return false;
+
+    return Value_convert(value, value, field_type);
+}
+
+
 int Value_serialise(const Value* value, int len, char* str)
 {
     rassert(value != NULL);
@@ -158,8 +191,11 @@ int Value_serialise(const Value* value, int len, char* str)
     {
         case VALUE_TYPE_NONE:
         {
-            int print_len = snprintf(str, (size_t)len, "null");
-            return min(len - 1, print_len);
+            static const char null_str[] = "null";
+            const int print_len = min(len - 1, (int)strlen(null_str));
+            memcpy(str, null_str, (size_t)print_len);
+            str[print_len] = '\0';
+            return print_len;
         }
         break;
 
@@ -189,9 +225,21 @@ int Value_serialise(const Value* value, int len, char* str)
 
         case VALUE_TYPE_STRING:
         {
-            int print_len = snprintf(
-                    str, (size_t)len, "\"%s\"", value->value.string_type);
-            return min(len - 1, print_len);
+            // Quotes are added around the string, truncated if necessary
+            const int str_len = (int)strlen(value->value.string_type);
+            int print_len = 0;
+            if (print_len < len - 1)
+                str[print_len++] = '"';
+
+            const int copy_len = min(len - 1 - print_len, str_len);
+            memcpy(str + print_len, value->value.string_type, (size_t)copy_len);
+            print_len += copy_len;
+
+            if (print_len < len - 1)
+                str[print_len++] = '"';
+
+            str[print_len] = '\0';
+            return print_len;
         }
         break;
 
@@ -98,6 +98,23 @@ Value* Value_copy(Value* restrict dest, const Value* restrict src);
 bool Value_convert(Value* dest, const Value* src, Value_type new_type);
 
 
+/**
+ * Convert a Value in place to match an event parameter type.
+ *
+ * The special parameter types \c VALUE_TYPE_REALTIME,
+ * \c VALUE_TYPE_MAYBE_STRING and \c VALUE_TYPE_MAYBE_REALTIME accept any
+ * Value of a matching type without conversion.
+ *
+ * \param value        The Value -- must not be \c NULL.
+ * \param field_type   The parameter type -- must be valid or one of the
+ *                     special parameter types.
+ *
+ * \return   \c true if successful, or \c false if \a value does not match
+ *           \a field_type.
+ */
+bool Value_convert_to_field_type(Value* value, Value_type field_type);
+
+
 /**
  * Serialise a Value.
  *
@@ -26,12 +26,17 @@ DECLS(Au_state);
 DECLS(Au_streams);
 DECLS(Au_table);
 DECLS(Audio_unit);
+DECLS(Automation_lanes);
 DECLS(Background_loader);
 DECLS(Bind);
 DECLS(Bit_array);
 DECLS(Channel);
 DECLS(Channel_event_buffer);
+DECLS(Command_queue);
 DECLS(Connections);
+DECLS(Data_cache);
+DECLS(Data_cache_entry);
+DECLS(Data_cache_writer);
 DECLS(Device);
 DECLS(Device_impl);
 DECLS(Device_state);
@@ -52,8 +57,11 @@ DECLS(Processor);
 DECLS(Random);
 DECLS(Sample);
 DECLS(Sample_params);
+DECLS(Sample_streamer);
 DECLS(Song);
 DECLS(Streader);
+DECLS(Thread_arena);
+DECLS(Timeline);
 DECLS(Tstamp);
 DECLS(Tuning_state);
 DECLS(Tuning_table);
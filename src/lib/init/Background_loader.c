@@ -329,6 +329,9 @@ struct Background_loader
     Task_queue cleanup_queue;
 
     Array* final_cleanups;
+
+    Sample_streamer* sample_streamer;
+    Data_cache* data_cache;
 };
 
 
@@ -347,6 +350,8 @@ Background_loader* new_Background_loader(void)
     }
 
     loader->thread_count = 0;
+    loader->sample_streamer = NULL;
+    loader->data_cache = NULL;
 
     for (int i = 0; i < KQT_THREADS_MAX; ++i)
         Task_worker_init(&loader->workers[i], loader);
@@ -392,6 +397,41 @@ int Background_loader_get_thread_count(const Background_loader* loader)
 }
 
 
+void Background_loader_set_sample_streamer(
+        Background_loader* loader, Sample_streamer* streamer)
+{
+    rassert(loader != NULL);
+
+    loader->sample_streamer = streamer;
+
+    return;
+}
+
+
+Sample_streamer* Background_loader_get_sample_streamer(const Background_loader* loader)
+{
+    rassert(loader != NULL);
+    return loader->sample_streamer;
+}
+
+
+void Background_loader_set_data_cache(Background_loader* loader, Data_cache* cache)
+{
+    rassert(loader != NULL);
+
+    loader->data_cache = cache;
+
+    return;
+}
+
+
+Data_cache* Background_loader_get_data_cache(const Background_loader* loader)
+{
+    rassert(loader != NULL);
+    return loader->data_cache;
+}
+
+
 static void Background_loader_run_cleanups(Background_loader* loader)
 {
     rassert(loader != NULL);
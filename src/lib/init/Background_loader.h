@@ -72,6 +72,46 @@ void Background_loader_set_thread_count(Background_loader* loader, int count);
 int Background_loader_get_thread_count(const Background_loader* loader);
 
 
+/**
+ * Set the Sample streamer used for loaded Samples.
+ *
+ * \param loader     The Background loader -- must not be \c NULL.
+ * \param streamer   The Sample streamer, or \c NULL if loaded Samples should
+ *                   be kept entirely in memory.
+ */
+void Background_loader_set_sample_streamer(
+        Background_loader* loader, Sample_streamer* streamer);
+
+
+/**
+ * Get the Sample streamer used for loaded Samples.
+ *
+ * \param loader   The Background loader -- must not be \c NULL.
+ *
+ * \return   The Sample streamer, or \c NULL if not set.
+ */
+Sample_streamer* Background_loader_get_sample_streamer(const Background_loader* loader);
+
+
+/**
+ * Set the Data cache used for loaded and generated sample data.
+ *
+ * \param loader   The Background loader -- must not be \c NULL.
+ * \param cache    The Data cache, or \c NULL if caching should be disabled.
+ */
+void Background_loader_set_data_cache(Background_loader* loader, Data_cache* cache);
+
+
+/**
+ * Get the Data cache used for loaded and generated sample data.
+ *
+ * \param loader   The Background loader -- must not be \c NULL.
+ *
+ * \return   The Data cache, or \c NULL if not set.
+ */
+Data_cache* Background_loader_get_data_cache(const Background_loader* loader);
+
+
 /**
  * Execute a task in the Background loader.
  *
@@ -33,18 +33,19 @@
 struct Bind
 {
     AAtree* cblists;
+    bool affects_sequencing;
 };
 
 
 typedef struct Constraint
 {
-    char event_name[KQT_EVENT_NAME_MAX + 1];
+    Event_type event_type;
     char* expr;
     struct Constraint* next;
 } Constraint;
 
 
-static Constraint* new_Constraint(Streader* sr);
+static Constraint* new_Constraint(Streader* sr, const Event_names* names);
 
 
 static bool Constraint_match(
@@ -88,6 +89,7 @@ typedef struct Cblist
     //char event_name[KQT_EVENT_NAME_MAX + 1];
     Event_type event_type;
     Source_state source_state;
+    bool affects_sequencing;
     Cblist_item* first;
     Cblist_item* last;
 } Cblist;
@@ -96,6 +98,7 @@ typedef struct Cblist
 #define CBLIST_KEY(type) (&(Cblist){        \
         .event_type = (type),               \
         .source_state = SOURCE_STATE_NEW,   \
+        .affects_sequencing = false,        \
         .first = NULL,                      \
         .last = NULL })
 
@@ -112,7 +115,8 @@ static void Cblist_append(Cblist* list, Cblist_item* item);
 static void del_Cblist(Cblist* list);
 
 
-static bool read_constraints(Streader* sr, Bind* map, Cblist_item* item);
+static bool read_constraints(
+        Streader* sr, Cblist_item* item, const Event_names* names);
 
 
 static bool read_events(Streader* sr, Cblist_item* item, const Event_names* names);
@@ -121,6 +125,9 @@ static bool read_events(Streader* sr, Cblist_item* item, const Event_names* name
 static bool Bind_is_cyclic(const Bind* map, const Event_names* event_names);
 
 
+static void Bind_find_sequencing_sources(Bind* map, const Event_names* event_names);
+
+
 typedef struct bedata
 {
     Bind* map;
@@ -166,7 +173,7 @@ static bool read_bind_entry(Streader* sr, int32_t index, void* userdata)
     }
     Cblist_append(cblist, item);
 
-    if (!(read_constraints(sr, bd->map, item) &&
+    if (!(read_constraints(sr, item, bd->names) &&
                 Streader_match_char(sr, ',') &&
                 read_events(sr, item, bd->names))
        )
@@ -190,6 +197,7 @@ Bind* new_Bind(Streader* sr, const Event_names* names)
         return NULL;
     }
 
+    map->affects_sequencing = false;
     map->cblists = new_AAtree(
             (AAtree_item_cmp*)Cblist_cmp, (AAtree_item_destroy*)del_Cblist);
     if (map->cblists == NULL)
@@ -217,6 +225,8 @@ Bind* new_Bind(Streader* sr, const Event_names* names)
         return NULL;
     }
 
+    Bind_find_sequencing_sources(map, names);
+
     return map;
 }
 
@@ -239,7 +249,7 @@ Event_cache* Bind_create_cache(const Bind* map)
             Constraint* constraint = item->constraints;
             while (constraint != NULL)
             {
-                if (!Event_cache_add_event(cache, constraint->event_name))
+                if (!Event_cache_add_event(cache, constraint->event_type))
                 {
                     del_Event_cache(cache);
                     return NULL;
@@ -276,23 +286,36 @@ bool Bind_event_has_constraints(const Bind* map, Event_type event_type)
 }
 
 
+bool Bind_affects_sequencing(const Bind* map)
+{
+    rassert(map != NULL);
+    return map->affects_sequencing;
+}
+
+
+bool Bind_event_affects_sequencing(const Bind* map, Event_type event_type)
+{
+    rassert(map != NULL);
+
+    const Cblist* list = AAtree_get_exact(map->cblists, CBLIST_KEY(event_type));
+    return (list != NULL) && list->affects_sequencing;
+}
+
+
 Target_event* Bind_get_first(
         const Bind* map,
-        const Event_names* event_names,
         Event_cache* cache,
         Env_state* estate,
-        const char* event_name,
+        Event_type event_type,
         const Value* value,
         Random* rand)
 {
     rassert(map != NULL);
     rassert(cache != NULL);
-    rassert(event_name != NULL);
+    rassert(Event_is_valid(event_type));
     rassert(value != NULL);
 
-    Event_cache_update(cache, event_name, value);
-
-    const Event_type event_type = Event_names_get(event_names, event_name);
+    Event_cache_update(cache, event_type, value);
 
     Cblist* list = AAtree_get_exact(map->cblists, CBLIST_KEY(event_type));
     if (list == NULL)
@@ -412,15 +435,82 @@ static bool Bind_dfs(
 }
 
 
+static bool Bind_fires_sequencing_events(
+        const Bind* map, const Event_names* event_names, Event_type event_type)
+{
+    rassert(map != NULL);
+    rassert(event_names != NULL);
+
+    const Cblist* cblist = AAtree_get_exact(map->cblists, CBLIST_KEY(event_type));
+    if (cblist == NULL)
+        return false;
+
+    const Cblist_item* item = cblist->first;
+    while (item != NULL)
+    {
+        const Target_event* event = item->first_event;
+        while (event != NULL)
+        {
+            Streader* sr = Streader_init(
+                    STREADER_AUTO, event->desc, (int64_t)strlen(event->desc));
+            char next_name[KQT_EVENT_NAME_MAX + 1] = "";
+            Streader_readf(sr, "[%s", READF_STR(KQT_EVENT_NAME_MAX, next_name));
+            rassert(!Streader_is_error_set(sr));
+
+            const Event_type next_type = Event_names_get(event_names, next_name);
+            if (Event_is_control(next_type) ||
+                    Event_is_general(next_type) ||
+                    Event_is_master(next_type) ||
+                    Bind_fires_sequencing_events(map, event_names, next_type))
+                return true;
+
+            event = event->next;
+        }
+
+        item = item->next;
+    }
+
+    return false;
+}
+
+
+static void Bind_find_sequencing_sources(Bind* map, const Event_names* event_names)
+{
+    rassert(map != NULL);
+    rassert(event_names != NULL);
+
+    AAiter* iter = AAiter_init(AAITER_AUTO, map->cblists);
+    Cblist* cblist = AAiter_get_at_least(iter, CBLIST_KEY(Event_NONE));
+    while (cblist != NULL)
+    {
+        cblist->affects_sequencing =
+            Bind_fires_sequencing_events(map, event_names, cblist->event_type);
+        if (cblist->affects_sequencing)
+            map->affects_sequencing = true;
+
+        cblist = AAiter_get_next(iter);
+    }
+
+    return;
+}
+
+
+typedef struct edata
+{
+    Cblist_item* item;
+    const Event_names* names;
+} edata;
+
 static bool read_constraint(Streader* sr, int32_t index, void* userdata)
 {
     rassert(sr != NULL);
     rassert(userdata != NULL);
     ignore(index);
 
-    Cblist_item* item = userdata;
+    edata* ed = userdata;
+    Cblist_item* item = ed->item;
 
-    Constraint* constraint = new_Constraint(sr);
+    Constraint* constraint = new_Constraint(sr, ed->names);
     if (constraint == NULL)
         return false;
 
@@ -430,21 +520,17 @@ static bool read_constraint(Streader* sr, int32_t index, void* userdata)
     return true;
 }
 
-static bool read_constraints(Streader* sr, Bind* map, Cblist_item* item)
+static bool read_constraints(
+        Streader* sr, Cblist_item* item, const Event_names* names)
 {
     rassert(sr != NULL);
-    rassert(map != NULL);
     rassert(item != NULL);
+    rassert(names != NULL);
 
-    return Streader_read_list(sr, read_constraint, item);
-}
-
+    edata* ed = &(edata){ .item = item, .names = names, };
 
-typedef struct edata
-{
-    Cblist_item* item;
-    const Event_names* names;
-} edata;
+    return Streader_read_list(sr, read_constraint, ed);
+}
 
 static bool read_event(Streader* sr, int32_t index, void* userdata)
 {
@@ -496,6 +582,7 @@ static Cblist* new_Cblist(Event_type event_type)
 
     list->event_type = event_type;
     list->source_state = SOURCE_STATE_NEW;
+    list->affects_sequencing = false;
     list->first = list->last = NULL;
 
     return list;
@@ -596,9 +683,10 @@ static void del_Cblist_item(Cblist_item* item)
 }
 
 
-static Constraint* new_Constraint(Streader* sr)
+static Constraint* new_Constraint(Streader* sr, const Event_names* names)
 {
     rassert(sr != NULL);
+    rassert(names != NULL);
 
     if (Streader_is_error_set(sr))
         return NULL;
@@ -613,12 +701,16 @@ static Constraint* new_Constraint(Streader* sr)
     c->expr = NULL;
     c->next = NULL;
 
-    if (!Streader_readf(sr, "[%s,", READF_STR(KQT_EVENT_NAME_MAX + 1, c->event_name)))
+    char event_name[KQT_EVENT_NAME_MAX + 1] = "";
+    if (!Streader_readf(sr, "[%s,", READF_STR(KQT_EVENT_NAME_MAX + 1, event_name)))
     {
         del_Constraint(c);
         return NULL;
     }
 
+    // Unknown event names are cached as Event_NONE which never gets a value
+    c->event_type = Event_names_get(names, event_name);
+
     Streader_skip_whitespace(sr);
     const char* const expr = Streader_get_remaining_data(sr);
     if (!Streader_read_string(sr, 0, NULL))
@@ -662,13 +754,13 @@ static bool Constraint_match(
     rassert(estate != NULL);
     rassert(rand != NULL);
 
-    const Value* value = Event_cache_get_value(cache, constraint->event_name);
+    const Value* value = Event_cache_get_value(cache, constraint->event_type);
     rassert(value != NULL);
 
     Value* result = VALUE_AUTO;
     Streader* sr = Streader_init(
             STREADER_AUTO, constraint->expr, (int64_t)strlen(constraint->expr));
-    //fprintf(stderr, "%s, %s", constraint->event_name, constraint->expr);
+    //fprintf(stderr, "%d, %s", (int)constraint->event_type, constraint->expr);
     evaluate_expr(sr, estate, value, result, rand);
     //fprintf(stderr, ", %s", state->message);
     //fprintf(stderr, " -> %d %s\n", (int)result->type,
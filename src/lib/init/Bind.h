@@ -73,14 +73,37 @@ Event_cache* Bind_create_cache(const Bind* map);
 bool Bind_event_has_constraints(const Bind* map, Event_type event_type);
 
 
+/**
+ * Find out whether the Bind may fire events that affect sequencing.
+ *
+ * \param map   The Bind -- must not be \c NULL.
+ *
+ * \return   \c true if any target event of the Bind is a control, general or
+ *           master event, otherwise \c false.
+ */
+bool Bind_affects_sequencing(const Bind* map);
+
+
+/**
+ * Find out whether binding an event may fire events that affect sequencing.
+ *
+ * \param map          The Bind -- must not be \c NULL.
+ * \param event_type   The type of the source event.
+ *
+ * \return   \c true if the event is bound, directly or through other bound
+ *           events, to a control, general or master event, otherwise
+ *           \c false.
+ */
+bool Bind_event_affects_sequencing(const Bind* map, Event_type event_type);
+
+
 /**
  * Get the first event that is a result from binding.
  *
  * \param map          The Bind -- must not be \c NULL.
- * \param event_names  The Event names -- must not be \c NULL.
  * \param cache        The Event cache -- must not be \c NULL.
  * \param estate       The Environment state -- must not be \c NULL.
- * \param event_name   The name of the fired event -- must not be \c NULL.
+ * \param event_type   The type of the fired event -- must be valid.
  * \param value        The event parameter -- must not be \c NULL.
  * \param rand         The random source -- must not be \c NULL.
  *
@@ -89,10 +112,9 @@ bool Bind_event_has_constraints(const Bind* map, Event_type event_type);
  */
 Target_event* Bind_get_first(
         const Bind* map,
-        const Event_names* event_names,
         Event_cache* cache,
         Env_state* estate,
-        const char* event_name,
+        Event_type event_type,
         const Value* value,
         Random* rand);
 
@@ -18,6 +18,7 @@
 #include <debug/assert.h>
 #include <init/Device_node.h>
 #include <init/devices/Audio_unit.h>
+#include <init/Module.h>
 #include <memory.h>
 #include <string/common.h>
 
@@ -109,18 +110,21 @@ static bool read_connection(Streader* sr, int32_t index, void* userdata)
     if (Streader_is_error_set(sr))
         return false;
 
-    if (rcdata->level == CONNECTION_LEVEL_AU)
-    {
-        if (string_eq(src_name, ""))
-            strcpy(src_name, "Iin");
-    }
+    if (string_eq(src_name, ""))
+        strcpy(src_name, "Iin");
 
     if (AAtree_get_exact(rcdata->graph->nodes, src_name) == NULL)
     {
         const Device* actual_master = rcdata->master;
-        if ((rcdata->level == CONNECTION_LEVEL_AU) &&
-                string_eq(src_name, "Iin"))
-            actual_master = Audio_unit_get_input_interface((Audio_unit*)rcdata->master);
+        if (string_eq(src_name, "Iin"))
+        {
+            if (rcdata->level == CONNECTION_LEVEL_AU)
+                actual_master =
+                    Audio_unit_get_input_interface((Audio_unit*)rcdata->master);
+            else
+                actual_master =
+                    Module_get_input_interface((const Module*)rcdata->master);
+        }
 
         Device_node* new_src = new_Device_node(
                 src_name, rcdata->au_table, actual_master);
@@ -437,15 +441,6 @@ static int validate_connection_path(
     // Port
     if (string_has_prefix(str, "in_") || string_has_prefix(str, "out_"))
     {
-        if (string_has_prefix(str, "in_") &&
-                root &&
-                (level != CONNECTION_LEVEL_AU))
-        {
-            Streader_set_error(
-                    sr, "Input ports are not allowed for master: \"%s\"", path);
-            return -1;
-        }
-
         if (type == DEVICE_PORT_TYPE_RECV)
         {
             bool can_receive = (!root && string_has_prefix(str, "in_")) ||
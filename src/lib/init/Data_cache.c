@@ -0,0 +1,521 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <init/Data_cache.h>
+
+#include <debug/assert.h>
+#include <mathnum/common.h>
+#include <mathnum/md5.h>
+#include <memory.h>
+
+#ifdef WITH_MMAP
+#include <sys/mman.h>
+#endif
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+
+#define ENTRY_MAGIC "KQTCACHE"
+#define ENTRY_VERSION 1
+#define ENTRY_BYTE_ORDER 0x01020304
+#define ENTRY_HEADER_SIZE 64
+#define ENTRY_ALIGNMENT 64
+#define TEMP_FILE_TRIES_MAX 100
+
+
+struct Data_cache
+{
+    char* dir;
+    atomic_int temp_index;
+};
+
+
+struct Data_cache_entry
+{
+    int channels;
+    int bits;
+    bool is_float;
+    int64_t len;
+    int64_t stride;
+
+    char* contents;
+    int64_t size;
+    bool is_mapped;
+};
+
+
+struct Data_cache_writer
+{
+    FILE* file;
+    char* temp_path;
+    char* path;
+    int bits;
+    int64_t len;
+    int64_t stride;
+    bool has_failed;
+};
+
+
+typedef struct Entry_header
+{
+    char magic[8];
+    int32_t version;
+    uint32_t byte_order;
+    int32_t channels;
+    int32_t bits;
+    int32_t is_float;
+    int32_t reserved;
+    int64_t len;
+} Entry_header;
+
+
+static_assert(sizeof(Entry_header) <= ENTRY_HEADER_SIZE, "Data cache header is too large");
+
+
+static int64_t get_stride(int bits, int64_t len)
+{
+    rassert(bits > 0);
+    rassert(len > 0);
+
+    const int64_t size = len * (bits / 8);
+    return ((size + ENTRY_ALIGNMENT - 1) / ENTRY_ALIGNMENT) * ENTRY_ALIGNMENT;
+}
+
+
+static bool is_valid_format(int channels, int bits, bool is_float)
+{
+    return ((channels == 1) || (channels == 2)) &&
+        ((bits == 8) || (bits == 16) || (bits == 32)) &&
+        (!is_float || (bits == 32));
+}
+
+
+Data_cache_key* Data_cache_key_init(
+        Data_cache_key* key, const char* type, const void* data, int64_t size)
+{
+    rassert(key != NULL);
+    rassert(type != NULL);
+    rassert(strlen(type) <= DATA_CACHE_TYPE_LENGTH_MAX);
+    rassert(data != NULL);
+    rassert(size >= 0);
+
+    strcpy(key->type, type);
+
+    const char* bytes = data;
+    uint64_t lower = 0;
+    uint64_t upper = 0;
+
+    if (size <= INT_MAX)
+    {
+        md5(bytes, (int)size, &lower, &upper, true);
+    }
+    else
+    {
+        // Chain the sums of large blocks as the MD5 interface uses int lengths
+        static const int block_size = 1 << 30;
+        for (int64_t pos = 0; pos < size; pos += block_size)
+        {
+            uint64_t chain[4] = { lower, upper, 0, 0 };
+            md5(bytes + pos,
+                    (int)min(size - pos, block_size),
+                    &chain[2],
+                    &chain[3],
+                    true);
+            md5((const char*)chain, (int)sizeof(chain), &lower, &upper, true);
+        }
+    }
+
+    key->lower = lower;
+    key->upper = upper;
+
+    return key;
+}
+
+
+static bool make_path(
+        const Data_cache* cache, const Data_cache_key* key, const char* suffix, char** path)
+{
+    rassert(cache != NULL);
+    rassert(key != NULL);
+    rassert(suffix != NULL);
+    rassert(path != NULL);
+
+    static const char* path_format = "%s/%s-%016" PRIx64 "%016" PRIx64 ".kqtc%s";
+
+    const int length = snprintf(
+            NULL, 0, path_format, cache->dir, key->type, key->upper, key->lower, suffix);
+    *path = memory_alloc_items(char, length + 1);
+    if (*path == NULL)
+        return false;
+
+    snprintf(
+            *path,
+            (size_t)length + 1,
+            path_format,
+            cache->dir,
+            key->type,
+            key->upper,
+            key->lower,
+            suffix);
+
+    return true;
+}
+
+
+Data_cache* new_Data_cache(const char* dir, Error* error)
+{
+    rassert(dir != NULL);
+    rassert(strlen(dir) > 0);
+    rassert(error != NULL);
+
+    Data_cache* cache = memory_alloc_item(Data_cache);
+    if (cache == NULL)
+    {
+        Error_set(error, ERROR_MEMORY, "Could not allocate memory for data cache");
+        return NULL;
+    }
+
+    cache->temp_index = 0;
+    cache->dir = memory_alloc_items(char, (int64_t)strlen(dir) + 1);
+    if (cache->dir == NULL)
+    {
+        Error_set(error, ERROR_MEMORY, "Could not allocate memory for data cache");
+        del_Data_cache(cache);
+        return NULL;
+    }
+
+    strcpy(cache->dir, dir);
+
+    return cache;
+}
+
+
+static bool seek_file(FILE* file, int64_t offset, int whence)
+{
+    rassert(file != NULL);
+    rassert(offset >= 0);
+
+    // Fail cleanly if the offset does not fit in the file offset type
+    if ((sizeof(off_t) < sizeof(int64_t)) && (offset > INT32_MAX))
+        return false;
+
+    return (fseeko(file, (off_t)offset, whence) == 0);
+}
+
+
+static char* load_contents(FILE* file, int64_t size, bool* is_mapped)
+{
+    rassert(file != NULL);
+    rassert(size > 0);
+    rassert(is_mapped != NULL);
+
+#ifdef WITH_MMAP
+    void* area = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+    if (area != MAP_FAILED)
+    {
+        *is_mapped = true;
+        return area;
+    }
+#endif
+
+    *is_mapped = false;
+
+    char* contents = memory_alloc_items(char, size);
+    if (contents == NULL)
+        return NULL;
+
+    if (!seek_file(file, 0, SEEK_SET) ||
+            (fread(contents, 1, (size_t)size, file) != (size_t)size))
+    {
+        memory_free(contents);
+        return NULL;
+    }
+
+    return contents;
+}
+
+
+Data_cache_entry* Data_cache_open_entry(Data_cache* cache, const Data_cache_key* key)
+{
+    rassert(cache != NULL);
+    rassert(key != NULL);
+
+    char* path = NULL;
+    if (!make_path(cache, key, "", &path))
+        return NULL;
+
+    FILE* file = fopen(path, "rb");
+    memory_free(path);
+    if (file == NULL)
+        return NULL;
+
+    // Validate the header and the file size
+    Entry_header header;
+    if (fread(&header, sizeof(Entry_header), 1, file) != 1 ||
+            (memcmp(header.magic, ENTRY_MAGIC, 8) != 0) ||
+            (header.version != ENTRY_VERSION) ||
+            (header.byte_order != ENTRY_BYTE_ORDER) ||
+            !is_valid_format(header.channels, header.bits, header.is_float != 0) ||
+            (header.len <= 0))
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    const int64_t stride = get_stride(header.bits, header.len);
+    const int64_t size = ENTRY_HEADER_SIZE + header.channels * stride;
+    if (!seek_file(file, 0, SEEK_END) || (ftello(file) < size))
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    Data_cache_entry* entry = memory_alloc_item(Data_cache_entry);
+    if (entry == NULL)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    entry->channels = header.channels;
+    entry->bits = header.bits;
+    entry->is_float = (header.is_float != 0);
+    entry->len = header.len;
+    entry->stride = stride;
+    entry->size = size;
+    entry->contents = load_contents(file, size, &entry->is_mapped);
+
+    fclose(file);
+
+    if (entry->contents == NULL)
+    {
+        memory_free(entry);
+        return NULL;
+    }
+
+    return entry;
+}
+
+
+int Data_cache_entry_get_channels(const Data_cache_entry* entry)
+{
+    rassert(entry != NULL);
+    return entry->channels;
+}
+
+
+int Data_cache_entry_get_bits(const Data_cache_entry* entry)
+{
+    rassert(entry != NULL);
+    return entry->bits;
+}
+
+
+bool Data_cache_entry_is_float(const Data_cache_entry* entry)
+{
+    rassert(entry != NULL);
+    return entry->is_float;
+}
+
+
+int64_t Data_cache_entry_get_len(const Data_cache_entry* entry)
+{
+    rassert(entry != NULL);
+    return entry->len;
+}
+
+
+const void* Data_cache_entry_get_data(const Data_cache_entry* entry, int ch)
+{
+    rassert(entry != NULL);
+    rassert(ch >= 0);
+    rassert(ch < entry->channels);
+
+    return entry->contents + ENTRY_HEADER_SIZE + ch * entry->stride;
+}
+
+
+void del_Data_cache_entry(Data_cache_entry* entry)
+{
+    if (entry == NULL)
+        return;
+
+#ifdef WITH_MMAP
+    if (entry->is_mapped)
+    {
+        munmap(entry->contents, (size_t)entry->size);
+        memory_free(entry);
+        return;
+    }
+#endif
+
+    memory_free(entry->contents);
+    memory_free(entry);
+
+    return;
+}
+
+
+Data_cache_writer* new_Data_cache_writer(
+        Data_cache* cache,
+        const Data_cache_key* key,
+        int channels,
+        int bits,
+        bool is_float,
+        int64_t len)
+{
+    rassert(cache != NULL);
+    rassert(key != NULL);
+    rassert(is_valid_format(channels, bits, is_float));
+    rassert(len > 0);
+
+    Data_cache_writer* writer = memory_alloc_item(Data_cache_writer);
+    if (writer == NULL)
+        return NULL;
+
+    writer->file = NULL;
+    writer->temp_path = NULL;
+    writer->path = NULL;
+    writer->bits = bits;
+    writer->len = len;
+    writer->stride = get_stride(bits, len);
+    writer->has_failed = false;
+
+    if (!make_path(cache, key, "", &writer->path))
+    {
+        Data_cache_writer_finish(writer, false);
+        return NULL;
+    }
+
+    // Create a temporary file that is not used by other threads or processes
+    for (int i = 0; i < TEMP_FILE_TRIES_MAX; ++i)
+    {
+        char suffix[32] = "";
+        snprintf(suffix, 32, ".tmp%d", atomic_fetch_add(&cache->temp_index, 1));
+
+        if (!make_path(cache, key, suffix, &writer->temp_path))
+            break;
+
+        writer->file = fopen(writer->temp_path, "w+xb");
+        if (writer->file != NULL)
+            break;
+
+        memory_free(writer->temp_path);
+        writer->temp_path = NULL;
+    }
+
+    if (writer->file == NULL)
+    {
+        Data_cache_writer_finish(writer, false);
+        return NULL;
+    }
+
+    Entry_header header;
+    memset(&header, 0, sizeof(Entry_header));
+    memcpy(header.magic, ENTRY_MAGIC, 8);
+    header.version = ENTRY_VERSION;
+    header.byte_order = ENTRY_BYTE_ORDER;
+    header.channels = channels;
+    header.bits = bits;
+    header.is_float = is_float ? 1 : 0;
+    header.len = len;
+
+    if (fwrite(&header, sizeof(Entry_header), 1, writer->file) != 1)
+    {
+        Data_cache_writer_finish(writer, false);
+        return NULL;
+    }
+
+    // Extend the file to its final size so that it can be mapped as a whole
+    const int64_t size = ENTRY_HEADER_SIZE + channels * writer->stride;
+    if (!seek_file(writer->file, size - 1, SEEK_SET) ||
+            (fputc(0, writer->file) == EOF))
+    {
+        Data_cache_writer_finish(writer, false);
+        return NULL;
+    }
+
+    return writer;
+}
+
+
+void Data_cache_writer_write(
+        Data_cache_writer* writer, int ch, int64_t start, int64_t count, const void* data)
+{
+    rassert(writer != NULL);
+    rassert(ch >= 0);
+    rassert(start >= 0);
+    rassert(count >= 0);
+    rassert(start + count <= writer->len);
+    rassert(data != NULL);
+
+    if (writer->has_failed || (count == 0))
+        return;
+
+    const int bytes = writer->bits / 8;
+    const int64_t offset = ENTRY_HEADER_SIZE + ch * writer->stride + start * bytes;
+    if (!seek_file(writer->file, offset, SEEK_SET) ||
+            (fwrite(data, (size_t)bytes, (size_t)count, writer->file) != (size_t)count))
+        writer->has_failed = true;
+
+    return;
+}
+
+
+void Data_cache_writer_finish(Data_cache_writer* writer, bool complete)
+{
+    if (writer == NULL)
+        return;
+
+    if (writer->file != NULL)
+    {
+        if (fclose(writer->file) != 0)
+            writer->has_failed = true;
+
+        rassert(writer->temp_path != NULL);
+        rassert(writer->path != NULL);
+
+        if (!complete || writer->has_failed ||
+                (rename(writer->temp_path, writer->path) != 0))
+            remove(writer->temp_path);
+    }
+
+    memory_free(writer->temp_path);
+    memory_free(writer->path);
+    memory_free(writer);
+
+    return;
+}
+
+
+void del_Data_cache(Data_cache* cache)
+{
+    if (cache == NULL)
+        return;
+
+    memory_free(cache->dir);
+    memory_free(cache);
+
+    return;
+}
+
+
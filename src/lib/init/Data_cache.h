@@ -0,0 +1,221 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_DATA_CACHE_H
+#define KQT_DATA_CACHE_H
+
+
+#include <decl.h>
+#include <Error.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * Data cache stores decoded and generated sample data in a directory so that
+ * repeated loads of the same data can skip the processing.
+ *
+ * Each entry is a file named after the type of the data and an MD5 sum of
+ * the source data and parameters. The sample data is stored channel by
+ * channel after a fixed-size header, with each channel aligned for direct
+ * memory mapping. Entries are written to temporary files and renamed when
+ * complete, so several processes may share the same directory.
+ */
+
+
+#define DATA_CACHE_TYPE_LENGTH_MAX 16
+
+
+/**
+ * A content-based identifier of a Data cache entry.
+ */
+typedef struct Data_cache_key
+{
+    char type[DATA_CACHE_TYPE_LENGTH_MAX + 1];
+    uint64_t lower;
+    uint64_t upper;
+} Data_cache_key;
+
+
+/**
+ * Initialise a Data cache key.
+ *
+ * \param key    The Data cache key -- must not be \c NULL.
+ * \param type   The type of the cached data -- must not be \c NULL and must
+ *               contain only letters, digits and underscores. The length of
+ *               \a type must not exceed \c DATA_CACHE_TYPE_LENGTH_MAX. The
+ *               type should include a version number of the algorithm that
+ *               produces the data.
+ * \param data   The source data -- must not be \c NULL.
+ * \param size   The size of \a data in bytes -- must be >= \c 0.
+ *
+ * \return   The parameter \a key.
+ */
+Data_cache_key* Data_cache_key_init(
+        Data_cache_key* key, const char* type, const void* data, int64_t size);
+
+
+/**
+ * Create a new Data cache.
+ *
+ * \param dir     The cache directory -- must not be \c NULL or empty. The
+ *                directory must exist.
+ * \param error   Destination for error information -- must not be \c NULL.
+ *
+ * \return   The new Data cache if successful, otherwise \c NULL.
+ */
+Data_cache* new_Data_cache(const char* dir, Error* error);
+
+
+/**
+ * Open an entry in the Data cache.
+ *
+ * This function may be called from several threads simultaneously.
+ *
+ * \param cache   The Data cache -- must not be \c NULL.
+ * \param key     The Data cache key -- must not be \c NULL.
+ *
+ * \return   The entry if found, or \c NULL if there is no valid entry for
+ *           \a key or resource allocation failed.
+ */
+Data_cache_entry* Data_cache_open_entry(Data_cache* cache, const Data_cache_key* key);
+
+
+/**
+ * Get the number of channels in the Data cache entry.
+ *
+ * \param entry   The Data cache entry -- must not be \c NULL.
+ *
+ * \return   The number of channels.
+ */
+int Data_cache_entry_get_channels(const Data_cache_entry* entry);
+
+
+/**
+ * Get the bit resolution of the Data cache entry.
+ *
+ * \param entry   The Data cache entry -- must not be \c NULL.
+ *
+ * \return   The number of bits in each stored value (8, 16 or 32).
+ */
+int Data_cache_entry_get_bits(const Data_cache_entry* entry);
+
+
+/**
+ * Find out whether the Data cache entry contains floating point data.
+ *
+ * \param entry   The Data cache entry -- must not be \c NULL.
+ *
+ * \return   \c true if the data is floating point, otherwise \c false.
+ */
+bool Data_cache_entry_is_float(const Data_cache_entry* entry);
+
+
+/**
+ * Get the length of the Data cache entry.
+ *
+ * \param entry   The Data cache entry -- must not be \c NULL.
+ *
+ * \return   The number of values in each channel.
+ */
+int64_t Data_cache_entry_get_len(const Data_cache_entry* entry);
+
+
+/**
+ * Get the data of a channel in the Data cache entry.
+ *
+ * \param entry   The Data cache entry -- must not be \c NULL.
+ * \param ch      The channel number -- must be >= \c 0 and less than the
+ *                number of channels in \a entry.
+ *
+ * \return   The channel data.
+ */
+const void* Data_cache_entry_get_data(const Data_cache_entry* entry, int ch);
+
+
+/**
+ * Destroy an existing Data cache entry.
+ *
+ * \param entry   The Data cache entry, or \c NULL.
+ */
+void del_Data_cache_entry(Data_cache_entry* entry);
+
+
+/**
+ * Start writing an entry into the Data cache.
+ *
+ * The entry becomes visible after a successful call of
+ * \a Data_cache_writer_finish.
+ *
+ * \param cache      The Data cache -- must not be \c NULL.
+ * \param key        The Data cache key -- must not be \c NULL.
+ * \param channels   The number of channels -- must be \c 1 or \c 2.
+ * \param bits       The bit resolution -- must be \c 8, \c 16 or \c 32.
+ * \param is_float   \c true if the data is floating point. If \c true,
+ *                   \a bits must be \c 32.
+ * \param len        The number of values in each channel -- must be > \c 0.
+ *
+ * \return   The Data cache writer, or \c NULL if the entry could not be
+ *           created. Failures are not reported further as the cache is
+ *           optional.
+ */
+Data_cache_writer* new_Data_cache_writer(
+        Data_cache* cache,
+        const Data_cache_key* key,
+        int channels,
+        int bits,
+        bool is_float,
+        int64_t len);
+
+
+/**
+ * Write data into the Data cache entry.
+ *
+ * \param writer   The Data cache writer -- must not be \c NULL.
+ * \param ch       The channel number -- must be >= \c 0 and less than the
+ *                 number of channels in the entry.
+ * \param start    The index of the first value -- must be >= \c 0.
+ * \param count    The number of values -- must be >= \c 0 and must not
+ *                 extend past the entry length.
+ * \param data     The values in the format of the entry -- must not be
+ *                 \c NULL.
+ */
+void Data_cache_writer_write(
+        Data_cache_writer* writer, int ch, int64_t start, int64_t count, const void* data);
+
+
+/**
+ * Finish writing the Data cache entry and destroy the Data cache writer.
+ *
+ * \param writer     The Data cache writer, or \c NULL.
+ * \param complete   \c true if all data has been written and the entry
+ *                   should be stored, \c false if the entry should be
+ *                   discarded.
+ */
+void Data_cache_writer_finish(Data_cache_writer* writer, bool complete);
+
+
+/**
+ * Destroy an existing Data cache.
+ *
+ * \param cache   The Data cache, or \c NULL.
+ */
+void del_Data_cache(Data_cache* cache);
+
+
+#endif // KQT_DATA_CACHE_H
+
+
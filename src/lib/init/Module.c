@@ -18,6 +18,7 @@
 #include <mathnum/common.h>
 #include <memory.h>
 #include <init/comp_defaults.h>
+#include <init/Sample_streamer.h>
 #include <init/sheet/Channel_defaults_list.h>
 #include <string/common.h>
 
@@ -54,12 +55,16 @@ Module* new_Module(void)
     module->au_controls = NULL;
     module->au_table = NULL;
     module->connections = NULL;
+    module->in_iface = NULL;
     module->is_dc_blocker_enabled = true;
     module->mix_vol_dB = COMP_DEFAULT_MIX_VOL;
     module->mix_vol = exp2(module->mix_vol_dB / 6);
     module->force_shift = 0;
+    module->control_period = COMP_DEFAULT_CONTROL_PERIOD;
     module->env = NULL;
     module->bind = NULL;
+    module->sample_streamer = NULL;
+    atomic_init(&module->ref_count, 1);
     for (int i = 0; i < KQT_SONGS_MAX; ++i)
         module->order_lists[i] = NULL;
     for (int i = 0; i < KQT_TUNING_TABLES_MAX; ++i)
@@ -70,10 +75,12 @@ Module* new_Module(void)
     module->pats = new_Pat_table(KQT_PATTERNS_MAX);
     module->au_controls = new_Bit_array(KQT_CONTROLS_MAX);
     module->au_table = new_Au_table(KQT_AUDIO_UNITS_MAX);
+    module->in_iface = new_Au_interface();
     if (module->songs == NULL           ||
             module->pats == NULL        ||
             module->au_controls == NULL ||
-            module->au_table == NULL)
+            module->au_table == NULL    ||
+            module->in_iface == NULL)
     {
         del_Module(module);
         return NULL;
@@ -178,6 +185,37 @@ bool Module_read_force_shift(Module* module, Streader* sr)
 }
 
 
+bool Module_read_control_period(Module* module, Streader* sr)
+{
+    rassert(module != NULL);
+    rassert(sr != NULL);
+
+    if (Streader_is_error_set(sr))
+        return false;
+
+    int64_t period = COMP_DEFAULT_CONTROL_PERIOD;
+
+    if (Streader_has_data(sr))
+    {
+        if (!Streader_read_int(sr, &period))
+            return false;
+
+        if ((period < 1) || (period > KQT_CONTROL_PERIOD_MAX))
+        {
+            Streader_set_error(
+                    sr,
+                    "Control period must be within [1, %d]",
+                    KQT_CONTROL_PERIOD_MAX);
+            return false;
+        }
+    }
+
+    module->control_period = (int32_t)period;
+
+    return true;
+}
+
+
 bool Module_parse_random_seed(Module* module, Streader* sr)
 {
     rassert(module != NULL);
@@ -323,6 +361,20 @@ const Connections* Module_get_connections(const Module* module)
 }
 
 
+const Device* Module_get_input_interface(const Module* module)
+{
+    rassert(module != NULL);
+    return &module->in_iface->parent;
+}
+
+
+Device* Module_get_input_interface_mut(Module* module)
+{
+    rassert(module != NULL);
+    return &module->in_iface->parent;
+}
+
+
 void Module_set_mix_vol(Module* module, double mix_vol)
 {
     rassert(module != NULL);
@@ -447,6 +499,24 @@ void Module_set_bind(Module* module, Bind* bind)
 }
 
 
+void Module_set_sample_streamer(Module* module, Sample_streamer* streamer)
+{
+    rassert(module != NULL);
+
+    del_Sample_streamer(module->sample_streamer);
+    module->sample_streamer = streamer;
+
+    return;
+}
+
+
+Sample_streamer* Module_get_sample_streamer(const Module* module)
+{
+    rassert(module != NULL);
+    return module->sample_streamer;
+}
+
+
 const Tuning_table* Module_get_tuning_table(const Module* module, int index)
 {
     rassert(module != NULL);
@@ -470,15 +540,39 @@ void Module_set_tuning_table(Module* module, int index, Tuning_table* tt)
 }
 
 
+void Module_add_ref(Module* module)
+{
+    rassert(module != NULL);
+    const int prev_count = atomic_fetch_add(&module->ref_count, 1);
+    rassert(prev_count > 0);
+
+    return;
+}
+
+
+bool Module_is_shared(const Module* module)
+{
+    rassert(module != NULL);
+    return (atomic_load(&module->ref_count) > 1);
+}
+
+
 void del_Module(Module* module)
 {
     if (module == NULL)
         return;
 
+    // Only the last user may continue to destroy the Module
+    const int prev_count = atomic_fetch_sub(&module->ref_count, 1);
+    rassert(prev_count > 0);
+    if (prev_count > 1)
+        return;
+
     del_Environment(module->env);
     del_Song_table(module->songs);
     del_Pat_table(module->pats);
     del_Connections(module->connections);
+    del_Au_interface(module->in_iface);
     del_Au_table(module->au_table);
     del_Bit_array(module->au_controls);
     del_Input_map(module->au_map);
@@ -493,6 +587,9 @@ void del_Module(Module* module)
 
     del_Bind(module->bind);
 
+    // Streamed Samples release themselves from the Sample streamer
+    del_Sample_streamer(module->sample_streamer);
+
     Device_deinit(&module->parent);
     memory_free(module);
 
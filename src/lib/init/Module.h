@@ -19,6 +19,7 @@
 #include <decl.h>
 #include <init/Bind.h>
 #include <init/Connections.h>
+#include <init/devices/Au_interface.h>
 #include <init/devices/Device.h>
 #include <init/Environment.h>
 #include <init/Input_map.h>
@@ -32,6 +33,7 @@
 #include <kunquat/limits.h>
 #include <string/Streader.h>
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -51,13 +53,17 @@ struct Module
     Bit_array* au_controls;             ///< Audio unit control existence info.
     Au_table* au_table;                 ///< The Audio units.
     Connections* connections;           ///< Device connections.
+    Au_interface* in_iface;             ///< Input interface.
     Tuning_table* tuning_tables[KQT_TUNING_TABLES_MAX];
     bool is_dc_blocker_enabled;         ///< Block dc in the final mix.
     double mix_vol_dB;                  ///< Mixing volume in dB.
     double mix_vol;                     ///< Mixing volume.
     double force_shift;                 ///< Force shift.
+    int32_t control_period;             ///< Control stream evaluation period.
     Environment* env;                   ///< Environment variables.
     Bind* bind;
+    Sample_streamer* sample_streamer;   ///< Storage of streamed sample data.
+    atomic_int ref_count;               ///< Number of users of the Module.
 };
 
 
@@ -65,6 +71,7 @@ struct Module
  * Create a new Module.
  *
  * The caller shall eventually call del_Module() to destroy the Module returned.
+ * The new Module has one reference.
  *
  * \return   The new Module if successful, or \c NULL if memory allocation
  *           failed.
@@ -116,6 +123,17 @@ bool Module_read_mixing_volume(Module* module, Streader* sr);
 bool Module_read_force_shift(Module* module, Streader* sr);
 
 
+/**
+ * Read the control period of the Module.
+ *
+ * \param module   The Module -- must not be \c NULL.
+ * \param sr       The Streader of the JSON input -- must not be \c NULL.
+ *
+ * \return   \c true if successful, otherwise \c false.
+ */
+bool Module_read_control_period(Module* module, Streader* sr);
+
+
 /**
  * Parse the random seed of the composition.
  *
@@ -204,6 +222,29 @@ bool Module_find_pattern_location(
 const Connections* Module_get_connections(const Module* module);
 
 
+/**
+ * Get the input interface of the Module.
+ *
+ * The send ports of the input interface carry the audio input of the host
+ * into the connection graph as the input ports of the master.
+ *
+ * \param module   The Module -- must not be \c NULL.
+ *
+ * \return   The input interface.
+ */
+const Device* Module_get_input_interface(const Module* module);
+
+
+/**
+ * Get the mutable input interface of the Module.
+ *
+ * \param module   The Module -- must not be \c NULL.
+ *
+ * \return   The input interface.
+ */
+Device* Module_get_input_interface_mut(Module* module);
+
+
 /**
  * Set a Tuning table in the Module.
  *
@@ -343,7 +384,53 @@ void Module_set_bind(Module* module, Bind* bind);
 
 
 /**
- * Destroy an existing Module.
+ * Set the Sample streamer of the Module.
+ *
+ * The Module takes ownership of the Sample streamer and destroys it along
+ * with the Module. Any previous Sample streamer is destroyed.
+ *
+ * \param module     The Module -- must not be \c NULL.
+ * \param streamer   The Sample streamer, or \c NULL.
+ */
+void Module_set_sample_streamer(Module* module, Sample_streamer* streamer);
+
+
+/**
+ * Get the Sample streamer of the Module.
+ *
+ * \param module   The Module -- must not be \c NULL.
+ *
+ * \return   The Sample streamer, or \c NULL if streaming is disabled.
+ */
+Sample_streamer* Module_get_sample_streamer(const Module* module);
+
+
+/**
+ * Add a reference to the Module.
+ *
+ * A Module with more than one reference is shared between Players that
+ * belong to different Handles and must not be modified.
+ *
+ * \param module   The Module -- must not be \c NULL.
+ */
+void Module_add_ref(Module* module);
+
+
+/**
+ * Find out whether the Module has more than one reference.
+ *
+ * \param module   The Module -- must not be \c NULL.
+ *
+ * \return   \c true if \a module is shared, otherwise \c false.
+ */
+bool Module_is_shared(const Module* module);
+
+
+/**
+ * Release a reference to the Module.
+ *
+ * The Module is destroyed when its last reference is released. References
+ * may be released by Handles in different threads.
  *
  * \param module   The Module, or \c NULL.
  */
@@ -22,6 +22,7 @@
 #include <init/devices/Au_expressions.h>
 #include <init/devices/Au_streams.h>
 #include <init/devices/Audio_unit.h>
+#include <init/devices/Device_field.h>
 #include <init/devices/Device_params.h>
 #include <init/devices/Device_impl.h>
 #include <init/devices/Param_proc_filter.h>
@@ -37,6 +38,8 @@
 #include <ctype.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <math.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -50,6 +53,7 @@ typedef struct Reader_params
     const char* subkey;
     int version;
     Streader* sr;
+    const double* float_value; // replaces sr if not NULL
 } Reader_params;
 
 
@@ -71,6 +75,115 @@ static const struct
 };
 
 
+// A hashed index of the key patterns, built on first use
+
+#define KEYP_INDEX_SIZE 128
+#define KEYP_COUNT_MAX 96
+
+enum
+{
+    KEYP_INDEX_UNBUILT = 0,
+    KEYP_INDEX_BUILDING,
+    KEYP_INDEX_READY,
+};
+
+static atomic_int keyp_index_state = KEYP_INDEX_UNBUILT;
+static int keyp_index[KEYP_INDEX_SIZE]; // keyp_to_func index + 1, or 0 if unused
+static uint32_t keyp_hashes[KEYP_COUNT_MAX];
+static int keyp_lengths[KEYP_COUNT_MAX];
+
+
+static bool prepare_keyp_index(void)
+{
+    int state = atomic_load(&keyp_index_state);
+    if (state == KEYP_INDEX_READY)
+        return true;
+
+    // Other threads use the linear search until we are finished
+    if ((state != KEYP_INDEX_UNBUILT) ||
+            !atomic_compare_exchange_strong(
+                &keyp_index_state, &state, KEYP_INDEX_BUILDING))
+        return false;
+
+    for (int i = 0; keyp_to_func[i].keyp != NULL; ++i)
+    {
+        rassert(i < KEYP_COUNT_MAX);
+
+        const char* keyp = keyp_to_func[i].keyp;
+        rassert(string_has_suffix(keyp, "/") || string_has_suffix(keyp, ".json"));
+
+        keyp_hashes[i] = string_hash(keyp);
+        keyp_lengths[i] = (int)strlen(keyp);
+
+        int pos = (int)(keyp_hashes[i] % KEYP_INDEX_SIZE);
+        while (keyp_index[pos] != 0)
+            pos = (pos + 1) % KEYP_INDEX_SIZE;
+
+        keyp_index[pos] = i + 1;
+    }
+
+    atomic_store(&keyp_index_state, KEYP_INDEX_READY);
+
+    return true;
+}
+
+
+static int find_keyp_entry_linear(const char* key_pattern)
+{
+    rassert(key_pattern != NULL);
+
+    for (int i = 0; keyp_to_func[i].keyp != NULL; ++i)
+    {
+        if (string_has_prefix(key_pattern, keyp_to_func[i].keyp))
+            return i;
+    }
+
+    return -1;
+}
+
+
+static int find_keyp_entry(const char* key_pattern)
+{
+    rassert(key_pattern != NULL);
+
+    if (!prepare_keyp_index())
+        return find_keyp_entry_linear(key_pattern);
+
+    // Look up each prefix that may match a key pattern in the table,
+    // preferring the first one listed in the table
+    int found = -1;
+    uint32_t hash = STRING_HASH_INIT;
+    for (int len = 1; key_pattern[len - 1] != '\0'; ++len)
+    {
+        hash = string_hash_add(hash, key_pattern[len - 1]);
+
+        const bool is_candidate =
+            (key_pattern[len - 1] == '/') ||
+            ((len >= 5) && (strncmp(&key_pattern[len - 5], ".json", 5) == 0));
+        if (!is_candidate)
+            continue;
+
+        int pos = (int)(hash % KEYP_INDEX_SIZE);
+        while (keyp_index[pos] != 0)
+        {
+            const int entry = keyp_index[pos] - 1;
+            if ((keyp_hashes[entry] == hash) &&
+                    (keyp_lengths[entry] == len) &&
+                    (strncmp(keyp_to_func[entry].keyp, key_pattern, (size_t)len) == 0))
+            {
+                if ((found < 0) || (entry < found))
+                    found = entry;
+                break;
+            }
+
+            pos = (pos + 1) % KEYP_INDEX_SIZE;
+        }
+    }
+
+    return found;
+}
+
+
 #define set_error(params)                                                        \
     if (true)                                                                    \
     {                                                                            \
@@ -248,87 +361,129 @@ bool parse_data(Handle* handle, const char* key, const void* data, long length)
     const bool is_nonempty_json_data = string_has_suffix(key, ".json") && (data != NULL);
 
     // Find a known key pattern that is a prefix of our retrieved key pattern
-    for (int i = 0; keyp_to_func[i].keyp != NULL; ++i)
+    const int entry = find_keyp_entry(key_pattern);
+    if (entry < 0)
     {
-        if (string_has_prefix(key_pattern, keyp_to_func[i].keyp))
+        // Accept unknown key pattern without modification
+        return true;
+    }
+
+    // Fill in params
+    Reader_params params;
+    params.handle = handle;
+    params.indices = key_indices;
+    params.subkey = key + strlen(keyp_to_func[entry].keyp);
+    params.version = 0;
+    params.sr = Streader_init(STREADER_AUTO, data, length);
+    params.float_value = NULL;
+
+    if (is_nonempty_json_data)
+    {
+        int64_t version = -1;
+        if (!Streader_readf(params.sr, "[%i,", &version))
         {
-            // Fill in params
-            Reader_params params;
-            params.handle = handle;
-            params.indices = key_indices;
-            params.subkey = key + strlen(keyp_to_func[i].keyp);
-            params.version = 0;
-            params.sr = Streader_init(STREADER_AUTO, data, length);
-
-            if (is_nonempty_json_data)
-            {
-                int64_t version = -1;
-                if (!Streader_readf(params.sr, "[%i,", &version))
-                {
-                    set_error(&params);
-                    return false;
-                }
-
-                if (version < 0 || version > (int64_t)INT_MAX)
-                {
-                    Streader_set_error(
-                            params.sr,
-                            "Invalid version number of key %s: %lld",
-                            key,
-                            (long long)version);
-                    set_error(&params);
-                    return false;
-                }
-
-                if (string_has_suffix(keyp_to_func[i].keyp, ".json") &&
-                       (version > keyp_to_func[i].version))
-                {
-                    Streader_set_error(
-                            params.sr,
-                            "Unsupported version number of key %s: %lld"
-                            " (latest supported version is %d)",
-                            key,
-                            (long long)version,
-                            keyp_to_func[i].version);
-                    set_error(&params);
-                    return false;
-                }
-
-                params.version = (int)version;
-            }
+            set_error(&params);
+            return false;
+        }
 
-            // Send read parameters to our callback
-            const bool success = keyp_to_func[i].func(&params);
-            if (!success)
-                return false;
+        if (version < 0 || version > (int64_t)INT_MAX)
+        {
+            Streader_set_error(
+                    params.sr,
+                    "Invalid version number of key %s: %lld",
+                    key,
+                    (long long)version);
+            set_error(&params);
+            return false;
+        }
 
-            // TODO: Currently we don't always scan all the data, so we might
-            //       not be at the correct location for checking the end bracket
-            /*
-            if (is_nonempty_json_data)
-            {
-                if (!Streader_readf(params.sr, "]"))
-                {
-                    set_error(&params);
-                    return false;
-                }
-            }
-            */
+        if (string_has_suffix(keyp_to_func[entry].keyp, ".json") &&
+               (version > keyp_to_func[entry].version))
+        {
+            Streader_set_error(
+                    params.sr,
+                    "Unsupported version number of key %s: %lld"
+                    " (latest supported version is %d)",
+                    key,
+                    (long long)version,
+                    keyp_to_func[entry].version);
+            set_error(&params);
+            return false;
+        }
 
-            // Mark connections for update if needed
-            if (was_connection_possible != is_connection_possible(
-                        handle, key_pattern, key_indices))
-                handle->update_connections = true;
+        params.version = (int)version;
+    }
 
-            return true;
+    // Send read parameters to our callback
+    const bool success = keyp_to_func[entry].func(&params);
+    if (!success)
+        return false;
+
+    // TODO: Currently we don't always scan all the data, so we might
+    //       not be at the correct location for checking the end bracket
+    /*
+    if (is_nonempty_json_data)
+    {
+        if (!Streader_readf(params.sr, "]"))
+        {
+            set_error(&params);
+            return false;
         }
     }
+    */
+
+    // Mark connections for update if needed
+    if (was_connection_possible != is_connection_possible(
+                handle, key_pattern, key_indices))
+        handle->update_connections = true;
 
-    // Accept unknown key pattern without modification
     return true;
 }
 
 
+bool parse_float_data(Handle* handle, const char* key, double value)
+{
+    rassert(handle != NULL);
+    rassert(key != NULL);
+    rassert(get_keyp_device_field_type(key) == DEVICE_FIELD_FLOAT);
+    rassert(isfinite(value));
+
+    char key_pattern[KQT_KEY_LENGTH_MAX] = "";
+    Key_indices key_indices = { 0 };
+    for (int i = 0; i < KEY_INDICES_MAX; ++i)
+        key_indices[i] = -1;
+
+    if (!extract_key_pattern(key, key_pattern, key_indices))
+    {
+        Handle_set_error(handle, ERROR_ARGUMENT, "Invalid key: %s", key);
+        return false;
+    }
+
+    // Only processor parameters are numeric, and they do not affect connections
+    const int entry = find_keyp_entry(key_pattern);
+    if ((entry < 0) ||
+            ((keyp_to_func[entry].func != read_proc_impl_key) &&
+             (keyp_to_func[entry].func != read_proc_conf_key) &&
+             (keyp_to_func[entry].func != read_au_proc_impl_key) &&
+             (keyp_to_func[entry].func != read_au_proc_conf_key)))
+    {
+        Handle_set_error(
+                handle, ERROR_ARGUMENT, "Key %s is not a processor parameter", key);
+        return false;
+    }
+
+    Reader_params params;
+    params.handle = handle;
+    params.indices = key_indices;
+    params.subkey = key + strlen(keyp_to_func[entry].keyp);
+    params.version = 0;
+    params.sr = NULL;
+    params.float_value = &value;
+
+    return keyp_to_func[entry].func(&params);
+}
+
+
 static bool read_dc_blocker_enabled(Reader_params* params)
 {
     rassert(params != NULL);
@@ -378,6 +533,27 @@ static bool read_force_shift(Reader_params* params)
 }
 
 
+static bool read_control_period(Reader_params* params)
+{
+    rassert(params != NULL);
+
+    Module* module = Handle_get_module(params->handle);
+    if (!Module_read_control_period(module, params->sr))
+    {
+        set_error(params);
+        return false;
+    }
+
+    Device_states_set_control_period(
+            Player_get_device_states(params->handle->player), module->control_period);
+    Device_states_set_control_period(
+            Player_get_device_states(params->handle->length_counter),
+            module->control_period);
+
+    return true;
+}
+
+
 #define acquire_port_index(index, params, depth)            \
     if (true)                                               \
     {                                                       \
@@ -388,6 +564,31 @@ static bool read_force_shift(Reader_params* params)
     else ignore(0)
 
 
+static bool read_in_port_manifest(Reader_params* params)
+{
+    rassert(params != NULL);
+
+    int32_t in_port_index = -1;
+    acquire_port_index(in_port_index, params, 0);
+
+    const bool existent = read_default_manifest(params->sr);
+    if (Streader_is_error_set(params->sr))
+    {
+        set_error(params);
+        return false;
+    }
+
+    Module* module = Handle_get_module(params->handle);
+    Device_set_port_existence(
+            Module_get_input_interface_mut(module),
+            DEVICE_PORT_TYPE_SEND,
+            in_port_index,
+            existent);
+
+    return true;
+}
+
+
 static bool read_out_port_manifest(Reader_params* params)
 {
     rassert(params != NULL);
@@ -519,7 +720,8 @@ static bool read_bind(Reader_params* params)
 
     Module_set_bind(Handle_get_module(params->handle), map);
 
-    if (!Player_refresh_bind_state(params->handle->player))
+    if (!Player_refresh_bind_state(params->handle->player) ||
+            !Player_refresh_bind_state(params->handle->length_counter))
     {
         Handle_set_error(params->handle, ERROR_MEMORY,
                 "Couldn't allocate memory for bind state");
@@ -1361,12 +1563,33 @@ static bool read_any_proc_impl_conf_key(
     acquire_au(au, params->handle, au_table, au_index);
     Proc_table* proc_table = Audio_unit_get_procs(au);
 
+    const bool is_new_proc = (Proc_table_get_proc_mut(proc_table, proc_index) == NULL);
     Processor* proc = add_processor(params->handle, au, proc_table, proc_index);
     if (proc == NULL)
         return false;
 
     // Update Device
-    if (!Device_set_key(
+    if (params->float_value != NULL)
+    {
+        if (!Device_set_float_key(
+                    (Device*)proc,
+                    params->subkey,
+                    *params->float_value,
+                    params->handle->bkg_loader))
+        {
+            Handle_set_error(
+                    params->handle,
+                    ERROR_MEMORY,
+                    "Could not allocate memory for device key %s",
+                    params->subkey);
+            return false;
+        }
+
+        // Values of existing processors do not require validation
+        if (is_new_proc)
+            params->handle->data_is_validated = false;
+    }
+    else if (!Device_set_key(
                 (Device*)proc,
                 params->subkey,
                 params->version,
@@ -41,6 +41,23 @@
 bool parse_data(Handle* handle, const char* key, const void* data, long length);
 
 
+/**
+ * Parse a floating-point processor parameter given in binary form.
+ *
+ * This is equivalent to calling \a parse_data with the value of version
+ * \c 0 in JSON format. If the processor already exists, the Handle remains
+ * validated.
+ *
+ * \param handle   The Kunquat Handle -- must not be \c NULL.
+ * \param key      The key of the data -- must be a valid key of
+ *                 floating-point type.
+ * \param value    The value -- must be finite.
+ *
+ * \return   \c true if successful, otherwise \c false.
+ */
+bool parse_float_data(Handle* handle, const char* key, double value);
+
+
 #endif // KQT_PARSE_MANAGER_H
 
 
@@ -0,0 +1,936 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <init/Sample_streamer.h>
+
+#include <debug/assert.h>
+#include <init/devices/param_types/Sample.h>
+#include <mathnum/common.h>
+#include <memory.h>
+#include <threads/Condition.h>
+#include <threads/Mutex.h>
+#include <threads/Thread.h>
+
+#ifdef ENABLE_THREADS
+#include <stdatomic.h>
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+
+#define FILL_CHUNK_LEN 4096
+#define IDLE_REFILLS_MAX 64
+#define CACHE_FILE_TRIES_MAX 1000
+
+
+#ifdef ENABLE_THREADS
+typedef atomic_int Shared_int;
+typedef atomic_int_least64_t Shared_int64;
+#define SHARED_LOAD(p, order) atomic_load_explicit((p), memory_order_ ## order)
+#define SHARED_STORE(p, value, order) \
+    atomic_store_explicit((p), (value), memory_order_ ## order)
+#define SHARED_ADD(p, value) atomic_fetch_add((p), (value))
+#else
+// Without the I/O thread, the streams are only accessed in the rendering thread
+typedef int Shared_int;
+typedef int64_t Shared_int64;
+#define SHARED_LOAD(p, order) (*(p))
+#define SHARED_STORE(p, value, order) (*(p) = (value))
+#define SHARED_ADD(p, value) (*(p) += (value))
+#endif
+
+
+static_assert(
+        (SAMPLE_STREAMER_RING_LEN & (SAMPLE_STREAMER_RING_LEN - 1)) == 0,
+        "Sample streamer ring length must be a power of two");
+
+
+typedef enum
+{
+    STREAM_FREE = 0,
+    STREAM_OPENING,
+    STREAM_OPEN,
+    STREAM_CLOSING,
+} Stream_state;
+
+
+typedef struct Stream
+{
+    Shared_int state;
+    Shared_int gen;
+
+    // Set when opening, read-only while open
+    const Sample* sample;
+    Sample_loop loop;
+    int64_t loop_start;
+    int64_t loop_end;
+
+    // Accessed by the reader and the I/O thread
+    Shared_int64 read_pos;
+    Shared_int64 ring_start;
+    Shared_int64 fill_end;
+    Shared_int64 access_count;
+
+    // Used only by the I/O thread
+    int64_t seen_access_count;
+    int idle_refills;
+
+    float* ring[2];
+} Stream;
+
+
+struct Sample_streamer
+{
+    int64_t preload_len;
+    FILE* cache;
+    char* cache_path;
+    int64_t cache_size;
+    int sample_count;
+
+    Shared_int64 underrun_count;
+
+    Stream streams[SAMPLE_STREAMER_STREAMS_MAX];
+
+    // Buffers used by the refill
+    char read_buf[FILL_CHUNK_LEN * 4];
+    float frames[2][FILL_CHUNK_LEN];
+
+#ifdef ENABLE_THREADS
+    Mutex lock;
+    Condition refill_cond;
+    bool refill_requested;
+    bool stop_thread;
+    Thread io_thread;
+#endif
+};
+
+
+static void lock_streamer(Sample_streamer* streamer)
+{
+    rassert(streamer != NULL);
+
+#ifdef ENABLE_THREADS
+    Mutex_lock(&streamer->lock);
+#endif
+
+    return;
+}
+
+
+static void unlock_streamer(Sample_streamer* streamer)
+{
+    rassert(streamer != NULL);
+
+#ifdef ENABLE_THREADS
+    Mutex_unlock(&streamer->lock);
+#endif
+
+    return;
+}
+
+
+static int get_frame_bytes(const Sample* sample)
+{
+    rassert(sample != NULL);
+    return sample->bits / 8;
+}
+
+
+static int64_t get_cache_offset(const Sample* sample, int ch, int64_t frame)
+{
+    rassert(sample != NULL);
+    rassert(ch >= 0);
+    rassert(ch < sample->channels);
+    rassert(frame >= sample->resident_len);
+
+    const int64_t stream_len = sample->len - sample->resident_len;
+    return sample->stream_offset +
+        (ch * stream_len + frame - sample->resident_len) * get_frame_bytes(sample);
+}
+
+
+static bool seek_file(FILE* file, int64_t offset)
+{
+    rassert(file != NULL);
+    rassert(offset >= 0);
+
+    // Fail cleanly if the offset does not fit in the file offset type
+    if ((sizeof(off_t) < sizeof(int64_t)) && (offset > INT32_MAX))
+        return false;
+
+    return (fseeko(file, (off_t)offset, SEEK_SET) == 0);
+}
+
+
+static void convert_frames(
+        const Sample* sample, const void* src, int64_t count, float* dest)
+{
+    rassert(sample != NULL);
+    rassert(src != NULL);
+    rassert(count >= 0);
+    rassert(dest != NULL);
+
+    if (sample->is_float)
+    {
+        memcpy(dest, src, sizeof(float) * (size_t)count);
+        return;
+    }
+
+    switch (sample->bits)
+    {
+        case 8:
+        {
+            const int8_t* data = src;
+            for (int64_t i = 0; i < count; ++i)
+                dest[i] = (float)(data[i] * (1.0 / 0x80));
+        }
+        break;
+
+        case 16:
+        {
+            const int16_t* data = src;
+            for (int64_t i = 0; i < count; ++i)
+                dest[i] = (float)(data[i] * (1.0 / 0x8000UL));
+        }
+        break;
+
+        case 32:
+        {
+            const int32_t* data = src;
+            for (int64_t i = 0; i < count; ++i)
+                dest[i] = (float)(data[i] * (1.0 / 0x80000000UL));
+        }
+        break;
+
+        default:
+            rassert(false);
+    }
+
+    return;
+}
+
+
+static void read_frames(
+        Sample_streamer* streamer, const Sample* sample, int64_t first, int64_t count)
+{
+    rassert(streamer != NULL);
+    rassert(sample != NULL);
+    rassert(first >= 0);
+    rassert(count > 0);
+    rassert(count <= FILL_CHUNK_LEN);
+    rassert(first + count <= sample->len);
+
+    const int bytes = get_frame_bytes(sample);
+    const int64_t resident_count = clamp(sample->resident_len - first, 0, count);
+
+    for (int ch = 0; ch < sample->channels; ++ch)
+    {
+        float* dest = streamer->frames[ch];
+
+        if (resident_count > 0)
+        {
+            const char* data = sample->data[ch];
+            convert_frames(sample, data + first * bytes, resident_count, dest);
+        }
+
+        const int64_t stream_count = count - resident_count;
+        if (stream_count > 0)
+        {
+            const int64_t stream_first = first + resident_count;
+            const int64_t offset = get_cache_offset(sample, ch, stream_first);
+            size_t read_count = 0;
+            if (seek_file(streamer->cache, offset))
+                read_count = fread(
+                        streamer->read_buf,
+                        (size_t)bytes,
+                        (size_t)stream_count,
+                        streamer->cache);
+
+            convert_frames(
+                    sample,
+                    streamer->read_buf,
+                    (int64_t)read_count,
+                    dest + resident_count);
+            for (int64_t i = resident_count + (int64_t)read_count; i < count; ++i)
+                dest[i] = 0;
+        }
+    }
+
+    return;
+}
+
+
+/**
+ * Find a run of consecutive sample frames starting at a playback position.
+ *
+ * The loop calculations must match those in Sample_render.
+ */
+static int64_t get_run(
+        const Stream* stream, int64_t pos, int64_t max_count, int64_t* first, bool* reverse)
+{
+    rassert(stream != NULL);
+    rassert(pos >= 0);
+    rassert(max_count > 0);
+    rassert(first != NULL);
+    rassert(reverse != NULL);
+
+    *reverse = false;
+
+    switch (stream->loop)
+    {
+        case SAMPLE_LOOP_OFF:
+        {
+            *first = pos;
+            return min(max_count, stream->sample->len - pos);
+        }
+        break;
+
+        case SAMPLE_LOOP_UNI:
+        {
+            const int64_t loop_len = stream->loop_end - stream->loop_start;
+            const int64_t frame = (pos < stream->loop_end)
+                ? pos
+                : stream->loop_start + (pos - stream->loop_start) % loop_len;
+            *first = frame;
+            return min(max_count, stream->loop_end - frame);
+        }
+        break;
+
+        case SAMPLE_LOOP_BI:
+        {
+            const int64_t uni_loop_len = stream->loop_end - stream->loop_start - 1;
+            const int64_t step_count = uni_loop_len * 2;
+            const int64_t loop_len = max(1, step_count);
+
+            if (pos - stream->loop_start < uni_loop_len)
+            {
+                *first = pos;
+                return min(max_count, stream->loop_start + uni_loop_len - pos);
+            }
+
+            const int64_t loop_pos = (pos - stream->loop_start) % loop_len;
+            if (loop_pos < uni_loop_len)
+            {
+                *first = stream->loop_start + loop_pos;
+                return min(max_count, uni_loop_len - loop_pos);
+            }
+
+            const int64_t count = min(max_count, loop_len - loop_pos);
+            *first = stream->loop_start + step_count - loop_pos - count + 1;
+            *reverse = true;
+            return count;
+        }
+        break;
+
+        default:
+            rassert(false);
+    }
+
+    return 0;
+}
+
+
+static void fill_stream(Sample_streamer* streamer, Stream* stream)
+{
+    rassert(streamer != NULL);
+    rassert(stream != NULL);
+
+    const Sample* sample = stream->sample;
+
+    const int64_t read_pos = SHARED_LOAD(&stream->read_pos, acquire);
+    int64_t fill_end = SHARED_LOAD(&stream->fill_end, relaxed);
+    if (fill_end < read_pos)
+    {
+        // The reader has skipped the frames we did not have time to read
+        fill_end = read_pos;
+        SHARED_STORE(&stream->ring_start, read_pos, relaxed);
+        SHARED_STORE(&stream->fill_end, read_pos, release);
+    }
+
+    int64_t target = read_pos + SAMPLE_STREAMER_RING_LEN;
+    if (stream->loop == SAMPLE_LOOP_OFF)
+        target = min(target, sample->len);
+
+    const int64_t mask = SAMPLE_STREAMER_RING_LEN - 1;
+
+    while (fill_end < target)
+    {
+        int64_t first = 0;
+        bool reverse = false;
+        const int64_t count = get_run(
+                stream, fill_end, min(target - fill_end, FILL_CHUNK_LEN), &first, &reverse);
+        rassert(count > 0);
+
+        read_frames(streamer, sample, first, count);
+
+        for (int ch = 0; ch < sample->channels; ++ch)
+        {
+            const float* frames = streamer->frames[ch];
+            float* ring = stream->ring[ch];
+            for (int64_t i = 0; i < count; ++i)
+            {
+                const int64_t src_index = reverse ? count - i - 1 : i;
+                ring[(fill_end + i) & mask] = frames[src_index];
+            }
+        }
+
+        fill_end += count;
+        SHARED_STORE(&stream->fill_end, fill_end, release);
+    }
+
+    return;
+}
+
+
+static bool change_state(Stream* stream, Stream_state from, Stream_state to)
+{
+    rassert(stream != NULL);
+
+#ifdef ENABLE_THREADS
+    int expected = from;
+    return atomic_compare_exchange_strong(&stream->state, &expected, to);
+#else
+    if (stream->state != (int)from)
+        return false;
+
+    stream->state = to;
+    return true;
+#endif
+}
+
+
+static void free_stream(Stream* stream)
+{
+    rassert(stream != NULL);
+
+    stream->sample = NULL;
+    SHARED_ADD(&stream->gen, 1);
+    SHARED_STORE(&stream->state, STREAM_FREE, release);
+
+    return;
+}
+
+
+static void refill_streams(Sample_streamer* streamer)
+{
+    rassert(streamer != NULL);
+
+    lock_streamer(streamer);
+
+    for (int i = 0; i < SAMPLE_STREAMER_STREAMS_MAX; ++i)
+    {
+        Stream* stream = &streamer->streams[i];
+
+        const int state = SHARED_LOAD(&stream->state, acquire);
+        if (state == STREAM_CLOSING)
+        {
+            free_stream(stream);
+            continue;
+        }
+        else if (state != STREAM_OPEN)
+        {
+            continue;
+        }
+
+        // Close streams abandoned by their voices
+        const int64_t access_count = SHARED_LOAD(&stream->access_count, seq_cst);
+        if (access_count == stream->seen_access_count)
+        {
+            ++stream->idle_refills;
+            if (stream->idle_refills >= IDLE_REFILLS_MAX)
+            {
+                free_stream(stream);
+                continue;
+            }
+        }
+        else
+        {
+            stream->seen_access_count = access_count;
+            stream->idle_refills = 0;
+        }
+
+        fill_stream(streamer, stream);
+    }
+
+    unlock_streamer(streamer);
+
+    return;
+}
+
+
+#ifdef ENABLE_THREADS
+static void* run_io_thread(void* user_data)
+{
+    rassert(user_data != NULL);
+
+    Sample_streamer* streamer = user_data;
+
+    Mutex* cond_mutex = Condition_get_mutex(&streamer->refill_cond);
+    Mutex_lock(cond_mutex);
+
+    while (true)
+    {
+        while (!streamer->refill_requested && !streamer->stop_thread)
+            Condition_wait(&streamer->refill_cond);
+
+        if (streamer->stop_thread)
+            break;
+
+        streamer->refill_requested = false;
+        Mutex_unlock(cond_mutex);
+
+        refill_streams(streamer);
+
+        Mutex_lock(cond_mutex);
+    }
+
+    Mutex_unlock(cond_mutex);
+
+    return NULL;
+}
+#endif
+
+
+static FILE* open_cache_file(const char* cache_dir, char** path, Error* error)
+{
+    rassert(path != NULL);
+    rassert(error != NULL);
+
+    *path = NULL;
+
+    if ((cache_dir == NULL) || (cache_dir[0] == '\0'))
+    {
+        FILE* file = tmpfile();
+        if (file == NULL)
+            Error_set(error, ERROR_RESOURCE, "Could not create a sample cache file");
+
+        return file;
+    }
+
+    static const char* name_format = "%s/kunquat_samples_%d.cache";
+    const int path_len = snprintf(NULL, 0, name_format, cache_dir, CACHE_FILE_TRIES_MAX);
+    char* cache_path = memory_alloc_items(char, path_len + 1);
+    if (cache_path == NULL)
+    {
+        Error_set(error, ERROR_MEMORY, "Could not allocate memory for sample cache path");
+        return NULL;
+    }
+
+    for (int i = 0; i < CACHE_FILE_TRIES_MAX; ++i)
+    {
+        snprintf(cache_path, (size_t)path_len + 1, name_format, cache_dir, i);
+        FILE* file = fopen(cache_path, "w+xb");
+        if (file != NULL)
+        {
+            *path = cache_path;
+            return file;
+        }
+    }
+
+    Error_set(
+            error,
+            ERROR_RESOURCE,
+            "Could not create a sample cache file in %s",
+            cache_dir);
+    memory_free(cache_path);
+
+    return NULL;
+}
+
+
+Sample_streamer* new_Sample_streamer(
+        int64_t preload_len, const char* cache_dir, Error* error)
+{
+    rassert(preload_len > 0);
+    rassert(error != NULL);
+
+    Sample_streamer* streamer = memory_alloc_item(Sample_streamer);
+    if (streamer == NULL)
+    {
+        Error_set(error, ERROR_MEMORY, "Could not allocate memory for sample streamer");
+        return NULL;
+    }
+
+    streamer->preload_len = preload_len;
+    streamer->cache = NULL;
+    streamer->cache_path = NULL;
+    streamer->cache_size = 0;
+    streamer->sample_count = 0;
+    streamer->underrun_count = 0;
+
+    for (int i = 0; i < SAMPLE_STREAMER_STREAMS_MAX; ++i)
+    {
+        Stream* stream = &streamer->streams[i];
+        stream->state = STREAM_FREE;
+        stream->gen = 0;
+        stream->sample = NULL;
+        stream->loop = SAMPLE_LOOP_OFF;
+        stream->loop_start = 0;
+        stream->loop_end = 0;
+        stream->read_pos = 0;
+        stream->ring_start = 0;
+        stream->fill_end = 0;
+        stream->access_count = 0;
+        stream->seen_access_count = 0;
+        stream->idle_refills = 0;
+        stream->ring[0] = NULL;
+        stream->ring[1] = NULL;
+    }
+
+#ifdef ENABLE_THREADS
+    streamer->lock = *MUTEX_AUTO;
+    streamer->refill_cond = *CONDITION_AUTO;
+    streamer->refill_requested = false;
+    streamer->stop_thread = false;
+    streamer->io_thread = *THREAD_AUTO;
+#endif
+
+    for (int i = 0; i < SAMPLE_STREAMER_STREAMS_MAX; ++i)
+    {
+        Stream* stream = &streamer->streams[i];
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            stream->ring[ch] = memory_calloc_items(float, SAMPLE_STREAMER_RING_LEN);
+            if (stream->ring[ch] == NULL)
+            {
+                Error_set(
+                        error,
+                        ERROR_MEMORY,
+                        "Could not allocate memory for sample stream buffers");
+                del_Sample_streamer(streamer);
+                return NULL;
+            }
+        }
+    }
+
+    streamer->cache = open_cache_file(cache_dir, &streamer->cache_path, error);
+    if (streamer->cache == NULL)
+    {
+        del_Sample_streamer(streamer);
+        return NULL;
+    }
+
+#ifdef ENABLE_THREADS
+    Mutex_init(&streamer->lock);
+    Condition_init(&streamer->refill_cond);
+
+    if (!Thread_init(&streamer->io_thread, run_io_thread, streamer, error))
+    {
+        del_Sample_streamer(streamer);
+        return NULL;
+    }
+#endif
+
+    return streamer;
+}
+
+
+int64_t Sample_streamer_get_preload_len(const Sample_streamer* streamer)
+{
+    rassert(streamer != NULL);
+    return streamer->preload_len;
+}
+
+
+bool Sample_streamer_has_samples(const Sample_streamer* streamer)
+{
+    rassert(streamer != NULL);
+    return (streamer->sample_count > 0);
+}
+
+
+void Sample_streamer_reserve(Sample_streamer* streamer, Sample* sample)
+{
+    rassert(streamer != NULL);
+    rassert(sample != NULL);
+    rassert(sample->streamer == NULL);
+
+    if (sample->len <= streamer->preload_len)
+        return;
+
+    lock_streamer(streamer);
+
+    sample->resident_len = streamer->preload_len;
+    sample->streamer = streamer;
+    sample->stream_offset = streamer->cache_size;
+
+    // NOTE: The space of released Samples is not reused
+    streamer->cache_size +=
+        (sample->len - sample->resident_len) * sample->channels * get_frame_bytes(sample);
+    ++streamer->sample_count;
+
+    unlock_streamer(streamer);
+
+    return;
+}
+
+
+bool Sample_streamer_write(
+        Sample_streamer* streamer,
+        const Sample* sample,
+        int ch,
+        int64_t start,
+        int64_t count,
+        const void* data,
+        Error* error)
+{
+    rassert(streamer != NULL);
+    rassert(sample != NULL);
+    rassert(sample->streamer == streamer);
+    rassert(ch >= 0);
+    rassert(ch < sample->channels);
+    rassert(start >= sample->resident_len);
+    rassert(count >= 0);
+    rassert(start + count <= sample->len);
+    rassert(data != NULL);
+    rassert(error != NULL);
+
+    if (count == 0)
+        return true;
+
+    lock_streamer(streamer);
+
+    const int64_t offset = get_cache_offset(sample, ch, start);
+    const bool success =
+        seek_file(streamer->cache, offset) &&
+        (fwrite(data, (size_t)get_frame_bytes(sample), (size_t)count, streamer->cache) ==
+            (size_t)count);
+
+    unlock_streamer(streamer);
+
+    if (!success)
+    {
+        Error_set(error, ERROR_RESOURCE, "Could not write to the sample cache file");
+        return false;
+    }
+
+    return true;
+}
+
+
+void Sample_streamer_release_sample(Sample_streamer* streamer, const Sample* sample)
+{
+    rassert(streamer != NULL);
+    rassert(sample != NULL);
+    rassert(sample->streamer == streamer);
+
+    lock_streamer(streamer);
+
+    for (int i = 0; i < SAMPLE_STREAMER_STREAMS_MAX; ++i)
+    {
+        Stream* stream = &streamer->streams[i];
+        const int state = SHARED_LOAD(&stream->state, acquire);
+        if ((state != STREAM_FREE) && (stream->sample == sample))
+            free_stream(stream);
+    }
+
+    rassert(streamer->sample_count > 0);
+    --streamer->sample_count;
+
+    unlock_streamer(streamer);
+
+    return;
+}
+
+
+int Sample_streamer_open_stream(
+        Sample_streamer* streamer,
+        const Sample* sample,
+        Sample_loop loop,
+        int64_t loop_start,
+        int64_t loop_end,
+        int64_t start_pos,
+        int* gen)
+{
+    rassert(streamer != NULL);
+    rassert(sample != NULL);
+    rassert(sample->streamer == streamer);
+    rassert(start_pos >= 0);
+    rassert(gen != NULL);
+
+    for (int i = 0; i < SAMPLE_STREAMER_STREAMS_MAX; ++i)
+    {
+        Stream* stream = &streamer->streams[i];
+
+        if (!change_state(stream, STREAM_FREE, STREAM_OPENING))
+            continue;
+
+        stream->sample = sample;
+        stream->loop = loop;
+        stream->loop_start = loop_start;
+        stream->loop_end = loop_end;
+        stream->read_pos = start_pos;
+        stream->ring_start = start_pos;
+        stream->fill_end = start_pos;
+        stream->access_count = stream->seen_access_count + 1;
+        stream->idle_refills = 0;
+
+        *gen = SHARED_LOAD(&stream->gen, seq_cst);
+        SHARED_STORE(&stream->state, STREAM_OPEN, release);
+
+        return i;
+    }
+
+    return -1;
+}
+
+
+bool Sample_streamer_get_view(
+        Sample_streamer* streamer, int stream_index, int gen, Sample_stream_view* view)
+{
+    rassert(streamer != NULL);
+    rassert(stream_index >= 0);
+    rassert(stream_index < SAMPLE_STREAMER_STREAMS_MAX);
+    rassert(view != NULL);
+
+    Stream* stream = &streamer->streams[stream_index];
+    if ((SHARED_LOAD(&stream->state, acquire) != STREAM_OPEN) ||
+            (SHARED_LOAD(&stream->gen, seq_cst) != gen))
+        return false;
+
+    SHARED_ADD(&stream->access_count, 1);
+
+    const int64_t fill_end = SHARED_LOAD(&stream->fill_end, acquire);
+    const int64_t ring_start = SHARED_LOAD(&stream->ring_start, relaxed);
+
+    view->start = max(ring_start, fill_end - SAMPLE_STREAMER_RING_LEN);
+    view->stop = max(view->start, fill_end);
+    view->ring[0] = stream->ring[0];
+    view->ring[1] = stream->ring[1];
+
+    return true;
+}
+
+
+void Sample_streamer_advance(
+        Sample_streamer* streamer, int stream_index, int gen, int64_t pos)
+{
+    rassert(streamer != NULL);
+    rassert(stream_index >= 0);
+    rassert(stream_index < SAMPLE_STREAMER_STREAMS_MAX);
+    rassert(pos >= 0);
+
+    Stream* stream = &streamer->streams[stream_index];
+    if (SHARED_LOAD(&stream->gen, seq_cst) != gen)
+        return;
+
+    SHARED_STORE(&stream->read_pos, pos, release);
+
+    return;
+}
+
+
+void Sample_streamer_close_stream(Sample_streamer* streamer, int stream_index, int gen)
+{
+    rassert(streamer != NULL);
+    rassert(stream_index >= 0);
+    rassert(stream_index < SAMPLE_STREAMER_STREAMS_MAX);
+
+    Stream* stream = &streamer->streams[stream_index];
+    if (SHARED_LOAD(&stream->gen, seq_cst) != gen)
+        return;
+
+    // The I/O thread frees the stream so that we never reset it during refill
+    change_state(stream, STREAM_OPEN, STREAM_CLOSING);
+
+    return;
+}
+
+
+void Sample_streamer_refill(Sample_streamer* streamer)
+{
+    rassert(streamer != NULL);
+
+#ifdef ENABLE_THREADS
+    Mutex* cond_mutex = Condition_get_mutex(&streamer->refill_cond);
+    Mutex_lock(cond_mutex);
+    streamer->refill_requested = true;
+    Condition_broadcast(&streamer->refill_cond);
+    Mutex_unlock(cond_mutex);
+#else
+    refill_streams(streamer);
+#endif
+
+    return;
+}
+
+
+int64_t Sample_streamer_get_underrun_count(const Sample_streamer* streamer)
+{
+    rassert(streamer != NULL);
+    return SHARED_LOAD(&streamer->underrun_count, seq_cst);
+}
+
+
+void Sample_streamer_add_underruns(Sample_streamer* streamer, int64_t count)
+{
+    rassert(streamer != NULL);
+    rassert(count >= 0);
+
+    if (count > 0)
+        SHARED_ADD(&streamer->underrun_count, count);
+
+    return;
+}
+
+
+void del_Sample_streamer(Sample_streamer* streamer)
+{
+    if (streamer == NULL)
+        return;
+
+    rassert(streamer->sample_count == 0);
+
+#ifdef ENABLE_THREADS
+    if (Thread_is_initialised(&streamer->io_thread))
+    {
+        Mutex* cond_mutex = Condition_get_mutex(&streamer->refill_cond);
+        Mutex_lock(cond_mutex);
+        streamer->stop_thread = true;
+        Condition_broadcast(&streamer->refill_cond);
+        Mutex_unlock(cond_mutex);
+
+        Thread_join(&streamer->io_thread);
+    }
+
+    Condition_deinit(&streamer->refill_cond);
+    Mutex_deinit(&streamer->lock);
+#endif
+
+    if (streamer->cache != NULL)
+        fclose(streamer->cache);
+
+    if (streamer->cache_path != NULL)
+    {
+        remove(streamer->cache_path);
+        memory_free(streamer->cache_path);
+    }
+
+    for (int i = 0; i < SAMPLE_STREAMER_STREAMS_MAX; ++i)
+    {
+        memory_free(streamer->streams[i].ring[0]);
+        memory_free(streamer->streams[i].ring[1]);
+    }
+
+    memory_free(streamer);
+
+    return;
+}
+
+
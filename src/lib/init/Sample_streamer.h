@@ -0,0 +1,260 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_SAMPLE_STREAMER_H
+#define KQT_SAMPLE_STREAMER_H
+
+
+#include <decl.h>
+#include <Error.h>
+#include <init/devices/param_types/Sample_params.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * Sample streamer keeps only the beginning of long Samples in memory and
+ * stores the remaining frames in a cache file.
+ *
+ * During playback, each voice that reaches the end of the resident part
+ * opens a stream. A background I/O thread reads the frames ahead of the
+ * playback position of each open stream into a ring buffer in the order
+ * they will be played, including loops. If the thread falls behind, the
+ * missing frames are rendered as silence. Without thread support, the
+ * streams are refilled in the rendering thread instead.
+ */
+
+
+#define SAMPLE_STREAMER_STREAMS_MAX 256
+#define SAMPLE_STREAMER_RING_LEN 16384
+
+
+/**
+ * A view to the frames currently available in a stream.
+ */
+typedef struct Sample_stream_view
+{
+    int64_t start;        ///< The first available frame in playback order.
+    int64_t stop;         ///< The first frame not yet available.
+    const float* ring[2]; ///< The ring buffers, indexed by the frame modulo ring length.
+} Sample_stream_view;
+
+
+/**
+ * Create a new Sample streamer.
+ *
+ * \param preload_len   The number of frames kept in memory for each Sample
+ *                      -- must be > \c 0.
+ * \param cache_dir     The directory of the cache file, or \c NULL or an
+ *                      empty string if a temporary file should be used.
+ * \param error         Destination for error information -- must not be
+ *                      \c NULL.
+ *
+ * \return   The new Sample streamer if successful, otherwise \c NULL.
+ */
+Sample_streamer* new_Sample_streamer(
+        int64_t preload_len, const char* cache_dir, Error* error);
+
+
+/**
+ * Get the number of frames kept in memory for each Sample.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ *
+ * \return   The preload length.
+ */
+int64_t Sample_streamer_get_preload_len(const Sample_streamer* streamer);
+
+
+/**
+ * Find out whether the Sample streamer holds data of existing Samples.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ *
+ * \return   \c true if any Sample is using \a streamer, otherwise \c false.
+ */
+bool Sample_streamer_has_samples(const Sample_streamer* streamer);
+
+
+/**
+ * Reserve cache space for the frames of a Sample beyond the preload length.
+ *
+ * If the Sample is longer than the preload length, this function sets the
+ * resident length and the streamer of \a sample. The caller should then
+ * allocate only the resident part of the sample data and pass the remaining
+ * frames to \a Sample_streamer_write.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ * \param sample     The Sample -- must not be \c NULL and must have its
+ *                   length and format set.
+ */
+void Sample_streamer_reserve(Sample_streamer* streamer, Sample* sample);
+
+
+/**
+ * Write streamed frames of a Sample into the cache file.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ * \param sample     The Sample -- must not be \c NULL and must have cache
+ *                   space reserved in \a streamer.
+ * \param ch         The channel number -- must be >= \c 0 and less than the
+ *                   number of channels in \a sample.
+ * \param start      The first frame to be written -- must be >= the resident
+ *                   length of \a sample.
+ * \param count      The number of frames to be written -- must be >= \c 0
+ *                   and must not exceed the length of \a sample.
+ * \param data       The frames in the format of \a sample -- must not be
+ *                   \c NULL.
+ * \param error      Destination for error information -- must not be
+ *                   \c NULL.
+ *
+ * \return   \c true if successful, otherwise \c false.
+ */
+bool Sample_streamer_write(
+        Sample_streamer* streamer,
+        const Sample* sample,
+        int ch,
+        int64_t start,
+        int64_t count,
+        const void* data,
+        Error* error);
+
+
+/**
+ * Release all resources of a Sample in the Sample streamer.
+ *
+ * This function is called when \a sample is destroyed. All streams of
+ * \a sample are closed.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ * \param sample     The Sample -- must not be \c NULL.
+ */
+void Sample_streamer_release_sample(Sample_streamer* streamer, const Sample* sample);
+
+
+/**
+ * Open a stream for playing a Sample.
+ *
+ * This function does not block and may be called from rendering threads.
+ *
+ * \param streamer    The Sample streamer -- must not be \c NULL.
+ * \param sample      The Sample -- must not be \c NULL and must use
+ *                    \a streamer.
+ * \param loop        The loop mode used for playback.
+ * \param loop_start  The loop start position.
+ * \param loop_end    The loop end position.
+ * \param start_pos   The playback position where streaming starts
+ *                    -- must be >= \c 0.
+ * \param gen         Destination for the stream generation -- must not be
+ *                    \c NULL.
+ *
+ * \return   The stream number, or \c -1 if all streams are in use.
+ */
+int Sample_streamer_open_stream(
+        Sample_streamer* streamer,
+        const Sample* sample,
+        Sample_loop loop,
+        int64_t loop_start,
+        int64_t loop_end,
+        int64_t start_pos,
+        int* gen);
+
+
+/**
+ * Get the frames available in a stream.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ * \param stream     The stream number -- must be >= \c 0 and
+ *                   < \c SAMPLE_STREAMER_STREAMS_MAX.
+ * \param gen        The stream generation returned by
+ *                   \a Sample_streamer_open_stream.
+ * \param view       The destination view -- must not be \c NULL.
+ *
+ * \return   \c true if the stream is still open, or \c false if it has been
+ *           closed by the Sample streamer.
+ */
+bool Sample_streamer_get_view(
+        Sample_streamer* streamer, int stream, int gen, Sample_stream_view* view);
+
+
+/**
+ * Notify the Sample streamer about the current playback position of a stream.
+ *
+ * Frames before \a pos may be overwritten after this call.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ * \param stream     The stream number -- must be >= \c 0 and
+ *                   < \c SAMPLE_STREAMER_STREAMS_MAX.
+ * \param gen        The stream generation.
+ * \param pos        The new playback position -- must be >= \c 0.
+ */
+void Sample_streamer_advance(Sample_streamer* streamer, int stream, int gen, int64_t pos);
+
+
+/**
+ * Close a stream.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ * \param stream     The stream number -- must be >= \c 0 and
+ *                   < \c SAMPLE_STREAMER_STREAMS_MAX.
+ * \param gen        The stream generation.
+ */
+void Sample_streamer_close_stream(Sample_streamer* streamer, int stream, int gen);
+
+
+/**
+ * Refill the ring buffers of open streams.
+ *
+ * This function should be called after rendering each audio buffer. With
+ * thread support, the refill is done by the I/O thread of the Sample streamer
+ * and this function returns immediately.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ */
+void Sample_streamer_refill(Sample_streamer* streamer);
+
+
+/**
+ * Get the number of frames that were not available during playback.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ *
+ * \return   The number of frames rendered as silence due to I/O delays.
+ */
+int64_t Sample_streamer_get_underrun_count(const Sample_streamer* streamer);
+
+
+/**
+ * Add to the number of frames that were not available during playback.
+ *
+ * \param streamer   The Sample streamer -- must not be \c NULL.
+ * \param count      The number of missing frames -- must be >= \c 0.
+ */
+void Sample_streamer_add_underruns(Sample_streamer* streamer, int64_t count);
+
+
+/**
+ * Destroy an existing Sample streamer.
+ *
+ * \param streamer   The Sample streamer, or \c NULL. No Sample may be using
+ *                   \a streamer.
+ */
+void del_Sample_streamer(Sample_streamer* streamer);
+
+
+#endif // KQT_SAMPLE_STREAMER_H
+
+
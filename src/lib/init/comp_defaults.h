@@ -17,6 +17,7 @@
 
 
 #define COMP_DEFAULT_MIX_VOL -8
+#define COMP_DEFAULT_CONTROL_PERIOD 1
 
 
 #endif // KQT_COMP_DEFAULTS_H
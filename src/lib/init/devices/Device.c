@@ -334,6 +334,25 @@ bool Device_set_key(
 }
 
 
+bool Device_set_float_key(
+        Device* device, const char* key, double value, Background_loader* bkg_loader)
+{
+    rassert(device != NULL);
+    rassert(key != NULL);
+    rassert(string_has_prefix(key, "i/") || string_has_prefix(key, "c/"));
+    rassert(isfinite(value));
+    rassert(bkg_loader != NULL);
+
+    if (!Device_params_set_float(device->dparams, key, value))
+        return false;
+
+    if ((device->dimpl != NULL) && !Device_impl_set_key(device->dimpl, key + 2, bkg_loader))
+        return false;
+
+    return true;
+}
+
+
 bool Device_set_state_key(
         const Device* device,
         Device_states* dstates,
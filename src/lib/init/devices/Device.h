@@ -248,6 +248,24 @@ bool Device_set_key(
         Background_loader* bkg_loader);
 
 
+/**
+ * Set a floating-point key in the Device.
+ *
+ * This is equivalent to \a Device_set_key with the value given in binary
+ * form.
+ *
+ * \param device       The Device -- must not be \c NULL.
+ * \param key          The key that changed -- must not be \c NULL and must
+ *                     be of floating-point type.
+ * \param value        The new value -- must be finite.
+ * \param bkg_loader   The Background loader -- must not be \c NULL.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Device_set_float_key(
+        Device* device, const char* key, double value, Background_loader* bkg_loader);
+
+
 /**
  * Notify a Device state of a Device key change.
  *
@@ -21,6 +21,7 @@
 #include <memory.h>
 #include <string/common.h>
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -418,6 +419,19 @@ int Device_field_cmp(const Device_field* field1, const Device_field* field2)
 }
 
 
+void Device_field_set_float(Device_field* field, double value)
+{
+    rassert(field != NULL);
+    rassert(field->type == DEVICE_FIELD_FLOAT);
+    rassert(isfinite(value));
+
+    field->data.float_type = value;
+    field->empty = false;
+
+    return;
+}
+
+
 void Device_field_set_empty(Device_field* field, bool empty)
 {
     rassert(field != NULL);
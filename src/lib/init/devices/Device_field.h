@@ -165,6 +165,16 @@ bool Device_field_get_empty(const Device_field* field);
 //bool Device_field_modify(Device_field* field, void* data);
 
 
+/**
+ * Set the value of a floating-point Device field.
+ *
+ * \param field   The Device field -- must not be \c NULL and must be of type
+ *                \c DEVICE_FIELD_FLOAT.
+ * \param value   The new value -- must be finite.
+ */
+void Device_field_set_float(Device_field* field, double value);
+
+
 /**
  * Get a reference to a boolean value from the Device field.
  *
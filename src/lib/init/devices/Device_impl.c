@@ -28,8 +28,11 @@
 #include <string.h>
 
 
-typedef struct Set_cb
+struct Set_cb
 {
+    Set_cb* next;
+    uint32_t hash;
+    Device_field_type field_type;
     char key_pattern[KQT_KEY_LENGTH_MAX];
 
     union
@@ -57,7 +60,7 @@ typedef struct Set_cb
 #undef cb_info
     } cb;
 
-} Set_cb;
+};
 
 
 bool Device_impl_init(Device_impl* dimpl, Device_impl_destroy_func* destroy)
@@ -75,17 +78,53 @@ bool Device_impl_init(Device_impl* dimpl, Device_impl_destroy_func* destroy)
     dimpl->fire_voice_dev_event = NULL;
     dimpl->destroy = destroy;
 
-    dimpl->set_cbs = NULL;
+    for (int i = 0; i < DEVICE_IMPL_SET_CB_BUCKETS; ++i)
+        dimpl->set_cbs[i] = NULL;
 
-    dimpl->set_cbs = new_AAtree(
-            (AAtree_item_cmp*)strcmp, (AAtree_item_destroy*)memory_free);
-    if (dimpl->set_cbs == NULL)
+    return true;
+}
+
+
+static const Set_cb* Device_impl_get_set_cb(const Device_impl* dimpl, const char* keyp)
+{
+    rassert(dimpl != NULL);
+    rassert(keyp != NULL);
+
+    const uint32_t hash = string_hash(keyp);
+    const Set_cb* set_cb = dimpl->set_cbs[hash % DEVICE_IMPL_SET_CB_BUCKETS];
+    while (set_cb != NULL)
     {
-        Device_impl_deinit(dimpl);
-        return false;
+        if ((set_cb->hash == hash) && string_eq(set_cb->key_pattern, keyp))
+            return set_cb;
+
+        set_cb = set_cb->next;
     }
 
-    return true;
+    return NULL;
+}
+
+
+static Set_cb* Device_impl_add_set_cb(Device_impl* dimpl, const char* keyp)
+{
+    rassert(dimpl != NULL);
+    rassert(keyp != NULL);
+    rassert(strlen(keyp) < KQT_KEY_LENGTH_MAX);
+    rassert(Device_impl_get_set_cb(dimpl, keyp) == NULL);
+
+    Set_cb* set_cb = memory_alloc_item(Set_cb);
+    if (set_cb == NULL)
+        return NULL;
+
+    strcpy(set_cb->key_pattern, keyp);
+    set_cb->hash = string_hash(keyp);
+    set_cb->field_type = get_keyp_device_field_type(keyp);
+    rassert(set_cb->field_type != DEVICE_FIELD_NONE);
+
+    const uint32_t bucket = set_cb->hash % DEVICE_IMPL_SET_CB_BUCKETS;
+    set_cb->next = dimpl->set_cbs[bucket];
+    dimpl->set_cbs[bucket] = set_cb;
+
+    return set_cb;
 }
 
 
@@ -155,21 +194,14 @@ int32_t Device_impl_get_voice_wb_size(const Device_impl* dimpl, int32_t audio_ra
         rassert(strlen(keyp) < KQT_KEY_LENGTH_MAX);               \
         rassert(set_func != NULL);                                \
                                                                   \
-        Set_cb* set_cb = memory_alloc_item(Set_cb);               \
+        Set_cb* set_cb = Device_impl_add_set_cb(dimpl, keyp);     \
         if (set_cb == NULL)                                       \
             return false;                                         \
                                                                   \
-        strcpy(set_cb->key_pattern, keyp);                        \
         set_cb->cb.type_name ## _type.default_val = default_val;  \
         set_cb->cb.type_name ## _type.set = set_func;             \
         set_cb->cb.type_name ## _type.set_state = set_state_func; \
                                                                   \
-        if (!AAtree_ins(dimpl->set_cbs, set_cb))                  \
-        {                                                         \
-            memory_free(set_cb);                                  \
-            return false;                                         \
-        }                                                         \
-                                                                  \
         return true;                                              \
     }
 
@@ -192,21 +224,14 @@ bool Device_impl_register_set_tstamp(
     rassert(strlen(keyp) < KQT_KEY_LENGTH_MAX);
     rassert(set_func != NULL);
 
-    Set_cb* set_cb = memory_alloc_item(Set_cb);
+    Set_cb* set_cb = Device_impl_add_set_cb(dimpl, keyp);
     if (set_cb == NULL)
         return false;
 
-    strcpy(set_cb->key_pattern, keyp);
     Tstamp_copy(&set_cb->cb.tstamp_type.default_val, default_val);
     set_cb->cb.tstamp_type.set = set_func;
     set_cb->cb.tstamp_type.set_state = set_state_func;
 
-    if (!AAtree_ins(dimpl->set_cbs, set_cb))
-    {
-        memory_free(set_cb);
-        return false;
-    }
-
     return true;
 }
 
@@ -223,21 +248,14 @@ bool Device_impl_register_set_envelope(
     rassert(strlen(keyp) < KQT_KEY_LENGTH_MAX);
     rassert(set_func != NULL);
 
-    Set_cb* set_cb = memory_alloc_item(Set_cb);
+    Set_cb* set_cb = Device_impl_add_set_cb(dimpl, keyp);
     if (set_cb == NULL)
         return false;
 
-    strcpy(set_cb->key_pattern, keyp);
     set_cb->cb.envelope_type.default_val = default_val;
     set_cb->cb.envelope_type.set = set_func;
     set_cb->cb.envelope_type.set_state = set_state_func;
 
-    if (!AAtree_ins(dimpl->set_cbs, set_cb))
-    {
-        memory_free(set_cb);
-        return false;
-    }
-
     return true;
 }
 
@@ -254,21 +272,14 @@ bool Device_impl_register_set_sample(
     rassert(strlen(keyp) < KQT_KEY_LENGTH_MAX);
     rassert(set_func != NULL);
 
-    Set_cb* set_cb = memory_alloc_item(Set_cb);
+    Set_cb* set_cb = Device_impl_add_set_cb(dimpl, keyp);
     if (set_cb == NULL)
         return false;
 
-    strcpy(set_cb->key_pattern, keyp);
     set_cb->cb.sample_type.default_val = default_val;
     set_cb->cb.sample_type.set = set_func;
     set_cb->cb.sample_type.set_state = set_state_func;
 
-    if (!AAtree_ins(dimpl->set_cbs, set_cb))
-    {
-        memory_free(set_cb);
-        return false;
-    }
-
     return true;
 }
 
@@ -285,21 +296,14 @@ bool Device_impl_register_set_num_list(
     rassert(strlen(keyp) < KQT_KEY_LENGTH_MAX);
     rassert(set_func != NULL);
 
-    Set_cb* set_cb = memory_alloc_item(Set_cb);
+    Set_cb* set_cb = Device_impl_add_set_cb(dimpl, keyp);
     if (set_cb == NULL)
         return false;
 
-    strcpy(set_cb->key_pattern, keyp);
     set_cb->cb.num_list_type.default_val = default_val;
     set_cb->cb.num_list_type.set = set_func;
     set_cb->cb.num_list_type.set_state = set_state_func;
 
-    if (!AAtree_ins(dimpl->set_cbs, set_cb))
-    {
-        memory_free(set_cb);
-        return false;
-    }
-
     return true;
 }
 
@@ -316,21 +320,14 @@ bool Device_impl_register_set_padsynth_params(
     rassert(strlen(keyp) < KQT_KEY_LENGTH_MAX);
     rassert(set_func != NULL);
 
-    Set_cb* set_cb = memory_alloc_item(Set_cb);
+    Set_cb* set_cb = Device_impl_add_set_cb(dimpl, keyp);
     if (set_cb == NULL)
         return false;
 
-    strcpy(set_cb->key_pattern, keyp);
     set_cb->cb.padsynth_params_type.default_val = default_val;
     set_cb->cb.padsynth_params_type.set = set_func;
     set_cb->cb.padsynth_params_type.set_state = set_state_func;
 
-    if (!AAtree_ins(dimpl->set_cbs, set_cb))
-    {
-        memory_free(set_cb);
-        return false;
-    }
-
     return true;
 }
 
@@ -350,7 +347,7 @@ bool Device_impl_set_key(
 
     extract_key_pattern(key, keyp, indices);
 
-    const Set_cb* set_cb = AAtree_get_exact(dimpl->set_cbs, keyp);
+    const Set_cb* set_cb = Device_impl_get_set_cb(dimpl, keyp);
     if (set_cb != NULL)
     {
 #define SET_FIELD(type_name, type)                                         \
@@ -373,11 +370,7 @@ bool Device_impl_set_key(
         }                                                                  \
         else ignore(0)
 
-        const Device_field_type dftype = get_keyp_device_field_type(
-                set_cb->key_pattern);
-        rassert(dftype != DEVICE_FIELD_NONE);
-
-        switch (dftype)
+        switch (set_cb->field_type)
         {
             case DEVICE_FIELD_BOOL:
                 SET_FIELD(bool, bool);
@@ -461,7 +454,7 @@ bool Device_impl_set_state_key(
 
     extract_key_pattern(key, keyp, indices);
 
-    const Set_cb* set_cb = AAtree_get_exact(dimpl->set_cbs, keyp);
+    const Set_cb* set_cb = Device_impl_get_set_cb(dimpl, keyp);
     if (set_cb != NULL)
     {
 #define SET_FIELD(type_name, type)                                                    \
@@ -486,10 +479,7 @@ bool Device_impl_set_state_key(
         }                                                                             \
         else ignore(0)
 
-        const Device_field_type dftype = get_keyp_device_field_type(set_cb->key_pattern);
-        rassert(dftype != DEVICE_FIELD_NONE);
-
-        switch (dftype)
+        switch (set_cb->field_type)
         {
             case DEVICE_FIELD_BOOL:
                 SET_FIELD(bool, bool);
@@ -558,8 +548,18 @@ void Device_impl_deinit(Device_impl* dimpl)
 {
     rassert(dimpl != NULL);
 
-    del_AAtree(dimpl->set_cbs);
-    dimpl->set_cbs = NULL;
+    for (int i = 0; i < DEVICE_IMPL_SET_CB_BUCKETS; ++i)
+    {
+        Set_cb* set_cb = dimpl->set_cbs[i];
+        while (set_cb != NULL)
+        {
+            Set_cb* next = set_cb->next;
+            memory_free(set_cb);
+            set_cb = next;
+        }
+
+        dimpl->set_cbs[i] = NULL;
+    }
 
     return;
 }
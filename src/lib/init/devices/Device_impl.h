@@ -16,7 +16,6 @@
 #define KQT_DEVICE_IMPL_H
 
 
-#include <containers/AAtree.h>
 #include <decl.h>
 #include <init/devices/param_types/Envelope.h>
 #include <init/devices/param_types/Hit_map.h>
@@ -64,6 +63,12 @@ typedef bool (Set_state_padsynth_params_func)(
         Device_state*, const Key_indices, const Padsynth_params*);
 
 
+#define DEVICE_IMPL_SET_CB_BUCKETS 64
+
+
+typedef struct Set_cb Set_cb;
+
+
 typedef int32_t Device_impl_get_voice_wb_size_func(
         const Device_impl*, int32_t audio_rate);
 typedef void Device_impl_destroy_func(Device_impl*);
@@ -75,7 +80,7 @@ typedef void Device_impl_destroy_func(Device_impl*);
 struct Device_impl
 {
     const Device* device;
-    AAtree* set_cbs;
+    Set_cb* set_cbs[DEVICE_IMPL_SET_CB_BUCKETS]; // hashed by key pattern
 
     Proc_type proc_type;
 
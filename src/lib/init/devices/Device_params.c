@@ -116,13 +116,8 @@ bool key_is_device_param(const char* key)
 {
     rassert(key != NULL);
 
-    if (key_is_text_device_param(key))
-        return true;
-
-    const Device_field_type type = get_keyp_device_field_type(key);
-    return (type == DEVICE_FIELD_WAVPACK) ||
-        (type == DEVICE_FIELD_WAV) ||
-        (type == DEVICE_FIELD_VORBIS);
+    // All field types are either text or sample data
+    return get_keyp_device_field_type(key) != DEVICE_FIELD_NONE;
 }
 
 
@@ -238,6 +233,38 @@ bool Device_params_parse_value(
 }
 
 
+bool Device_params_set_float(Device_params* params, const char* key, double value)
+{
+    rassert(params != NULL);
+    rassert(key != NULL);
+    rassert(string_has_prefix(key, "i/") || string_has_prefix(key, "c/"));
+    rassert(get_keyp_device_field_type(key) == DEVICE_FIELD_FLOAT);
+    rassert(isfinite(value));
+
+    AAtree* tree = string_has_prefix(key, "i/") ? params->implement : params->config;
+    key = key + 2;
+
+    Device_field* field = AAtree_get_exact(tree, key);
+    if (field != NULL)
+    {
+        Device_field_set_float(field, value);
+        return true;
+    }
+
+    field = new_Device_field(key, &value);
+    if (field == NULL)
+        return false;
+
+    if (!AAtree_ins(tree, field))
+    {
+        del_Device_field(field);
+        return false;
+    }
+
+    return true;
+}
+
+
 #define get_of_type(params, key, ftype)                                      \
     if (true)                                                                \
     {                                                                        \
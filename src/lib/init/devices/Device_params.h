@@ -221,6 +221,22 @@ bool Device_params_parse_value(
         Background_loader* bkg_loader);
 
 
+/**
+ * Set a floating-point Device parameter value.
+ *
+ * This is equivalent to parsing a value of version \c 0 with
+ * \a Device_params_parse_value but does not use a textual representation.
+ *
+ * \param params   The Device parameters -- must not be \c NULL.
+ * \param key      The key -- must be a valid subkey with the i/ or c/ as
+ *                 the first component and must be of floating-point type.
+ * \param value    The new value -- must be finite.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Device_params_set_float(Device_params* params, const char* key, double value);
+
+
 /**
  * Modify an existing Device parameter value.
  *
@@ -15,6 +15,7 @@
 #include <init/devices/param_types/Envelope.h>
 
 #include <debug/assert.h>
+#include <mathnum/common.h>
 #include <memory.h>
 #include <string/common.h>
 
@@ -42,6 +43,13 @@ struct Envelope
     int nodes_res;
     int marks[ENVELOPE_MARKS_MAX];
     double* nodes;
+
+    // Compiled form, see Envelope_compile
+    bool is_compiled;
+    double grid_start;
+    double grid_scale;
+    int grid[ENVELOPE_GRID_SIZE];
+    double* slopes;
 };
 
 
@@ -65,8 +73,11 @@ Envelope* new_Envelope(int nodes_max,
         return NULL;
 
     env->nodes = memory_alloc_items(double, nodes_max * 2);
-    if (env->nodes == NULL)
+    env->slopes = memory_alloc_items(double, nodes_max);
+    if ((env->nodes == NULL) || (env->slopes == NULL))
     {
+        memory_free(env->nodes);
+        memory_free(env->slopes);
         memory_free(env);
         return NULL;
     }
@@ -90,6 +101,12 @@ Envelope* new_Envelope(int nodes_max,
     env->last_x_locked = false;
     env->last_y_locked = false;
 
+    env->is_compiled = false;
+    env->grid_start = 0;
+    env->grid_scale = 0;
+    for (int i = 0; i < ENVELOPE_GRID_SIZE; ++i)
+        env->grid[i] = 0;
+
     return env;
 }
 
@@ -177,7 +194,12 @@ bool Envelope_read(Envelope* env, Streader* sr)
 
     Envelope_set_interp(env, ENVELOPE_INT_LINEAR);
 
-    return Streader_read_dict(sr, read_env_item, env);
+    if (!Streader_read_dict(sr, read_env_item, env))
+        return false;
+
+    Envelope_compile(env);
+
+    return true;
 }
 
 
@@ -288,6 +310,7 @@ void Envelope_set_interp(Envelope* env, Envelope_int interp)
 //  rassert(interp >= ENVELOPE_INT_NEAREST);
     rassert(interp < ENVELOPE_INT_LAST);
     env->interp = interp;
+    env->is_compiled = false;
     return;
 }
 
@@ -325,6 +348,8 @@ int Envelope_set_node(Envelope* env, double x, double y)
     rassert(isfinite(x));
     rassert(isfinite(y));
 
+    env->is_compiled = false;
+
     if (env->node_count >= env->nodes_max)
     {
         rassert(env->node_count == env->nodes_max);
@@ -378,6 +403,8 @@ bool Envelope_del_node(Envelope* env, int index)
     rassert(env != NULL);
     rassert(index >= 0);
 
+    env->is_compiled = false;
+
     if (index >= env->node_count)
         return false;
 
@@ -425,6 +452,8 @@ double* Envelope_move_node(Envelope* env, int index, double x, double y)
     rassert(isfinite(x));
     rassert(isfinite(y));
 
+    env->is_compiled = false;
+
     if (index >= env->node_count)
         return NULL;
 
@@ -486,6 +515,99 @@ double* Envelope_move_node(Envelope* env, int index, double x, double y)
 }
 
 
+void Envelope_compile(Envelope* env)
+{
+    rassert(env != NULL);
+
+    env->is_compiled = false;
+
+    if ((env->node_count < 2) ||
+            ((env->interp != ENVELOPE_INT_NEAREST) &&
+             (env->interp != ENVELOPE_INT_LINEAR)))
+        return;
+
+    const int last = env->node_count - 1;
+    const double first_x = env->nodes[0];
+    const double last_x = env->nodes[last * 2];
+    if (!(first_x < last_x) || !isfinite(last_x - first_x))
+        return;
+
+    // Slopes are calculated exactly as in the search-based evaluation
+    for (int i = 0; i < last; ++i)
+    {
+        const double prev_x = env->nodes[i * 2];
+        const double prev_y = env->nodes[i * 2 + 1];
+        const double next_x = env->nodes[i * 2 + 2];
+        const double next_y = env->nodes[i * 2 + 3];
+        env->slopes[i] = (next_x > prev_x) ? (next_y - prev_y) / (next_x - prev_x) : 0;
+    }
+    env->slopes[last] = 0;
+
+    // Map each grid cell to the last node at or before the start of the cell
+    env->grid_start = first_x;
+    env->grid_scale = ENVELOPE_GRID_SIZE / (last_x - first_x);
+
+    int node_index = 0;
+    for (int cell = 0; cell < ENVELOPE_GRID_SIZE; ++cell)
+    {
+        const double cell_x = first_x + cell / env->grid_scale;
+        while ((node_index < last) && (env->nodes[node_index * 2 + 2] <= cell_x))
+            ++node_index;
+
+        env->grid[cell] = node_index;
+    }
+
+    env->is_compiled = true;
+
+    return;
+}
+
+
+static int Envelope_find_segment(const Envelope* env, double x, int segment)
+{
+    rassert(env != NULL);
+    rassert(env->is_compiled);
+    rassert(segment >= 0);
+    rassert(segment < env->node_count);
+
+    const int last = env->node_count - 1;
+    while ((segment < last) && (env->nodes[segment * 2 + 2] <= x))
+        ++segment;
+    while ((segment > 0) && (env->nodes[segment * 2] > x))
+        --segment;
+
+    return segment;
+}
+
+
+static int Envelope_get_grid_segment(const Envelope* env, double x)
+{
+    rassert(env != NULL);
+    rassert(env->is_compiled);
+
+    const int cell = clamp(
+            (int)((x - env->grid_start) * env->grid_scale), 0, ENVELOPE_GRID_SIZE - 1);
+
+    return Envelope_find_segment(env, x, env->grid[cell]);
+}
+
+
+static double Envelope_get_segment_value(const Envelope* env, double x, int segment)
+{
+    rassert(env != NULL);
+    rassert(env->is_compiled);
+
+    const double* node = env->nodes + segment * 2;
+    if ((segment == env->node_count - 1) || (x == node[0]))
+        return node[1];
+
+    if (env->interp == ENVELOPE_INT_NEAREST)
+        return (x - node[0] < node[2] - x) ? node[1] : node[3];
+
+    return node[1] + (x - node[0]) * env->slopes[segment];
+}
+
+
 double Envelope_get_value(const Envelope* env, double x)
 {
     rassert(env != NULL);
@@ -496,6 +618,9 @@ double Envelope_get_value(const Envelope* env, double x)
             || x > env->nodes[env->node_count * 2 - 2])
         return NAN;
 
+    if (env->is_compiled)
+        return Envelope_get_segment_value(env, x, Envelope_get_grid_segment(env, x));
+
     // Binary search the markers surrounding x
     int start = 0;
     int end = env->node_count - 1;
@@ -547,6 +672,91 @@ double Envelope_get_value(const Envelope* env, double x)
 }
 
 
+double Envelope_get_value_from(const Envelope* env, double x, int* segment)
+{
+    rassert(env != NULL);
+    rassert(isfinite(x));
+    rassert(segment != NULL);
+
+    if (!env->is_compiled)
+        return Envelope_get_value(env, x);
+
+    if (x < env->nodes[0] || x > env->nodes[env->node_count * 2 - 2])
+        return NAN;
+
+    if ((*segment >= 0) && (*segment < env->node_count))
+        *segment = Envelope_find_segment(env, x, *segment);
+    else
+        *segment = Envelope_get_grid_segment(env, x);
+
+    return Envelope_get_segment_value(env, x, *segment);
+}
+
+
+void Envelope_get_values(
+        const Envelope* env, const float* in_values, float* out_values, int32_t count)
+{
+    rassert(env != NULL);
+    rassert(env->node_count > 0);
+    rassert(in_values != NULL);
+    rassert(out_values != NULL);
+    rassert(count >= 0);
+
+    const double* nodes = env->nodes;
+    const int last = env->node_count - 1;
+    const double first_x = nodes[0];
+    const double last_x = nodes[last * 2];
+
+    if (!env->is_compiled)
+    {
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const double x = clamp((double)in_values[i], first_x, last_x);
+            out_values[i] = (float)Envelope_get_value(env, x);
+        }
+
+        return;
+    }
+
+    const double* slopes = env->slopes;
+    const int* grid = env->grid;
+    const double grid_start = env->grid_start;
+    const double grid_scale = env->grid_scale;
+
+    if (env->interp == ENVELOPE_INT_LINEAR)
+    {
+        // The slope of the last node is zero, so the end point needs no special case
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const double x = clamp((double)in_values[i], first_x, last_x);
+
+            const int cell = clamp(
+                    (int)((x - grid_start) * grid_scale), 0, ENVELOPE_GRID_SIZE - 1);
+            int segment = grid[cell];
+            while ((segment < last) && (nodes[segment * 2 + 2] <= x))
+                ++segment;
+            while ((segment > 0) && (nodes[segment * 2] > x))
+                --segment;
+
+            const double* node = nodes + segment * 2;
+            out_values[i] = (float)(node[1] + (x - node[0]) * slopes[segment]);
+        }
+    }
+    else
+    {
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const double x = clamp((double)in_values[i], first_x, last_x);
+
+            const int segment = Envelope_get_grid_segment(env, x);
+            out_values[i] = (float)Envelope_get_segment_value(env, x, segment);
+        }
+    }
+
+    return;
+}
+
+
 void Envelope_set_first_lock(Envelope* env, bool lock_x, bool lock_y)
 {
     rassert(env != NULL);
@@ -577,6 +787,7 @@ void del_Envelope(Envelope* env)
         return;
 
     memory_free(env->nodes);
+    memory_free(env->slopes);
     memory_free(env);
 
     return;
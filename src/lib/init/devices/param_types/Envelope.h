@@ -22,10 +22,12 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 
 #define ENVELOPE_MARKS_MAX (4)
+#define ENVELOPE_GRID_SIZE (64)
 
 
 /**
@@ -192,6 +194,56 @@ double* Envelope_move_node(Envelope* env, int index, double x, double y);
 double Envelope_get_value(const Envelope* env, double x);
 
 
+/**
+ * Compile the Envelope for fast evaluation.
+ *
+ * The compiled form consists of a uniform grid that maps positions to
+ * segments and the slopes of the segments. It is built automatically by
+ * \a Envelope_read and discarded by all functions that modify the
+ * Envelope. Code that modifies the nodes returned by \a Envelope_get_node
+ * must call this function afterwards. Envelopes that are not compiled are
+ * evaluated by searching the nodes.
+ *
+ * \param env   The Envelope -- must not be \c NULL.
+ */
+void Envelope_compile(Envelope* env);
+
+
+/**
+ * Get a value from the Envelope starting the search from a known segment.
+ *
+ * This function is faster than \a Envelope_get_value when consecutive
+ * calls use nearby positions.
+ *
+ * \param env       The Envelope -- must not be \c NULL.
+ * \param x         The x coordinate -- must be finite.
+ * \param segment   The index of the node that starts the segment used in
+ *                  the previous call, or \c -1 if unknown -- must not be
+ *                  \c NULL. This is updated if the Envelope is defined at
+ *                  \a x.
+ *
+ * \return   The value of y at the position \a x, or \c NAN if the Envelope
+ *           is undefined at \a x.
+ */
+double Envelope_get_value_from(const Envelope* env, double x, int* segment);
+
+
+/**
+ * Get values from the Envelope for a buffer of positions.
+ *
+ * \param env          The Envelope -- must not be \c NULL and must contain
+ *                     at least one node.
+ * \param in_values    The x coordinates -- must not be \c NULL. Values
+ *                     outside the range of x coordinates of the nodes are
+ *                     clamped to the range.
+ * \param out_values   The destination buffer for the values of y -- must
+ *                     not be \c NULL.
+ * \param count        The number of values -- must be >= \c 0.
+ */
+void Envelope_get_values(
+        const Envelope* env, const float* in_values, float* out_values, int32_t count);
+
+
 /**
  * Set the locking of the first node.
  *
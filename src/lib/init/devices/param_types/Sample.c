@@ -15,6 +15,7 @@
 #include <init/devices/param_types/Sample.h>
 
 #include <debug/assert.h>
+#include <init/Sample_streamer.h>
 #include <memory.h>
 
 #include <stdbool.h>
@@ -37,8 +38,11 @@ Sample* new_Sample(void)
     sample->bits = 16;
     sample->is_float = false;
     sample->len = 0;
+    sample->resident_len = 0;
     sample->data[0] = NULL;
     sample->data[1] = NULL;
+    sample->streamer = NULL;
+    sample->stream_offset = 0;
 
     return sample;
 }
@@ -59,6 +63,7 @@ Sample* new_Sample_from_buffers(float* buffers[], int count, int64_t length)
     sample->bits = 32;
     sample->is_float = true;
     sample->len = length;
+    sample->resident_len = length;
     for (int i = 0; i < count; ++i)
     {
         rassert(buffers[i] != NULL);
@@ -86,11 +91,21 @@ int64_t Sample_get_len(const Sample* sample)
 }
 
 
+int64_t Sample_get_resident_len(const Sample* sample)
+{
+    rassert(sample != NULL);
+    return sample->resident_len;
+}
+
+
 void del_Sample(Sample* sample)
 {
     if (sample == NULL)
         return;
 
+    if (sample->streamer != NULL)
+        Sample_streamer_release_sample(sample->streamer, sample);
+
     memory_free(sample->data[0]);
     memory_free(sample->data[1]);
     memory_free(sample);
@@ -37,7 +37,10 @@ struct Sample
     int bits;             ///< The bit resolution (8, 16, 24 or 32).
     bool is_float;        ///< Whether this sample is in floating point format.
     int64_t len;          ///< The length of the sample (in amplitude values per channel).
+    int64_t resident_len; ///< The number of amplitude values per channel stored in \a data.
     void* data[2];        ///< The sample data.
+    Sample_streamer* streamer; ///< The Sample streamer of the remaining data, or \c NULL.
+    int64_t stream_offset;     ///< The position of the remaining data in the stream cache.
 };
 
 
@@ -78,6 +81,19 @@ Sample* new_Sample_from_buffers(float* buffers[], int count, int64_t length);
 int64_t Sample_get_len(const Sample* sample);
 
 
+/**
+ * Get the number of frames of the Sample stored in memory.
+ *
+ * This is less than the length of the Sample if the remaining frames are
+ * streamed from a cache file by a Sample streamer.
+ *
+ * \param sample   The Sample -- must not be \c NULL.
+ *
+ * \return   The resident length in frames/buffer.
+ */
+int64_t Sample_get_resident_len(const Sample* sample);
+
+
 /**
  * Get a buffer from the Sample.
  *
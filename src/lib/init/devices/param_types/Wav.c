@@ -175,6 +175,7 @@ bool Sample_parse_wav(Sample* sample, Streader* sr)
     sample->bits = 32;
     sample->is_float = true;
     sample->len = sfinfo->frames;
+    sample->resident_len = sample->len;
     sample->data[0] = sample->data[1] = NULL;
 
     float* nbuf_l = memory_alloc_items(float, sample->len * (int)sizeof(float));
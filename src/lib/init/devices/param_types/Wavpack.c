@@ -16,7 +16,9 @@
 
 #include <debug/assert.h>
 #include <init/Background_loader.h>
+#include <init/Data_cache.h>
 #include <init/devices/param_types/Sample.h>
+#include <init/Sample_streamer.h>
 #include <mathnum/common.h>
 #include <memory.h>
 
@@ -219,6 +221,7 @@ typedef struct Callback_data
     void* copied_data;
     Sample* sample;
     String_context sc;
+    Data_cache* data_cache;
 } Callback_data;
 
 
@@ -238,6 +241,7 @@ static Callback_data* new_Callback_data(void)
     cb_data->context = NULL;
     cb_data->copied_data = NULL;
     cb_data->sample = NULL;
+    cb_data->data_cache = NULL;
 
     return cb_data;
 }
@@ -258,10 +262,10 @@ static void del_Callback_data(Callback_data* cb_data)
 }
 
 
-#define read_wp_samples(type, sample, src, count, offset, lshift)       \
+#define read_wp_samples(type, sample, dests, src, count, offset, lshift) \
     if (true)                                                           \
     {                                                                   \
-        type* sample_bufs[] = { sample->data[0], sample->data[1] };     \
+        type* sample_bufs[] = { dests[0], dests[1] };                   \
                                                                         \
         for (int ch = 0; ch < sample->channels; ++ch)                   \
         {                                                               \
@@ -271,6 +275,83 @@ static void del_Callback_data(Callback_data* cb_data)
         }                                                               \
     } else ignore(0)
 
+
+static bool store_staged_frames(
+        Sample* sample,
+        void* staged[2],
+        int64_t start,
+        int64_t count,
+        Error* error)
+{
+    rassert(sample != NULL);
+    rassert(sample->streamer != NULL);
+    rassert(staged != NULL);
+    rassert(start >= 0);
+    rassert(count > 0);
+    rassert(error != NULL);
+
+    const int bytes = sample->bits / 8;
+    const int64_t resident_count = clamp(sample->resident_len - start, 0, count);
+
+    for (int ch = 0; ch < sample->channels; ++ch)
+    {
+        const char* src = staged[ch];
+
+        if (resident_count > 0)
+        {
+            char* dest = sample->data[ch];
+            memcpy(dest + start * bytes, src, (size_t)(resident_count * bytes));
+        }
+
+        if (!Sample_streamer_write(
+                    sample->streamer,
+                    sample,
+                    ch,
+                    start + resident_count,
+                    count - resident_count,
+                    src + resident_count * bytes,
+                    error))
+            return false;
+    }
+
+    return true;
+}
+
+static bool load_cached_data(Sample* sample, const Data_cache_entry* entry, Error* error)
+{
+    rassert(sample != NULL);
+    rassert(entry != NULL);
+    rassert(error != NULL);
+
+    if ((Data_cache_entry_get_channels(entry) != sample->channels) ||
+            (Data_cache_entry_get_bits(entry) != sample->bits) ||
+            (Data_cache_entry_is_float(entry) != sample->is_float) ||
+            (Data_cache_entry_get_len(entry) != sample->len))
+        return false;
+
+    const int bytes = sample->bits / 8;
+
+    for (int ch = 0; ch < sample->channels; ++ch)
+    {
+        const char* src = Data_cache_entry_get_data(entry, ch);
+        memcpy(sample->data[ch], src, (size_t)(sample->resident_len * bytes));
+
+        if ((sample->streamer != NULL) &&
+                !Sample_streamer_write(
+                    sample->streamer,
+                    sample,
+                    ch,
+                    sample->resident_len,
+                    sample->len - sample->resident_len,
+                    src + sample->resident_len * bytes,
+                    error))
+            return false;
+    }
+
+    return true;
+}
+
+
 static void load_wavpack_data(Error* error, void* user_data)
 {
     rassert(error != NULL);
@@ -283,23 +364,62 @@ static void load_wavpack_data(Error* error, void* user_data)
 
     Sample* sample = cb_data->sample;
 
+    // Use previously decoded data if available
+    Data_cache_writer* cache_writer = NULL;
+    if (cb_data->data_cache != NULL)
+    {
+        Data_cache_key* key = Data_cache_key_init(
+                &(Data_cache_key){ .type = "" },
+                "wavpack1",
+                cb_data->sc.data,
+                cb_data->sc.length);
+
+        Data_cache_entry* entry = Data_cache_open_entry(cb_data->data_cache, key);
+        if (entry != NULL)
+        {
+            const bool loaded = load_cached_data(sample, entry, error);
+            del_Data_cache_entry(entry);
+            if (loaded || Error_is_set(error))
+                return;
+        }
+
+        cache_writer = new_Data_cache_writer(
+                cb_data->data_cache,
+                key,
+                sample->channels,
+                sample->bits,
+                sample->is_float,
+                sample->len);
+    }
+
     const int req_bytes = sample->bits / 8;
 
 #define WAVPACK_BUFFER_SIZE 256
 
     int32_t buf[WAVPACK_BUFFER_SIZE] = { 0 };
+
+    // Frames beyond the resident part are staged before writing them to the
+    // sample stream cache
+    int32_t staging[2][WAVPACK_BUFFER_SIZE] = { { 0 } };
+    void* staged[2] = { staging[0], staging[1] };
+
     int64_t read = WavpackUnpackSamples(
             cb_data->context, buf, (uint32_t)(WAVPACK_BUFFER_SIZE / sample->channels));
     int64_t written = 0;
     while (read > 0 && written < sample->len)
     {
+        const bool use_staging =
+            (sample->streamer != NULL) && (written + read > sample->resident_len);
+        void** dests = use_staging ? staged : sample->data;
+        const int64_t offset = use_staging ? 0 : written;
+
         if (req_bytes == 1)
         {
-            read_wp_samples(int8_t, sample, buf, read, written, 0);
+            read_wp_samples(int8_t, sample, dests, buf, read, offset, 0);
         }
         else if (req_bytes == 2)
         {
-            read_wp_samples(int16_t, sample, buf, read, written, 0);
+            read_wp_samples(int16_t, sample, dests, buf, read, offset, 0);
         }
         else
         {
@@ -307,23 +427,41 @@ static void load_wavpack_data(Error* error, void* user_data)
 
             if (sample->is_float)
             {
-                float* sample_bufs[] = { sample->data[0], sample->data[1] };
+                float* sample_bufs[] = { dests[0], dests[1] };
                 float* buf_float = (float*)buf;
 
                 for (int ch = 0; ch < sample->channels; ++ch)
                 {
                     for (int64_t i = 0; i < read; ++i)
-                        sample_bufs[ch][written + i] =
+                        sample_bufs[ch][offset + i] =
                             buf_float[i * sample->channels + ch];
                 }
             }
             else
             {
                 const int shift = (cb_data->bits == 24) ? 8 : 0;
-                read_wp_samples(int32_t, sample, buf, read, written, shift);
+                read_wp_samples(int32_t, sample, dests, buf, read, offset, shift);
             }
         }
 
+        const int64_t store_count = min(read, sample->len - written);
+
+        if (cache_writer != NULL)
+        {
+            for (int ch = 0; ch < sample->channels; ++ch)
+            {
+                const char* src = dests[ch];
+                Data_cache_writer_write(
+                        cache_writer, ch, written, store_count, src + offset * req_bytes);
+            }
+        }
+
+        if (use_staging && !store_staged_frames(sample, staged, written, store_count, error))
+        {
+            Data_cache_writer_finish(cache_writer, false);
+            return;
+        }
+
         written += read;
         read = WavpackUnpackSamples(
                 cb_data->context,
@@ -344,6 +482,8 @@ static void load_wavpack_data(Error* error, void* user_data)
                 "Couldn't read all sample data");
     }
 
+    Data_cache_writer_finish(cache_writer, !Error_is_set(error));
+
     return;
 }
 
@@ -370,6 +510,7 @@ static void cleanup_loader(Error* error, void* user_data)
         memory_free(sample->data[1]);
         sample->data[0] = sample->data[1] = NULL;
         sample->len = 0;
+        sample->resident_len = 0;
     }
 
     return;
@@ -468,9 +609,15 @@ bool Sample_parse_wavpack(Sample* sample, Streader* sr, Background_loader* bkg_l
         sample->bits = 32;
     }
 
+    // Keep only the beginning of long samples in memory if streaming is enabled
+    sample->resident_len = sample->len;
+    Sample_streamer* streamer = Background_loader_get_sample_streamer(bkg_loader);
+    if (streamer != NULL)
+        Sample_streamer_reserve(streamer, sample);
+
     const int req_bytes = sample->bits / 8;
     sample->data[0] = sample->data[1] = NULL;
-    void* nbuf_l = memory_alloc_items(char, sample->len * req_bytes);
+    void* nbuf_l = memory_alloc_items(char, sample->resident_len * req_bytes);
     if (nbuf_l == NULL)
     {
         del_Callback_data(cb_data);
@@ -480,7 +627,7 @@ bool Sample_parse_wavpack(Sample* sample, Streader* sr, Background_loader* bkg_l
 
     if (cb_data->channels == 2)
     {
-        void* nbuf_r = memory_alloc_items(char, sample->len * req_bytes);
+        void* nbuf_r = memory_alloc_items(char, sample->resident_len * req_bytes);
         if (nbuf_r == NULL)
         {
             memory_free(nbuf_l);
@@ -496,6 +643,7 @@ bool Sample_parse_wavpack(Sample* sample, Streader* sr, Background_loader* bkg_l
     sample->data[0] = nbuf_l;
 
     cb_data->sample = sample;
+    cb_data->data_cache = Background_loader_get_data_cache(bkg_loader);
 
     Background_loader_task* task =
         MAKE_BACKGROUND_LOADER_TASK(load_wavpack_data, cleanup_loader, cb_data);
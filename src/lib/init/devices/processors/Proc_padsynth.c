@@ -18,6 +18,8 @@
 #include <containers/Array.h>
 #include <debug/assert.h>
 #include <init/Background_loader.h>
+#include <init/Data_cache.h>
+#include <init/devices/param_types/Envelope.h>
 #include <init/devices/param_types/Padsynth_params.h>
 #include <init/devices/Proc_cons.h>
 #include <init/devices/processors/Proc_init_utils.h>
@@ -33,6 +35,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 static Set_padsynth_params_func Proc_padsynth_set_params;
@@ -475,10 +478,97 @@ static double get_profile_bound(double bandwidth_i)
 }
 
 
-static double get_phase_spread(double freq_i, double bandwidth_i)
+/**
+ * Gaussian iterator evaluates scale * exp(-x^2) at evenly spaced points.
+ *
+ * Consecutive values are obtained with two multiplications using the ratio
+ * exp(-(x + d)^2) / exp(-x^2) = exp(-2xd - d^2), which itself changes by the
+ * constant factor exp(-2d^2) at each step. The recurrence is started when x
+ * gets close enough to the centre for the ratio to remain finite.
+ */
+typedef struct Gaussian_iter
+{
+    double x;
+    double x_step;
+    double scale;
+    bool is_started;
+    double value;
+    double ratio;
+    double ratio_mult;
+} Gaussian_iter;
+
+
+#define GAUSSIAN_ITER_X_MAX 26.0 // exp(-26^2) is still a normal double
+
+
+static void Gaussian_iter_init(
+        Gaussian_iter* iter, double x_start, double x_step, double scale)
+{
+    rassert(iter != NULL);
+    rassert(isfinite(x_start));
+    rassert(isfinite(x_step));
+    rassert(x_step >= 0);
+
+    iter->x = x_start;
+    iter->x_step = x_step;
+    iter->scale = scale;
+    iter->is_started = false;
+    iter->value = 0;
+    iter->ratio = 0;
+    iter->ratio_mult = 0;
+
+    return;
+}
+
+
+static double Gaussian_iter_next(Gaussian_iter* iter)
 {
-    const double x = freq_i / bandwidth_i;
-    return 1.0 - exp(-x * x);
+    rassert(iter != NULL);
+
+    if (!iter->is_started)
+    {
+        if (iter->x < -GAUSSIAN_ITER_X_MAX)
+        {
+            iter->x += iter->x_step;
+            return 0.0;
+        }
+
+        const double x = iter->x;
+        const double d = iter->x_step;
+        iter->value = iter->scale * exp(-x * x);
+        iter->ratio = exp(-(2.0 * x * d) - (d * d));
+        iter->ratio_mult = exp(-2.0 * d * d);
+        iter->is_started = true;
+    }
+
+    const double value = iter->value;
+    iter->value *= iter->ratio;
+    iter->ratio *= iter->ratio_mult;
+
+    return value;
+}
+
+
+#undef GAUSSIAN_ITER_X_MAX
+
+
+static void Gaussian_iter_init_profile(
+        Gaussian_iter* iter,
+        int32_t start,
+        int32_t sample_length,
+        double freq_i,
+        double bandwidth_i,
+        double scale)
+{
+    rassert(iter != NULL);
+    rassert(sample_length > 0);
+    rassert(bandwidth_i > 0);
+
+    const double x_start = ((start / (double)sample_length) - freq_i) / bandwidth_i;
+    const double x_step = 1.0 / (sample_length * bandwidth_i);
+    Gaussian_iter_init(iter, x_start, x_step, scale);
+
+    return;
 }
 
 
@@ -490,6 +580,7 @@ typedef struct Callback_data
     double* freq_phase;
     FFT_worker fw;
     const Padsynth_params* params;
+    Data_cache* data_cache;
 } Callback_data;
 
 
@@ -519,6 +610,7 @@ static Callback_data* new_Callback_data(const Padsynth_params* params)
     cb_data->freq_amp = NULL;
     cb_data->freq_phase = NULL;
     cb_data->params = params;
+    cb_data->data_cache = NULL;
 
     int32_t sample_length = PADSYNTH_DEFAULT_SAMPLE_LENGTH;
     if (params != NULL)
@@ -551,6 +643,92 @@ static void cleanup_cb_data(Error* error, void* user_data)
 }
 
 
+static bool make_cache_key(Data_cache_key* key, const Callback_data* cb_data)
+{
+    rassert(key != NULL);
+    rassert(cb_data != NULL);
+    rassert(cb_data->params != NULL);
+
+    const Padsynth_params* params = cb_data->params;
+    const Envelope* res_env = params->is_res_env_enabled ? params->res_env : NULL;
+
+    const int env_node_count = (res_env != NULL) ? Envelope_node_count(res_env) : 0;
+    const int64_t harmonic_count = Array_get_size(params->harmonics);
+
+    // Collect everything that affects the generated sample
+    const int64_t value_count = 14 + env_node_count * 2 + harmonic_count * 3;
+    double* values = memory_alloc_items(double, value_count);
+    if (values == NULL)
+        return false;
+
+    int64_t vi = 0;
+    values[vi++] = params->sample_length;
+    values[vi++] = params->audio_rate;
+    values[vi++] = params->bandwidth_base;
+    values[vi++] = params->bandwidth_scale;
+    values[vi++] = params->phase_var_at_harmonic;
+    values[vi++] = params->phase_var_off_harmonic;
+    values[vi++] = params->phase_spread_bandwidth_base;
+    values[vi++] = params->phase_spread_bandwidth_scale;
+    values[vi++] = params->use_phase_data ? 1 : 0;
+    values[vi++] = cb_data->entry->centre_pitch;
+    values[vi++] = cb_data->context_index;
+    values[vi++] = (res_env != NULL) ? (int)Envelope_get_interp(res_env) : -1;
+    values[vi++] = env_node_count;
+    values[vi++] = (double)harmonic_count;
+
+    for (int i = 0; i < env_node_count; ++i)
+    {
+        const double* node = Envelope_get_node(res_env, i);
+        values[vi++] = node[0];
+        values[vi++] = node[1];
+    }
+
+    for (int64_t h = 0; h < harmonic_count; ++h)
+    {
+        const Padsynth_harmonic* harmonic = Array_get_ref(params->harmonics, h);
+        values[vi++] = harmonic->freq_mul;
+        values[vi++] = harmonic->amplitude;
+        values[vi++] = harmonic->phase;
+    }
+
+    rassert(vi == value_count);
+
+    Data_cache_key_init(
+            key, "padsynth2", values, value_count * (int64_t)sizeof(double));
+    memory_free(values);
+
+    return true;
+}
+
+
+static bool load_cached_sample(
+        Data_cache* cache, const Data_cache_key* key, float* buf, int32_t sample_length)
+{
+    rassert(cache != NULL);
+    rassert(key != NULL);
+    rassert(buf != NULL);
+    rassert(sample_length > 0);
+
+    Data_cache_entry* entry = Data_cache_open_entry(cache, key);
+    if (entry == NULL)
+        return false;
+
+    const bool is_valid =
+        (Data_cache_entry_get_channels(entry) == 1) &&
+        Data_cache_entry_is_float(entry) &&
+        (Data_cache_entry_get_len(entry) == sample_length + 1);
+    if (is_valid)
+        memcpy(buf,
+                Data_cache_entry_get_data(entry, 0),
+                sizeof(float) * (size_t)(sample_length + 1));
+
+    del_Data_cache_entry(entry);
+
+    return is_valid;
+}
+
+
 static void make_padsynth_sample(Error* error, void* user_data)
 {
     rassert(error != NULL);
@@ -577,6 +755,21 @@ static void make_padsynth_sample(Error* error, void* user_data)
 
     const int32_t buf_length = sample_length / 2;
 
+    float* buf = Sample_get_buffer(cb_data->entry->sample, 0);
+    rassert(buf != NULL);
+
+    // Use a previously generated sample if available
+    Data_cache_key key_data;
+    Data_cache_key* cache_key = NULL;
+    if ((params != NULL) && (cb_data->data_cache != NULL))
+    {
+        cache_key = &key_data;
+        if (!make_cache_key(cache_key, cb_data))
+            cache_key = NULL;
+        else if (load_cached_sample(cb_data->data_cache, cache_key, buf, sample_length))
+            return;
+    }
+
     for (int32_t i = 0; i < buf_length; ++i)
     {
         freq_amp[i] = 0;
@@ -645,6 +838,22 @@ static void make_padsynth_sample(Error* error, void* user_data)
 
                 Random_set_seed(phase_random, Random_get_uint64(random));
 
+                const double add_cos = cos(harmonic->phase);
+                const double add_sin = sin(harmonic->phase);
+
+                Gaussian_iter* amp_iter = &(Gaussian_iter){ .is_started = false };
+                Gaussian_iter_init_profile(
+                        amp_iter,
+                        buf_start,
+                        sample_length,
+                        freq_i,
+                        bandwidth_i,
+                        harmonic->amplitude / bandwidth_i);
+
+                Gaussian_iter* spread_iter = &(Gaussian_iter){ .is_started = false };
+                Gaussian_iter_init_profile(
+                        spread_iter, buf_start, sample_length, freq_i, ps_bandwidth_i, 1.0);
+
                 for (int32_t i = buf_start; i < buf_stop; ++i)
                 {
                     // Add amplitude and phase of the harmonic
@@ -653,12 +862,9 @@ static void make_padsynth_sample(Error* error, void* user_data)
                     const double orig_real = orig_amp * cos(orig_phase);
                     const double orig_imag = orig_amp * sin(orig_phase);
 
-                    const double harmonic_profile =
-                        profile((i / (double)sample_length) - freq_i, bandwidth_i);
-
-                    const double add_amp = harmonic_profile * harmonic->amplitude;
-                    const double add_real = add_amp * cos(harmonic->phase);
-                    const double add_imag = add_amp * sin(harmonic->phase);
+                    const double add_amp = Gaussian_iter_next(amp_iter);
+                    const double add_real = add_amp * add_cos;
+                    const double add_imag = add_amp * add_sin;
 
                     const double new_real = orig_real + add_real;
                     const double new_imag = orig_imag + add_imag;
@@ -669,8 +875,7 @@ static void make_padsynth_sample(Error* error, void* user_data)
                         new_phase += PI2;
 
                     // Add phase variation
-                    const double phase_spread_norm = get_phase_spread(
-                            (i / (double)sample_length) - freq_i, ps_bandwidth_i);
+                    const double phase_spread_norm = 1.0 - Gaussian_iter_next(spread_iter);
                     const double phase_spread =
                         lerp(phase_var_at_h, phase_var_off_h, phase_spread_norm);
                     new_phase += Random_get_float_lb(phase_random) * PI2 * phase_spread;
@@ -683,12 +888,17 @@ static void make_padsynth_sample(Error* error, void* user_data)
             }
             else
             {
+                Gaussian_iter* amp_iter = &(Gaussian_iter){ .is_started = false };
+                Gaussian_iter_init_profile(
+                        amp_iter,
+                        buf_start,
+                        sample_length,
+                        freq_i,
+                        bandwidth_i,
+                        harmonic->amplitude / bandwidth_i);
+
                 for (int32_t i = buf_start; i < buf_stop; ++i)
-                {
-                    const double harmonic_profile =
-                        profile((i / (double)sample_length) - freq_i, bandwidth_i);
-                    freq_amp[i] += harmonic_profile * harmonic->amplitude;
-                }
+                    freq_amp[i] += Gaussian_iter_next(amp_iter);
             }
         }
 
@@ -731,17 +941,17 @@ static void make_padsynth_sample(Error* error, void* user_data)
     }
 
     // Set up frequencies in half-complex representation
-    float* buf = Sample_get_buffer(cb_data->entry->sample, 0);
-    rassert(buf != NULL);
-
     buf[0] = 0;
     buf[sample_length - 1] = 0;
     buf[sample_length] = 0;
 
+    // NOTE: Single precision is sufficient here as the result is stored as float
     for (int32_t i = 1; i < buf_length; ++i)
     {
-        buf[i * 2 - 1] = (float)(freq_amp[i] * cos(freq_phase[i]));
-        buf[i * 2] = (float)(freq_amp[i] * sin(freq_phase[i]));
+        const float amp = (float)freq_amp[i];
+        const float phase = (float)freq_phase[i];
+        buf[i * 2 - 1] = amp * cosf(phase);
+        buf[i * 2] = amp * sinf(phase);
     }
 
     // Apply IFFT
@@ -764,6 +974,17 @@ static void make_padsynth_sample(Error* error, void* user_data)
     // Duplicate first frame (for interpolation code)
     buf[sample_length] = buf[0];
 
+    if (cache_key != NULL)
+    {
+        Data_cache_writer* writer = new_Data_cache_writer(
+                cb_data->data_cache, cache_key, 1, 32, true, sample_length + 1);
+        if (writer != NULL)
+        {
+            Data_cache_writer_write(writer, 0, 0, sample_length + 1, buf);
+            Data_cache_writer_finish(writer, true);
+        }
+    }
+
     return;
 }
 
@@ -810,6 +1031,11 @@ static bool apply_padsynth(
     if (cb_data_count == 0)
         return false;
 
+    Data_cache* data_cache =
+        (bkg_loader != NULL) ? Background_loader_get_data_cache(bkg_loader) : NULL;
+    for (int i = 0; i < cb_data_count; ++i)
+        cb_datas[i]->data_cache = data_cache;
+
     bool last_cb_data_is_direct = (cb_data_count < sample_count);
 
     // Allocate new sample map here so that we don't lose old data on allocation failure
@@ -186,6 +186,8 @@ static bool Proc_rangemap_update_envelope(Proc_rangemap* rangemap)
     while (Envelope_node_count(rangemap->envelope) > final_node_count)
         Envelope_del_node(rangemap->envelope, final_node_count);
 
+    Envelope_compile(rangemap->envelope);
+
     return true;
 }
 
@@ -34,6 +34,9 @@
 MODULE_KEYP(dc_blocker_enabled,     "p_dc_blocker_enabled.json",        0,  "true")
 MODULE_KEYP(mixing_volume, "p_mixing_volume.json", 0, MAKE_STRING(COMP_DEFAULT_MIX_VOL))
 MODULE_KEYP(force_shift,            "p_force_shift.json",               0,  "0")
+MODULE_KEYP(control_period, "p_control_period.json", 0,
+        MAKE_STRING(COMP_DEFAULT_CONTROL_PERIOD))
+MODULE_KEYP(in_port_manifest,       "in_XX/p_manifest.json",            0,  "")
 MODULE_KEYP(out_port_manifest,      "out_XX/p_manifest.json",           0,  "")
 MODULE_KEYP(connections,            "p_connections.json",               0,  "[]")
 MODULE_KEYP(control_map,            "p_control_map.json",               0,  "[]")
@@ -15,10 +15,15 @@
 #include <init/sheet/Column.h>
 
 #include <debug/assert.h>
+#include <kunquat/limits.h>
 #include <mathnum/Tstamp.h>
 #include <memory.h>
 #include <player/Event_names.h>
+#include <player/Event_properties.h>
+#include <string/common.h>
+#include <Value.h>
 
+#include <ctype.h>
 #include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -33,6 +38,14 @@ struct Column
     uint32_t version;
     Column_iter* edit_iter;
     AAtree* triggers;
+
+    // Playback representation
+    uint32_t rows_version;
+    int32_t row_count;
+    Column_row* rows;
+    Column_trigger* row_triggers;
+    int32_t seq_row_count;
+    Column_row* seq_rows; // rows with triggers that affect sequencing
 };
 
 
@@ -249,6 +262,12 @@ Column* new_Column(const Tstamp* len)
         return NULL;
 
     col->version = 1;
+    col->rows_version = col->version;
+    col->row_count = 0;
+    col->rows = NULL;
+    col->row_triggers = NULL;
+    col->seq_row_count = 0;
+    col->seq_rows = NULL;
     col->triggers = new_AAtree(
             (AAtree_item_cmp*)Trigger_list_cmp, (AAtree_item_destroy*)del_Trigger_list);
     if (col->triggers == NULL)
@@ -293,6 +312,13 @@ Column* new_Column_from_string(
         return NULL;
     }
 
+    if (!Column_build_rows(col))
+    {
+        Streader_set_memory_error(sr, "Could not allocate memory for column");
+        del_Column(col);
+        return NULL;
+    }
+
     return col;
 }
 
@@ -404,11 +430,287 @@ bool Column_ins(Column* col, Trigger* trigger)
 }
 
 
+static bool read_literal(const char* expr, Value* value)
+{
+    rassert(expr != NULL);
+    rassert(value != NULL);
+
+    // Only accept plain numbers; anything else is left for the evaluator
+    const char* digits = (expr[0] == '-') ? expr + 1 : expr;
+    if (!isdigit((unsigned char)digits[0]))
+        return false;
+
+    for (const char* ch = digits; *ch != '\0'; ++ch)
+    {
+        if (!isdigit((unsigned char)*ch) && (*ch != '.'))
+            return false;
+    }
+
+    Streader* sr = Streader_init(STREADER_AUTO, expr, (int64_t)strlen(expr));
+
+    if (strchr(digits, '.') != NULL)
+    {
+        value->type = VALUE_TYPE_FLOAT;
+        if (!Streader_read_float(sr, &value->value.float_type))
+            return false;
+    }
+    else
+    {
+        value->type = VALUE_TYPE_INT;
+        if (!Streader_read_int(sr, &value->value.int_type))
+            return false;
+    }
+
+    return !Streader_has_data(sr);
+}
+
+
+static void Column_trigger_init(Column_trigger* ctr, const Trigger* trigger)
+{
+    rassert(ctr != NULL);
+    rassert(trigger != NULL);
+
+    ctr->type = Trigger_get_type(trigger);
+    ctr->event_name[0] = '\0';
+    ctr->has_const_arg = false;
+    ctr->arg.type = VALUE_TYPE_NONE;
+    ctr->desc = Trigger_get_desc(trigger);
+    ctr->arg_desc = NULL;
+
+    Streader* sr =
+        Streader_init(STREADER_AUTO, ctr->desc, (int64_t)strlen(ctr->desc));
+    if (!Streader_readf(sr, "[%s,", READF_STR(KQT_EVENT_NAME_MAX, ctr->event_name)))
+        return;
+
+    Streader_skip_whitespace(sr);
+    ctr->arg_desc = Streader_get_remaining_data(sr);
+
+    // Resolve the argument now if it does not depend on playback state
+    const Value_type field_type = Event_properties_get_param_type(ctr->type);
+
+    if (string_has_suffix(ctr->event_name, "\""))
+    {
+        // Quoted arguments are never evaluated, so leave errors to the player
+        ctr->arg.type = VALUE_TYPE_STRING;
+        ctr->has_const_arg = (field_type == VALUE_TYPE_STRING) &&
+            Streader_read_string(sr, KQT_VAR_NAME_MAX + 1, ctr->arg.value.string_type);
+        if (!ctr->has_const_arg)
+            ctr->arg_desc = NULL;
+
+        return;
+    }
+
+    if ((field_type == VALUE_TYPE_NONE) ||
+            (field_type == VALUE_TYPE_MAYBE_STRING) ||
+            (field_type == VALUE_TYPE_MAYBE_REALTIME))
+    {
+        if (Streader_read_null(sr))
+        {
+            ctr->arg.type = VALUE_TYPE_NONE;
+            ctr->has_const_arg = true;
+            return;
+        }
+
+        Streader_clear_error(sr);
+    }
+
+    char expr[KQT_VAR_NAME_MAX + 1] = "";
+    if (!Streader_read_string(sr, KQT_VAR_NAME_MAX + 1, expr))
+        return;
+
+    ctr->has_const_arg =
+        read_literal(expr, &ctr->arg) &&
+        Value_convert_to_field_type(&ctr->arg, field_type);
+
+    return;
+}
+
+
+bool Column_build_rows(Column* col)
+{
+    rassert(col != NULL);
+
+    if (col->rows_version == col->version)
+        return true;
+
+    memory_free(col->rows);
+    memory_free(col->row_triggers);
+    memory_free(col->seq_rows);
+    col->rows = NULL;
+    col->row_triggers = NULL;
+    col->row_count = 0;
+    col->seq_rows = NULL;
+    col->seq_row_count = 0;
+
+    const Tstamp* start_pos = Tstamp_set(TSTAMP_AUTO, INT64_MIN, 0);
+
+    // Count rows and triggers
+    int32_t row_count = 0;
+    int32_t trigger_count = 0;
+    {
+        Column_iter* citer = Column_iter_init(COLUMN_ITER_AUTO);
+        Column_iter_change_col(citer, col);
+        const Trigger_list* row = Column_iter_get_row(citer, start_pos);
+        while (row != NULL)
+        {
+            ++row_count;
+            for (const Trigger_list* trl = row->next; trl->trigger != NULL; trl = trl->next)
+                ++trigger_count;
+
+            row = Column_iter_get_next_row(citer);
+        }
+    }
+
+    if (row_count > 0)
+    {
+        col->rows = memory_alloc_items(Column_row, row_count);
+        col->row_triggers = memory_alloc_items(Column_trigger, trigger_count);
+        if ((col->rows == NULL) || (col->row_triggers == NULL))
+        {
+            memory_free(col->rows);
+            memory_free(col->row_triggers);
+            col->rows = NULL;
+            col->row_triggers = NULL;
+            return false;
+        }
+    }
+
+    // Fill the arrays
+    {
+        Column_iter* citer = Column_iter_init(COLUMN_ITER_AUTO);
+        Column_iter_change_col(citer, col);
+        const Trigger_list* row = Column_iter_get_row(citer, start_pos);
+        int32_t row_index = 0;
+        int32_t trigger_index = 0;
+        while (row != NULL)
+        {
+            rassert(row_index < row_count);
+            Column_row* crow = &col->rows[row_index];
+            Tstamp_copy(&crow->pos, Trigger_get_pos(row->next->trigger));
+            crow->trigger_count = 0;
+            crow->triggers = &col->row_triggers[trigger_index];
+
+            for (const Trigger_list* trl = row->next; trl->trigger != NULL; trl = trl->next)
+            {
+                rassert(trigger_index < trigger_count);
+                Column_trigger_init(&col->row_triggers[trigger_index], trl->trigger);
+                ++trigger_index;
+                ++crow->trigger_count;
+            }
+
+            ++row_index;
+            row = Column_iter_get_next_row(citer);
+        }
+    }
+
+    col->row_count = row_count;
+
+    // Collect rows that need to be visited in sequencer-only playback
+    int32_t seq_row_count = 0;
+    for (int32_t i = 0; i < row_count; ++i)
+    {
+        if (Column_row_affects_sequencing(&col->rows[i]))
+            ++seq_row_count;
+    }
+
+    if (seq_row_count > 0)
+    {
+        col->seq_rows = memory_alloc_items(Column_row, seq_row_count);
+        if (col->seq_rows == NULL)
+        {
+            memory_free(col->rows);
+            memory_free(col->row_triggers);
+            col->rows = NULL;
+            col->row_triggers = NULL;
+            col->row_count = 0;
+            return false;
+        }
+
+        int32_t seq_index = 0;
+        for (int32_t i = 0; i < row_count; ++i)
+        {
+            if (Column_row_affects_sequencing(&col->rows[i]))
+                col->seq_rows[seq_index++] = col->rows[i];
+        }
+        rassert(seq_index == seq_row_count);
+    }
+
+    col->seq_row_count = seq_row_count;
+    col->rows_version = col->version;
+
+    return true;
+}
+
+
+bool Column_row_affects_sequencing(const Column_row* row)
+{
+    rassert(row != NULL);
+
+    for (int32_t i = 0; i < row->trigger_count; ++i)
+    {
+        const Event_type type = row->triggers[i].type;
+        if (Event_is_control(type) || Event_is_general(type) || Event_is_master(type))
+            return true;
+    }
+
+    return false;
+}
+
+
+static const Column_row* find_row(
+        const Column_row* rows, int32_t row_count, const Tstamp* pos)
+{
+    rassert(rows != NULL || row_count == 0);
+    rassert(row_count >= 0);
+    rassert(pos != NULL);
+
+    // Find the first row at or after pos
+    int32_t low = 0;
+    int32_t high = row_count;
+    while (low < high)
+    {
+        const int32_t mid = low + (high - low) / 2;
+        if (Tstamp_cmp(&rows[mid].pos, pos) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low >= row_count)
+        return NULL;
+
+    return &rows[low];
+}
+
+
+const Column_row* Column_get_row(const Column* col, const Tstamp* pos)
+{
+    rassert(col != NULL);
+    rassert(col->rows_version == col->version);
+    rassert(pos != NULL);
+
+    return find_row(col->rows, col->row_count, pos);
+}
+
+
+const Column_row* Column_get_seq_row(const Column* col, const Tstamp* pos)
+{
+    rassert(col != NULL);
+    rassert(col->rows_version == col->version);
+    rassert(pos != NULL);
+
+    return find_row(col->seq_rows, col->seq_row_count, pos);
+}
+
+
 void del_Column(Column* col)
 {
     if (col == NULL)
         return;
 
+    memory_free(col->rows);
+    memory_free(col->row_triggers);
+    memory_free(col->seq_rows);
     del_AAtree(col->triggers);
     del_Column_iter(col->edit_iter);
     memory_free(col);
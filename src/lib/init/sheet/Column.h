@@ -18,9 +18,12 @@
 
 #include <containers/AAtree.h>
 #include <init/sheet/Trigger.h>
+#include <kunquat/limits.h>
 #include <mathnum/Tstamp.h>
 #include <player/Event_names.h>
+#include <player/Event_type.h>
 #include <string/Streader.h>
+#include <Value.h>
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -35,6 +38,31 @@ typedef struct Trigger_list
 } Trigger_list;
 
 
+/**
+ * A Trigger in the playback representation of a Column.
+ */
+typedef struct Column_trigger
+{
+    Event_type type;                            ///< The event type.
+    char event_name[KQT_EVENT_NAME_MAX + 1];    ///< The event name.
+    bool has_const_arg;                         ///< \c true if \a arg is final.
+    Value arg;                                  ///< The pre-parsed argument.
+    const char* arg_desc;                       ///< The argument expression.
+    const char* desc;                           ///< The Trigger description.
+} Column_trigger;
+
+
+/**
+ * A row of Triggers in the playback representation of a Column.
+ */
+typedef struct Column_row
+{
+    Tstamp pos;
+    int32_t trigger_count;
+    const Column_trigger* triggers;
+} Column_row;
+
+
 /**
  * Column is a container for Triggers in a Pattern. It contains a
  * "monophonic" section of music.
@@ -167,6 +195,59 @@ Column* new_Column_from_string(
 bool Column_ins(Column* col, Trigger* trigger);
 
 
+/**
+ * Build the playback representation of the Column.
+ *
+ * The playback representation stores the trigger rows in a contiguous array
+ * with event types and constant arguments resolved. This function must be
+ * called after inserting Triggers before the Column is used in playback.
+ *
+ * \param col   The Column -- must not be \c NULL.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Column_build_rows(Column* col);
+
+
+/**
+ * Get a trigger row from the playback representation of the Column.
+ *
+ * \param col   The Column -- must not be \c NULL and must not have been
+ *              modified after the last call of Column_build_rows.
+ * \param pos   The minimum position of the row -- must not be \c NULL.
+ *
+ * \return   The first trigger row at or after \a pos, or \c NULL if one
+ *           does not exist.
+ */
+const Column_row* Column_get_row(const Column* col, const Tstamp* pos);
+
+
+/**
+ * Find out whether a trigger row contains Triggers that affect sequencing.
+ *
+ * These are the control, general and master events that may change the
+ * tempo or the playback position.
+ *
+ * \param row   The trigger row -- must not be \c NULL.
+ *
+ * \return   \c true if \a row affects sequencing, otherwise \c false.
+ */
+bool Column_row_affects_sequencing(const Column_row* row);
+
+
+/**
+ * Get a trigger row that affects sequencing from the Column.
+ *
+ * \param col   The Column -- must not be \c NULL and must not have been
+ *              modified after the last call of Column_build_rows.
+ * \param pos   The minimum position of the row -- must not be \c NULL.
+ *
+ * \return   The first trigger row that affects sequencing at or after
+ *           \a pos, or \c NULL if one does not exist.
+ */
+const Column_row* Column_get_seq_row(const Column* col, const Tstamp* pos);
+
+
 /**
  * Destroy an existing Column.
  *
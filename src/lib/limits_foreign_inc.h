@@ -26,6 +26,7 @@ KQT_LIMIT_INT(KEY_LENGTH_MAX)
 KQT_LIMIT_INT(AUDIO_BUFFER_SIZE_MAX)
 KQT_LIMIT_INT(THREADS_MAX)
 KQT_LIMIT_INT(CALC_DURATION_MAX)
+KQT_LIMIT_INT(CONTROL_PERIOD_MAX)
 KQT_LIMIT_INT(VOICES_MAX)
 KQT_LIMIT_INT(SONGS_MAX)
 KQT_LIMIT_INT(TRACKS_MAX)
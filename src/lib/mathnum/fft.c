@@ -163,7 +163,7 @@ static void drfti1(int32_t n, float* wa, int32_t* ifac)
     if (nfm1 == 0)
         return;
 
-    const float argh = (float)(PI2 / (double)n);
+    const double argh = PI2 / (double)n;
     int32_t is = 0;
     int32_t l1 = 1;
 
@@ -179,14 +179,24 @@ static void drfti1(int32_t n, float* wa, int32_t* ifac)
         {
             ld += l1;
             int32_t i = is;
-            const float argld = (float)ld * argh;
-            float fi = 0.0f;
+
+            // Generate the roots by repeated rotation in double precision,
+            // which is far cheaper than evaluating sine and cosine for each
+            // root and accurate enough for single precision output
+            const double argld = (double)ld * argh;
+            const double step_cos = cos(argld);
+            const double step_sin = sin(argld);
+            double cur_cos = 1.0;
+            double cur_sin = 0.0;
             for (int32_t ii = 2; ii < ido; ii += 2)
             {
-                fi += 1.0f;
-                const float arg = fi * argld;
-                wa[i++] = cosf(arg);
-                wa[i++] = sinf(arg);
+                const double next_cos = (cur_cos * step_cos) - (cur_sin * step_sin);
+                const double next_sin = (cur_sin * step_cos) + (cur_cos * step_sin);
+                cur_cos = next_cos;
+                cur_sin = next_sin;
+
+                wa[i++] = (float)cur_cos;
+                wa[i++] = (float)cur_sin;
             }
             is += ido;
         }
@@ -16,8 +16,13 @@
 
 #include <debug/assert.h>
 
+#ifdef ENABLE_THREAD_ARENAS
+#include <sys/mman.h>
+#endif
+
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 
 static int32_t out_of_memory_error_steps = -1;
@@ -162,6 +167,80 @@ void memory_free_aligned(void* ptr)
 }
 
 
+void* memory_alloc_pages(int64_t size, bool use_huge_pages)
+{
+    rassert(size >= 0);
+    rassert(size % MEMORY_HUGE_PAGE_SIZE == 0);
+
+    if (size == 0)
+        return NULL;
+
+#ifdef ENABLE_THREAD_ARENAS
+    update_out_of_memory_error();
+
+    const int64_t align = use_huge_pages ? MEMORY_HUGE_PAGE_SIZE : 0;
+    void* area = mmap(
+            NULL,
+            (size_t)(size + align),
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0);
+    if (area == MAP_FAILED)
+        return NULL;
+
+    ++total_alloc_count;
+
+    char* block = area;
+
+    if (align > 0)
+    {
+        // Trim the mapping so that huge pages can cover the whole block
+        const int64_t rem = (int64_t)((intptr_t)block % align);
+        const int64_t head = (rem == 0) ? 0 : align - rem;
+        const int64_t tail = align - head;
+        if (head > 0)
+            munmap(block, (size_t)head);
+        if (tail > 0)
+            munmap(block + head + size, (size_t)tail);
+
+        block += head;
+
+#ifdef MADV_HUGEPAGE
+        madvise(block, (size_t)size, MADV_HUGEPAGE);
+#endif
+    }
+
+    return block;
+#else
+    ignore(use_huge_pages);
+
+    char* block = memory_alloc_aligned(size, 64);
+    if (block != NULL)
+        memset(block, 0, (size_t)size);
+
+    return block;
+#endif
+}
+
+
+void memory_free_pages(void* ptr, int64_t size)
+{
+    if (ptr == NULL)
+        return;
+
+#ifdef ENABLE_THREAD_ARENAS
+    rassert(size > 0);
+    munmap(ptr, (size_t)size);
+#else
+    ignore(size);
+    memory_free_aligned(ptr);
+#endif
+
+    return;
+}
+
+
 void memory_fake_out_of_memory(int32_t steps)
 {
     out_of_memory_error_steps = steps;
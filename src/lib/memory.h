@@ -16,6 +16,7 @@
 #define KQT_MEMORY_H
 
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -109,6 +110,44 @@ void memory_free(void* ptr);
 void memory_free_aligned(void* ptr);
 
 
+/**
+ * The size of a huge page used by \a memory_alloc_pages.
+ */
+#define MEMORY_HUGE_PAGE_SIZE 2097152
+
+
+/**
+ * Allocate a zero-initialised block of memory pages.
+ *
+ * If libkunquat is built with thread arenas, the pages are mapped without
+ * touching them so that the first thread writing to a page decides its
+ * placement. Otherwise the memory is allocated with \a memory_alloc_aligned
+ * and cleared.
+ *
+ * \param size             The amount of bytes to be allocated -- must be a
+ *                         multiple of \c MEMORY_HUGE_PAGE_SIZE and >= \c 0.
+ * \param use_huge_pages   \c true if transparent huge pages should be
+ *                         requested. This is ignored if not supported.
+ *
+ * \return   The starting address of the allocated memory block aligned to at
+ *           least \c 64 bytes, or \c NULL if memory allocation failed or
+ *           \a size was \c 0.
+ */
+void* memory_alloc_pages(int64_t size, bool use_huge_pages);
+
+
+/**
+ * Free a block of memory pages.
+ *
+ * NOTE: This function must only be used to free memory allocated with
+ *       \a memory_alloc_pages.
+ *
+ * \param ptr    The starting address of the memory block, or \c NULL.
+ * \param size   The size passed to \a memory_alloc_pages.
+ */
+void memory_free_pages(void* ptr, int64_t size);
+
+
 /**
  * Simulate a memory allocation error on a single allocation request.
  *
@@ -0,0 +1,409 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/Automation_lanes.h>
+
+#include <debug/assert.h>
+#include <init/Au_table.h>
+#include <init/devices/Au_streams.h>
+#include <init/devices/Audio_unit.h>
+#include <init/devices/Device.h>
+#include <init/devices/Device_impl.h>
+#include <init/devices/Proc_type.h>
+#include <init/Module.h>
+#include <kunquat/limits.h>
+#include <mathnum/common.h>
+#include <memory.h>
+#include <player/Device_states.h>
+#include <player/devices/Device_state.h>
+#include <player/devices/processors/Stream_state.h>
+#include <string/var_name.h>
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+typedef struct Lane
+{
+    int au_index;
+    int sub_au_index;
+    char stream_name[KQT_VAR_NAME_MAX + 1];
+    uint32_t device_id; // 0 if the target does not exist
+
+    int32_t value_count;
+    int32_t const_start;
+    bool is_active;
+    float* values;
+} Lane;
+
+
+static void del_Lane(Lane* lane)
+{
+    if (lane == NULL)
+        return;
+
+    memory_free(lane->values);
+    memory_free(lane);
+
+    return;
+}
+
+
+struct Automation_lanes
+{
+    int32_t buffer_size;
+    int lane_count; // one past the last existing lane
+    Lane* lanes[AUTOMATION_LANES_MAX];
+};
+
+
+static uint32_t find_target_id(
+        const Lane* lane, const Module* module, const Device_states* dstates)
+{
+    rassert(lane != NULL);
+    rassert(module != NULL);
+    rassert(dstates != NULL);
+
+    const Audio_unit* au = Au_table_get(Module_get_au_table(module), lane->au_index);
+    if ((au == NULL) || !Device_is_existent((const Device*)au))
+        return 0;
+
+    if (lane->sub_au_index >= 0)
+    {
+        au = Audio_unit_get_au(au, lane->sub_au_index);
+        if ((au == NULL) || !Device_is_existent((const Device*)au))
+            return 0;
+    }
+
+    const Au_streams* streams = Audio_unit_get_streams(au);
+    if (streams == NULL)
+        return 0;
+
+    const int proc_index = Au_streams_get_target_proc_index(streams, lane->stream_name);
+    if (proc_index < 0)
+        return 0;
+
+    const Device* device = (const Device*)Audio_unit_get_proc(au, proc_index);
+    if ((device == NULL) ||
+            !Device_is_existent(device) ||
+            (device->dimpl == NULL) ||
+            (Device_impl_get_proc_type(device->dimpl) != Proc_type_stream) ||
+            !Device_get_mixed_signals(device))
+        return 0;
+
+    const uint32_t id = Device_get_id(device);
+    const Device_state* dstate = Device_states_get_state(dstates, id);
+    if ((dstate == NULL) || (dstate->device != device))
+        return 0;
+
+    return id;
+}
+
+
+Automation_lanes* new_Automation_lanes(int32_t buffer_size)
+{
+    rassert(buffer_size >= 0);
+
+    Automation_lanes* lanes = memory_alloc_item(Automation_lanes);
+    if (lanes == NULL)
+        return NULL;
+
+    lanes->buffer_size = buffer_size;
+    lanes->lane_count = 0;
+    for (int i = 0; i < AUTOMATION_LANES_MAX; ++i)
+        lanes->lanes[i] = NULL;
+
+    return lanes;
+}
+
+
+bool Automation_lanes_set_buffer_size(Automation_lanes* lanes, int32_t size)
+{
+    rassert(lanes != NULL);
+    rassert(size >= 0);
+
+    for (int i = 0; i < lanes->lane_count; ++i)
+    {
+        Lane* lane = lanes->lanes[i];
+        if (lane == NULL)
+            continue;
+
+        lane->value_count = 0;
+
+        float* new_values = memory_realloc_items(float, max(1, size), lane->values);
+        if (new_values == NULL)
+            return false;
+
+        lane->values = new_values;
+    }
+
+    lanes->buffer_size = size;
+
+    return true;
+}
+
+
+int Automation_lanes_add(
+        Automation_lanes* lanes,
+        int au_index,
+        int sub_au_index,
+        const char* stream_name,
+        const Module* module,
+        const Device_states* dstates)
+{
+    rassert(lanes != NULL);
+    rassert(au_index >= 0);
+    rassert(au_index < KQT_AUDIO_UNITS_MAX);
+    rassert(sub_au_index >= -1);
+    rassert(sub_au_index < KQT_AUDIO_UNITS_MAX);
+    rassert(stream_name != NULL);
+    rassert(is_valid_var_name(stream_name));
+    rassert(module != NULL);
+    rassert(dstates != NULL);
+
+    int index = 0;
+    while ((index < AUTOMATION_LANES_MAX) && (lanes->lanes[index] != NULL))
+        ++index;
+
+    if (index >= AUTOMATION_LANES_MAX)
+        return -1;
+
+    Lane* lane = memory_alloc_item(Lane);
+    if (lane == NULL)
+        return -1;
+
+    lane->au_index = au_index;
+    lane->sub_au_index = sub_au_index;
+    strcpy(lane->stream_name, stream_name);
+    lane->value_count = 0;
+    lane->const_start = 0;
+    lane->is_active = false;
+    lane->values = memory_alloc_items(float, max(1, lanes->buffer_size));
+    if (lane->values == NULL)
+    {
+        del_Lane(lane);
+        return -1;
+    }
+
+    lane->device_id = find_target_id(lane, module, dstates);
+
+    lanes->lanes[index] = lane;
+    lanes->lane_count = max(lanes->lane_count, index + 1);
+
+    return index;
+}
+
+
+bool Automation_lanes_has_lane(const Automation_lanes* lanes, int lane)
+{
+    rassert(lanes != NULL);
+    return (lane >= 0) && (lane < lanes->lane_count) && (lanes->lanes[lane] != NULL);
+}
+
+
+bool Automation_lanes_is_connected(const Automation_lanes* lanes, int lane)
+{
+    rassert(lanes != NULL);
+    rassert(Automation_lanes_has_lane(lanes, lane));
+
+    return lanes->lanes[lane]->device_id != 0;
+}
+
+
+void Automation_lanes_remove(Automation_lanes* lanes, int lane)
+{
+    rassert(lanes != NULL);
+    rassert(Automation_lanes_has_lane(lanes, lane));
+    rassert(!lanes->lanes[lane]->is_active);
+
+    del_Lane(lanes->lanes[lane]);
+    lanes->lanes[lane] = NULL;
+
+    while ((lanes->lane_count > 0) && (lanes->lanes[lanes->lane_count - 1] == NULL))
+        --lanes->lane_count;
+
+    return;
+}
+
+
+void Automation_lanes_connect(
+        Automation_lanes* lanes, const Module* module, const Device_states* dstates)
+{
+    rassert(lanes != NULL);
+    rassert(module != NULL);
+    rassert(dstates != NULL);
+
+    for (int i = 0; i < lanes->lane_count; ++i)
+    {
+        Lane* lane = lanes->lanes[i];
+        if (lane != NULL)
+            lane->device_id = find_target_id(lane, module, dstates);
+    }
+
+    return;
+}
+
+
+void Automation_lanes_set_values(
+        Automation_lanes* lanes, int lane, int32_t count, const float* values)
+{
+    rassert(lanes != NULL);
+    rassert(Automation_lanes_has_lane(lanes, lane));
+    rassert(count >= 0);
+    rassert(count <= lanes->buffer_size);
+    rassert((values != NULL) || (count == 0));
+
+    Lane* l = lanes->lanes[lane];
+
+    if (count > 0)
+        memcpy(l->values, values, sizeof(float) * (size_t)count);
+
+    l->value_count = count;
+
+    return;
+}
+
+
+bool Automation_lanes_add_point(
+        Automation_lanes* lanes,
+        int lane,
+        int32_t frame_offset,
+        double value,
+        const Device_states* dstates)
+{
+    rassert(lanes != NULL);
+    rassert(Automation_lanes_has_lane(lanes, lane));
+    rassert(frame_offset >= 0);
+    rassert(frame_offset < lanes->buffer_size);
+    rassert(isfinite(value));
+    rassert(dstates != NULL);
+
+    Lane* l = lanes->lanes[lane];
+
+    if (frame_offset < l->value_count)
+        return false;
+
+    // If nothing is written yet, start from the current value of the stream
+    double start_value = 0;
+    if (l->value_count > 0)
+        start_value = l->values[l->value_count - 1];
+    else if (l->device_id != 0)
+        start_value = Stream_pstate_get_value(
+                Device_states_get_state(dstates, l->device_id));
+
+    // The previous frame may belong to the previous render call
+    const double start_pos = l->value_count - 1;
+    const double step = (value - start_value) / (frame_offset - start_pos);
+    for (int32_t i = l->value_count; i < frame_offset; ++i)
+        l->values[i] = (float)(start_value + (i - start_pos) * step);
+
+    l->values[frame_offset] = (float)value;
+    l->value_count = frame_offset + 1;
+
+    return true;
+}
+
+
+void Automation_lanes_start(
+        Automation_lanes* lanes, Device_states* dstates, int32_t frame_count)
+{
+    rassert(lanes != NULL);
+    rassert(dstates != NULL);
+    rassert(frame_count >= 0);
+    rassert(frame_count <= lanes->buffer_size);
+
+    for (int i = 0; i < lanes->lane_count; ++i)
+    {
+        Lane* lane = lanes->lanes[i];
+        if ((lane == NULL) || (lane->value_count == 0) || (lane->device_id == 0))
+            continue;
+
+        // Hold the last written value until the end of the render call
+        const float hold_value = lane->values[lane->value_count - 1];
+        for (int32_t k = lane->value_count; k < frame_count; ++k)
+            lane->values[k] = hold_value;
+
+        lane->const_start = lane->value_count;
+        lane->is_active = true;
+    }
+
+    return;
+}
+
+
+void Automation_lanes_apply(
+        Automation_lanes* lanes, Device_states* dstates, int32_t frame_offset)
+{
+    rassert(lanes != NULL);
+    rassert(dstates != NULL);
+    rassert(frame_offset >= 0);
+
+    for (int i = 0; i < lanes->lane_count; ++i)
+    {
+        const Lane* lane = lanes->lanes[i];
+        if ((lane == NULL) || !lane->is_active)
+            continue;
+
+        Stream_pstate_set_automation(
+                Device_states_get_state(dstates, lane->device_id),
+                lane->values + frame_offset,
+                max(0, lane->const_start - frame_offset));
+    }
+
+    return;
+}
+
+
+void Automation_lanes_finish(Automation_lanes* lanes, Device_states* dstates)
+{
+    rassert(lanes != NULL);
+    rassert(dstates != NULL);
+
+    for (int i = 0; i < lanes->lane_count; ++i)
+    {
+        Lane* lane = lanes->lanes[i];
+        if (lane == NULL)
+            continue;
+
+        if (lane->is_active)
+        {
+            Stream_pstate_set_automation(
+                    Device_states_get_state(dstates, lane->device_id), NULL, 0);
+            lane->is_active = false;
+        }
+
+        lane->value_count = 0;
+    }
+
+    return;
+}
+
+
+void del_Automation_lanes(Automation_lanes* lanes)
+{
+    if (lanes == NULL)
+        return;
+
+    for (int i = 0; i < lanes->lane_count; ++i)
+        del_Lane(lanes->lanes[i]);
+
+    memory_free(lanes);
+
+    return;
+}
+
+
@@ -0,0 +1,223 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_AUTOMATION_LANES_H
+#define KQT_AUTOMATION_LANES_H
+
+
+#include <decl.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * Automation lanes feed values from the host directly into the output
+ * buffers of stream processors that process mixed signals.
+ *
+ * Each lane targets a stream of an audio unit. The host writes values for
+ * the frames of the next render call, either as blocks of values or as
+ * breakpoints that are joined with linear ramps. The last written value is
+ * held until the end of the render call and is kept by the stream
+ * processor afterwards. Lanes without values for a render call leave their
+ * stream processors to their normal operation.
+ */
+
+
+#define AUTOMATION_LANES_MAX 1024
+
+
+/**
+ * Create new Automation lanes.
+ *
+ * \param buffer_size   The audio buffer size -- must be >= \c 0.
+ *
+ * \return   The new Automation lanes, or \c NULL if memory allocation
+ *           failed.
+ */
+Automation_lanes* new_Automation_lanes(int32_t buffer_size);
+
+
+/**
+ * Set the audio buffer size of the Automation lanes.
+ *
+ * Values written for the next render call are discarded.
+ *
+ * \param lanes   The Automation lanes -- must not be \c NULL.
+ * \param size    The new audio buffer size -- must be >= \c 0.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Automation_lanes_set_buffer_size(Automation_lanes* lanes, int32_t size);
+
+
+/**
+ * Add a lane to the Automation lanes.
+ *
+ * \param lanes          The Automation lanes -- must not be \c NULL.
+ * \param au_index       The index of the audio unit in the composition
+ *                       -- must be >= \c 0 and < \c KQT_AUDIO_UNITS_MAX.
+ * \param sub_au_index   The index of the audio unit inside the audio unit
+ *                       \a au_index, or \c -1 if the target is in
+ *                       \a au_index itself.
+ * \param stream_name    The name of the stream -- must be a valid variable
+ *                       name.
+ * \param module         The Module -- must not be \c NULL.
+ * \param dstates        The Device states -- must not be \c NULL.
+ *
+ * \return   The lane number, or \c -1 if there is no free lane or memory
+ *           allocation failed.
+ */
+int Automation_lanes_add(
+        Automation_lanes* lanes,
+        int au_index,
+        int sub_au_index,
+        const char* stream_name,
+        const Module* module,
+        const Device_states* dstates);
+
+
+/**
+ * Find out whether a lane exists in the Automation lanes.
+ *
+ * \param lanes   The Automation lanes -- must not be \c NULL.
+ * \param lane    The lane number.
+ *
+ * \return   \c true if \a lane exists, otherwise \c false.
+ */
+bool Automation_lanes_has_lane(const Automation_lanes* lanes, int lane);
+
+
+/**
+ * Find out whether the target of a lane exists.
+ *
+ * \param lanes   The Automation lanes -- must not be \c NULL.
+ * \param lane    The lane number -- must be an existing lane.
+ *
+ * \return   \c true if the lane is connected to a stream processor that
+ *           processes mixed signals, otherwise \c false.
+ */
+bool Automation_lanes_is_connected(const Automation_lanes* lanes, int lane);
+
+
+/**
+ * Remove a lane from the Automation lanes.
+ *
+ * \param lanes   The Automation lanes -- must not be \c NULL.
+ * \param lane    The lane number -- must be an existing lane.
+ */
+void Automation_lanes_remove(Automation_lanes* lanes, int lane);
+
+
+/**
+ * Find the target processors of all lanes.
+ *
+ * This function must be called after the Module has changed.
+ *
+ * \param lanes     The Automation lanes -- must not be \c NULL.
+ * \param module    The Module -- must not be \c NULL.
+ * \param dstates   The Device states -- must not be \c NULL.
+ */
+void Automation_lanes_connect(
+        Automation_lanes* lanes, const Module* module, const Device_states* dstates);
+
+
+/**
+ * Set values of a lane for the start of the next render call.
+ *
+ * Any values and breakpoints previously written for the next render call
+ * are replaced.
+ *
+ * \param lanes    The Automation lanes -- must not be \c NULL.
+ * \param lane     The lane number -- must be an existing lane.
+ * \param count    The number of values -- must be >= \c 0 and <= the audio
+ *                 buffer size.
+ * \param values   The values -- must not be \c NULL if \a count > \c 0.
+ *                 Each value must be finite.
+ */
+void Automation_lanes_set_values(
+        Automation_lanes* lanes, int lane, int32_t count, const float* values);
+
+
+/**
+ * Add a breakpoint to a lane for the next render call.
+ *
+ * The values between the previously written frame and \a frame_offset are
+ * interpolated linearly. If no values have been written for the next render
+ * call, the ramp starts from the current value of the stream.
+ *
+ * \param lanes          The Automation lanes -- must not be \c NULL.
+ * \param lane           The lane number -- must be an existing lane.
+ * \param frame_offset   The frame offset of the breakpoint -- must be >= \c 0
+ *                       and less than the audio buffer size.
+ * \param value          The value at \a frame_offset -- must be finite.
+ * \param dstates        The Device states -- must not be \c NULL.
+ *
+ * \return   \c true if successful, or \c false if \a frame_offset precedes
+ *           a frame already written.
+ */
+bool Automation_lanes_add_point(
+        Automation_lanes* lanes,
+        int lane,
+        int32_t frame_offset,
+        double value,
+        const Device_states* dstates);
+
+
+/**
+ * Prepare lanes for rendering.
+ *
+ * \param lanes         The Automation lanes -- must not be \c NULL.
+ * \param dstates       The Device states -- must not be \c NULL.
+ * \param frame_count   The number of frames to be rendered -- must be >= \c 0
+ *                      and <= the audio buffer size.
+ */
+void Automation_lanes_start(
+        Automation_lanes* lanes, Device_states* dstates, int32_t frame_count);
+
+
+/**
+ * Pass the lane values of a part of the render call to the stream
+ * processors.
+ *
+ * \param lanes          The Automation lanes -- must not be \c NULL.
+ * \param dstates        The Device states -- must not be \c NULL.
+ * \param frame_offset   The offset of the part in the render call -- must be
+ *                       >= \c 0.
+ */
+void Automation_lanes_apply(
+        Automation_lanes* lanes, Device_states* dstates, int32_t frame_offset);
+
+
+/**
+ * Finish rendering and discard the values written for the render call.
+ *
+ * \param lanes     The Automation lanes -- must not be \c NULL.
+ * \param dstates   The Device states -- must not be \c NULL.
+ */
+void Automation_lanes_finish(Automation_lanes* lanes, Device_states* dstates);
+
+
+/**
+ * Destroy existing Automation lanes.
+ *
+ * \param lanes   The Automation lanes, or \c NULL.
+ */
+void del_Automation_lanes(Automation_lanes* lanes);
+
+
+#endif // KQT_AUTOMATION_LANES_H
+
+
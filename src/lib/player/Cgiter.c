@@ -35,17 +35,38 @@ void Cgiter_init(Cgiter* cgiter, const Module* module, int col_index)
     cgiter->col_index = col_index;
     Position_init(&cgiter->pos);
 
-    cgiter->cur_tr.head = NULL;
-
     cgiter->row_returned = false;
 
     cgiter->has_finished = false;
     cgiter->is_pattern_playback_state = false;
+    cgiter->is_sequencer_only = false;
 
     return;
 }
 
 
+void Cgiter_set_sequencer_only(Cgiter* cgiter, bool enabled)
+{
+    rassert(cgiter != NULL);
+    cgiter->is_sequencer_only = enabled;
+    return;
+}
+
+
+static const Column_row* get_row(
+        const Cgiter* cgiter, const Column* column, const Tstamp* pos)
+{
+    rassert(cgiter != NULL);
+    rassert(column != NULL);
+    rassert(pos != NULL);
+
+    if (cgiter->is_sequencer_only)
+        return Column_get_seq_row(column, pos);
+
+    return Column_get_row(column, pos);
+}
+
+
 static const Pat_inst_ref* find_pat_inst_ref(
         const Module* module, int track, int system)
 {
@@ -117,7 +138,7 @@ void Cgiter_reset(Cgiter* cgiter, const Position* start_pos)
 }
 
 
-const Trigger_row* Cgiter_get_trigger_row(Cgiter* cgiter)
+const Column_row* Cgiter_get_trigger_row(Cgiter* cgiter)
 {
     rassert(cgiter != NULL);
 
@@ -146,21 +167,17 @@ const Trigger_row* Cgiter_get_trigger_row(Cgiter* cgiter)
     // Store current pattern instance for reference
     cgiter->pos.piref = *piref;
 
-    Column* column = Pattern_get_column(pattern, cgiter->col_index);
+    const Column* column = Pattern_get_column(pattern, cgiter->col_index);
     if (column == NULL)
         return NULL;
 
-    Column_iter* citer = Column_iter_init(COLUMN_ITER_AUTO);
-    Column_iter_change_col(citer, column);
-    cgiter->cur_tr.head = Column_iter_get_row(citer, &cgiter->pos.pat_pos);
-    if (cgiter->cur_tr.head == NULL)
-        return NULL;
-    rassert(cgiter->cur_tr.head->next != NULL);
-    rassert(cgiter->cur_tr.head->next->trigger != NULL);
-    if (Tstamp_cmp(&cgiter->cur_tr.head->next->trigger->pos, &cgiter->pos.pat_pos) > 0)
+    const Column_row* row = get_row(cgiter, column, &cgiter->pos.pat_pos);
+    if ((row == NULL) || (Tstamp_cmp(&row->pos, &cgiter->pos.pat_pos) > 0))
         return NULL;
 
-    return &cgiter->cur_tr;
+    rassert(row->trigger_count > 0);
+
+    return row;
 }
 
 
@@ -218,26 +235,19 @@ bool Cgiter_get_local_bp_dist(const Cgiter* cgiter, Tstamp* dist)
     }
 
     // Check next trigger row
-    Column* column = Pattern_get_column(pattern, cgiter->col_index);
+    const Column* column = Pattern_get_column(pattern, cgiter->col_index);
     rassert(column != NULL);
-    Column_iter* citer = Column_iter_init(COLUMN_ITER_AUTO);
-    Column_iter_change_col(citer, column);
-
     const Tstamp* epsilon = Tstamp_set(TSTAMP_AUTO, 0, 1);
     Tstamp* next_pos_min = Tstamp_add(TSTAMP_AUTO, &cgiter->pos.pat_pos, epsilon);
-    const Trigger_list* row = Column_iter_get_row(citer, next_pos_min);
+    const Column_row* row = get_row(cgiter, column, next_pos_min);
 
     if (row != NULL)
     {
-        rassert(row->next != NULL);
-        rassert(row->next->trigger != NULL);
-        if (Tstamp_cmp(&row->next->trigger->pos, pat_length) <= 0)
+        if (Tstamp_cmp(&row->pos, pat_length) <= 0)
         {
             // Trigger row found inside this pattern
-            const Tstamp* dist_to_row = Tstamp_sub(
-                    TSTAMP_AUTO,
-                    &row->next->trigger->pos,
-                    &cgiter->pos.pat_pos);
+            const Tstamp* dist_to_row =
+                Tstamp_sub(TSTAMP_AUTO, &row->pos, &cgiter->pos.pat_pos);
             Tstamp_mina(dist, dist_to_row);
             return true;
         }
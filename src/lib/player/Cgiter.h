@@ -25,13 +25,6 @@
 #include <stdlib.h>
 
 
-// TODO: define proper interface in Column
-typedef struct Trigger_row
-{
-    Trigger_list* head;
-} Trigger_row;
-
-
 /**
  * Iterates over triggers in column groups.
  */
@@ -41,12 +34,12 @@ typedef struct Cgiter
     int col_index;
 
     Position pos;
-    Trigger_row cur_tr; // TODO: remove
 
     bool row_returned;
 
     bool has_finished;
     bool is_pattern_playback_state;
+    bool is_sequencer_only;
 } Cgiter;
 
 
@@ -72,6 +65,19 @@ void Cgiter_init(Cgiter* cgiter, const Module* module, int col_index);
 void Cgiter_reset(Cgiter* cgiter, const Position* start_pos);
 
 
+/**
+ * Set the sequencer-only mode of the Cgiter.
+ *
+ * In sequencer-only mode, the Cgiter only stops at trigger rows that affect
+ * sequencing. Rows that contain only channel and audio unit events are
+ * skipped as if they did not exist.
+ *
+ * \param cgiter    The Cgiter -- must not be \c NULL.
+ * \param enabled   \c true if sequencer-only mode should be used.
+ */
+void Cgiter_set_sequencer_only(Cgiter* cgiter, bool enabled);
+
+
 /**
  * Return trigger row at the current Cgiter position.
  *
@@ -79,7 +85,7 @@ void Cgiter_reset(Cgiter* cgiter, const Position* start_pos);
  *
  * \return   The trigger row if one exists, otherwise \c NULL.
  */
-const Trigger_row* Cgiter_get_trigger_row(Cgiter* cgiter);
+const Column_row* Cgiter_get_trigger_row(Cgiter* cgiter);
 
 
 /**
@@ -0,0 +1,148 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/Command_queue.h>
+
+#include <debug/assert.h>
+#include <memory.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/*
+ * Each cell carries a sequence number that tells whose turn it is to access
+ * the cell. A producer may write a cell at position pos when the sequence
+ * number equals pos, and the consumer may read it when the number equals
+ * pos + 1. Producers claim positions by incrementing the shared write
+ * position, so the only contended operation is one compare-and-swap.
+ */
+typedef struct Cell
+{
+    atomic_size_t seq;
+    Command command;
+} Cell;
+
+
+struct Command_queue
+{
+    size_t mask;
+    Cell* cells;
+    atomic_size_t write_pos;
+    size_t read_pos;
+};
+
+
+Command_queue* new_Command_queue(int size)
+{
+    rassert(size >= 2);
+    rassert((size & (size - 1)) == 0);
+
+    Command_queue* queue = memory_alloc_item(Command_queue);
+    if (queue == NULL)
+        return NULL;
+
+    queue->mask = (size_t)size - 1;
+    queue->cells = memory_alloc_items(Cell, size);
+    if (queue->cells == NULL)
+    {
+        del_Command_queue(queue);
+        return NULL;
+    }
+
+    for (int i = 0; i < size; ++i)
+        atomic_init(&queue->cells[i].seq, (size_t)i);
+
+    atomic_init(&queue->write_pos, 0);
+    queue->read_pos = 0;
+
+    return queue;
+}
+
+
+bool Command_queue_push(Command_queue* queue, const Command* command)
+{
+    rassert(queue != NULL);
+    rassert(command != NULL);
+
+    size_t pos = atomic_load_explicit(&queue->write_pos, memory_order_relaxed);
+    Cell* cell = NULL;
+
+    while (true)
+    {
+        cell = &queue->cells[pos & queue->mask];
+        const size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        const ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)pos;
+
+        if (diff == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(
+                        &queue->write_pos,
+                        &pos,
+                        pos + 1,
+                        memory_order_relaxed,
+                        memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&queue->write_pos, memory_order_relaxed);
+        }
+    }
+
+    cell->command = *command;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+
+    return true;
+}
+
+
+bool Command_queue_pop(Command_queue* queue, Command* dest)
+{
+    rassert(queue != NULL);
+    rassert(dest != NULL);
+
+    const size_t pos = queue->read_pos;
+    Cell* cell = &queue->cells[pos & queue->mask];
+    const size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+    if (seq != pos + 1)
+        return false;
+
+    *dest = cell->command;
+    atomic_store_explicit(&cell->seq, pos + queue->mask + 1, memory_order_release);
+    queue->read_pos = pos + 1;
+
+    return true;
+}
+
+
+void del_Command_queue(Command_queue* queue)
+{
+    if (queue == NULL)
+        return;
+
+    memory_free(queue->cells);
+    memory_free(queue);
+
+    return;
+}
+
+
@@ -0,0 +1,110 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_COMMAND_QUEUE_H
+#define KQT_COMMAND_QUEUE_H
+
+
+#include <decl.h>
+#include <player/Event_type.h>
+#include <Value.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * Command queue passes control commands from host threads to the thread
+ * that renders audio.
+ *
+ * The queue is a bounded lock-free ring that accepts commands from any
+ * number of threads simultaneously. Commands are removed by one consumer
+ * thread in the order they were added.
+ */
+
+
+#define COMMAND_QUEUE_SIZE 1024
+
+
+typedef enum
+{
+    COMMAND_FIRE_EVENT,
+    COMMAND_SET_CHANNEL_MUTE,
+} Command_type;
+
+
+/**
+ * A control command applied at a frame offset of a render call.
+ */
+typedef struct Command
+{
+    Command_type type;
+    int32_t frame_offset;   ///< The offset from the start of the next render call.
+    int channel;
+    Event_type event_type;  ///< The event type of \c COMMAND_FIRE_EVENT.
+    Value arg;              ///< The event argument or mute setting.
+} Command;
+
+
+/**
+ * Create a new Command queue.
+ *
+ * \param size   The maximum number of queued commands -- must be a power of
+ *               two and >= \c 2.
+ *
+ * \return   The new Command queue, or \c NULL if memory allocation failed.
+ */
+Command_queue* new_Command_queue(int size);
+
+
+/**
+ * Add a command to the Command queue.
+ *
+ * This function does not block and may be called from several threads
+ * simultaneously.
+ *
+ * \param queue     The Command queue -- must not be \c NULL.
+ * \param command   The command -- must not be \c NULL.
+ *
+ * \return   \c true if successful, or \c false if the queue is full.
+ */
+bool Command_queue_push(Command_queue* queue, const Command* command);
+
+
+/**
+ * Remove the oldest command from the Command queue.
+ *
+ * This function must only be called from one thread at a time.
+ *
+ * \param queue   The Command queue -- must not be \c NULL.
+ * \param dest    The destination command -- must not be \c NULL.
+ *
+ * \return   \c true if a command was removed, or \c false if the queue is
+ *           empty.
+ */
+bool Command_queue_pop(Command_queue* queue, Command* dest);
+
+
+/**
+ * Destroy an existing Command queue.
+ *
+ * \param queue   The Command queue, or \c NULL.
+ */
+void del_Command_queue(Command_queue* queue);
+
+
+#endif // KQT_COMMAND_QUEUE_H
+
+
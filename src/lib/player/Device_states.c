@@ -18,10 +18,15 @@
 #include <init/Connections.h>
 #include <init/devices/Audio_unit.h>
 #include <kunquat/limits.h>
+#include <mathnum/common.h>
 #include <player/devices/Device_state.h>
 #include <player/devices/Device_thread_state.h>
 #include <memory.h>
 
+#ifdef ENABLE_THREADS
+#include <stdatomic.h>
+#endif
+
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -33,6 +38,12 @@ static_assert((ENTRY_TABLE_SIZE & (ENTRY_TABLE_SIZE - 1)) == 0,
         "Device state entry table must have a size of 2^n");
 
 
+#ifdef ENABLE_THREADS
+// Number of entry table slots claimed at a time when mixing thread states
+#define MIX_SLOT_CHUNK_SIZE 8
+#endif
+
+
 static uint32_t id_hash(uint32_t id)
 {
     return id & (ENTRY_TABLE_SIZE - 1);
@@ -62,10 +73,12 @@ static void del_Entry(Entry* entry)
 }
 
 
-static Entry* new_Entry(Device_state* state, int thread_count)
+static Entry* new_Entry(
+        Device_state* state, int thread_count, Thread_arena* arenas[])
 {
     rassert(state != NULL);
     rassert(thread_count >= 0);
+    rassert(arenas != NULL);
 
     Entry* entry = memory_alloc_item(Entry);
     if (entry == NULL)
@@ -81,7 +94,8 @@ static Entry* new_Entry(Device_state* state, int thread_count)
 
     for (int ti = 0; ti < thread_count; ++ti)
     {
-        entry->thread_states[ti] = new_Device_thread_state(device, audio_buffer_size);
+        entry->thread_states[ti] =
+            new_Device_thread_state(device, audio_buffer_size, arenas[ti]);
         if (entry->thread_states[ti] == NULL)
         {
             del_Entry(entry);
@@ -96,7 +110,13 @@ static Entry* new_Entry(Device_state* state, int thread_count)
 struct Device_states
 {
     int thread_count;
+    Thread_arena* arenas[KQT_THREADS_MAX];
+    int32_t control_period;
     Entry* entries[ENTRY_TABLE_SIZE];
+
+#ifdef ENABLE_THREADS
+    atomic_int atomic_mix_slot_index;
+#endif
 };
 
 
@@ -107,19 +127,30 @@ Device_states* new_Device_states(void)
         return NULL;
 
     states->thread_count = 0;
+    for (int i = 0; i < KQT_THREADS_MAX; ++i)
+        states->arenas[i] = NULL;
+    states->control_period = 1;
     for (int i = 0; i < ENTRY_TABLE_SIZE; ++i)
         states->entries[i] = NULL;
 
+#ifdef ENABLE_THREADS
+    states->atomic_mix_slot_index = 0;
+#endif
+
     return states;
 }
 
 
-bool Device_states_set_thread_count(Device_states* states, int new_count)
+bool Device_states_set_thread_count(
+        Device_states* states, int new_count, Thread_arena* arenas[])
 {
     rassert(states != NULL);
     rassert(new_count >= 1);
     rassert(new_count <= KQT_THREADS_MAX);
 
+    for (int ti = 0; ti < KQT_THREADS_MAX; ++ti)
+        states->arenas[ti] = ((arenas != NULL) && (ti < new_count)) ? arenas[ti] : NULL;
+
     for (int ei = 0; ei < ENTRY_TABLE_SIZE; ++ei)
     {
         Entry* entry = states->entries[ei];
@@ -134,8 +165,8 @@ bool Device_states_set_thread_count(Device_states* states, int new_count)
             {
                 if (entry->thread_states[ti] == NULL)
                 {
-                    Device_thread_state* ts =
-                        new_Device_thread_state(device, audio_buffer_size);
+                    Device_thread_state* ts = new_Device_thread_state(
+                            device, audio_buffer_size, states->arenas[ti]);
                     if (ts == NULL)
                         return false;
 
@@ -167,7 +198,7 @@ bool Device_states_add_state(Device_states* states, Device_state* state)
 
     const uint32_t h = id_hash(state->device_id);
 
-    Entry* entry = new_Entry(state, states->thread_count);
+    Entry* entry = new_Entry(state, states->thread_count, states->arenas);
     if (entry == NULL)
         return false;
 
@@ -175,6 +206,7 @@ bool Device_states_add_state(Device_states* states, Device_state* state)
     entry->next = tail;
     states->entries[h] = entry;
 
+    Device_state_set_control_period(state, states->control_period);
     Device_state_reset(state);
 
     return true;
@@ -309,6 +341,30 @@ bool Device_states_set_audio_rate(Device_states* states, int32_t rate)
 }
 
 
+void Device_states_set_control_period(Device_states* states, int32_t period)
+{
+    rassert(states != NULL);
+    rassert(period >= 1);
+    rassert(period <= KQT_CONTROL_PERIOD_MAX);
+
+    states->control_period = period;
+
+    for (int ei = 0; ei < ENTRY_TABLE_SIZE; ++ei)
+    {
+        Entry* entry = states->entries[ei];
+        while (entry != NULL)
+        {
+            rassert(entry->state != NULL);
+            Device_state_set_control_period(entry->state, period);
+
+            entry = entry->next;
+        }
+    }
+
+    return;
+}
+
+
 bool Device_states_set_audio_buffer_size(Device_states* states, int32_t size)
 {
     rassert(states != NULL);
@@ -556,17 +612,32 @@ bool Device_states_prepare(Device_states* dstates, const Connections* conns)
 }
 
 
-void Device_states_mix_thread_states(
-        Device_states* dstates, int32_t buf_start, int32_t buf_stop)
+void Device_states_start_mixing_thread_states(Device_states* dstates)
 {
     rassert(dstates != NULL);
-    rassert(buf_start >= 0);
-    rassert(buf_stop >= 0);
 
-    if (dstates->thread_count <= 1)
-        return;
+#ifdef ENABLE_THREADS
+    dstates->atomic_mix_slot_index = 0;
+#endif
 
-    for (int ei = 0; ei < ENTRY_TABLE_SIZE; ++ei)
+    return;
+}
+
+
+static void mix_entry_slots(
+        Device_states* dstates,
+        int slot_start,
+        int slot_stop,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(dstates != NULL);
+    rassert(slot_start >= 0);
+    rassert(slot_stop <= ENTRY_TABLE_SIZE);
+
+    const int src_count = dstates->thread_count - 1;
+
+    for (int ei = slot_start; ei < slot_stop; ++ei)
     {
         Entry* entry = dstates->entries[ei];
         while (entry != NULL)
@@ -574,14 +645,12 @@ void Device_states_mix_thread_states(
             Device_thread_state* dest_state = entry->thread_states[0];
             rassert(dest_state != NULL);
 
-            for (int ti = 1; ti < dstates->thread_count; ++ti)
-            {
-                const Device_thread_state* src_state = entry->thread_states[ti];
-                rassert(src_state != NULL);
+            const Device_thread_state* src_states[KQT_THREADS_MAX] = { NULL };
+            for (int si = 0; si < src_count; ++si)
+                src_states[si] = entry->thread_states[si + 1];
 
-                Device_thread_state_combine_mixed_audio(
-                        dest_state, src_state, buf_start, buf_stop);
-            }
+            Device_thread_state_combine_mixed_audio(
+                    dest_state, src_count, src_states, buf_start, buf_stop);
 
             entry = entry->next;
         }
@@ -591,6 +660,36 @@ void Device_states_mix_thread_states(
 }
 
 
+void Device_states_mix_thread_states(
+        Device_states* dstates, int32_t buf_start, int32_t buf_stop)
+{
+    rassert(dstates != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop >= 0);
+
+    if (dstates->thread_count <= 1)
+        return;
+
+#ifdef ENABLE_THREADS
+    // Claim entry table slots until all of them have been processed
+    while (true)
+    {
+        const int slot_start =
+            atomic_fetch_add(&dstates->atomic_mix_slot_index, MIX_SLOT_CHUNK_SIZE);
+        if (slot_start >= ENTRY_TABLE_SIZE)
+            break;
+
+        const int slot_stop = min(slot_start + MIX_SLOT_CHUNK_SIZE, ENTRY_TABLE_SIZE);
+        mix_entry_slots(dstates, slot_start, slot_stop, buf_start, buf_stop);
+    }
+#else
+    mix_entry_slots(dstates, 0, ENTRY_TABLE_SIZE, buf_start, buf_stop);
+#endif
+
+    return;
+}
+
+
 void Device_states_reset(Device_states* states)
 {
     rassert(states != NULL);
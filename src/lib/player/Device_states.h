@@ -39,10 +39,15 @@ Device_states* new_Device_states(void);
  * \param states      The Device states -- must not be \c NULL.
  * \param new_count   The number of threads -- must be >= \c 1 and
  *                    <= \c KQT_THREADS_MAX.
+ * \param arenas      The Thread arenas of the threads, or \c NULL if all
+ *                    buffers should be allocated from the general heap.
+ *                    Individual arenas may also be \c NULL. The arenas must
+ *                    outlive the thread states allocated from them.
  *
  * \return   \c true if successful, or \c false if memory allocation failed.
  */
-bool Device_states_set_thread_count(Device_states* states, int new_count);
+bool Device_states_set_thread_count(
+        Device_states* states, int new_count, Thread_arena* arenas[]);
 
 
 /**
@@ -104,6 +109,18 @@ Device_thread_state* Device_states_get_thread_state(
 bool Device_states_set_audio_rate(Device_states* states, int32_t rate);
 
 
+/**
+ * Set the control period.
+ *
+ * The period is also applied to all Device states added afterwards.
+ *
+ * \param states   The Device states -- must not be \c NULL.
+ * \param period   The control period in frames -- must be >= \c 1 and
+ *                 <= \c KQT_CONTROL_PERIOD_MAX.
+ */
+void Device_states_set_control_period(Device_states* states, int32_t period);
+
+
 /**
  * Set the audio buffer size.
  *
@@ -155,9 +172,25 @@ void Device_states_set_tempo(Device_states* states, double tempo);
 bool Device_states_prepare(Device_states* dstates, const Connections* conns);
 
 
+/**
+ * Prepare the Device states for mixing buffers rendered by separate threads.
+ *
+ * This function must be called before each round of calls to
+ * \a Device_states_mix_thread_states.
+ *
+ * \param dstates   The Device states -- must not be \c NULL.
+ */
+void Device_states_start_mixing_thread_states(Device_states* dstates);
+
+
 /**
  * Mix buffers rendered by separate threads.
  *
+ * The buffers of each device are added to the buffers of the first thread.
+ * If libkunquat is built with thread support, this function may be called
+ * by several threads concurrently, in which case the devices are divided
+ * between the callers.
+ *
  * \param dstates     The Device states -- must not be \c NULL.
  * \param buf_start   The start index of the buffer area to be processed
  *                    -- must be less than the buffer size.
@@ -25,6 +25,9 @@ EVENT_AUTO_DEF("Arow",      location_row,           TSTAMP,         v_any_ts)
 EVENT_AUTO_DEF("Avoices",   voice_count,            INT,            v_any_int)
 EVENT_AUTO_DEF("Avgroups",  vgroup_count,           INT,            v_any_int)
 EVENT_AUTO_DEF("Af",        actual_force,           REALTIME,       NULL)
+EVENT_AUTO_DEF("Aoverload", cpu_overload,           FLOAT,          v_any_float)
+EVENT_AUTO_DEF("Apolyphony", polyphony_limit,       INT,            v_any_int)
+EVENT_AUTO_DEF("Avsteal",   vgroup_steal_count,     INT,            v_any_int)
 
 
 #undef EVENT_AUTO_DEF
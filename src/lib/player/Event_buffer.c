@@ -15,12 +15,14 @@
 #include <player/Event_buffer.h>
 
 #include <debug/assert.h>
+#include <kunquat/Player.h>
 #include <mathnum/common.h>
 #include <memory.h>
 #include <string/common.h>
+#include <string/serialise.h>
 
+#include <limits.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -31,6 +33,10 @@ struct Event_buffer
     int32_t write_pos;
     char* buf;
 
+    int32_t bin_size;
+    int32_t bin_write_pos;
+    unsigned char* bin_buf;
+
     int32_t events_added;
     bool is_skipping;
     int32_t events_skipped;
@@ -54,13 +60,19 @@ Event_buffer* new_Event_buffer(int32_t size)
     ebuf->write_pos = 0;
     ebuf->buf = NULL;
 
+    // A binary record never takes much more space than its JSON counterpart
+    ebuf->bin_size = ebuf->size + EVENT_LEN_MAX;
+    ebuf->bin_write_pos = 0;
+    ebuf->bin_buf = NULL;
+
     ebuf->events_added = 0;
     ebuf->is_skipping = false;
     ebuf->events_skipped = 0;
 
     // Init fields
     ebuf->buf = memory_calloc_items(char, ebuf->size + 1);
-    if (ebuf->buf == NULL)
+    ebuf->bin_buf = memory_alloc_items(unsigned char, ebuf->bin_size);
+    if ((ebuf->buf == NULL) || (ebuf->bin_buf == NULL))
     {
         del_Event_buffer(ebuf);
         return NULL;
@@ -130,6 +142,112 @@ const char* Event_buffer_get_events(const Event_buffer* ebuf)
 }
 
 
+const unsigned char* Event_buffer_get_events_binary(
+        const Event_buffer* ebuf, int32_t* size)
+{
+    rassert(ebuf != NULL);
+    rassert(size != NULL);
+
+    *size = ebuf->bin_write_pos;
+
+    return ebuf->bin_buf;
+}
+
+
+static void Event_buffer_add_binary(
+        Event_buffer* ebuf, int ch, const char* name, const Value* arg)
+{
+    rassert(ebuf != NULL);
+    rassert(name != NULL);
+    rassert(arg != NULL);
+
+    unsigned char arg_type = KQT_EVENT_ARG_NONE;
+    unsigned char payload[KQT_VAR_NAME_MAX + 3] = { 0 };
+    size_t payload_len = 0;
+
+    switch (arg->type)
+    {
+        case VALUE_TYPE_NONE:
+            break;
+
+        case VALUE_TYPE_BOOL:
+        {
+            arg_type = KQT_EVENT_ARG_BOOL;
+            payload[0] = arg->value.bool_type ? 1 : 0;
+            payload_len = 1;
+        }
+        break;
+
+        case VALUE_TYPE_INT:
+        {
+            arg_type = KQT_EVENT_ARG_INT;
+            memcpy(payload, &arg->value.int_type, sizeof(int64_t));
+            payload_len = sizeof(int64_t);
+        }
+        break;
+
+        case VALUE_TYPE_FLOAT:
+        {
+            arg_type = KQT_EVENT_ARG_FLOAT;
+            memcpy(payload, &arg->value.float_type, sizeof(double));
+            payload_len = sizeof(double);
+        }
+        break;
+
+        case VALUE_TYPE_TSTAMP:
+        {
+            arg_type = KQT_EVENT_ARG_TSTAMP;
+            const Tstamp* ts = &arg->value.Tstamp_type;
+            memcpy(payload, &ts->beats, sizeof(int64_t));
+            memcpy(payload + sizeof(int64_t), &ts->rem, sizeof(int32_t));
+            payload_len = sizeof(int64_t) + sizeof(int32_t);
+        }
+        break;
+
+        case VALUE_TYPE_STRING:
+        {
+            arg_type = KQT_EVENT_ARG_STRING;
+            payload_len = strlen(arg->value.string_type);
+            rassert(payload_len <= sizeof(payload));
+            memcpy(payload, arg->value.string_type, payload_len);
+        }
+        break;
+
+        case VALUE_TYPE_PAT_INST_REF:
+        {
+            arg_type = KQT_EVENT_ARG_PAT_INST_REF;
+            const int32_t pat = arg->value.Pat_inst_ref_type.pat;
+            const int32_t inst = arg->value.Pat_inst_ref_type.inst;
+            memcpy(payload, &pat, sizeof(int32_t));
+            memcpy(payload + sizeof(int32_t), &inst, sizeof(int32_t));
+            payload_len = 2 * sizeof(int32_t);
+        }
+        break;
+
+        default:
+            rassert(false);
+    }
+
+    const size_t name_len = strlen(name);
+    rassert(name_len <= UCHAR_MAX);
+
+    const int32_t record_len = (int32_t)(4 + name_len + payload_len);
+    rassert(ebuf->bin_write_pos + record_len <= ebuf->bin_size);
+
+    unsigned char* record = ebuf->bin_buf + ebuf->bin_write_pos;
+    record[0] = (unsigned char)ch;
+    record[1] = arg_type;
+    record[2] = (unsigned char)name_len;
+    record[3] = (unsigned char)payload_len;
+    memcpy(record + 4, name, name_len);
+    memcpy(record + 4 + name_len, payload, payload_len);
+
+    ebuf->bin_write_pos += record_len;
+
+    return;
+}
+
+
 void Event_buffer_add(Event_buffer* ebuf, int ch, const char* name, const Value* arg)
 {
     rassert(ebuf != NULL);
@@ -161,45 +279,55 @@ void Event_buffer_add(Event_buffer* ebuf, int ch, const char* name, const Value*
         return;
     }
 
-    int advance = 0;
+    char* const start = ebuf->buf + ebuf->write_pos;
+    char* pos = start;
 
     // Everything before the name
-    advance += sprintf(
-            ebuf->buf + ebuf->write_pos + advance,
-            "%s[%d, [",
-            ebuf->write_pos == 1 ? "" : ", ",
-            ch);
+    if (ebuf->write_pos != 1)
+    {
+        *pos++ = ',';
+        *pos++ = ' ';
+    }
+    *pos++ = '[';
+    pos += serialise_int(pos, EVENT_LEN_MAX, ch);
+    *pos++ = ',';
+    *pos++ = ' ';
+    *pos++ = '[';
 
     // Name
     const size_t len = strlen(name);
     rassert(len > 0);
+    *pos++ = '"';
     if (name[len - 1] == '"')
     {
         // Print with properly escaped trailing double quote
-        advance += sprintf(
-                ebuf->buf + ebuf->write_pos + advance,
-                "\"%.*s\\\"\", ",
-                (int)(len - 1),
-                name);
+        memcpy(pos, name, len - 1);
+        pos += len - 1;
+        *pos++ = '\\';
+        *pos++ = '"';
     }
     else
     {
         // Print name as-is
-        advance += sprintf(
-                ebuf->buf + ebuf->write_pos + advance,
-                "\"%s\", ",
-                name);
+        memcpy(pos, name, len);
+        pos += len;
     }
+    *pos++ = '"';
+    *pos++ = ',';
+    *pos++ = ' ';
 
     static const char closing_str[] = "]]";
 
     // Value
-    const int max_value_bytes = EVENT_LEN_MAX - advance - (int)strlen(closing_str);
-    advance += Value_serialise(
-            arg, max_value_bytes, ebuf->buf + ebuf->write_pos + advance);
+    const int max_value_bytes =
+        EVENT_LEN_MAX - (int)(pos - start) - (int)strlen(closing_str);
+    pos += Value_serialise(arg, max_value_bytes, pos);
 
     // Close the event
-    advance += sprintf(ebuf->buf + ebuf->write_pos + advance, "%s", closing_str);
+    memcpy(pos, closing_str, strlen(closing_str));
+    pos += strlen(closing_str);
+
+    const int advance = (int)(pos - start);
 
     // Update the write position
     ebuf->write_pos += advance;
@@ -208,6 +336,8 @@ void Event_buffer_add(Event_buffer* ebuf, int ch, const char* name, const Value*
     // Close the list
     strcpy(ebuf->buf + ebuf->write_pos, "]");
 
+    Event_buffer_add_binary(ebuf, ch, name, arg);
+
     ++ebuf->events_added;
 
     return;
@@ -245,6 +375,7 @@ void Event_buffer_clear(Event_buffer* ebuf)
 
     strcpy(ebuf->buf, EMPTY_BUFFER);
     ebuf->write_pos = 1;
+    ebuf->bin_write_pos = 0;
 
     return;
 }
@@ -256,6 +387,7 @@ void del_Event_buffer(Event_buffer* ebuf)
         return;
 
     memory_free(ebuf->buf);
+    memory_free(ebuf->bin_buf);
     memory_free(ebuf);
 
     return;
@@ -121,6 +121,22 @@ bool Event_buffer_is_zero_skipping(const Event_buffer* ebuf);
 const char* Event_buffer_get_events(const Event_buffer* ebuf);
 
 
+/**
+ * Get the Event buffer contents in the binary format.
+ *
+ * The format is described in the documentation of
+ * \a kqt_Handle_receive_events_binary.
+ *
+ * \param ebuf   The Event buffer -- must not be \c NULL.
+ * \param size   Destination for the size of the contents in bytes -- must not
+ *               be \c NULL.
+ *
+ * \return   The events.
+ */
+const unsigned char* Event_buffer_get_events_binary(
+        const Event_buffer* ebuf, int32_t* size);
+
+
 /**
  * Add an event to the Event buffer.
  *
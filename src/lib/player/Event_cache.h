@@ -1,7 +1,7 @@
 
 
 /*
- * Author: Tomi Jylhä-Ollila, Finland 2012-2016
+ * Author: Tomi Jylhä-Ollila, Finland 2012-2019
  *
  * This file is part of Kunquat.
  *
@@ -16,6 +16,7 @@
 #define KQT_EVENT_CACHE_H
 
 
+#include <player/Event_type.h>
 #include <Value.h>
 
 #include <stdbool.h>
@@ -41,33 +42,33 @@ Event_cache* new_Event_cache(void);
  * Add an event to the Event cache.
  *
  * \param cache        The Event cache -- must not be \c NULL.
- * \param event_name   The name of the Event -- must not be \c NULL.
+ * \param event_type   The Event type -- must be valid or \c Event_NONE.
  *
  * \return   \c true if successful, or \c false if memory allocation failed.
  */
-bool Event_cache_add_event(Event_cache* cache, char* event_name);
+bool Event_cache_add_event(Event_cache* cache, Event_type event_type);
 
 
 /**
  * Update the Event cache.
  *
  * \param cache        The Event cache -- must not be \c NULL.
- * \param event_name   The name of the Event -- must not be \c NULL.
+ * \param event_type   The Event type -- must be valid.
  * \param value        The Event parameter -- must not be \c NULL.
  */
-void Event_cache_update(Event_cache* cache, const char* event_name, const Value* value);
+void Event_cache_update(Event_cache* cache, Event_type event_type, const Value* value);
 
 
 /**
  * Get a value from the Event cache.
  *
  * \param cache        The Event cache -- must not be \c NULL.
- * \param event_name   The name of the Event -- must not be \c NULL and
- *                     must be an event name found in \a cache.
+ * \param event_type   The Event type -- must be an Event type found in
+ *                     \a cache.
  *
- * \return   The value associated with \a event_name. This is never \c NULL.
+ * \return   The value associated with \a event_type. This is never \c NULL.
  */
-const Value* Event_cache_get_value(const Event_cache* cache, const char* event_name);
+const Value* Event_cache_get_value(const Event_cache* cache, Event_type event_type);
 
 
 /**
@@ -24,6 +24,7 @@
 
 typedef struct Entry
 {
+    const char* name;
     Value_type param_type;
     Param_validator* validator;
     char name_setter[KQT_EVENT_NAME_MAX + 1];
@@ -33,13 +34,22 @@ typedef struct Entry
 static Entry entries[Event_STOP] =
 {
 #define EVENT_TYPE_DEF(name, category, type_suffix, arg_type, validator) \
-    [Event_##category##_##type_suffix] = { VALUE_TYPE_##arg_type, validator, "" },
+    [Event_##category##_##type_suffix] = \
+        { name, VALUE_TYPE_##arg_type, validator, "" },
 #define EVENT_TYPE_NS_DEF(name, category, type_suffix, arg_type, validator, ns) \
-    [Event_##category##_##type_suffix] = { VALUE_TYPE_##arg_type, validator, ns },
+    [Event_##category##_##type_suffix] = \
+        { name, VALUE_TYPE_##arg_type, validator, ns },
 #include <player/Event_types.h>
 };
 
 
+const char* Event_properties_get_name(Event_type event_type)
+{
+    rassert(Event_is_valid(event_type));
+    return entries[event_type].name;
+}
+
+
 Value_type Event_properties_get_param_type(Event_type event_type)
 {
     rassert(Event_is_valid(event_type));
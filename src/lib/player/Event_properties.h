@@ -24,6 +24,16 @@
 #include <stdlib.h>
 
 
+/**
+ * Get the name of a given Event type.
+ *
+ * \param event_type   The Event type -- must be valid.
+ *
+ * \return   The event name.
+ */
+const char* Event_properties_get_name(Event_type event_type);
+
+
 /**
  * Get the parameter type of a given Event type.
  *
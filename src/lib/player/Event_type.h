@@ -67,6 +67,9 @@ typedef enum
     Event_auto_voice_count,
     Event_auto_vgroup_count,
     Event_auto_actual_force,
+    Event_auto_cpu_overload,
+    Event_auto_polyphony_limit,
+    Event_auto_vgroup_steal_count,
 
     Event_auto_STOP,
 
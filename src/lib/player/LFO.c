@@ -425,6 +425,82 @@ double LFO_skip(LFO* lfo, int64_t steps)
 }
 
 
+static double LFO_get_value(const LFO* lfo)
+{
+    rassert(lfo != NULL);
+
+    double cur_depth = lfo->target_depth;
+    if (Slider_in_progress(&lfo->depth_slider))
+    {
+        const double progress = Slider_get_value(&lfo->depth_slider);
+        cur_depth = lerp(lfo->prev_depth, lfo->target_depth, progress);
+    }
+
+    return fast_sin(lfo->phase) * cur_depth;
+}
+
+
+int32_t LFO_mix_values(
+        LFO* lfo, float* values, int32_t buf_start, int32_t buf_stop, int32_t ctl_period)
+{
+    rassert(lfo != NULL);
+    rassert(values != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop >= buf_start);
+    rassert(ctl_period >= 1);
+
+    int32_t cur_pos = buf_start;
+    int32_t final_lfo_stop = buf_start;
+    while (cur_pos < buf_stop)
+    {
+        const int32_t estimated_steps = LFO_estimate_active_steps_left(lfo);
+        if (estimated_steps <= 0)
+        {
+            final_lfo_stop = cur_pos;
+            break;
+        }
+
+        int32_t lfo_stop = buf_stop;
+        if (estimated_steps < buf_stop - cur_pos)
+            lfo_stop = cur_pos + estimated_steps;
+
+        int32_t i = cur_pos;
+
+        if (ctl_period > 1)
+        {
+            while ((i + ctl_period <= lfo_stop) && lfo->on)
+            {
+                if (!LFO_active(lfo))
+                {
+                    // Let the first step start the oscillation
+                    values[i] += (float)LFO_step(lfo);
+                    ++i;
+                    continue;
+                }
+
+                const double start_value = LFO_get_value(lfo);
+                LFO_skip(lfo, ctl_period - 1);
+                const double end_value = LFO_step(lfo);
+                const double step = (end_value - start_value) / ctl_period;
+
+                for (int32_t k = 0; k < ctl_period; ++k)
+                    values[i + k] += (float)(start_value + (step * (k + 1)));
+
+                i += ctl_period;
+            }
+        }
+
+        for (; i < lfo_stop; ++i)
+            values[i] += (float)LFO_step(lfo);
+
+        final_lfo_stop = lfo_stop;
+        cur_pos = lfo_stop;
+    }
+
+    return final_lfo_stop;
+}
+
+
 static void LFO_update_time(LFO* lfo, int32_t audio_rate, double tempo)
 {
     rassert(lfo != NULL);
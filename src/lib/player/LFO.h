@@ -208,6 +208,26 @@ double LFO_step(LFO* lfo);
 double LFO_skip(LFO* lfo, int64_t steps);
 
 
+/**
+ * Add LFO updates to a value buffer.
+ *
+ * With a control period greater than \c 1, the LFO is advanced one period at
+ * a time and the oscillation is interpolated linearly inside each period.
+ * A LFO that is fading out after being turned off is always stepped at audio
+ * rate so that it stops at the correct phase.
+ *
+ * \param lfo          The LFO -- must not be \c NULL.
+ * \param values       The buffer to be updated -- must not be \c NULL.
+ * \param buf_start    The buffer start index -- must be >= \c 0.
+ * \param buf_stop     The buffer stop index -- must be >= \a buf_start.
+ * \param ctl_period   The control period -- must be >= \c 1.
+ *
+ * \return   The stop index of the area modified by the LFO.
+ */
+int32_t LFO_mix_values(
+        LFO* lfo, float* values, int32_t buf_start, int32_t buf_stop, int32_t ctl_period);
+
+
 /**
  * Find out whether the LFO is still providing non-trivial values.
  *
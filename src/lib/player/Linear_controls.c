@@ -50,6 +50,7 @@ void Linear_controls_reset(Linear_controls* lc)
     LFO_reset(&lc->lfo);
     lc->def_osc_speed = 0;
     lc->def_osc_depth = 0;
+    lc->ctl_period = 1;
 
     return;
 }
@@ -79,6 +80,17 @@ void Linear_controls_set_tempo(Linear_controls* lc, double tempo)
 }
 
 
+void Linear_controls_set_control_period(Linear_controls* lc, int32_t period)
+{
+    rassert(lc != NULL);
+    rassert(period >= 1);
+
+    lc->ctl_period = period;
+
+    return;
+}
+
+
 void Linear_controls_set_range(Linear_controls* lc, double min_value, double max_value)
 {
     rassert(lc != NULL);
@@ -252,69 +264,27 @@ void Linear_controls_fill_work_buffer(
 
     float* values = Work_buffer_get_contents_mut(wb);
 
-    int32_t const_start = buf_start;
+    const double slide_step = Slider_get_step(&lc->slider);
+    const bool lfo_active = (LFO_estimate_active_steps_left(&lc->lfo) > 0);
 
     // Apply slider
-    {
-        int32_t cur_pos = buf_start;
-        while (cur_pos < buf_stop)
-        {
-            const int32_t estimated_steps =
-                Slider_estimate_active_steps_left(&lc->slider);
-            if (estimated_steps > 0)
-            {
-                int32_t slide_stop = buf_stop;
-                if (estimated_steps < buf_stop - cur_pos)
-                    slide_stop = cur_pos + estimated_steps;
-
-                double new_value = lc->value;
-                for (int32_t i = cur_pos; i < slide_stop; ++i)
-                {
-                    new_value = Slider_step(&lc->slider);
-                    values[i] = (float)new_value;
-                }
-                lc->value = new_value;
-
-                const_start = slide_stop;
-                cur_pos = slide_stop;
-            }
-            else
-            {
-                const float value = (float)lc->value;
-                for (int32_t i = cur_pos; i < buf_stop; ++i)
-                    values[i] = value;
+    int32_t const_start = Slider_fill_values(
+            &lc->slider, &lc->value, 0, values, buf_start, buf_stop, lc->ctl_period);
 
-                cur_pos = buf_stop;
-            }
-        }
+    // The slide is linear except for its last frame which may be snapped to target
+    const int32_t ramp_stop = const_start - 1;
+    bool is_ramp = !lfo_active && (ramp_stop - buf_start >= 2);
+    if (is_ramp)
+    {
+        const double first = values[buf_start];
+        const double last = values[ramp_stop - 1];
+        is_ramp = (min(first, last) >= lc->min_value) && (max(first, last) <= lc->max_value);
     }
 
     // Apply LFO
     {
-        int32_t cur_pos = buf_start;
-        int32_t final_lfo_stop = buf_start;
-        while (cur_pos < buf_stop)
-        {
-            const int32_t estimated_steps = LFO_estimate_active_steps_left(&lc->lfo);
-            if (estimated_steps > 0)
-            {
-                int32_t lfo_stop = buf_stop;
-                if (estimated_steps < buf_stop - cur_pos)
-                    lfo_stop = cur_pos + estimated_steps;
-
-                for (int32_t i = cur_pos; i < lfo_stop; ++i)
-                    values[i] += (float)LFO_step(&lc->lfo);
-
-                final_lfo_stop = lfo_stop;
-                cur_pos = lfo_stop;
-            }
-            else
-            {
-                final_lfo_stop = cur_pos;
-                break;
-            }
-        }
-
+        const int32_t final_lfo_stop = LFO_mix_values(
+                &lc->lfo, values, buf_start, buf_stop, lc->ctl_period);
         const_start = max(const_start, final_lfo_stop);
     }
 
@@ -336,6 +306,9 @@ void Linear_controls_fill_work_buffer(
     // Mark constant region of the buffer
     Work_buffer_set_const_start(wb, const_start);
 
+    if (is_ramp)
+        Work_buffer_set_ramp(wb, buf_start, ramp_stop, (float)slide_step);
+
     return;
 }
 
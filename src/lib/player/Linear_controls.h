@@ -36,6 +36,7 @@ struct Linear_controls
     LFO lfo;
     double def_osc_speed;
     double def_osc_depth;
+    int32_t ctl_period;
 };
 
 
@@ -73,6 +74,15 @@ void Linear_controls_set_audio_rate(Linear_controls* lc, int32_t audio_rate);
 void Linear_controls_set_tempo(Linear_controls* lc, double tempo);
 
 
+/**
+ * Set control period of the Linear controls.
+ *
+ * \param lc       The Linear controls -- must not be \c NULL.
+ * \param period   The control period in frames -- must be >= \c 1.
+ */
+void Linear_controls_set_control_period(Linear_controls* lc, int32_t period);
+
+
 /**
  * Set value range in the Linear controls.
  *
@@ -380,6 +380,14 @@ static bool Mixed_signal_plan_build_from_node(
             task_info->is_input_required = false;
         }
     }
+    else if ((Device_node_get_type(node) == DEVICE_NODE_TYPE_MASTER) &&
+            (level_index > 0) &&
+            (container_id == 0))
+    {
+        // The input interface of the master is filled by the host
+        Mixed_signal_task_info* task_info = Array_get_ref(plan->tasks, task_info_index);
+        task_info->is_input_required = false;
+    }
 
     Device_thread_state* recv_ts =
         Device_states_get_thread_state(dstates, 0, node_device_id);
@@ -16,19 +16,28 @@
 
 #include <debug/assert.h>
 #include <Error.h>
+#include <init/Au_table.h>
+#include <init/Bind.h>
 #include <init/devices/Au_params.h>
 #include <init/devices/Audio_unit.h>
+#include <init/devices/Device_impl.h>
 #include <init/sheet/Channel_defaults.h>
+#include <init/sheet/Pattern.h>
 #include <kunquat/limits.h>
 #include <mathnum/common.h>
 #include <memory.h>
 #include <Pat_inst_ref.h>
+#include <player/Automation_lanes.h>
+#include <player/devices/Au_state.h>
 #include <player/devices/Device_thread_state.h>
 #include <player/devices/Voice_state.h>
+#include <player/Event_properties.h>
 #include <player/Mixed_signal_plan.h>
 #include <player/Player_private.h>
 #include <player/Player_seq.h>
 #include <player/Position.h>
+#include <player/Thread_arena.h>
+#include <player/Timeline.h>
 #include <player/Tuning_state.h>
 #include <player/Voice_group.h>
 #include <player/Voice_group_reservations.h>
@@ -41,11 +50,22 @@
 #include <threads/Mutex.h>
 #include <threads/Thread.h>
 
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+
+#ifdef ENABLE_THREAD_ARENAS
+#ifdef ENABLE_HUGE_PAGES
+#define ARENA_HUGE_PAGES true
+#else
+#define ARENA_HUGE_PAGES false
+#endif
+#endif
 
 
 #ifdef ENABLE_THREADS
@@ -54,6 +74,7 @@ static void* render_thread_func(void* arg);
 
 
 static bool Player_prepare_mixing_with_thread_count(Player* player, int thread_count);
+static bool Player_create_module_states(Player* player);
 
 
 static void Player_thread_params_init(
@@ -68,6 +89,7 @@ static void Player_thread_params_init(
     tp->thread_id = thread_id;
     tp->active_voices = 0;
     tp->active_vgroups = 0;
+    tp->arena = NULL;
     tp->work_buffers = NULL;
     for (int ch = 0; ch < 2; ++ch)
         tp->test_voice_outputs[ch] = NULL;
@@ -136,12 +158,15 @@ Player* new_Player(
     player->audio_buffer_size = audio_buffer_size;
     player->audio_buffer = NULL;
     player->audio_frames_available = 0;
+    player->bus_count = 1;
+    player->bus_buffers = NULL;
 
     player->thread_count = 0;
     for (int i = 0; i < KQT_THREADS_MAX; ++i)
         Player_thread_params_init(&player->thread_params[i], player, i);
     player->start_cond = *CONDITION_AUTO;
     player->vgroups_start_barrier = *BARRIER_AUTO;
+    player->vgroups_rendered_barrier = *BARRIER_AUTO;
     player->vgroups_finished_barrier = *BARRIER_AUTO;
     for (int i = 0; i < KQT_THREADS_MAX; ++i)
         player->threads[i] = *THREAD_AUTO;
@@ -153,6 +178,15 @@ Player* new_Player(
     player->device_states = NULL;
     player->estate = NULL;
     player->event_buffer = NULL;
+    player->command_queue = NULL;
+    player->pending_commands = NULL;
+    player->pending_command_count = 0;
+    player->automation_lanes = NULL;
+    for (int i = 0; i < KQT_DEVICE_PORTS_MAX; ++i)
+    {
+        player->input_audio[i] = NULL;
+        player->input_frames[i] = 0;
+    }
     player->voices = NULL;
     player->mixed_signal_plan = NULL;
     Master_params_preinit(&player->master_params);
@@ -163,6 +197,7 @@ Player* new_Player(
     player->frame_remainder = 0.0;
 
     player->cgiters_accessed = false;
+    player->is_sequencer_only = false;
     for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
         Cgiter_init(&player->cgiters[i], player->module, i);
 
@@ -171,7 +206,13 @@ Player* new_Player(
 
     player->events_returned = false;
 
+    Polyphony_governor_init(&player->polyphony_governor, voice_count);
+    player->pending_overload = 0;
+    player->reported_polyphony_limit = voice_count;
+    player->reported_steal_count = 0;
+
     player->susp_event_ch = -1;
+    player->susp_event_type = Event_NONE;
     memset(player->susp_event_name, '\0', KQT_EVENT_NAME_MAX + 1);
     player->susp_event_value = *VALUE_AUTO;
 
@@ -179,10 +220,16 @@ Player* new_Player(
     player->device_states = new_Device_states();
     player->estate = new_Env_state(player->module->env);
     player->event_buffer = new_Event_buffer(event_buffer_size);
+    player->command_queue = new_Command_queue(COMMAND_QUEUE_SIZE);
+    player->pending_commands = memory_alloc_items(Command, COMMAND_QUEUE_SIZE);
+    player->automation_lanes = new_Automation_lanes(player->audio_buffer_size);
     player->voices = new_Voice_pool(voice_count);
     if (player->device_states == NULL ||
             player->estate == NULL ||
             player->event_buffer == NULL ||
+            player->command_queue == NULL ||
+            player->pending_commands == NULL ||
+            player->automation_lanes == NULL ||
             player->voices == NULL ||
             !Voice_pool_reserve_state_space(
                 player->voices,
@@ -192,16 +239,22 @@ Player* new_Player(
         return NULL;
     }
 
-    Device_state* master_state = Device_create_state(
-            (const Device*)player->module,
-            player->audio_rate,
-            player->audio_buffer_size);
-    if (master_state == NULL || !Device_states_add_state(
-                player->device_states, master_state))
+    const Device* master_devices[] =
     {
-        del_Device_state(master_state);
-        del_Player(player);
-        return NULL;
+        (const Device*)player->module,
+        Module_get_input_interface(player->module),
+    };
+    for (int i = 0; i < 2; ++i)
+    {
+        Device_state* master_state = Device_create_state(
+                master_devices[i], player->audio_rate, player->audio_buffer_size);
+        if (master_state == NULL || !Device_states_add_state(
+                    player->device_states, master_state))
+        {
+            del_Device_state(master_state);
+            del_Player(player);
+            return NULL;
+        }
     }
 
     if (Master_params_init(
@@ -255,6 +308,12 @@ Player* new_Player(
         }
     }
 
+    if (!Player_create_module_states(player))
+    {
+        del_Player(player);
+        return NULL;
+    }
+
     if (!Player_set_thread_count(player, 1, ERROR_AUTO))
     {
         del_Player(player);
@@ -279,6 +338,71 @@ Device_states* Player_get_device_states(const Player* player)
 }
 
 
+Command_queue* Player_get_command_queue(const Player* player)
+{
+    rassert(player != NULL);
+    return player->command_queue;
+}
+
+
+Automation_lanes* Player_get_automation_lanes(const Player* player)
+{
+    rassert(player != NULL);
+    return player->automation_lanes;
+}
+
+
+bool Player_set_input_audio(
+        Player* player, int port, int32_t frame_count, const float* data)
+{
+    rassert(player != NULL);
+    rassert(port >= 0);
+    rassert(port < KQT_DEVICE_PORTS_MAX);
+    rassert(frame_count >= 0);
+    rassert(frame_count <= player->audio_buffer_size);
+    rassert((data != NULL) || (frame_count == 0));
+
+    if ((player->input_audio[port] == NULL) && (frame_count > 0))
+    {
+        player->input_audio[port] =
+            memory_alloc_items(float, player->audio_buffer_size);
+        if (player->input_audio[port] == NULL)
+            return false;
+    }
+
+    if (frame_count > 0)
+        memcpy(player->input_audio[port], data, sizeof(float) * (size_t)frame_count);
+
+    player->input_frames[port] = frame_count;
+
+    return true;
+}
+
+
+static bool Player_add_pending_command(Player* player, const Command* command)
+{
+    rassert(player != NULL);
+    rassert(command != NULL);
+
+    if (player->pending_command_count >= COMMAND_QUEUE_SIZE)
+        return false;
+
+    // Keep the pending commands sorted by frame offset in arrival order
+    Command* pending = player->pending_commands;
+    int pos = player->pending_command_count;
+    while ((pos > 0) && (pending[pos - 1].frame_offset > command->frame_offset))
+    {
+        pending[pos] = pending[pos - 1];
+        --pos;
+    }
+
+    pending[pos] = *command;
+    ++player->pending_command_count;
+
+    return true;
+}
+
+
 static bool Player_thread_params_create_buffers(
         Player_thread_params* tp, int32_t audio_buffer_size)
 {
@@ -286,7 +410,16 @@ static bool Player_thread_params_create_buffers(
     rassert(tp->work_buffers == NULL);
     rassert(audio_buffer_size >= 0);
 
-    tp->work_buffers = new_Work_buffers(audio_buffer_size);
+#ifdef ENABLE_THREAD_ARENAS
+    if (tp->arena == NULL)
+    {
+        tp->arena = new_Thread_arena(ARENA_HUGE_PAGES);
+        if (tp->arena == NULL)
+            return false;
+    }
+#endif
+
+    tp->work_buffers = new_Work_buffers(audio_buffer_size, tp->arena);
     if (tp->work_buffers == NULL)
     {
         Player_thread_params_deinit(tp);
@@ -298,7 +431,8 @@ static bool Player_thread_params_create_buffers(
         for (int ch = 0; ch < 2; ++ch)
         {
             rassert(tp->test_voice_outputs[ch] == NULL);
-            tp->test_voice_outputs[ch] = new_Work_buffer(audio_buffer_size);
+            tp->test_voice_outputs[ch] =
+                new_Work_buffer_in_arena(audio_buffer_size, tp->arena);
             if (tp->test_voice_outputs[ch] == NULL)
             {
                 Player_thread_params_deinit(tp);
@@ -334,10 +468,7 @@ bool Player_set_thread_count(Player* player, int new_count, Error* error)
 
     // (De)allocate player Work buffers as needed
     for (int i = new_count; i < old_count; ++i)
-    {
-        del_Work_buffers(player->thread_params[i].work_buffers);
-        player->thread_params[i].work_buffers = NULL;
-    }
+        Player_thread_params_deinit(&player->thread_params[i]);
     for (int i = old_count; i < new_count; ++i)
     {
         if (!Player_thread_params_create_buffers(
@@ -352,7 +483,11 @@ bool Player_set_thread_count(Player* player, int new_count, Error* error)
     }
 
     // (De)allocate Work buffers of Device states as needed
-    if (!Device_states_set_thread_count(player->device_states, new_count) ||
+    Thread_arena* arenas[KQT_THREADS_MAX] = { NULL };
+    for (int i = 0; i < new_count; ++i)
+        arenas[i] = player->thread_params[i].arena;
+
+    if (!Device_states_set_thread_count(player->device_states, new_count, arenas) ||
             !Player_prepare_mixing_with_thread_count(player, new_count))
     {
         Error_set(
@@ -362,6 +497,13 @@ bool Player_set_thread_count(Player* player, int new_count, Error* error)
         return false;
     }
 
+    // Remove arenas of unused threads after all buffers in them are gone
+    for (int i = new_count; i < old_count; ++i)
+    {
+        del_Thread_arena(player->thread_params[i].arena);
+        player->thread_params[i].arena = NULL;
+    }
+
 #ifdef ENABLE_THREADS
 
     const int threads_needed = (new_count > 1) ? new_count : 0;
@@ -383,6 +525,7 @@ bool Player_set_thread_count(Player* player, int new_count, Error* error)
 
     // Deinitialise old barriers
     Barrier_deinit(&player->vgroups_start_barrier);
+    Barrier_deinit(&player->vgroups_rendered_barrier);
     Barrier_deinit(&player->vgroups_finished_barrier);
 
     // Create new barriers
@@ -390,7 +533,9 @@ bool Player_set_thread_count(Player* player, int new_count, Error* error)
     {
         const int count = threads_needed + 1;
 
+        // The rendered barrier only synchronises the rendering threads
         if (!Barrier_init(&player->vgroups_start_barrier, count, error) ||
+                !Barrier_init(&player->vgroups_rendered_barrier, threads_needed, error) ||
                 !Barrier_init(&player->vgroups_finished_barrier, count, error))
             return false;
     }
@@ -457,6 +602,24 @@ int Player_get_thread_count(const Player* player)
 }
 
 
+void Player_set_cpu_budget(Player* player, double budget)
+{
+    rassert(player != NULL);
+    rassert(budget >= 0);
+    rassert(budget <= 1);
+
+    Polyphony_governor_set_budget(&player->polyphony_governor, budget);
+    Voice_pool_set_polyphony_limit(
+            player->voices, Polyphony_governor_get_limit(&player->polyphony_governor));
+
+    player->pending_overload = 0;
+    player->reported_polyphony_limit = Voice_pool_get_polyphony_limit(player->voices);
+    player->reported_steal_count = Voice_pool_get_steal_count(player->voices);
+
+    return;
+}
+
+
 bool Player_reserve_voice_state_space(Player* player, int32_t size)
 {
     rassert(player != NULL);
@@ -483,6 +646,47 @@ bool Player_reserve_voice_work_buffer_space(Player* player, int32_t size)
 }
 
 
+static bool Player_update_buses(Player* player)
+{
+    rassert(player != NULL);
+
+    // Each pair of master output ports forms a bus
+    int bus_count = 1;
+    for (int port = KQT_BUFFERS_MAX; port < KQT_DEVICE_PORTS_MAX; ++port)
+    {
+        if (Device_get_port_existence(
+                    (const Device*)player->module, DEVICE_PORT_TYPE_RECV, port))
+            bus_count = port / KQT_BUFFERS_MAX + 1;
+    }
+
+    if ((bus_count == player->bus_count) || (player->audio_buffer_size == 0))
+    {
+        player->bus_count = bus_count;
+        return true;
+    }
+
+    if (bus_count == 1)
+    {
+        memory_free(player->bus_buffers);
+        player->bus_buffers = NULL;
+        player->bus_count = 1;
+        return true;
+    }
+
+    float* new_buses = memory_realloc_items(
+            float,
+            player->audio_buffer_size * KQT_BUFFERS_MAX * (bus_count - 1),
+            player->bus_buffers);
+    if (new_buses == NULL)
+        return false;
+
+    player->bus_buffers = new_buses;
+    player->bus_count = bus_count;
+
+    return true;
+}
+
+
 static bool Player_prepare_mixing_with_thread_count(Player* player, int thread_count)
 {
     rassert(player != NULL);
@@ -492,8 +696,12 @@ static bool Player_prepare_mixing_with_thread_count(Player* player, int thread_c
     del_Mixed_signal_plan(player->mixed_signal_plan);
     player->mixed_signal_plan = NULL;
 
+    if (!Player_update_buses(player))
+        return false;
+
+    // Players without audio output only track the playback position
     const Connections* conns = Module_get_connections(player->module);
-    if (conns == NULL)
+    if ((conns == NULL) || (player->audio_buffer_size == 0))
         return true;
 
     if (!Device_states_prepare(player->device_states, conns))
@@ -616,6 +824,129 @@ bool Player_create_tuning_state(Player* player, int index)
 }
 
 
+static bool Player_create_au_states(Player* player, const Audio_unit* au)
+{
+    rassert(player != NULL);
+    rassert(au != NULL);
+
+    // Players without audio output only need space for Voice states
+    const bool is_rendering = (player->audio_buffer_size > 0);
+
+    Device_states* dstates = player->device_states;
+
+    if (is_rendering)
+    {
+        const Device* au_devices[] =
+        {
+            (const Device*)au,
+            Audio_unit_get_input_interface(au),
+            Audio_unit_get_output_interface(au),
+        };
+        for (int i = 0; i < 3; ++i)
+        {
+            rassert(au_devices[i] != NULL);
+            Device_state* ds = Device_create_state(
+                    au_devices[i], player->audio_rate, player->audio_buffer_size);
+            if ((ds == NULL) || !Device_states_add_state(dstates, ds))
+            {
+                del_Device_state(ds);
+                return false;
+            }
+        }
+
+        Au_state* au_state = (Au_state*)Device_states_get_state(
+                dstates, Device_get_id((const Device*)au));
+        Au_state_set_device_states(au_state, dstates);
+    }
+
+    for (int i = 0; i < KQT_PROCESSORS_MAX; ++i)
+    {
+        const Processor* proc = Audio_unit_get_proc(au, i);
+        if (proc == NULL)
+            continue;
+
+        const Device_impl* dimpl = Device_get_impl((const Device*)proc);
+        if (dimpl == NULL)
+            continue;
+
+        if (!Player_reserve_voice_state_space(
+                    player, Device_impl_get_vstate_size(dimpl)))
+            return false;
+
+        if (!is_rendering)
+            continue;
+
+        const int32_t wb_size = Device_impl_get_voice_wb_size(dimpl, player->audio_rate);
+        if ((wb_size > Player_get_voice_work_buffer_size(player)) &&
+                !Player_reserve_voice_work_buffer_space(player, wb_size))
+            return false;
+
+        Device_state* ds = Device_create_state(
+                (const Device*)proc, player->audio_rate, player->audio_buffer_size);
+        if ((ds == NULL) || !Device_states_add_state(dstates, ds))
+        {
+            del_Device_state(ds);
+            return false;
+        }
+
+        if (!Device_sync_states((const Device*)proc, dstates))
+            return false;
+    }
+
+    for (int i = 0; i < KQT_AUDIO_UNITS_MAX; ++i)
+    {
+        const Audio_unit* sub_au = Audio_unit_get_au(au, i);
+        if ((sub_au != NULL) && !Player_create_au_states(player, sub_au))
+            return false;
+    }
+
+    return true;
+}
+
+
+static bool Player_create_module_states(Player* player)
+{
+    rassert(player != NULL);
+
+    Au_table* au_table = Module_get_au_table(player->module);
+    for (int i = 0; i < KQT_AUDIO_UNITS_MAX; ++i)
+    {
+        const Audio_unit* au = Au_table_get(au_table, i);
+        if (au == NULL)
+            continue;
+
+        if (!Player_create_au_states(player, au))
+            return false;
+
+        const Au_streams* streams = Audio_unit_get_streams(au);
+        if ((streams != NULL) && !Player_alloc_channel_streams(player, streams))
+            return false;
+    }
+
+    Device_states_set_control_period(player->device_states, player->module->control_period);
+
+    for (int i = 0; i < KQT_TUNING_TABLES_MAX; ++i)
+    {
+        if ((Module_get_tuning_table(player->module, i) != NULL) &&
+                !Player_create_tuning_state(player, i))
+            return false;
+    }
+
+    if ((player->module->bind != NULL) && !Player_refresh_bind_state(player))
+        return false;
+
+    return true;
+}
+
+
+void Player_set_sequencer_only(Player* player, bool enabled)
+{
+    rassert(player != NULL);
+    player->is_sequencer_only = enabled;
+    return;
+}
+
+
 void Player_reset(Player* player, int track_num)
 {
     rassert(player != NULL);
@@ -640,13 +971,25 @@ void Player_reset(Player* player, int track_num)
 
     Player_reset_channels(player);
 
+    // Bound channel events may fire tempo changes, jumps and pattern delays,
+    // so we need to visit all trigger rows if the Bind contains such targets
+    const Bind* bind = player->module->bind;
+    const bool use_seq_rows = player->is_sequencer_only &&
+        ((bind == NULL) || !Bind_affects_sequencing(bind));
+
     for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
+    {
+        Cgiter_set_sequencer_only(&player->cgiters[i], use_seq_rows);
         Cgiter_reset(&player->cgiters[i], &player->master_params.cur_pos);
+    }
 
     player->cgiters_accessed = false;
 
     Event_buffer_clear(player->event_buffer);
 
+    // The frame offsets of pending commands refer to the old position
+    player->pending_command_count = 0;
+
     player->audio_frames_processed = 0;
     player->nanoseconds_history = 0;
 
@@ -674,6 +1017,16 @@ void Player_reset_dc_blocker(Player* player)
 }
 
 
+void Player_stop(Player* player)
+{
+    rassert(player != NULL);
+
+    player->master_params.playback_state = PLAYBACK_STOPPED;
+
+    return;
+}
+
+
 bool Player_set_audio_rate(Player* player, int32_t rate)
 {
     rassert(player != NULL);
@@ -770,10 +1123,52 @@ bool Player_set_audio_buffer_size(Player* player, int32_t size)
         player->audio_buffer = new_buffer;
     }
 
+    if (size == 0)
+    {
+        memory_free(player->bus_buffers);
+        player->bus_buffers = NULL;
+    }
+    else if (player->bus_count > 1)
+    {
+        float* new_buses = memory_realloc_items(
+                float,
+                size * KQT_BUFFERS_MAX * (player->bus_count - 1),
+                player->bus_buffers);
+        if (new_buses == NULL)
+            return false;
+
+        player->bus_buffers = new_buses;
+    }
+
     // Update device state buffers
     if (!Device_states_set_audio_buffer_size(player->device_states, size))
         return false;
 
+    if (!Automation_lanes_set_buffer_size(player->automation_lanes, size))
+        return false;
+
+    for (int port = 0; port < KQT_DEVICE_PORTS_MAX; ++port)
+    {
+        player->input_frames[port] = 0;
+
+        if (player->input_audio[port] == NULL)
+            continue;
+
+        if (size == 0)
+        {
+            memory_free(player->input_audio[port]);
+            player->input_audio[port] = NULL;
+            continue;
+        }
+
+        float* new_input =
+            memory_realloc_items(float, size, player->input_audio[port]);
+        if (new_input == NULL)
+            return false;
+
+        player->input_audio[port] = new_input;
+    }
+
     // Update work buffers
     for (int i = 0; i < KQT_THREADS_MAX; ++i)
     {
@@ -1234,8 +1629,16 @@ static void* render_thread_func(void* arg)
 
         rassert(params->thread_id < player->thread_count);
 
+        if (params->arena != NULL)
+            Thread_arena_touch(params->arena);
+
         Player_process_voice_groups_synced(player, params, player->render_frame_count);
 
+        // Combine the signals of all threads once every thread has rendered
+        Barrier_wait(&player->vgroups_rendered_barrier);
+        Device_states_mix_thread_states(
+                player->device_states, 0, player->render_frame_count);
+
         // Wait to indicate that we have finished processing voice groups
         Barrier_wait(&player->vgroups_finished_barrier);
     }
@@ -1285,6 +1688,9 @@ static void Player_process_voices_single_threaded(
     rassert(frame_count > 0);
     rassert(stats != NULL);
 
+    if (player->thread_params[0].arena != NULL)
+        Thread_arena_touch(player->thread_params[0].arena);
+
     Voice_pool_start_group_iteration(player->voices);
 
     // Foreground voices
@@ -1354,6 +1760,8 @@ static void Player_process_voices(Player* player, int32_t frame_count)
         // Pass render start and stop parameters to threads
         player->render_frame_count = frame_count;
 
+        Device_states_start_mixing_thread_states(player->device_states);
+
         // Synchronise with all threads to start voice group processing
         Barrier_wait(&player->vgroups_start_barrier);
 
@@ -1381,9 +1789,6 @@ static void Player_process_voices(Player* player, int32_t frame_count)
         active_vgroup_count = stats->vgroup_count;
     }
 
-    if (player->thread_count > 1)
-        Device_states_mix_thread_states(player->device_states, 0, frame_count);
-
     player->master_params.active_voices =
         max(player->master_params.active_voices, active_voice_count);
     player->master_params.active_vgroups =
@@ -1393,6 +1798,64 @@ static void Player_process_voices(Player* player, int32_t frame_count)
 }
 
 
+static float* Player_get_bus_audio_mut(Player* player, int bus)
+{
+    rassert(player != NULL);
+    rassert(bus > 0);
+    rassert(bus < player->bus_count);
+
+    return player->bus_buffers +
+        ((bus - 1) * player->audio_buffer_size * KQT_BUFFERS_MAX);
+}
+
+
+static void Player_feed_input_audio(
+        Player* player, int32_t frame_offset, int32_t frame_count)
+{
+    rassert(player != NULL);
+    rassert(frame_offset >= 0);
+    rassert(frame_count >= 0);
+
+    Device_thread_state* iface_ts = Device_states_get_thread_state(
+            player->device_states,
+            0,
+            Device_get_id(Module_get_input_interface(player->module)));
+    rassert(iface_ts != NULL);
+
+    for (int port = 0; port < KQT_DEVICE_PORTS_MAX; ++port)
+    {
+        const int32_t input_frames = player->input_frames[port];
+        if (input_frames <= frame_offset)
+            continue;
+
+        // The receiving devices mix directly from the interface buffers
+        Work_buffer* wb = Device_thread_state_get_mixed_buffer(
+                iface_ts, DEVICE_PORT_TYPE_SEND, port);
+        if (wb == NULL)
+            continue;
+
+        const int32_t copy_count = min(frame_count, input_frames - frame_offset);
+        memcpy(Work_buffer_get_contents_mut(wb),
+                player->input_audio[port] + frame_offset,
+                sizeof(float) * (size_t)copy_count);
+
+        if (copy_count < frame_count)
+        {
+            Work_buffer_clear(wb, copy_count, frame_count);
+        }
+        else
+        {
+            Work_buffer_mark_valid(wb);
+            Work_buffer_clear_const_start(wb);
+            Work_buffer_clear_ramp(wb);
+            Work_buffer_set_final(wb, false);
+        }
+    }
+
+    return;
+}
+
+
 static void Player_process_mixed_signals(Player* player, int32_t frame_count)
 {
     rassert(player != NULL);
@@ -1455,6 +1918,7 @@ static bool Player_update_receive(Player* player)
             Player_process_event(
                     player,
                     player->susp_event_ch,
+                    player->susp_event_type,
                     player->susp_event_name,
                     &player->susp_event_value,
                     is_at_global_breakpoint,
@@ -1567,7 +2031,7 @@ static void Player_apply_dc_blocker(Player* player, int32_t frame_count)
     const float R = (float)((adapt_time_frames - 1) / adapt_time_frames);
     const float gain = (1 + R) / 2;
 
-    for (int ch = 0; ch < 2; ++ch)
+    for (int ch = 0; ch < player->bus_count * KQT_BUFFERS_MAX; ++ch)
     {
         Work_buffer* wb = Device_thread_state_get_mixed_buffer(
                 master_ts, DEVICE_PORT_TYPE_RECV, ch);
@@ -1605,12 +2069,18 @@ static void Player_apply_master_volume(Player* player, int32_t frame_count)
             player->device_states, 0, Device_get_id((const Device*)player->module));
     rassert(master_ts != NULL);
 
-    Work_buffer* master_wbs[2] = { NULL };
-    for (int ch = 0; ch < 2; ++ch)
+    const int ch_count = player->bus_count * KQT_BUFFERS_MAX;
+
+    Work_buffer* master_wbs[KQT_DEVICE_PORTS_MAX] = { NULL };
+    bool has_valid_wbs = false;
+    for (int ch = 0; ch < ch_count; ++ch)
+    {
         master_wbs[ch] = Device_thread_state_get_mixed_buffer(
                 master_ts, DEVICE_PORT_TYPE_RECV, ch);
+        has_valid_wbs = has_valid_wbs || Work_buffer_is_valid(master_wbs[ch]);
+    }
 
-    if (!Work_buffer_is_valid(master_wbs[0]) && !Work_buffer_is_valid(master_wbs[1]))
+    if (!has_valid_wbs)
     {
         Slider_skip(&player->master_params.volume_log_slider, frame_count);
         return;
@@ -1619,7 +2089,7 @@ static void Player_apply_master_volume(Player* player, int32_t frame_count)
     Slider slider;
     Slider_init(&slider);
 
-    for (int ch = 0; ch < 2; ++ch)
+    for (int ch = 0; ch < ch_count; ++ch)
     {
         Work_buffer* wb = master_wbs[ch];
         if (!Work_buffer_is_valid(wb))
@@ -1676,18 +2146,228 @@ static void Player_init_final(Player* player)
 }
 
 
-void Player_play(Player* player, int32_t nframes)
+static double get_time_seconds(void)
 {
-    rassert(player != NULL);
-    rassert(player->audio_buffer_size > 0);
-    rassert(nframes >= 0);
+    struct timespec ts;
 
-    Player_flush_receive(player);
+#ifdef CLOCK_MONOTONIC
+    // Wall clock adjustments must not show up as render time
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+        return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
 
-    Event_buffer_clear(player->event_buffer);
+    if (timespec_get(&ts, TIME_UTC) != TIME_UTC)
+        return 0;
+
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+static void Player_report_cpu_budget_events(Player* player)
+{
+    rassert(player != NULL);
+
+    Event_buffer* ebuf = player->event_buffer;
+    if (Event_buffer_is_skipping(ebuf))
+        return;
+
+    Value* value = VALUE_AUTO;
+
+    if ((player->pending_overload > 0) && !Event_buffer_is_full(ebuf))
+    {
+        value->type = VALUE_TYPE_FLOAT;
+        value->value.float_type = player->pending_overload;
+        Event_buffer_add(ebuf, 0, "Aoverload", value);
+        player->pending_overload = 0;
+    }
+
+    const int limit = Voice_pool_get_polyphony_limit(player->voices);
+    if ((limit != player->reported_polyphony_limit) && !Event_buffer_is_full(ebuf))
+    {
+        value->type = VALUE_TYPE_INT;
+        value->value.int_type = limit;
+        Event_buffer_add(ebuf, 0, "Apolyphony", value);
+        player->reported_polyphony_limit = limit;
+    }
+
+    const uint64_t steal_count = Voice_pool_get_steal_count(player->voices);
+    if ((steal_count != player->reported_steal_count) && !Event_buffer_is_full(ebuf))
+    {
+        value->type = VALUE_TYPE_INT;
+        value->value.int_type = (int64_t)(steal_count - player->reported_steal_count);
+        Event_buffer_add(ebuf, 0, "Avsteal", value);
+        player->reported_steal_count = steal_count;
+    }
+
+    // Our events are not part of any sequencer event to be processed again
+    Event_buffer_reset_add_counter(ebuf);
+
+    return;
+}
+
+
+static void Player_update_cpu_budget(
+        Player* player, double render_time, int32_t frame_count)
+{
+    rassert(player != NULL);
+    rassert(render_time >= 0);
+    rassert(frame_count > 0);
+
+    Polyphony_governor* gov = &player->polyphony_governor;
+
+    const double audio_time = frame_count / (double)player->audio_rate;
+    const int allocated_count = Voice_pool_get_allocated_count(player->voices);
+    if (Polyphony_governor_update(gov, render_time, audio_time, allocated_count))
+        player->pending_overload =
+            max(player->pending_overload, render_time / audio_time);
+
+    const int limit = Polyphony_governor_get_limit(gov);
+    if (limit != Voice_pool_get_polyphony_limit(player->voices))
+    {
+        Voice_pool_set_polyphony_limit(player->voices, limit);
+        Voice_pool_enforce_polyphony_limit(player->voices);
+    }
+
+    Player_report_cpu_budget_events(player);
+
+    return;
+}
+
+
+static void Player_receive_commands(Player* player)
+{
+    rassert(player != NULL);
+
+    Command command = { .type = COMMAND_FIRE_EVENT };
+    while ((player->pending_command_count < COMMAND_QUEUE_SIZE) &&
+            Command_queue_pop(player->command_queue, &command))
+        Player_add_pending_command(player, &command);
+
+    return;
+}
+
+
+static void Player_apply_command(Player* player, const Command* command)
+{
+    rassert(player != NULL);
+    rassert(command != NULL);
+
+    switch (command->type)
+    {
+        case COMMAND_FIRE_EVENT:
+        {
+            const bool is_at_global_breakpoint = true;
+            const int32_t frame_offset = 0;
+            const bool skip = false;
+            const bool external = true;
+            Player_process_event(
+                    player,
+                    command->channel,
+                    command->event_type,
+                    Event_properties_get_name(command->event_type),
+                    &command->arg,
+                    is_at_global_breakpoint,
+                    frame_offset,
+                    skip,
+                    external);
+
+            Player_check_perform_goto(player);
+
+            // Store event parameters if processing was suspended
+            if (Event_buffer_is_skipping(player->event_buffer))
+            {
+                player->susp_event_ch = command->channel;
+                player->susp_event_type = command->event_type;
+                strcpy(player->susp_event_name,
+                        Event_properties_get_name(command->event_type));
+                Value_copy(&player->susp_event_value, &command->arg);
+            }
+            else
+            {
+                Event_buffer_reset_add_counter(player->event_buffer);
+            }
+        }
+        break;
+
+        case COMMAND_SET_CHANNEL_MUTE:
+        {
+            rassert(command->arg.type == VALUE_TYPE_BOOL);
+            Player_set_channel_mute(
+                    player, command->channel, command->arg.value.bool_type);
+        }
+        break;
+
+        default:
+            rassert(false);
+    }
+
+    return;
+}
+
+
+static void Player_apply_commands(Player* player, int32_t frame)
+{
+    rassert(player != NULL);
+    rassert(frame >= 0);
+
+    int applied_count = 0;
+    while ((applied_count < player->pending_command_count) &&
+            (player->pending_commands[applied_count].frame_offset <= frame) &&
+            !Event_buffer_is_full(player->event_buffer) &&
+            !Event_buffer_is_skipping(player->event_buffer))
+    {
+        Player_apply_command(player, &player->pending_commands[applied_count]);
+        ++applied_count;
+    }
+
+    if (applied_count > 0)
+    {
+        player->pending_command_count -= applied_count;
+        memmove(player->pending_commands,
+                player->pending_commands + applied_count,
+                (size_t)player->pending_command_count * sizeof(Command));
+    }
+
+    return;
+}
+
+
+static void Player_shift_commands(Player* player, int32_t frame_count)
+{
+    rassert(player != NULL);
+    rassert(frame_count >= 0);
+
+    for (int i = 0; i < player->pending_command_count; ++i)
+    {
+        Command* command = &player->pending_commands[i];
+        command->frame_offset = max(0, command->frame_offset - frame_count);
+    }
+
+    return;
+}
+
+
+void Player_play(Player* player, int32_t nframes)
+{
+    rassert(player != NULL);
+    rassert(!player->is_sequencer_only);
+    rassert(player->audio_buffer_size > 0);
+    rassert(nframes >= 0);
+
+    const bool is_budget_enabled =
+        Polyphony_governor_is_enabled(&player->polyphony_governor);
+    const double start_time = is_budget_enabled ? get_time_seconds() : 0;
+
+    Player_flush_receive(player);
+
+    Event_buffer_clear(player->event_buffer);
+
+    Player_receive_commands(player);
 
     nframes = min(nframes, player->audio_buffer_size);
 
+    Automation_lanes_start(player->automation_lanes, player->device_states, nframes);
+
     const Connections* connections = Module_get_connections(player->module);
     rassert(connections != NULL);
     rassert(player->mixed_signal_plan != NULL);
@@ -1702,8 +2382,16 @@ void Player_play(Player* player, int32_t nframes)
         for (int ci = 0; ci < KQT_CHANNELS_MAX; ++ci)
             Channel_event_buffer_init(&player->channels[ci]->local_events);
 
-        // Move forwards in composition
+        // Apply commands from the host and stop at the next one
+        Player_apply_commands(player, rendered);
+
         int32_t to_be_rendered = nframes - rendered;
+        if ((player->pending_command_count > 0) &&
+                (player->pending_commands[0].frame_offset > rendered))
+            to_be_rendered = min(
+                    to_be_rendered, player->pending_commands[0].frame_offset - rendered);
+
+        // Move forwards in composition
         if (!player->master_params.parent.pause && !Player_has_stopped(player))
         {
             if (!player->cgiters_accessed)
@@ -1736,6 +2424,11 @@ void Player_play(Player* player, int32_t nframes)
 
         // Process mixed signals in the connection graph
         {
+            Automation_lanes_apply(
+                    player->automation_lanes, player->device_states, rendered);
+
+            Player_feed_input_audio(player, rendered, to_be_rendered);
+
             Player_process_mixed_signals(player, to_be_rendered);
 
             Player_apply_master_volume(player, to_be_rendered);
@@ -1786,16 +2479,58 @@ void Player_play(Player* player, int32_t nframes)
                     *out++ = *(master_in[0])++ * mix_vol;
                     *out++ = *(master_in[1])++ * mix_vol;
                 }
+
+                // Copy the other buses
+                for (int bus = 1; bus < player->bus_count; ++bus)
+                {
+                    const float* bus_in[KQT_BUFFERS_MAX] = { NULL };
+                    for (int ch = 0; ch < KQT_BUFFERS_MAX; ++ch)
+                    {
+                        const int port = bus * KQT_BUFFERS_MAX + ch;
+                        const Work_buffer* wb = Device_thread_state_get_mixed_buffer(
+                                master_ts, DEVICE_PORT_TYPE_RECV, port);
+                        if (!Work_buffer_is_valid(wb))
+                        {
+                            if (!silent_cleared)
+                            {
+                                Work_buffer_clear(silent_wb, 0, to_be_rendered);
+                                silent_cleared = true;
+                            }
+                            wb = silent_wb;
+                        }
+                        bus_in[ch] = Work_buffer_get_contents(wb);
+                    }
+
+                    float* bus_out = Player_get_bus_audio_mut(player, bus) +
+                        (rendered * KQT_BUFFERS_MAX);
+                    for (int32_t i = 0; i < to_be_rendered; ++i)
+                    {
+                        *bus_out++ = *(bus_in[0])++ * mix_vol;
+                        *bus_out++ = *(bus_in[1])++ * mix_vol;
+                    }
+                }
             }
         }
 
         rendered += to_be_rendered;
     }
 
+    Automation_lanes_finish(player->automation_lanes, player->device_states);
+
+    // Input audio is consumed by the render call
+    for (int port = 0; port < KQT_DEVICE_PORTS_MAX; ++port)
+        player->input_frames[port] = 0;
+
+    if (is_budget_enabled && (rendered > 0))
+        Player_update_cpu_budget(
+                player, max(0.0, get_time_seconds() - start_time), rendered);
+
     player->audio_frames_available = rendered;
 
     player->audio_frames_processed += rendered;
 
+    Player_shift_commands(player, rendered);
+
     player->events_returned = false;
 
     return;
@@ -1854,6 +2589,174 @@ void Player_skip(Player* player, int64_t nframes)
 }
 
 
+static bool add_timeline_step(
+        Timeline* timeline,
+        int32_t frames,
+        int32_t audio_rate,
+        double tempo,
+        int system,
+        const Tstamp* start_pos,
+        const Tstamp* left,
+        const Position* end_pos)
+{
+    rassert(timeline != NULL);
+    rassert(frames > 0);
+    rassert(start_pos != NULL);
+    rassert(end_pos != NULL);
+
+    // Check if we moved forwards inside the system
+    const Tstamp* dist = Tstamp_sub(TSTAMP_AUTO, &end_pos->pat_pos, start_pos);
+    if ((end_pos->system == system) &&
+            (Tstamp_cmp(dist, TSTAMP_AUTO) > 0) &&
+            (fabs(Tstamp_toframes(dist, tempo, audio_rate) - frames) <= 1))
+        return Timeline_add_segment(timeline, frames, system, start_pos, dist, tempo);
+
+    // Check if we crossed the end of the pattern
+    if ((left != NULL) && (end_pos->system > system))
+    {
+        const double frames_left = Tstamp_toframes(left, tempo, audio_rate);
+        const double frames_after =
+            Tstamp_toframes(&end_pos->pat_pos, tempo, audio_rate);
+        if (fabs(frames_left + frames_after - frames) <= 2)
+        {
+            int32_t frames_before_end =
+                (int32_t)clamp(round(frames_left), 1, frames);
+            if (Tstamp_cmp(&end_pos->pat_pos, TSTAMP_AUTO) == 0)
+                frames_before_end = frames;
+
+            if (!Timeline_add_segment(
+                        timeline, frames_before_end, system, start_pos, left, tempo))
+                return false;
+
+            if (frames_before_end == frames)
+                return true;
+
+            return Timeline_add_segment(
+                    timeline,
+                    frames - frames_before_end,
+                    end_pos->system,
+                    TSTAMP_AUTO,
+                    &end_pos->pat_pos,
+                    tempo);
+        }
+    }
+
+    // We jumped, so we only know the time spent
+    Tstamp* length = Tstamp_fromframes(TSTAMP_AUTO, frames, tempo, audio_rate);
+    if (Tstamp_cmp(length, TSTAMP_AUTO) == 0)
+        Tstamp_set(length, 0, 1);
+
+    return Timeline_add_segment(timeline, frames, system, start_pos, length, tempo);
+}
+
+
+bool Player_build_timeline(Player* player, int track, Timeline* timeline)
+{
+    rassert(player != NULL);
+    rassert(player->audio_rate == 1000000000L);
+    rassert(track >= 0);
+    rassert(track < KQT_TRACKS_MAX);
+    rassert(timeline != NULL);
+    rassert(Timeline_get_duration(timeline) == 0);
+
+    Player_reset(player, track);
+
+    const Master_params* master_params = &player->master_params;
+
+    int64_t elapsed = 0;
+    while ((elapsed < KQT_CALC_DURATION_MAX) && !Player_has_stopped(player))
+    {
+        if (!player->cgiters_accessed)
+        {
+            player->cgiters_accessed = true;
+            Player_init_final(player);
+        }
+
+        const Position* pos = &player->cgiters[0].pos;
+        const int system = pos->system;
+        const Tstamp* start_pos = Tstamp_copy(TSTAMP_AUTO, &pos->pat_pos);
+        const bool is_delay = (Tstamp_cmp(&master_params->delay_left, TSTAMP_AUTO) > 0);
+
+        // Get the distance to the end of the pattern
+        const Pattern* pattern = NULL;
+        if (!is_delay && (pos->piref.pat >= 0))
+            pattern = Module_get_pattern(player->module, &pos->piref);
+        Tstamp pattern_left = *TSTAMP_AUTO;
+        Tstamp* left = NULL;
+        if (pattern != NULL)
+            left = Tstamp_sub(&pattern_left, Pattern_get_length(pattern), start_pos);
+
+        int32_t nframes = (int32_t)min(KQT_CALC_DURATION_MAX - elapsed, INT32_MAX);
+        if (left != NULL)
+        {
+            if (Tstamp_cmp(left, TSTAMP_AUTO) <= 0)
+            {
+                // Let the Cgiters move to the next system first
+                nframes = 0;
+                left = NULL;
+            }
+            else
+            {
+                // Stop at the end of the pattern so that we cross at most one
+                // pattern boundary per step, but always move by at least one
+                // remainder unit. Tempo slides may change the tempo first.
+                double max_tempo = master_params->tempo;
+                double min_tempo = master_params->tempo;
+                if (master_params->tempo_slide != 0)
+                {
+                    max_tempo = max(max_tempo, master_params->tempo_slide_target);
+                    min_tempo = min(min_tempo, master_params->tempo_slide_target);
+                }
+
+                const double frames_left =
+                    Tstamp_toframes(left, max_tempo, player->audio_rate);
+                const double frames_min =
+                    60.0 * player->audio_rate / (min_tempo * KQT_TSTAMP_BEAT) + 1;
+                nframes = (int32_t)min(nframes, max(frames_left, frames_min));
+            }
+        }
+
+        const int32_t frames = Player_move_forwards(player, nframes, true);
+
+        for (int ci = 0; ci < KQT_CHANNELS_MAX; ++ci)
+            Channel_event_buffer_init(&player->channels[ci]->local_events);
+
+        if (frames > 0)
+        {
+            if (is_delay)
+            {
+                if (!Timeline_add_segment(
+                            timeline,
+                            frames,
+                            system,
+                            start_pos,
+                            TSTAMP_AUTO,
+                            master_params->tempo))
+                    return false;
+            }
+            else if (!add_timeline_step(
+                        timeline,
+                        frames,
+                        player->audio_rate,
+                        master_params->tempo,
+                        system,
+                        start_pos,
+                        left,
+                        &player->cgiters[0].pos))
+            {
+                return false;
+            }
+        }
+
+        elapsed += frames;
+    }
+
+    player->audio_frames_processed = elapsed;
+
+    return true;
+}
+
+
 int32_t Player_get_frames_available(const Player* player)
 {
     rassert(player != NULL);
@@ -1868,6 +2771,27 @@ const float* Player_get_audio(const Player* player)
 }
 
 
+int Player_get_bus_count(const Player* player)
+{
+    rassert(player != NULL);
+    return player->bus_count;
+}
+
+
+const float* Player_get_bus_audio(const Player* player, int bus)
+{
+    rassert(player != NULL);
+    rassert(bus >= 0);
+    rassert(bus < player->bus_count);
+
+    if (bus == 0)
+        return player->audio_buffer;
+
+    return player->bus_buffers +
+        ((bus - 1) * player->audio_buffer_size * KQT_BUFFERS_MAX);
+}
+
+
 const char* Player_get_events(Player* player)
 {
     rassert(player != NULL);
@@ -1884,6 +2808,23 @@ const char* Player_get_events(Player* player)
 }
 
 
+const unsigned char* Player_get_events_binary(Player* player, int32_t* size)
+{
+    rassert(player != NULL);
+    rassert(size != NULL);
+
+    if (player->events_returned)
+    {
+        // Get more events if row processing was interrupted
+        Player_update_receive(player);
+    }
+
+    player->events_returned = true;
+
+    return Event_buffer_get_events_binary(player->event_buffer, size);
+}
+
+
 bool Player_has_stopped(const Player* player)
 {
     rassert(player != NULL);
@@ -1903,31 +2844,37 @@ void Player_set_channel_mute(Player* player, int ch, bool mute)
 }
 
 
-bool Player_fire(Player* player, int ch_num, Streader* event_reader)
+static void Player_fire_value(
+        Player* player,
+        int ch_num,
+        Event_type type,
+        const char* event_name,
+        const Value* value);
+
+
+static bool Player_read_event(
+        const Player* player,
+        Streader* event_reader,
+        char* event_name,
+        Event_type* type,
+        Value* value)
 {
     rassert(player != NULL);
-    rassert(ch_num >= 0);
-    rassert(ch_num < KQT_CHANNELS_MAX);
     rassert(event_reader != NULL);
+    rassert(event_name != NULL);
+    rassert(type != NULL);
+    rassert(value != NULL);
 
     if (Streader_is_error_set(event_reader))
         return false;
 
-    Player_flush_receive(player);
-
-    Event_buffer_clear(player->event_buffer);
-
     const Event_names* event_names = Event_handler_get_names(player->event_handler);
 
-    char event_name[KQT_EVENT_NAME_MAX + 1] = "";
-    Event_type type = Event_NONE;
-
     // Get event name
-    if (!get_event_type_info(event_reader, event_names, event_name, &type))
+    if (!get_event_type_info(event_reader, event_names, event_name, type))
         return false;
 
     // Get event argument
-    Value* value = VALUE_AUTO;
     value->type = Event_names_get_param_type(event_names, event_name);
 
     switch (value->type)
@@ -2000,8 +2947,94 @@ bool Player_fire(Player* player, int ch_num, Streader* event_reader)
             rassert(false);
     }
 
-    if (!Streader_match_char(event_reader, ']'))
+    return Streader_match_char(event_reader, ']');
+}
+
+
+bool Player_fire(Player* player, int ch_num, Streader* event_reader)
+{
+    rassert(player != NULL);
+    rassert(ch_num >= 0);
+    rassert(ch_num < KQT_CHANNELS_MAX);
+    rassert(event_reader != NULL);
+
+    char event_name[KQT_EVENT_NAME_MAX + 1] = "";
+    Event_type type = Event_NONE;
+    Value* value = VALUE_AUTO;
+    if (!Player_read_event(player, event_reader, event_name, &type, value))
+        return false;
+
+    Player_fire_value(player, ch_num, type, event_name, value);
+
+    return true;
+}
+
+
+bool Player_fire_at(
+        Player* player, int32_t frame_offset, int ch_num, Streader* event_reader)
+{
+    rassert(player != NULL);
+    rassert(frame_offset >= 0);
+    rassert(ch_num >= 0);
+    rassert(ch_num < KQT_CHANNELS_MAX);
+    rassert(event_reader != NULL);
+
+    char event_name[KQT_EVENT_NAME_MAX + 1] = "";
+    Command* command = &(Command)
+    {
+        .type = COMMAND_FIRE_EVENT,
+        .frame_offset = frame_offset,
+        .channel = ch_num,
+        .event_type = Event_NONE,
+        .arg = { .type = VALUE_TYPE_NONE },
+    };
+    if (!Player_read_event(
+                player, event_reader, event_name, &command->event_type, &command->arg))
+        return false;
+
+    if (!Player_add_pending_command(player, command))
+    {
+        Streader_set_error(event_reader, "Too many scheduled events");
         return false;
+    }
+
+    return true;
+}
+
+
+void Player_fire_by_type(
+        Player* player, int ch_num, Event_type event_type, const Value* value)
+{
+    rassert(player != NULL);
+    rassert(ch_num >= 0);
+    rassert(ch_num < KQT_CHANNELS_MAX);
+    rassert(Event_is_valid(event_type));
+    rassert(value != NULL);
+
+    Player_fire_value(
+            player, ch_num, event_type, Event_properties_get_name(event_type), value);
+
+    return;
+}
+
+
+static void Player_fire_value(
+        Player* player,
+        int ch_num,
+        Event_type type,
+        const char* event_name,
+        const Value* value)
+{
+    rassert(player != NULL);
+    rassert(ch_num >= 0);
+    rassert(ch_num < KQT_CHANNELS_MAX);
+    rassert(Event_is_valid(type));
+    rassert(event_name != NULL);
+    rassert(value != NULL);
+
+    Player_flush_receive(player);
+
+    Event_buffer_clear(player->event_buffer);
 
     // Fire
     const bool is_at_global_breakpoint = true;
@@ -2011,6 +3044,7 @@ bool Player_fire(Player* player, int ch_num, Streader* event_reader)
     Player_process_event(
             player,
             ch_num,
+            type,
             event_name,
             value,
             is_at_global_breakpoint,
@@ -2025,6 +3059,7 @@ bool Player_fire(Player* player, int ch_num, Streader* event_reader)
     if (Event_buffer_is_skipping(player->event_buffer))
     {
         player->susp_event_ch = ch_num;
+        player->susp_event_type = type;
         strcpy(player->susp_event_name, event_name);
         Value_copy(&player->susp_event_value, value);
     }
@@ -2035,7 +3070,7 @@ bool Player_fire(Player* player, int ch_num, Streader* event_reader)
 
     player->events_returned = false;
 
-    return true;
+    return;
 }
 
 
@@ -2061,6 +3096,7 @@ void del_Player(Player* player)
     Condition_deinit(&player->start_cond);
 
     Barrier_deinit(&player->vgroups_start_barrier);
+    Barrier_deinit(&player->vgroups_rendered_barrier);
     Barrier_deinit(&player->vgroups_finished_barrier);
 
     del_Event_handler(player->event_handler);
@@ -2072,9 +3108,17 @@ void del_Player(Player* player)
     for (int i = 0; i < KQT_THREADS_MAX; ++i)
         Player_thread_params_deinit(&player->thread_params[i]);
     del_Event_buffer(player->event_buffer);
+    del_Command_queue(player->command_queue);
+    memory_free(player->pending_commands);
+    del_Automation_lanes(player->automation_lanes);
+    for (int i = 0; i < KQT_DEVICE_PORTS_MAX; ++i)
+        memory_free(player->input_audio[i]);
     del_Env_state(player->estate);
     del_Device_states(player->device_states);
+    for (int i = 0; i < KQT_THREADS_MAX; ++i)
+        del_Thread_arena(player->thread_params[i].arena);
 
+    memory_free(player->bus_buffers);
     memory_free(player->audio_buffer);
 
     memory_free(player);
@@ -21,6 +21,7 @@
 #include <init/Module.h>
 #include <kunquat/limits.h>
 #include <player/Event_handler.h>
+#include <player/Event_type.h>
 #include <string/Streader.h>
 
 #include <stdbool.h>
@@ -46,6 +47,10 @@ typedef struct Player Player;
  * \param voice_count         The number of voices allocated
  *                            -- must be >= \c 0 and <= \c KQT_VOICES_MAX.
  *
+ * If \a module already contains audio units, the Player is set up for
+ * playing them. Players that exist during loading receive their resources
+ * incrementally.
+ *
  * \return   The new Player if successful, or \c NULL if memory allocation
  *           failed.
  */
@@ -73,6 +78,53 @@ const Event_handler* Player_get_event_handler(const Player* player);
 Device_states* Player_get_device_states(const Player* player);
 
 
+/**
+ * Return the Command queue of the Player.
+ *
+ * Commands in the queue are applied during the next call of \a Player_play
+ * at their frame offsets. Commands with offsets beyond the rendered frames
+ * are kept and applied during later calls.
+ *
+ * \param player   The Player -- must not be \c NULL.
+ *
+ * \return   The Command queue.
+ */
+Command_queue* Player_get_command_queue(const Player* player);
+
+
+/**
+ * Return the Automation lanes of the Player.
+ *
+ * Values written to the lanes are applied during the next call of
+ * \a Player_play.
+ *
+ * \param player   The Player -- must not be \c NULL.
+ *
+ * \return   The Automation lanes.
+ */
+Automation_lanes* Player_get_automation_lanes(const Player* player);
+
+
+/**
+ * Set audio input of the Player for the next call of \a Player_play.
+ *
+ * The input is sent to the connection graph from the input port \a port of
+ * the master. Frames beyond \a frame_count are silent.
+ *
+ * \param player        The Player -- must not be \c NULL.
+ * \param port          The input port -- must be >= \c 0 and
+ *                      < \c KQT_DEVICE_PORTS_MAX.
+ * \param frame_count   The number of frames -- must be >= \c 0 and <= the
+ *                      audio buffer size.
+ * \param data          The input data -- must not be \c NULL if
+ *                      \a frame_count > \c 0.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Player_set_input_audio(
+        Player* player, int port, int32_t frame_count, const float* data);
+
+
 /**
  * Set the number of threads used by the Player for audio rendering.
  *
@@ -96,6 +148,17 @@ bool Player_set_thread_count(Player* player, int new_count, Error* error);
 int Player_get_thread_count(const Player* player);
 
 
+/**
+ * Set the CPU budget of the Player.
+ *
+ * \param player   The Player -- must not be \c NULL.
+ * \param budget   The maximum acceptable ratio of rendering time to the
+ *                 duration of the rendered audio -- must be >= \c 0 and
+ *                 <= \c 1. Value \c 0 disables the budget.
+ */
+void Player_set_cpu_budget(Player* player, double budget);
+
+
 /**
  * Reserve state space for internal voice pool.
  *
@@ -234,6 +297,23 @@ int32_t Player_get_audio_buffer_size(const Player* player);
 int64_t Player_get_nanoseconds(const Player* player);
 
 
+/**
+ * Set the sequencer-only mode of the Player.
+ *
+ * In sequencer-only mode, the Player only follows tempo changes, jumps and
+ * the pattern position when skipping. Trigger rows without control, general
+ * or master events are not visited at all unless the Bind of the Module may
+ * fire such events, and tempo changes are not passed on to channels and
+ * devices. This is intended for Players that are only used for calculating
+ * durations and positions, and must not be used with \a Player_play. The
+ * mode takes effect when the Player is reset.
+ *
+ * \param player    The Player -- must not be \c NULL.
+ * \param enabled   \c true if sequencer-only mode should be used.
+ */
+void Player_set_sequencer_only(Player* player, bool enabled);
+
+
 /**
  * Reset the Player state.
  *
@@ -253,6 +333,16 @@ void Player_reset(Player* player, int track_num);
 void Player_reset_dc_blocker(Player* player);
 
 
+/**
+ * Stop the playback of the composition.
+ *
+ * The Player will only process events fired directly until reset.
+ *
+ * \param player   The Player -- must not be \c NULL.
+ */
+void Player_stop(Player* player);
+
+
 /**
  * Play music.
  *
@@ -274,6 +364,25 @@ void Player_play(Player* player, int32_t nframes);
 void Player_skip(Player* player, int64_t nframes);
 
 
+/**
+ * Build the Timeline of a track.
+ *
+ * The Player is reset and moved to the end of the track, or to the maximum
+ * duration calculated by \a kqt_Handle_get_duration if the track does not end
+ * before that. One frame equals one nanosecond in the Timeline.
+ *
+ * \param player     The Player -- must not be \c NULL and must use the audio
+ *                   rate of \c 1000000000. The Player should be in
+ *                   sequencer-only mode.
+ * \param track      The track number -- must be >= \c 0 and
+ *                   < \c KQT_TRACKS_MAX.
+ * \param timeline   The Timeline -- must not be \c NULL and must be empty.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Player_build_timeline(Player* player, int track, Timeline* timeline);
+
+
 /**
  * Get the number of frames available in the internal audio chunk.
  *
@@ -294,6 +403,31 @@ int32_t Player_get_frames_available(const Player* player);
 const float* Player_get_audio(const Player* player);
 
 
+/**
+ * Get the number of output buses.
+ *
+ * Each pair of master output ports forms a bus. The first bus contains the
+ * main output returned by \a Player_get_audio.
+ *
+ * \param player   The Player -- must not be \c NULL.
+ *
+ * \return   The number of buses.
+ */
+int Player_get_bus_count(const Player* player);
+
+
+/**
+ * Get the internal audio buffer of an output bus.
+ *
+ * \param player   The Player -- must not be \c NULL.
+ * \param bus      The bus number -- must be >= \c 0 and less than the
+ *                 number of buses.
+ *
+ * \return   The audio buffer of the bus.
+ */
+const float* Player_get_bus_audio(const Player* player, int bus);
+
+
 /**
  * Get the internal event buffer.
  *
@@ -304,6 +438,18 @@ const float* Player_get_audio(const Player* player);
 const char* Player_get_events(Player* player);
 
 
+/**
+ * Get the internal event buffer in the binary format.
+ *
+ * \param player   The Player -- must not be \c NULL.
+ * \param size     Destination for the size of the event data in bytes --
+ *                 must not be \c NULL.
+ *
+ * \return   The event data.
+ */
+const unsigned char* Player_get_events_binary(Player* player, int32_t* size);
+
+
 /**
  * Tell whether the Player has reached the end of playback.
  *
@@ -341,6 +487,37 @@ void Player_set_channel_mute(Player* player, int ch, bool mute);
 bool Player_fire(Player* player, int ch, Streader* event_reader);
 
 
+/**
+ * Schedule an event to be fired during the next call of \a Player_play.
+ *
+ * \param player         The Player -- must not be \c NULL.
+ * \param frame_offset   The offset in frames from the start of the next
+ *                       call of \a Player_play -- must be >= \c 0. Events
+ *                       beyond the rendered frames are fired during later
+ *                       calls.
+ * \param ch             The channel number -- must be >= \c 0 and
+ *                       < \c KQT_CHANNELS_MAX.
+ * \param event_reader   The event reader -- must not be \c NULL.
+ *
+ * \return   \c true if successful, or \c false if the event was invalid or
+ *           too many events are waiting to be fired.
+ */
+bool Player_fire_at(Player* player, int32_t frame_offset, int ch, Streader* event_reader);
+
+
+/**
+ * Fire an event with an already resolved type and argument.
+ *
+ * \param player       The Player -- must not be \c NULL.
+ * \param ch           The channel number -- must be >= \c 0 and
+ *                     < \c KQT_CHANNELS_MAX.
+ * \param event_type   The Event type -- must be valid.
+ * \param value        The event argument -- must not be \c NULL and must
+ *                     match the parameter type of \a event_type.
+ */
+void Player_fire_by_type(Player* player, int ch, Event_type event_type, const Value* value);
+
+
 /**
  * Destroy the Player.
  *
@@ -21,12 +21,14 @@
 #include <kunquat/limits.h>
 #include <player/Cgiter.h>
 #include <player/Channel.h>
+#include <player/Command_queue.h>
 #include <player/Device_states.h>
 #include <player/Env_state.h>
 #include <player/Event_buffer.h>
 #include <player/Event_handler.h>
 #include <player/Master_params.h>
 #include <player/Player.h>
+#include <player/Polyphony_governor.h>
 #include <player/Voice_group_reservations.h>
 #include <player/Voice_pool.h>
 #include <player/Work_buffer.h>
@@ -45,6 +47,7 @@ typedef struct Player_thread_params
     int thread_id; // NOTE: This is the ID used by the rendering code
     int active_voices;
     int active_vgroups;
+    Thread_arena* arena;
     Work_buffers* work_buffers;
     Work_buffer* test_voice_outputs[2];
 } Player_thread_params;
@@ -58,11 +61,14 @@ struct Player
     int32_t audio_buffer_size;
     float*  audio_buffer;
     int32_t audio_frames_available;
+    int     bus_count;
+    float*  bus_buffers; // buses after the first one, each interleaved
 
     int thread_count;
     Player_thread_params thread_params[KQT_THREADS_MAX];
     Condition start_cond;
     Barrier vgroups_start_barrier;
+    Barrier vgroups_rendered_barrier;
     Barrier vgroups_finished_barrier;
     Thread threads[KQT_THREADS_MAX];
     bool ok_to_start;
@@ -73,6 +79,12 @@ struct Player
     Device_states* device_states;
     Env_state*     estate;
     Event_buffer*  event_buffer;
+    Command_queue* command_queue;
+    Command*       pending_commands; // sorted by frame offset
+    int            pending_command_count;
+    Automation_lanes* automation_lanes;
+    float*         input_audio[KQT_DEVICE_PORTS_MAX];
+    int32_t        input_frames[KQT_DEVICE_PORTS_MAX];
     Voice_pool*    voices;
     Voice_group_reservations voice_group_res;
     Mixed_signal_plan* mixed_signal_plan;
@@ -83,6 +95,7 @@ struct Player
     double frame_remainder; // used for sub-frame time tracking
 
     bool cgiters_accessed;
+    bool is_sequencer_only;
     Cgiter cgiters[KQT_CHANNELS_MAX];
 
     // Position tracking
@@ -91,10 +104,17 @@ struct Player
 
     bool events_returned;
 
+    // CPU budget tracking
+    Polyphony_governor polyphony_governor;
+    double pending_overload;
+    int reported_polyphony_limit;
+    uint64_t reported_steal_count;
+
     // Suspended event processing state
-    int   susp_event_ch;
-    char  susp_event_name[KQT_EVENT_NAME_MAX + 1];
-    Value susp_event_value;
+    int        susp_event_ch;
+    Event_type susp_event_type;
+    char       susp_event_name[KQT_EVENT_NAME_MAX + 1];
+    Value      susp_event_value;
 };
 
 
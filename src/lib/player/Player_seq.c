@@ -18,6 +18,7 @@
 #include <expr.h>
 #include <mathnum/common.h>
 #include <player/Channel_event_buffer.h>
+#include <player/Event_properties.h>
 #include <player/Event_type.h>
 #include <player/events/note_setup.h>
 #include <string/common.h>
@@ -109,33 +110,7 @@ static bool process_expr(
         if (Streader_is_error_set(expr_reader))
             return false;
 
-        if (field_type == VALUE_TYPE_REALTIME)
-        {
-            if (!Value_type_is_realtime(ret_value->type))
-            {
-                Streader_set_error(expr_reader, "Type mismatch");
-                return false;
-            }
-        }
-        else if (field_type == VALUE_TYPE_MAYBE_STRING)
-        {
-            if (ret_value->type != VALUE_TYPE_NONE &&
-                    ret_value->type != VALUE_TYPE_STRING)
-            {
-                Streader_set_error(expr_reader, "Type mismatch");
-                return false;
-            }
-        }
-        else if (field_type == VALUE_TYPE_MAYBE_REALTIME)
-        {
-            if (ret_value->type != VALUE_TYPE_NONE &&
-                    !Value_type_is_realtime(ret_value->type))
-            {
-                Streader_set_error(expr_reader, "Type mismatch");
-                return false;
-            }
-        }
-        else if (!Value_convert(ret_value, ret_value, field_type))
+        if (!Value_convert_to_field_type(ret_value, field_type))
         {
             Streader_set_error(expr_reader, "Type mismatch");
             return false;
@@ -146,6 +121,19 @@ static bool process_expr(
 }
 
 
+static bool Player_event_affects_sequencing(const Player* player, Event_type type)
+{
+    rassert(player != NULL);
+    rassert(Event_is_valid(type));
+
+    return Event_is_control(type) ||
+        Event_is_general(type) ||
+        Event_is_master(type) ||
+        ((player->module->bind != NULL) &&
+         Bind_event_affects_sequencing(player->module->bind, type));
+}
+
+
 static void Player_process_expr_event(
         Player* player,
         int ch_num,
@@ -160,6 +148,7 @@ static void Player_process_expr_event(
 void Player_process_event(
         Player* player,
         int ch_num,
+        Event_type type,
         const char* event_name,
         const Value* arg,
         bool is_at_global_breakpoint,
@@ -171,14 +160,11 @@ void Player_process_event(
     rassert(implies(!skip, !Event_buffer_is_full(player->event_buffer)));
     rassert(ch_num >= 0);
     rassert(ch_num < KQT_CHANNELS_MAX);
+    rassert(Event_is_valid(type));
     rassert(event_name != NULL);
     rassert(arg != NULL);
     rassert(frame_offset >= 0);
 
-    const Event_names* event_names = Event_handler_get_names(player->event_handler);
-    const Event_type type = Event_names_get(event_names, event_name);
-    rassert(type != Event_NONE);
-
     const bool is_skipping_buffer =
         Event_buffer_is_skipping(player->event_buffer) &&
         !Event_buffer_is_zero_skipping(player->event_buffer);
@@ -195,7 +181,14 @@ void Player_process_event(
         return;
     }
 
-    if (!is_skipping_buffer && !Event_is_query(type) && !Event_is_auto(type))
+    // When skipping, a channel event is only processed as a bind source
+    const bool is_bind_source_only =
+        skip && !Event_is_control(type) && !Event_is_general(type) && !Event_is_master(type);
+
+    if (!is_skipping_buffer &&
+            !is_bind_source_only &&
+            !Event_is_query(type) &&
+            !Event_is_auto(type))
     {
         // TODO: how should we handle errors?
         if (Event_is_global_breakpoint(type) || is_at_global_breakpoint)
@@ -216,8 +209,8 @@ void Player_process_event(
                 }
             }
 
-            Event_handler_trigger(
-                player->event_handler, ch_num, event_name, arg, external);
+            Event_handler_trigger_by_type(
+                player->event_handler, ch_num, type, arg, external);
 
             if (!skip)
             {
@@ -260,19 +253,19 @@ void Player_process_event(
         Event_buffer_skip_step(player->event_buffer);
 
     // Handle bind
-    if (player->module->bind != NULL)
+    if ((player->module->bind != NULL) &&
+            (!skip || Bind_event_affects_sequencing(player->module->bind, type)))
     {
         Target_event* bound = Bind_get_first(
                 player->module->bind,
-                Event_handler_get_names(player->event_handler),
                 player->channels[ch_num]->event_cache,
                 player->estate,
-                event_name,
+                type,
                 arg,
                 &player->channels[ch_num]->rand);
         while (bound != NULL)
         {
-            if (Event_buffer_is_full(player->event_buffer))
+            if (!skip && Event_buffer_is_full(player->event_buffer))
             {
                 // Set event buffer to skip the amount of events
                 // added from the top-level bind
@@ -300,7 +293,7 @@ void Player_process_event(
     // Handle query events
     if (!is_skipping_buffer && !skip && Event_is_query(type))
     {
-#define try_process(name, value)                                    \
+#define try_process(ev_type, name, value)                           \
         if (true)                                                   \
         {                                                           \
             if (Event_buffer_is_full(player->event_buffer))         \
@@ -312,6 +305,7 @@ void Player_process_event(
                 Player_process_event(                               \
                         player,                                     \
                         ch_num,                                     \
+                        ev_type,                                    \
                         name,                                       \
                         value,                                      \
                         is_at_global_breakpoint,                    \
@@ -333,25 +327,25 @@ void Player_process_event(
                 Value* track = VALUE_AUTO;
                 track->type = VALUE_TYPE_INT;
                 track->value.int_type = cur_pos->track;
-                try_process("Atrack", track);
+                try_process(Event_auto_location_track, "Atrack", track);
 
                 Value* system = VALUE_AUTO;
                 system->type = VALUE_TYPE_INT;
                 system->value.int_type = cur_pos->system;
-                try_process("Asystem", system);
+                try_process(Event_auto_location_system, "Asystem", system);
 
                 if (Position_has_valid_pattern_pos(cur_pos))
                 {
                     Value* piref = VALUE_AUTO;
                     piref->type = VALUE_TYPE_PAT_INST_REF;
                     piref->value.Pat_inst_ref_type = cur_pos->piref;
-                    try_process("Apattern", piref);
+                    try_process(Event_auto_location_pattern, "Apattern", piref);
                 }
 
                 Value* row = VALUE_AUTO;
                 row->type = VALUE_TYPE_TSTAMP;
                 row->value.Tstamp_type = cur_pos->pat_pos;
-                try_process("Arow", row);
+                try_process(Event_auto_location_row, "Arow", row);
             }
             break;
 
@@ -360,12 +354,12 @@ void Player_process_event(
                 Value* voices = VALUE_AUTO;
                 voices->type = VALUE_TYPE_INT;
                 voices->value.int_type = player->master_params.active_voices;
-                try_process("Avoices", voices);
+                try_process(Event_auto_voice_count, "Avoices", voices);
 
                 Value* vgroups = VALUE_AUTO;
                 vgroups->type = VALUE_TYPE_INT;
                 vgroups->value.int_type = player->master_params.active_vgroups;
-                try_process("Avgroups", vgroups);
+                try_process(Event_auto_vgroup_count, "Avgroups", vgroups);
 
                 player->master_params.active_voices = 0;
                 player->master_params.active_vgroups = 0;
@@ -383,7 +377,7 @@ void Player_process_event(
                     force->value.bool_type = false;
                 }
 
-                try_process("Af", force);
+                try_process(Event_auto_actual_force, "Af", force);
             }
             break;
 
@@ -425,6 +419,12 @@ static void Player_process_expr_event(
 
     get_event_type_info(sr, event_names, event_name, &type);
 
+    // Bound events that do not affect sequencing are ignored when skipping
+    if (skip &&
+            !Streader_is_error_set(sr) &&
+            !Player_event_affects_sequencing(player, type))
+        return;
+
     Value* arg = VALUE_AUTO;
 
     if (string_has_suffix(event_name, "\""))
@@ -465,6 +465,7 @@ static void Player_process_expr_event(
         Player_process_event(
                 player,
                 ch_num,
+                type,
                 event_name,
                 arg,
                 is_at_global_breakpoint,
@@ -476,6 +477,79 @@ static void Player_process_expr_event(
 }
 
 
+static void Player_process_trigger(
+        Player* player,
+        int ch_num,
+        const Column_trigger* trigger,
+        bool is_at_global_breakpoint,
+        int32_t frame_offset,
+        bool skip,
+        bool external)
+{
+    rassert(player != NULL);
+    rassert(ch_num >= 0);
+    rassert(ch_num < KQT_CHANNELS_MAX);
+    rassert(trigger != NULL);
+
+    if (trigger->arg_desc == NULL)
+    {
+        Player_process_expr_event(
+                player,
+                ch_num,
+                trigger->desc,
+                NULL, // no meta value
+                is_at_global_breakpoint,
+                frame_offset,
+                skip,
+                external);
+        return;
+    }
+
+    const Value* arg = &trigger->arg;
+    Value* expr_value = VALUE_AUTO;
+
+    if (!trigger->has_const_arg)
+    {
+        // Evaluate the argument expression
+        Streader* sr = Streader_init(
+                STREADER_AUTO, trigger->arg_desc, (int64_t)strlen(trigger->arg_desc));
+
+        process_expr(
+                sr,
+                Event_properties_get_param_type(trigger->type),
+                player->estate,
+                &player->channels[ch_num]->expr_rand,
+                NULL, // no meta value
+                expr_value);
+
+        if (Streader_is_error_set(sr))
+        {
+            fprintf(stderr,
+                    "Couldn't parse `%s`: %s\n",
+                    trigger->desc,
+                    Streader_get_error_desc(sr));
+            return;
+        }
+
+        arg = expr_value;
+    }
+
+    if (!Event_is_control(trigger->type) || player->master_params.is_infinite)
+        Player_process_event(
+                player,
+                ch_num,
+                trigger->type,
+                trigger->event_name,
+                arg,
+                is_at_global_breakpoint,
+                frame_offset,
+                skip,
+                external);
+
+    return;
+}
+
+
 void Player_reset_channels(Player* player)
 {
     // Reset channels
@@ -693,26 +767,16 @@ static void Player_process_cgiters(Player* player, Tstamp* limit, bool skip)
             if (Cgiter_has_finished(cgiter)) // implies empty playback
                 break;
 
-            const Trigger_row* tr = Cgiter_get_trigger_row(cgiter);
+            const Column_row* tr = Cgiter_get_trigger_row(cgiter);
             if (tr != NULL)
             {
-                // Process trigger row
-                rassert(tr->head->next != NULL);
-                Trigger_list* trl = tr->head->next;
-
-                // Skip triggers if resuming
-                int trigger_index = 0;
-                while (trigger_index < player->master_params.cur_trigger &&
-                        trl->trigger != NULL)
+                // Process trigger row, skipping triggers if resuming
+                for (int trigger_index = player->master_params.cur_trigger;
+                        trigger_index < tr->trigger_count;
+                        ++trigger_index)
                 {
-                    ++trigger_index;
-                    trl = trl->next;
-                }
-
-                // Process triggers
-                while (trl->trigger != NULL)
-                {
-                    const Event_type event_type = Trigger_get_type(trl->trigger);
+                    const Column_trigger* ctr = &tr->triggers[trigger_index];
+                    const Event_type event_type = ctr->type;
 
                     const bool at_active_jump =
                         Tstamp_cmp(next_jump_row, &cgiter->pos.pat_pos) == 0 &&
@@ -757,9 +821,7 @@ static void Player_process_cgiters(Player* player, Tstamp* limit, bool skip)
                     {
                         // Process trigger normally
                         if (!skip ||
-                                Event_is_control(event_type) ||
-                                Event_is_general(event_type) ||
-                                Event_is_master(event_type))
+                                Player_event_affects_sequencing(player, event_type))
                         {
                             if (!Event_is_control(event_type) ||
                                     player->master_params.is_infinite)
@@ -776,11 +838,10 @@ static void Player_process_cgiters(Player* player, Tstamp* limit, bool skip)
 
                                 const bool external = false;
 
-                                Player_process_expr_event(
+                                Player_process_trigger(
                                         player,
                                         i,
-                                        Trigger_get_desc(trl->trigger),
-                                        NULL, // no meta value
+                                        ctr,
                                         is_at_global_breakpoint,
                                         frame_offset,
                                         skip,
@@ -860,8 +921,6 @@ static void Player_process_cgiters(Player* player, Tstamp* limit, bool skip)
                         Cgiter_clear_returned_status(cgiter);
                         return;
                     }
-
-                    trl = trl->next;
                 }
             }
 
@@ -998,6 +1057,10 @@ void Player_update_sliders_and_lfos_tempo(Player* player)
     Master_params* mp = &player->master_params;
     Slider_set_tempo(&mp->volume_log_slider, tempo);
 
+    // Sequencer-only playback does not use the channel and device states
+    if (player->is_sequencer_only)
+        return;
+
     // Update channels
     for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
     {
@@ -37,6 +37,7 @@ void Player_reset_channels(Player* player);
 void Player_process_event(
         Player* player,
         int ch_num,
+        Event_type event_type,
         const char* event_name,
         const Value* arg,
         bool is_at_global_breakpoint,
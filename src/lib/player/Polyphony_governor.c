@@ -0,0 +1,135 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/Polyphony_governor.h>
+
+#include <debug/assert.h>
+#include <mathnum/common.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+
+// Fraction of the budget below which the limit may be raised
+#define HEADROOM_RATIO 0.7
+
+// Number of consecutive calm updates required before raising the limit
+#define RAISE_INTERVAL 8
+
+// Weight of a new measurement in the smoothed load when the load decreases
+#define LOAD_DECAY 0.2
+
+
+Polyphony_governor* Polyphony_governor_init(Polyphony_governor* gov, int max_limit)
+{
+    rassert(gov != NULL);
+    rassert(max_limit >= 0);
+
+    gov->budget = 0;
+    gov->load = 0;
+    gov->max_limit = max_limit;
+    gov->limit = max_limit;
+    gov->calm_count = 0;
+
+    return gov;
+}
+
+
+void Polyphony_governor_set_budget(Polyphony_governor* gov, double budget)
+{
+    rassert(gov != NULL);
+    rassert(budget >= 0);
+    rassert(budget <= 1);
+
+    gov->budget = budget;
+    gov->load = 0;
+    gov->limit = gov->max_limit;
+    gov->calm_count = 0;
+
+    return;
+}
+
+
+bool Polyphony_governor_is_enabled(const Polyphony_governor* gov)
+{
+    rassert(gov != NULL);
+    return (gov->budget > 0);
+}
+
+
+bool Polyphony_governor_update(
+        Polyphony_governor* gov,
+        double render_time,
+        double audio_time,
+        int allocated_count)
+{
+    rassert(gov != NULL);
+    rassert(Polyphony_governor_is_enabled(gov));
+    rassert(render_time >= 0);
+    rassert(audio_time > 0);
+    rassert(allocated_count >= 0);
+
+    const double load = render_time / audio_time;
+
+    // React to overload immediately but recover slowly
+    if (load >= gov->load)
+        gov->load = load;
+    else
+        gov->load += (load - gov->load) * LOAD_DECAY;
+
+    const int min_limit = min(1, gov->max_limit);
+
+    if (load > gov->budget)
+    {
+        // Scale the number of Voices in use to fit the budget
+        const int used = clamp(allocated_count, min_limit, gov->limit);
+        const int fitting = (int)(used * gov->budget / load);
+        gov->limit = clamp(min(fitting, used - 1), min_limit, gov->max_limit);
+        gov->calm_count = 0;
+        return true;
+    }
+
+    if (gov->load < gov->budget * HEADROOM_RATIO)
+    {
+        ++gov->calm_count;
+        if (gov->calm_count >= RAISE_INTERVAL)
+        {
+            const int step = max(1, gov->max_limit / 16);
+            gov->limit = min(gov->limit + step, gov->max_limit);
+            gov->calm_count = 0;
+        }
+    }
+    else
+    {
+        gov->calm_count = 0;
+    }
+
+    return false;
+}
+
+
+int Polyphony_governor_get_limit(const Polyphony_governor* gov)
+{
+    rassert(gov != NULL);
+    return gov->limit;
+}
+
+
+double Polyphony_governor_get_load(const Polyphony_governor* gov)
+{
+    rassert(gov != NULL);
+    return gov->load;
+}
+
+
@@ -0,0 +1,119 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_POLYPHONY_GOVERNOR_H
+#define KQT_POLYPHONY_GOVERNOR_H
+
+
+#include <stdbool.h>
+
+
+/**
+ * Adjusts the polyphony limit of the Player based on the time spent rendering.
+ *
+ * The load of a render call is the ratio of the time spent rendering to the
+ * duration of the rendered audio. When the load exceeds the budget, the limit
+ * is lowered in proportion to the excess. The limit is raised gradually once
+ * the load stays clearly below the budget.
+ */
+typedef struct Polyphony_governor
+{
+    double budget;
+    double load;
+    int max_limit;
+    int limit;
+    int calm_count;
+} Polyphony_governor;
+
+
+/**
+ * Initialise a Polyphony governor.
+ *
+ * The governor is initially disabled.
+ *
+ * \param gov         The Polyphony governor -- must not be \c NULL.
+ * \param max_limit   The maximum polyphony limit -- must be >= \c 0.
+ *
+ * \return   The parameter \a gov.
+ */
+Polyphony_governor* Polyphony_governor_init(Polyphony_governor* gov, int max_limit);
+
+
+/**
+ * Set the CPU budget of the Polyphony governor.
+ *
+ * Setting the budget resets the polyphony limit to its maximum value.
+ *
+ * \param gov      The Polyphony governor -- must not be \c NULL.
+ * \param budget   The maximum acceptable load -- must be >= \c 0 and
+ *                 <= \c 1. Value \c 0 disables the governor.
+ */
+void Polyphony_governor_set_budget(Polyphony_governor* gov, double budget);
+
+
+/**
+ * Find out whether the Polyphony governor is enabled.
+ *
+ * \param gov   The Polyphony governor -- must not be \c NULL.
+ *
+ * \return   \c true if \a gov is enabled, otherwise \c false.
+ */
+bool Polyphony_governor_is_enabled(const Polyphony_governor* gov);
+
+
+/**
+ * Update the Polyphony governor with the cost of a render call.
+ *
+ * \param gov              The Polyphony governor -- must not be \c NULL and
+ *                         must be enabled.
+ * \param render_time      The time spent rendering in seconds -- must be
+ *                         >= \c 0.
+ * \param audio_time       The duration of the rendered audio in seconds --
+ *                         must be > \c 0.
+ * \param allocated_count  The number of Voices in use during rendering --
+ *                         must be >= \c 0.
+ *
+ * \return   \c true if the load of the render call exceeded the budget,
+ *           otherwise \c false.
+ */
+bool Polyphony_governor_update(
+        Polyphony_governor* gov,
+        double render_time,
+        double audio_time,
+        int allocated_count);
+
+
+/**
+ * Get the current polyphony limit of the Polyphony governor.
+ *
+ * \param gov   The Polyphony governor -- must not be \c NULL.
+ *
+ * \return   The polyphony limit.
+ */
+int Polyphony_governor_get_limit(const Polyphony_governor* gov);
+
+
+/**
+ * Get the smoothed load measured by the Polyphony governor.
+ *
+ * \param gov   The Polyphony governor -- must not be \c NULL.
+ *
+ * \return   The load, where \c 1 corresponds to rendering in real time.
+ */
+double Polyphony_governor_get_load(const Polyphony_governor* gov);
+
+
+#endif // KQT_POLYPHONY_GOVERNOR_H
+
+
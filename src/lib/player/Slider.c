@@ -99,6 +99,17 @@ double Slider_get_value(const Slider* slider)
 }
 
 
+double Slider_get_step(const Slider* slider)
+{
+    rassert(slider != NULL);
+
+    if (slider->progress >= 1)
+        return 0;
+
+    return (slider->to - slider->from) * slider->progress_update;
+}
+
+
 double Slider_step(Slider* slider)
 {
     rassert(slider != NULL);
@@ -120,6 +131,83 @@ double Slider_skip(Slider* slider, int64_t steps)
 }
 
 
+int32_t Slider_fill_values(
+        Slider* slider,
+        double* value,
+        double offset,
+        float* values,
+        int32_t buf_start,
+        int32_t buf_stop,
+        int32_t ctl_period)
+{
+    rassert(slider != NULL);
+    rassert(value != NULL);
+    rassert(isfinite(offset));
+    rassert(values != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop >= buf_start);
+    rassert(ctl_period >= 1);
+
+    int32_t const_start = buf_start;
+
+    int32_t cur_pos = buf_start;
+    while (cur_pos < buf_stop)
+    {
+        const int32_t estimated_steps = Slider_estimate_active_steps_left(slider);
+        if (estimated_steps > 0)
+        {
+            int32_t slide_stop = buf_stop;
+            if (estimated_steps < buf_stop - cur_pos)
+                slide_stop = cur_pos + estimated_steps;
+
+            double new_value = *value;
+
+            if (ctl_period > 1)
+            {
+                for (int32_t block_start = cur_pos;
+                        block_start < slide_stop;
+                        block_start += ctl_period)
+                {
+                    const int32_t block_stop = min(slide_stop, block_start + ctl_period);
+                    const int32_t step_count = block_stop - block_start;
+
+                    const double start_value = Slider_get_value(slider);
+                    new_value = Slider_skip(slider, step_count);
+                    const double step = (new_value - start_value) / step_count;
+
+                    for (int32_t i = 0; i < step_count; ++i)
+                        values[block_start + i] =
+                            (float)(start_value + (step * (i + 1)) + offset);
+                }
+            }
+            else
+            {
+                for (int32_t i = cur_pos; i < slide_stop; ++i)
+                {
+                    new_value = Slider_step(slider);
+                    values[i] = (float)(new_value + offset);
+                }
+            }
+
+            *value = new_value;
+
+            const_start = slide_stop;
+            cur_pos = slide_stop;
+        }
+        else
+        {
+            const float const_value = (float)(*value + offset);
+            for (int32_t i = cur_pos; i < buf_stop; ++i)
+                values[i] = const_value;
+
+            cur_pos = buf_stop;
+        }
+    }
+
+    return const_start;
+}
+
+
 int32_t Slider_estimate_active_steps_left(const Slider* slider)
 {
     rassert(slider != NULL);
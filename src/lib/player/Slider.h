@@ -91,6 +91,16 @@ void Slider_start(Slider* slider, double target, double start);
 double Slider_get_value(const Slider* slider);
 
 
+/**
+ * Get the per-frame change of value in the current slide of the Slider.
+ *
+ * \param slider   The Slider -- must not be \c NULL.
+ *
+ * \return   The value change per frame, or \c 0 if the slide has finished.
+ */
+double Slider_get_step(const Slider* slider);
+
+
 /**
  * Perform a step in the Slider.
  *
@@ -115,6 +125,36 @@ double Slider_step(Slider* slider);
 double Slider_skip(Slider* slider, int64_t steps);
 
 
+/**
+ * Write Slider updates into a value buffer.
+ *
+ * With a control period greater than \c 1, the Slider is advanced one period
+ * at a time and the values inside each period are interpolated linearly.
+ * Since the slide itself is linear, the result is identical to per-frame
+ * stepping apart from rounding errors. Frames after the end of the slide are
+ * filled with the final value.
+ *
+ * \param slider       The Slider -- must not be \c NULL.
+ * \param value        The current value, updated by this function
+ *                     -- must not be \c NULL.
+ * \param offset       The offset added to each output value -- must be finite.
+ * \param values       The output buffer -- must not be \c NULL.
+ * \param buf_start    The buffer start index -- must be >= \c 0.
+ * \param buf_stop     The buffer stop index -- must be >= \a buf_start.
+ * \param ctl_period   The control period -- must be >= \c 1.
+ *
+ * \return   The first index of the constant trail in \a values.
+ */
+int32_t Slider_fill_values(
+        Slider* slider,
+        double* value,
+        double offset,
+        float* values,
+        int32_t buf_start,
+        int32_t buf_stop,
+        int32_t ctl_period);
+
+
 /**
  * Estimate the number of active steps left in the Slider.
  *
@@ -0,0 +1,354 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/Thread_arena.h>
+
+#include <debug/assert.h>
+#include <mathnum/common.h>
+#include <memory.h>
+
+#ifdef ENABLE_THREAD_ARENAS
+#include <unistd.h>
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define CHUNK_SIZE_MIN 4194304
+#define DEFAULT_PAGE_SIZE 4096
+
+
+typedef struct Arena_chunk
+{
+    struct Arena_chunk* next;
+    char* data;
+    int64_t size;
+    int64_t used;
+    int64_t used_max;
+    int64_t allocated;
+    int64_t touched;
+} Arena_chunk;
+
+
+typedef struct Free_block
+{
+    struct Free_block* next;
+    int64_t size;
+} Free_block;
+
+
+struct Thread_arena
+{
+    bool use_huge_pages;
+    int64_t page_size;
+    Arena_chunk* chunks;
+    Free_block* free_blocks;
+};
+
+
+static int64_t round_up(int64_t size, int64_t multiple)
+{
+    rassert(size >= 0);
+    rassert(multiple > 0);
+
+    return ((size + multiple - 1) / multiple) * multiple;
+}
+
+
+static void del_Arena_chunk(Arena_chunk* chunk)
+{
+    if (chunk == NULL)
+        return;
+
+    memory_free_pages(chunk->data, chunk->size);
+    memory_free(chunk);
+
+    return;
+}
+
+
+static Arena_chunk* new_Arena_chunk(int64_t size, bool use_huge_pages)
+{
+    rassert(size > 0);
+
+    Arena_chunk* chunk = memory_alloc_item(Arena_chunk);
+    if (chunk == NULL)
+        return NULL;
+
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->used_max = 0;
+    chunk->allocated = 0;
+    chunk->touched = 0;
+    chunk->data = memory_alloc_pages(size, use_huge_pages);
+    if (chunk->data == NULL)
+    {
+        del_Arena_chunk(chunk);
+        return NULL;
+    }
+
+#ifndef ENABLE_THREAD_ARENAS
+    // Already touched during initialisation
+    chunk->touched = size;
+#endif
+
+    return chunk;
+}
+
+
+Thread_arena* new_Thread_arena(bool use_huge_pages)
+{
+    Thread_arena* arena = memory_alloc_item(Thread_arena);
+    if (arena == NULL)
+        return NULL;
+
+    arena->use_huge_pages = use_huge_pages;
+    arena->page_size = DEFAULT_PAGE_SIZE;
+    arena->chunks = NULL;
+    arena->free_blocks = NULL;
+
+#ifdef ENABLE_THREAD_ARENAS
+    {
+        const long page_size = sysconf(_SC_PAGESIZE);
+        if (page_size > 0)
+            arena->page_size = page_size;
+    }
+#endif
+
+    return arena;
+}
+
+
+static bool Arena_chunk_contains(const Arena_chunk* chunk, const void* ptr)
+{
+    rassert(chunk != NULL);
+    rassert(ptr != NULL);
+
+    const intptr_t addr = (intptr_t)ptr;
+    const intptr_t start = (intptr_t)chunk->data;
+
+    return (addr >= start) && (addr < start + (intptr_t)chunk->used);
+}
+
+
+static Arena_chunk** Thread_arena_find_chunk(Thread_arena* arena, const void* ptr)
+{
+    rassert(arena != NULL);
+    rassert(ptr != NULL);
+
+    Arena_chunk** chunk_ref = &arena->chunks;
+    while ((*chunk_ref != NULL) && !Arena_chunk_contains(*chunk_ref, ptr))
+        chunk_ref = &(*chunk_ref)->next;
+
+    rassert(*chunk_ref != NULL);
+    return chunk_ref;
+}
+
+
+static void Thread_arena_remove_free_blocks(Thread_arena* arena, const Arena_chunk* chunk)
+{
+    rassert(arena != NULL);
+    rassert(chunk != NULL);
+
+    Free_block** prev_next = &arena->free_blocks;
+    while (*prev_next != NULL)
+    {
+        if (Arena_chunk_contains(chunk, *prev_next))
+            *prev_next = (*prev_next)->next;
+        else
+            prev_next = &(*prev_next)->next;
+    }
+
+    return;
+}
+
+
+void* Thread_arena_alloc(Thread_arena* arena, int64_t size)
+{
+    rassert(arena != NULL);
+    rassert(size > 0);
+
+    const int64_t block_size = round_up(size, THREAD_ARENA_ALIGNMENT);
+
+    // Reuse a released block of matching size
+    Free_block** prev_next = &arena->free_blocks;
+    Free_block* free_block = arena->free_blocks;
+    while (free_block != NULL)
+    {
+        if (free_block->size == block_size)
+        {
+            *prev_next = free_block->next;
+            Arena_chunk* owner = *Thread_arena_find_chunk(arena, free_block);
+            owner->allocated += block_size;
+            memset(free_block, 0, (size_t)block_size);
+            return free_block;
+        }
+
+        prev_next = &free_block->next;
+        free_block = free_block->next;
+    }
+
+    Arena_chunk* chunk = arena->chunks;
+    if ((chunk == NULL) || (chunk->size - chunk->used < block_size))
+    {
+        const int64_t chunk_size =
+            max(CHUNK_SIZE_MIN, round_up(block_size, MEMORY_HUGE_PAGE_SIZE));
+        Arena_chunk* new_chunk = new_Arena_chunk(chunk_size, arena->use_huge_pages);
+        if (new_chunk == NULL)
+            return NULL;
+
+        if ((chunk != NULL) && (block_size >= CHUNK_SIZE_MIN))
+        {
+            // Keep allocating small blocks from the current chunk
+            new_chunk->next = chunk->next;
+            chunk->next = new_chunk;
+        }
+        else
+        {
+            new_chunk->next = arena->chunks;
+            arena->chunks = new_chunk;
+        }
+
+        chunk = new_chunk;
+    }
+
+    rassert(chunk->size - chunk->used >= block_size);
+
+    char* block = chunk->data + chunk->used;
+
+    // Clear memory returned to the chunk earlier
+    if (chunk->used < chunk->used_max)
+        memset(block, 0, (size_t)min(block_size, chunk->used_max - chunk->used));
+
+    chunk->used += block_size;
+    chunk->used_max = max(chunk->used_max, chunk->used);
+    chunk->allocated += block_size;
+
+    return block;
+}
+
+
+void Thread_arena_free(Thread_arena* arena, void* ptr, int64_t size)
+{
+    rassert(arena != NULL);
+    rassert(size > 0);
+
+    if (ptr == NULL)
+        return;
+
+    rassert((intptr_t)ptr % THREAD_ARENA_ALIGNMENT == 0);
+
+    const int64_t block_size = round_up(size, THREAD_ARENA_ALIGNMENT);
+
+    Arena_chunk** chunk_ref = Thread_arena_find_chunk(arena, ptr);
+    Arena_chunk* chunk = *chunk_ref;
+    chunk->allocated -= block_size;
+    rassert(chunk->allocated >= 0);
+
+    if (chunk->allocated == 0)
+    {
+        Thread_arena_remove_free_blocks(arena, chunk);
+
+        if (chunk == arena->chunks)
+        {
+            // Keep the current chunk for upcoming allocations
+            chunk->used = 0;
+        }
+        else
+        {
+            *chunk_ref = chunk->next;
+            del_Arena_chunk(chunk);
+        }
+
+        return;
+    }
+
+    if ((char*)ptr + block_size == chunk->data + chunk->used)
+    {
+        // Return the last block directly to the chunk
+        chunk->used -= block_size;
+        return;
+    }
+
+    Free_block* free_block = ptr;
+    free_block->next = arena->free_blocks;
+    free_block->size = block_size;
+    arena->free_blocks = free_block;
+
+    return;
+}
+
+
+void Thread_arena_touch(Thread_arena* arena)
+{
+    rassert(arena != NULL);
+
+    Arena_chunk* chunk = arena->chunks;
+    while (chunk != NULL)
+    {
+        while (chunk->touched < chunk->used)
+        {
+            // Rewrite the existing value as the page may already be in use
+            volatile char* byte = chunk->data + chunk->touched;
+            *byte = *byte;
+            chunk->touched += arena->page_size;
+        }
+
+        chunk = chunk->next;
+    }
+
+    return;
+}
+
+
+int64_t Thread_arena_get_reserved_size(const Thread_arena* arena)
+{
+    rassert(arena != NULL);
+
+    int64_t total = 0;
+
+    const Arena_chunk* chunk = arena->chunks;
+    while (chunk != NULL)
+    {
+        total += chunk->size;
+        chunk = chunk->next;
+    }
+
+    return total;
+}
+
+
+void del_Thread_arena(Thread_arena* arena)
+{
+    if (arena == NULL)
+        return;
+
+    Arena_chunk* chunk = arena->chunks;
+    while (chunk != NULL)
+    {
+        Arena_chunk* next = chunk->next;
+        del_Arena_chunk(chunk);
+        chunk = next;
+    }
+
+    memory_free(arena);
+
+    return;
+}
+
+
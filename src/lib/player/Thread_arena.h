@@ -0,0 +1,118 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_THREAD_ARENA_H
+#define KQT_THREAD_ARENA_H
+
+
+#include <decl.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * A memory arena for buffers that are used by a single rendering thread.
+ *
+ * Blocks are allocated and released by the thread that configures the Player,
+ * but the underlying pages are not written to until the owning rendering
+ * thread calls \a Thread_arena_touch. On systems with a first-touch page
+ * placement policy this places the memory on the NUMA node of the rendering
+ * thread.
+ *
+ * The arena is not thread-safe: allocation and touching must be separated by
+ * the synchronisation already performed between the Player and its threads.
+ */
+
+
+#define THREAD_ARENA_ALIGNMENT 64
+
+
+/**
+ * Create a new Thread arena.
+ *
+ * \param use_huge_pages   \c true if transparent huge pages should be
+ *                         requested for the arena memory. This is a hint and
+ *                         is ignored if not supported by the system.
+ *
+ * \return   The new Thread arena if successful, or \c NULL if memory
+ *           allocation failed.
+ */
+Thread_arena* new_Thread_arena(bool use_huge_pages);
+
+
+/**
+ * Allocate a zero-initialised block of memory from the Thread arena.
+ *
+ * \param arena   The Thread arena -- must not be \c NULL.
+ * \param size    The amount of bytes to be allocated -- must be > \c 0.
+ *
+ * \return   The starting address of the block aligned to
+ *           \c THREAD_ARENA_ALIGNMENT bytes, or \c NULL if memory allocation
+ *           failed.
+ */
+void* Thread_arena_alloc(Thread_arena* arena, int64_t size);
+
+
+/**
+ * Return a block of memory to the Thread arena.
+ *
+ * Memory areas that no longer contain allocated blocks are released, except
+ * for the area used for new allocations.
+ *
+ * \param arena   The Thread arena -- must not be \c NULL.
+ * \param ptr     The starting address of the block, or \c NULL. The block
+ *                must have been allocated from \a arena.
+ * \param size    The size passed to \a Thread_arena_alloc when allocating
+ *                \a ptr.
+ */
+void Thread_arena_free(Thread_arena* arena, void* ptr, int64_t size);
+
+
+/**
+ * Touch the pages of the Thread arena not yet touched.
+ *
+ * This function should be called by the rendering thread that owns the
+ * arena before accessing the allocated memory. The call is cheap if no new
+ * memory has been allocated since the previous call.
+ *
+ * \param arena   The Thread arena -- must not be \c NULL.
+ */
+void Thread_arena_touch(Thread_arena* arena);
+
+
+/**
+ * Get the amount of memory reserved by the Thread arena.
+ *
+ * \param arena   The Thread arena -- must not be \c NULL.
+ *
+ * \return   The total size of the memory areas allocated for \a arena.
+ */
+int64_t Thread_arena_get_reserved_size(const Thread_arena* arena);
+
+
+/**
+ * Destroy an existing Thread arena.
+ *
+ * All memory allocated from the arena is released.
+ *
+ * \param arena   The Thread arena, or \c NULL.
+ */
+void del_Thread_arena(Thread_arena* arena);
+
+
+#endif // KQT_THREAD_ARENA_H
+
+
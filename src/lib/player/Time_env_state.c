@@ -34,6 +34,7 @@ void Time_env_state_init(Time_env_state* testate)
     testate->is_finished = false;
     testate->cur_pos = 0;
     testate->next_node_index = 0;
+    testate->segment = -1;
     testate->cur_value = NAN;
     testate->update_value = 0;
     testate->scale_factor = 1;
@@ -96,6 +97,7 @@ int32_t Time_env_state_process(
     // Get state variables
     double cur_pos = testate->cur_pos;
     int next_node_index = testate->next_node_index;
+    int segment = testate->segment;
     double cur_value = testate->cur_value;
     double update_value = testate->update_value;
     double scale_factor = testate->scale_factor;
@@ -137,13 +139,14 @@ int32_t Time_env_state_process(
 
                 next_node = Envelope_get_node(env, next_node_index);
 
-                value = Envelope_get_value(env, cur_pos);
+                value = Envelope_get_value_from(env, cur_pos, &segment);
 
                 if (isfinite(value))
                 {
                     // Get new update value
-                    const double next_value = Envelope_get_value(
-                            env, cur_pos + inv_audio_rate);
+                    int next_segment = segment;
+                    const double next_value = Envelope_get_value_from(
+                            env, cur_pos + inv_audio_rate, &next_segment);
                     cur_value = value;
 
                     if (isfinite(next_value))
@@ -207,6 +210,7 @@ int32_t Time_env_state_process(
     // Update state for next process cycle
     testate->cur_pos = cur_pos;
     testate->next_node_index = next_node_index;
+    testate->segment = segment;
     testate->cur_value = cur_value;
     testate->update_value = update_value;
     testate->scale_factor = scale_factor;
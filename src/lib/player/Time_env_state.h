@@ -31,6 +31,7 @@ typedef struct Time_env_state
     bool is_finished;
     double cur_pos;
     int next_node_index;
+    int segment;
     double cur_value;
     double update_value;
     double scale_factor;
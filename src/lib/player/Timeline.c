@@ -0,0 +1,399 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/Timeline.h>
+
+#include <debug/assert.h>
+#include <mathnum/common.h>
+#include <mathnum/Tstamp.h>
+#include <memory.h>
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define NS_SECOND 1000000000L
+
+
+typedef struct Segment
+{
+    int64_t start_ns;
+    int system;
+    Tstamp start_pos;
+    Tstamp length; // zero in pattern delays
+    double tempo;
+} Segment;
+
+
+typedef struct Part
+{
+    int system;
+    Tstamp start;
+    Tstamp end;
+    int64_t arrival_ns; // includes the pattern delay at the start, if any
+    Tstamp origin;
+    int64_t origin_ns;
+    double tempo;
+} Part;
+
+
+struct Timeline
+{
+    int64_t duration;
+
+    int64_t segment_count;
+    int64_t segment_cap;
+    Segment* segments;
+
+    int64_t part_count;
+    int64_t part_cap;
+    Part* parts;
+
+    // Start of the pattern delay at the end of the Timeline, or -1
+    int64_t delay_start_ns;
+    int delay_system;
+    Tstamp delay_pos;
+};
+
+
+static int64_t get_ns(const Tstamp* dist, double tempo)
+{
+    rassert(dist != NULL);
+    rassert(tempo > 0);
+
+    return (int64_t)round(Tstamp_toframes(dist, tempo, NS_SECOND));
+}
+
+
+static Tstamp* get_dist(Tstamp* dist, int64_t ns, double tempo)
+{
+    rassert(dist != NULL);
+    rassert(ns >= 0);
+    rassert(tempo > 0);
+
+    const double beats = (double)ns * tempo / ((double)NS_SECOND * 60);
+    const double whole = floor(beats);
+
+    return Tstamp_set(dist, (int64_t)whole, (int32_t)((beats - whole) * KQT_TSTAMP_BEAT));
+}
+
+
+static int cmp_pos(int system1, const Tstamp* pos1, int system2, const Tstamp* pos2)
+{
+    rassert(pos1 != NULL);
+    rassert(pos2 != NULL);
+
+    if (system1 != system2)
+        return (system1 < system2) ? -1 : 1;
+
+    return Tstamp_cmp(pos1, pos2);
+}
+
+
+static bool reserve(void** items, int64_t* cap, int64_t count, int64_t item_size)
+{
+    rassert(items != NULL);
+    rassert(cap != NULL);
+    rassert(count >= 0);
+    rassert(item_size > 0);
+
+    if (count < *cap)
+        return true;
+
+    const int64_t new_cap = max(16, *cap * 2);
+    void* new_items = memory_realloc(*items, new_cap * item_size);
+    if (new_items == NULL)
+        return false;
+
+    *items = new_items;
+    *cap = new_cap;
+
+    return true;
+}
+
+
+Timeline* new_Timeline(void)
+{
+    Timeline* tl = memory_alloc_item(Timeline);
+    if (tl == NULL)
+        return NULL;
+
+    tl->duration = 0;
+    tl->segment_count = 0;
+    tl->segment_cap = 0;
+    tl->segments = NULL;
+    tl->part_count = 0;
+    tl->part_cap = 0;
+    tl->parts = NULL;
+    tl->delay_start_ns = -1;
+    tl->delay_system = 0;
+    Tstamp_init(&tl->delay_pos);
+
+    return tl;
+}
+
+
+static bool Timeline_add_parts(
+        Timeline* tl,
+        int system,
+        const Tstamp* start,
+        const Tstamp* end,
+        int64_t arrival_ns,
+        double tempo)
+{
+    rassert(tl != NULL);
+    rassert(start != NULL);
+    rassert(end != NULL);
+
+    // Find the first part that ends after our start
+    int64_t index = 0;
+    int64_t hi = tl->part_count;
+    while (index < hi)
+    {
+        const int64_t mid = index + (hi - index) / 2;
+        const Part* part = &tl->parts[mid];
+        if (cmp_pos(part->system, &part->end, system, start) <= 0)
+            index = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // Add the parts not played before
+    Tstamp* cur = Tstamp_copy(TSTAMP_AUTO, start);
+    while (Tstamp_cmp(cur, end) < 0)
+    {
+        const Part* next = NULL;
+        if ((index < tl->part_count) && (tl->parts[index].system == system))
+            next = &tl->parts[index];
+
+        if ((next != NULL) && (Tstamp_cmp(&next->start, cur) <= 0))
+        {
+            Tstamp_copy(cur, &next->end);
+            ++index;
+            continue;
+        }
+
+        Tstamp* part_end = Tstamp_copy(TSTAMP_AUTO, end);
+        if (next != NULL)
+            Tstamp_mina(part_end, &next->start);
+
+        if (!reserve((void**)&tl->parts, &tl->part_cap, tl->part_count, sizeof(Part)))
+            return false;
+
+        memmove(&tl->parts[index + 1],
+                &tl->parts[index],
+                (size_t)(tl->part_count - index) * sizeof(Part));
+        ++tl->part_count;
+
+        Part* part = &tl->parts[index];
+        part->system = system;
+        Tstamp_copy(&part->start, cur);
+        Tstamp_copy(&part->end, part_end);
+        Tstamp_copy(&part->origin, start);
+        part->origin_ns = tl->duration;
+        part->tempo = tempo;
+        if (Tstamp_cmp(cur, start) == 0)
+            part->arrival_ns = arrival_ns;
+        else
+            part->arrival_ns =
+                tl->duration + get_ns(Tstamp_sub(TSTAMP_AUTO, cur, start), tempo);
+
+        ++index;
+        Tstamp_copy(cur, part_end);
+    }
+
+    return true;
+}
+
+
+bool Timeline_add_segment(
+        Timeline* tl,
+        int64_t length_ns,
+        int system,
+        const Tstamp* start_pos,
+        const Tstamp* length,
+        double tempo)
+{
+    rassert(tl != NULL);
+    rassert(length_ns > 0);
+    rassert(system >= 0);
+    rassert(start_pos != NULL);
+    rassert(Tstamp_cmp(start_pos, TSTAMP_AUTO) >= 0);
+    rassert(length != NULL);
+    rassert(Tstamp_cmp(length, TSTAMP_AUTO) >= 0);
+    rassert(isfinite(tempo));
+    rassert(tempo > 0);
+
+    const bool is_delay = (Tstamp_cmp(length, TSTAMP_AUTO) == 0);
+
+    const bool continues_delay =
+        (tl->delay_start_ns >= 0) &&
+        (cmp_pos(tl->delay_system, &tl->delay_pos, system, start_pos) == 0);
+
+    if (is_delay)
+    {
+        if (!continues_delay)
+        {
+            tl->delay_start_ns = tl->duration;
+            tl->delay_system = system;
+            Tstamp_copy(&tl->delay_pos, start_pos);
+        }
+    }
+    else
+    {
+        const int64_t arrival_ns = continues_delay ? tl->delay_start_ns : tl->duration;
+        tl->delay_start_ns = -1;
+
+        const Tstamp* end_pos = Tstamp_add(TSTAMP_AUTO, start_pos, length);
+        if (!Timeline_add_parts(tl, system, start_pos, end_pos, arrival_ns, tempo))
+            return false;
+    }
+
+    // Extend the previous segment if we continue it seamlessly
+    if (tl->segment_count > 0)
+    {
+        Segment* prev = &tl->segments[tl->segment_count - 1];
+        const bool is_prev_delay = (Tstamp_cmp(&prev->length, TSTAMP_AUTO) == 0);
+        if ((prev->system == system) && (is_prev_delay == is_delay))
+        {
+            if (is_delay && (Tstamp_cmp(&prev->start_pos, start_pos) == 0))
+            {
+                tl->duration += length_ns;
+                return true;
+            }
+
+            const Tstamp* prev_end = Tstamp_add(TSTAMP_AUTO, &prev->start_pos, &prev->length);
+            if (!is_delay && (prev->tempo == tempo) && (Tstamp_cmp(prev_end, start_pos) == 0))
+            {
+                Tstamp_adda(&prev->length, length);
+                tl->duration += length_ns;
+                return true;
+            }
+        }
+    }
+
+    if (!reserve(
+                (void**)&tl->segments,
+                &tl->segment_cap,
+                tl->segment_count,
+                sizeof(Segment)))
+        return false;
+
+    Segment* segment = &tl->segments[tl->segment_count];
+    segment->start_ns = tl->duration;
+    segment->system = system;
+    Tstamp_copy(&segment->start_pos, start_pos);
+    Tstamp_copy(&segment->length, length);
+    segment->tempo = tempo;
+    ++tl->segment_count;
+
+    tl->duration += length_ns;
+
+    return true;
+}
+
+
+int64_t Timeline_get_duration(const Timeline* tl)
+{
+    rassert(tl != NULL);
+    return tl->duration;
+}
+
+
+int64_t Timeline_get_time(const Timeline* tl, int system, const Tstamp* pos)
+{
+    rassert(tl != NULL);
+    rassert(system >= 0);
+    rassert(pos != NULL);
+    rassert(Tstamp_cmp(pos, TSTAMP_AUTO) >= 0);
+
+    // Find the last part that starts at or before our position
+    int64_t lo = 0;
+    int64_t hi = tl->part_count;
+    while (lo < hi)
+    {
+        const int64_t mid = lo + (hi - lo) / 2;
+        const Part* part = &tl->parts[mid];
+        if (cmp_pos(part->system, &part->start, system, pos) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == 0)
+        return -1;
+
+    const Part* part = &tl->parts[lo - 1];
+    if ((part->system != system) || (Tstamp_cmp(pos, &part->end) >= 0))
+        return -1;
+
+    if (Tstamp_cmp(pos, &part->start) == 0)
+        return part->arrival_ns;
+
+    return part->origin_ns +
+        get_ns(Tstamp_sub(TSTAMP_AUTO, pos, &part->origin), part->tempo);
+}
+
+
+bool Timeline_get_position(const Timeline* tl, int64_t ns, int* system, Tstamp* pos)
+{
+    rassert(tl != NULL);
+    rassert(ns >= 0);
+    rassert(system != NULL);
+    rassert(pos != NULL);
+
+    if (ns >= tl->duration)
+        return false;
+
+    // Find the last segment that starts at or before ns
+    int64_t lo = 0;
+    int64_t hi = tl->segment_count;
+    while (lo < hi)
+    {
+        const int64_t mid = lo + (hi - lo) / 2;
+        if (tl->segments[mid].start_ns <= ns)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    rassert(lo > 0);
+    const Segment* segment = &tl->segments[lo - 1];
+
+    Tstamp* dist = get_dist(TSTAMP_AUTO, ns - segment->start_ns, segment->tempo);
+    Tstamp_mina(dist, &segment->length);
+
+    *system = segment->system;
+    Tstamp_add(pos, &segment->start_pos, dist);
+
+    return true;
+}
+
+
+void del_Timeline(Timeline* tl)
+{
+    if (tl == NULL)
+        return;
+
+    memory_free(tl->segments);
+    memory_free(tl->parts);
+    memory_free(tl);
+
+    return;
+}
+
+
@@ -0,0 +1,121 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_TIMELINE_H
+#define KQT_TIMELINE_H
+
+
+#include <decl.h>
+#include <mathnum/Tstamp.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * Timeline maps playback time of a track to positions in the track and back.
+ *
+ * The Timeline is built from consecutive segments of playback, each of which
+ * either moves forwards inside a single system at a constant tempo or stays
+ * at a row during a pattern delay. Segments are stored in playback order for
+ * time lookups. For position lookups, the Timeline keeps an index of the
+ * parts of the track in position order, each part referring to the time when
+ * the part was played for the first time.
+ */
+
+
+/**
+ * Create a new Timeline.
+ *
+ * \return   The new Timeline, or \c NULL if memory allocation failed.
+ */
+Timeline* new_Timeline(void);
+
+
+/**
+ * Add a segment to the end of the Timeline.
+ *
+ * \param tl          The Timeline -- must not be \c NULL.
+ * \param length_ns   The duration of the segment in nanoseconds -- must be
+ *                    > \c 0.
+ * \param system      The system of the segment -- must be >= \c 0.
+ * \param start_pos   The pattern position at the start of the segment -- must
+ *                    not be \c NULL or negative.
+ * \param length      The distance travelled during the segment -- must not be
+ *                    \c NULL or negative. A zero distance denotes a pattern
+ *                    delay.
+ * \param tempo       The tempo during the segment -- must be finite and
+ *                    > \c 0.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Timeline_add_segment(
+        Timeline* tl,
+        int64_t length_ns,
+        int system,
+        const Tstamp* start_pos,
+        const Tstamp* length,
+        double tempo);
+
+
+/**
+ * Get the total duration of the Timeline.
+ *
+ * \param tl   The Timeline -- must not be \c NULL.
+ *
+ * \return   The duration in nanoseconds.
+ */
+int64_t Timeline_get_duration(const Timeline* tl);
+
+
+/**
+ * Get the time at which a position is played for the first time.
+ *
+ * \param tl       The Timeline -- must not be \c NULL.
+ * \param system   The system -- must be >= \c 0.
+ * \param pos      The pattern position -- must not be \c NULL or negative.
+ *
+ * \return   The time in nanoseconds, or \c -1 if the position is never
+ *           played.
+ */
+int64_t Timeline_get_time(const Timeline* tl, int system, const Tstamp* pos);
+
+
+/**
+ * Get the position played at a given time.
+ *
+ * \param tl       The Timeline -- must not be \c NULL.
+ * \param ns       The time in nanoseconds -- must be >= \c 0.
+ * \param system   Destination for the system -- must not be \c NULL.
+ * \param pos      Destination for the pattern position -- must not be
+ *                 \c NULL.
+ *
+ * \return   \c true if successful, or \c false if \a ns is not less than the
+ *           duration of the Timeline.
+ */
+bool Timeline_get_position(const Timeline* tl, int64_t ns, int* system, Tstamp* pos);
+
+
+/**
+ * Destroy an existing Timeline.
+ *
+ * \param tl   The Timeline, or \c NULL.
+ */
+void del_Timeline(Timeline* tl);
+
+
+#endif // KQT_TIMELINE_H
+
+
@@ -22,6 +22,7 @@
 #include <player/devices/Voice_state.h>
 
 #include <inttypes.h>
+#include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -105,6 +106,17 @@ const Processor* Voice_get_proc(const Voice* voice)
 }
 
 
+float Voice_get_force_estimate(const Voice* voice)
+{
+    rassert(voice != NULL);
+
+    if ((voice->proc == NULL) || (voice->state == NULL))
+        return NAN;
+
+    return voice->state->force_estimate;
+}
+
+
 void Voice_set_work_buffer(Voice* voice, Work_buffer* wb)
 {
     rassert(voice != NULL);
@@ -133,6 +133,19 @@ bool Voice_is_external(const Voice* voice);
 const Processor* Voice_get_proc(const Voice* voice);
 
 
+/**
+ * Get the loudness estimate of the Voice.
+ *
+ * The estimate is provided by force processors and reflects the force of the
+ * latest rendered frame.
+ *
+ * \param voice   The Voice -- must not be \c NULL.
+ *
+ * \return   The force in dB, or \c NAN if the Voice has no estimate.
+ */
+float Voice_get_force_estimate(const Voice* voice);
+
+
 /**
  * Set the Work buffer associated with the Voice.
  *
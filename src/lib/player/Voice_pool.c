@@ -16,6 +16,7 @@
 
 #include <debug/assert.h>
 #include <kunquat/limits.h>
+#include <mathnum/common.h>
 #include <memory.h>
 #include <player/Voice_work_buffers.h>
 #include <threads/Mutex.h>
@@ -24,6 +25,7 @@
 #include <stdatomic.h>
 #endif
 
+#include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -37,6 +39,8 @@ struct Voice_pool
 #endif
 
     int size;
+    int polyphony_limit;
+    uint64_t steal_count;
     int32_t state_size;
     uint64_t new_group_id;
 
@@ -76,6 +80,8 @@ Voice_pool* new_Voice_pool(int size)
 #endif
 
     pool->size = size;
+    pool->polyphony_limit = size;
+    pool->steal_count = 0;
     pool->state_size = 0;
     pool->new_group_id = 0;
     pool->voice_state_memory = NULL;
@@ -225,45 +231,107 @@ uint64_t Voice_pool_new_group_id(Voice_pool* pool)
 }
 
 
-static Voice* try_extract_voice_from_array(Voice* voices[], uint64_t exclude_group_id)
+int Voice_pool_get_allocated_count(const Voice_pool* pool)
+{
+    rassert(pool != NULL);
+    return pool->size - pool->free_voice_count;
+}
+
+
+void Voice_pool_set_polyphony_limit(Voice_pool* pool, int limit)
+{
+    rassert(pool != NULL);
+    rassert(limit >= min(1, pool->size));
+    rassert(limit <= pool->size);
+
+    pool->polyphony_limit = limit;
+
+    return;
+}
+
+
+int Voice_pool_get_polyphony_limit(const Voice_pool* pool)
+{
+    rassert(pool != NULL);
+    return pool->polyphony_limit;
+}
+
+
+uint64_t Voice_pool_get_steal_count(const Voice_pool* pool)
+{
+    rassert(pool != NULL);
+    return pool->steal_count;
+}
+
+
+static bool find_quietest_group(
+        Voice* const voices[], uint64_t exclude_group_id, uint64_t* out_group_id)
 {
     rassert(voices != NULL);
-    rassert(exclude_group_id != 0);
+    rassert(out_group_id != NULL);
 
-    Voice* selected_voice = NULL;
-    int selected_voice_index = 0;
+    bool found = false;
+    float selected_force = INFINITY;
     uint64_t selected_group_id = UINT64_MAX;
 
-    for (int i = 0; i < KQT_VOICES_MAX; ++i)
+    // Voices of a group are stored contiguously
+    int i = 0;
+    while ((i < KQT_VOICES_MAX) && (voices[i] != NULL))
     {
-        Voice* cur_voice = voices[i];
-        if (cur_voice == NULL)
-            break;
+        const uint64_t group_id = voices[i]->group_id;
 
-        if ((cur_voice->group_id != exclude_group_id) &&
-                (cur_voice->group_id <= selected_group_id))
+        bool has_estimate = false;
+        float group_force = -INFINITY;
+        for (; (i < KQT_VOICES_MAX) && (voices[i] != NULL) &&
+                (voices[i]->group_id == group_id); ++i)
         {
-            selected_voice = cur_voice;
-            selected_voice_index = i;
-            selected_group_id = cur_voice->group_id;
+            const float force = Voice_get_force_estimate(voices[i]);
+            if (!isnan(force))
+            {
+                group_force = max(group_force, force);
+                has_estimate = true;
+            }
         }
-    }
 
-    if (selected_voice == NULL)
-        return NULL;
+        // Groups without a force processor are assumed to play at full force
+        if (!has_estimate)
+            group_force = 0;
 
-    // Remove gap in the Voice array
-    voices[selected_voice_index] = NULL;
-    for (int i = selected_voice_index + 1; i < KQT_VOICES_MAX; ++i)
-    {
-        if (voices[i] == NULL)
-            break;
+        if (group_id == exclude_group_id)
+            continue;
 
-        voices[i - 1] = voices[i];
-        voices[i] = NULL;
+        // Prefer the quietest group and the oldest one among equals
+        if (!found ||
+                (group_force < selected_force) ||
+                ((group_force == selected_force) && (group_id < selected_group_id)))
+        {
+            found = true;
+            selected_force = group_force;
+            selected_group_id = group_id;
+        }
     }
 
-    return selected_voice;
+    if (found)
+        *out_group_id = selected_group_id;
+
+    return found;
+}
+
+
+static bool Voice_pool_steal_group(Voice_pool* pool, uint64_t exclude_group_id)
+{
+    rassert(pool != NULL);
+
+    // Released notes are less important than playing ones
+    uint64_t group_id = 0;
+    if (!find_quietest_group(pool->background_voices, exclude_group_id, &group_id) &&
+            !find_quietest_group(pool->foreground_voices, exclude_group_id, &group_id))
+        return false;
+
+    Voice_pool_reset_group(pool, group_id);
+    ++pool->steal_count;
+
+    return true;
 }
 
 
@@ -276,38 +344,20 @@ Voice* Voice_pool_allocate_voice(
     rassert(ch_num < KQT_CHANNELS_MAX);
     rassert(group_id != 0);
 
-    Voice* new_voice = NULL;
-
-    if (pool->free_voice_count > 0)
+    if ((pool->free_voice_count == 0) ||
+            (Voice_pool_get_allocated_count(pool) >= pool->polyphony_limit))
     {
-        // Reserve a free voice
-        int reserved_index = pool->free_voice_count - 1;
-        new_voice = pool->free_voices[reserved_index];
-        pool->free_voices[reserved_index] = NULL;
-        --pool->free_voice_count;
+        const bool stolen = Voice_pool_steal_group(pool, group_id);
+        rassert(stolen || (pool->free_voice_count > 0));
+        ignore(stolen);
     }
-    else
-    {
-        // Try to find an old background voice
-        Voice* bg_voice =
-            try_extract_voice_from_array(pool->background_voices, group_id);
-
-        if (bg_voice != NULL)
-        {
-            Voice_pool_reset_group(pool, bg_voice->group_id);
-            new_voice = bg_voice;
-        }
-        else
-        {
-            // Get one of the oldest foreground voices as a last resort
-            Voice* fg_voice =
-                try_extract_voice_from_array(pool->foreground_voices, group_id);
 
-            rassert(fg_voice != NULL);
-            Voice_pool_reset_group(pool, fg_voice->group_id);
-            new_voice = fg_voice;
-        }
-    }
+    // Reserve a free voice
+    rassert(pool->free_voice_count > 0);
+    const int reserved_index = pool->free_voice_count - 1;
+    Voice* new_voice = pool->free_voices[reserved_index];
+    pool->free_voices[reserved_index] = NULL;
+    --pool->free_voice_count;
 
     rassert(new_voice != NULL);
     rassert(new_voice->group_id != group_id);
@@ -330,6 +380,19 @@ Voice* Voice_pool_allocate_voice(
 }
 
 
+int Voice_pool_enforce_polyphony_limit(Voice_pool* pool)
+{
+    rassert(pool != NULL);
+
+    int stolen_count = 0;
+    while ((Voice_pool_get_allocated_count(pool) > pool->polyphony_limit) &&
+            Voice_pool_steal_group(pool, 0))
+        ++stolen_count;
+
+    return stolen_count;
+}
+
+
 static void reset_voices_in_array(Voice_pool* pool, Voice* voices[], uint64_t group_id)
 {
     rassert(voices != NULL);
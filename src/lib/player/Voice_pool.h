@@ -87,6 +87,63 @@ bool Voice_pool_reserve_work_buffers(Voice_pool* pool, int32_t buf_size);
 int Voice_pool_get_size(const Voice_pool* pool);
 
 
+/**
+ * Get the number of Voices currently allocated from the Voice pool.
+ *
+ * \param pool   The Voice pool -- must not be \c NULL.
+ *
+ * \return   The number of allocated Voices.
+ */
+int Voice_pool_get_allocated_count(const Voice_pool* pool);
+
+
+/**
+ * Set the maximum number of Voices allocated at the same time.
+ *
+ * The limit is applied to subsequent allocations. Call
+ * \a Voice_pool_enforce_polyphony_limit to release Voices exceeding the limit.
+ *
+ * \param pool    The Voice pool -- must not be \c NULL.
+ * \param limit   The polyphony limit -- must be >= \c 1 and <= the size of
+ *                \a pool, or \c 0 if \a pool is empty.
+ */
+void Voice_pool_set_polyphony_limit(Voice_pool* pool, int limit);
+
+
+/**
+ * Get the maximum number of Voices allocated at the same time.
+ *
+ * \param pool   The Voice pool -- must not be \c NULL.
+ *
+ * \return   The polyphony limit.
+ */
+int Voice_pool_get_polyphony_limit(const Voice_pool* pool);
+
+
+/**
+ * Release Voice groups until the polyphony limit is met.
+ *
+ * Background groups are released before foreground groups, and the groups
+ * with the lowest force estimate are released first within each category.
+ *
+ * \param pool   The Voice pool -- must not be \c NULL.
+ *
+ * \return   The number of Voice groups released.
+ */
+int Voice_pool_enforce_polyphony_limit(Voice_pool* pool);
+
+
+/**
+ * Get the total number of Voice groups stolen for new Voices.
+ *
+ * \param pool   The Voice pool -- must not be \c NULL.
+ *
+ * \return   The number of stolen Voice groups, including the groups released
+ *           by \a Voice_pool_enforce_polyphony_limit.
+ */
+uint64_t Voice_pool_get_steal_count(const Voice_pool* pool);
+
+
 /**
  * Get a new Voice group ID from the Voice pool.
  *
@@ -100,9 +157,10 @@ uint64_t Voice_pool_new_group_id(Voice_pool* pool);
 /**
  * Allocate a new Voice from the Voice pool.
  *
- * This function always succeeds. In case all the Voices are in use, an existing
- * Voice group (other than  one of given ID) will be reset and one of its Voices
- * is returned.
+ * This function always succeeds. In case all the Voices are in use or the
+ * polyphony limit has been reached, an existing Voice group (other than one of
+ * given ID) will be reset and one of its Voices is returned. Background groups
+ * are stolen before foreground groups, and quieter groups before louder ones.
  *
  * \param pool          The Voice pool -- must not be \c NULL.
  * \param ch_num        The number of the channel requesting the Voice -- must be
@@ -17,6 +17,7 @@
 #include <debug/assert.h>
 #include <mathnum/common.h>
 #include <memory.h>
+#include <player/Thread_arena.h>
 #include <player/Work_buffer_private.h>
 
 #include <stdbool.h>
@@ -32,36 +33,81 @@ static_assert(sizeof(int32_t) <= WORK_BUFFER_ELEM_SIZE,
 #define MARGIN_ELEM_COUNT 3
 
 
+static void* alloc_contents(Thread_arena* arena, int32_t size)
+{
+    rassert(size > 0);
+
+    const int64_t byte_count =
+        (int64_t)(size + MARGIN_ELEM_COUNT) * WORK_BUFFER_ELEM_SIZE;
+
+    if (arena != NULL)
+        return Thread_arena_alloc(arena, byte_count);
+
+    float* contents = memory_alloc_items_aligned(char, byte_count, 64);
+    if (contents != NULL)
+    {
+        for (int32_t i = 0; i < size + MARGIN_ELEM_COUNT; ++i)
+            contents[i] = 0;
+    }
+
+    return contents;
+}
+
+
+static void free_contents(Thread_arena* arena, void* contents, int32_t size)
+{
+    if (arena != NULL)
+    {
+        const int64_t byte_count =
+            (int64_t)(size + MARGIN_ELEM_COUNT) * WORK_BUFFER_ELEM_SIZE;
+        Thread_arena_free(arena, contents, byte_count);
+    }
+    else
+    {
+        memory_free_aligned(contents);
+    }
+
+    return;
+}
+
+
 Work_buffer* new_Work_buffer(int32_t size)
 {
     rassert(size > 0);
     rassert(size <= WORK_BUFFER_SIZE_MAX);
 
+    return new_Work_buffer_in_arena(size, NULL);
+}
+
+
+Work_buffer* new_Work_buffer_in_arena(int32_t size, Thread_arena* arena)
+{
+    rassert(size > 0);
+    rassert(size <= WORK_BUFFER_SIZE_MAX);
+
     Work_buffer* buffer = memory_alloc_item(Work_buffer);
     if (buffer == NULL)
         return NULL;
 
     // Sanitise fields
+    buffer->arena = arena;
     buffer->size = size;
     buffer->is_valid = true;
     buffer->const_start = 0;
+    buffer->ramp_start = INT32_MAX;
+    buffer->ramp_stop = INT32_MAX;
+    buffer->ramp_step = 0;
     buffer->is_final = true;
     buffer->contents = NULL;
 
     // Allocate buffers
-    const int32_t actual_size = size + MARGIN_ELEM_COUNT;
-    buffer->contents =
-        memory_alloc_items_aligned(char, actual_size * WORK_BUFFER_ELEM_SIZE, 64);
+    buffer->contents = alloc_contents(arena, size);
     if (buffer->contents == NULL)
     {
         del_Work_buffer(buffer);
         return NULL;
     }
 
-    float* contents = buffer->contents;
-    for (int32_t i = 0; i < actual_size; ++i)
-        contents[i] = 0;
-
     return buffer;
 }
 
@@ -74,9 +120,13 @@ void Work_buffer_init_with_memory(
     rassert((intptr_t)space % 64 == 0);
     rassert(raw_elem_count >= 4);
 
+    buffer->arena = NULL;
     buffer->size = raw_elem_count - MARGIN_ELEM_COUNT;
     buffer->is_valid = true;
     buffer->const_start = 0;
+    buffer->ramp_start = INT32_MAX;
+    buffer->ramp_stop = INT32_MAX;
+    buffer->ramp_step = 0;
     buffer->is_final = true;
     buffer->contents = space;
 
@@ -122,13 +172,11 @@ bool Work_buffer_resize(Work_buffer* buffer, int32_t new_size)
     rassert(new_size > 0);
     rassert(new_size <= WORK_BUFFER_SIZE_MAX);
 
-    const int32_t actual_size = new_size + MARGIN_ELEM_COUNT;
-    char* new_contents =
-        memory_alloc_items_aligned(char, actual_size * WORK_BUFFER_ELEM_SIZE, 64);
+    void* new_contents = alloc_contents(buffer->arena, new_size);
     if (new_contents == NULL)
         return false;
 
-    memory_free_aligned(buffer->contents);
+    free_contents(buffer->arena, buffer->contents, buffer->size);
     buffer->contents = NULL;
 
     buffer->size = new_size;
@@ -136,6 +184,7 @@ bool Work_buffer_resize(Work_buffer* buffer, int32_t new_size)
 
     buffer->is_valid = false;
     Work_buffer_clear_const_start(buffer);
+    Work_buffer_clear_ramp(buffer);
     buffer->is_final = false;
 
     return true;
@@ -156,6 +205,7 @@ void Work_buffer_clear(Work_buffer* buffer, int32_t buf_start, int32_t buf_stop)
 
     buffer->is_valid = true;
     Work_buffer_set_const_start(buffer, buf_start);
+    Work_buffer_clear_ramp(buffer);
     buffer->is_final = true;
 
     return;
@@ -184,6 +234,7 @@ float* Work_buffer_get_contents_mut(Work_buffer* buffer)
 
     Work_buffer_mark_valid(buffer);
     Work_buffer_clear_const_start(buffer);
+    Work_buffer_clear_ramp(buffer);
     Work_buffer_set_final(buffer, false);
 
     return (float*)buffer->contents;
@@ -196,6 +247,7 @@ int32_t* Work_buffer_get_contents_int_mut(Work_buffer* buffer)
 
     Work_buffer_mark_valid(buffer);
     Work_buffer_clear_const_start(buffer);
+    Work_buffer_clear_ramp(buffer);
     Work_buffer_set_final(buffer, false);
 
     return (int32_t*)buffer->contents;
@@ -234,6 +286,9 @@ void Work_buffer_copy(
 
     Work_buffer_mark_valid(dest);
     Work_buffer_set_const_start(dest, Work_buffer_get_const_start(src));
+    dest->ramp_start = src->ramp_start;
+    dest->ramp_stop = src->ramp_stop;
+    dest->ramp_step = src->ramp_step;
     Work_buffer_set_final(dest, Work_buffer_is_final(src));
 
     return;
@@ -266,6 +321,131 @@ int32_t Work_buffer_get_const_start(const Work_buffer* buffer)
 }
 
 
+void Work_buffer_set_ramp(Work_buffer* buffer, int32_t start, int32_t stop, float step)
+{
+    rassert(buffer != NULL);
+    rassert(start >= 0);
+    rassert(stop >= start);
+    rassert(isfinite(step));
+
+    if (start == stop)
+    {
+        Work_buffer_clear_ramp(buffer);
+        return;
+    }
+
+    buffer->ramp_start = start;
+    buffer->ramp_stop = stop;
+    buffer->ramp_step = step;
+
+    return;
+}
+
+
+void Work_buffer_clear_ramp(Work_buffer* buffer)
+{
+    rassert(buffer != NULL);
+
+    buffer->ramp_start = INT32_MAX;
+    buffer->ramp_stop = INT32_MAX;
+    buffer->ramp_step = 0;
+
+    return;
+}
+
+
+int32_t Work_buffer_get_ramp_start(const Work_buffer* buffer)
+{
+    rassert(buffer != NULL);
+    return buffer->ramp_start;
+}
+
+
+int32_t Work_buffer_get_ramp_stop(const Work_buffer* buffer)
+{
+    rassert(buffer != NULL);
+    return buffer->ramp_stop;
+}
+
+
+float Work_buffer_get_ramp_step(const Work_buffer* buffer)
+{
+    rassert(buffer != NULL);
+    return buffer->ramp_step;
+}
+
+
+Work_buffer_segment* Work_buffer_get_segment(
+        const Work_buffer* buffer,
+        int32_t start,
+        int32_t stop,
+        Work_buffer_segment* seg)
+{
+    rassert(buffer != NULL);
+    rassert(Work_buffer_is_valid(buffer));
+    rassert(start >= 0);
+    rassert(stop > start);
+    rassert(stop <= Work_buffer_get_size(buffer) + MARGIN_ELEM_COUNT);
+    rassert(seg != NULL);
+
+    const float* contents = buffer->contents;
+
+    seg->start = start;
+    seg->value = contents[start];
+    seg->step = 0;
+
+    const int32_t const_start = buffer->const_start;
+    if (start >= const_start)
+    {
+        seg->type = WORK_BUFFER_SEGMENT_CONST;
+        seg->stop = stop;
+        return seg;
+    }
+
+    const int32_t ramp_stop = min(buffer->ramp_stop, const_start);
+    if ((buffer->ramp_start <= start) && (start < ramp_stop))
+    {
+        seg->type = WORK_BUFFER_SEGMENT_RAMP;
+        seg->stop = min(ramp_stop, stop);
+        seg->step = buffer->ramp_step;
+        return seg;
+    }
+
+    seg->type = WORK_BUFFER_SEGMENT_ARRAY;
+    seg->stop = min(const_start, stop);
+    if (buffer->ramp_start > start)
+        seg->stop = min(seg->stop, buffer->ramp_start);
+
+    return seg;
+}
+
+
+static void get_linear_area(
+        const Work_buffer* buffer, int32_t* start, int32_t* stop, float* step)
+{
+    rassert(buffer != NULL);
+    rassert(start != NULL);
+    rassert(stop != NULL);
+    rassert(step != NULL);
+
+    const int32_t ramp_stop = min(buffer->ramp_stop, buffer->const_start);
+    if (buffer->ramp_start < ramp_stop)
+    {
+        *start = buffer->ramp_start;
+        *stop = ramp_stop;
+        *step = buffer->ramp_step;
+    }
+    else
+    {
+        *start = buffer->const_start;
+        *stop = INT32_MAX;
+        *step = 0;
+    }
+
+    return;
+}
+
+
 void Work_buffer_set_final(Work_buffer* buffer, bool is_final)
 {
     rassert(buffer != NULL);
@@ -323,11 +503,44 @@ void Work_buffer_mix(
     const bool in_has_neg_inf_final_value =
         in_has_final_value && (src_contents[src_const_start] == -INFINITY);
 
-    for (int32_t i = buf_start; i < buf_stop; ++i)
+    int32_t dest_lin_start = INT32_MAX;
+    int32_t dest_lin_stop = INT32_MAX;
+    float dest_lin_step = 0;
+    get_linear_area(dest, &dest_lin_start, &dest_lin_stop, &dest_lin_step);
+
+    Work_buffer_segment seg;
+    for (int32_t i = buf_start; i < buf_stop; i = seg.stop)
     {
-        dassert(!isnan(dest_contents[i]));
-        dassert(!isnan(src_contents[i]));
-        dest_contents[i] += src_contents[i];
+        Work_buffer_get_segment(src, i, buf_stop, &seg);
+
+        if (seg.type == WORK_BUFFER_SEGMENT_ARRAY)
+        {
+            for (int32_t k = seg.start; k < seg.stop; ++k)
+            {
+                dassert(!isnan(dest_contents[k]));
+                dassert(!isnan(src_contents[k]));
+                dest_contents[k] += src_contents[k];
+            }
+        }
+        else if (seg.type == WORK_BUFFER_SEGMENT_RAMP)
+        {
+            const double start_value = seg.value;
+            const double step = seg.step;
+            for (int32_t k = seg.start; k < seg.stop; ++k)
+            {
+                dassert(!isnan(dest_contents[k]));
+                dest_contents[k] += (float)(start_value + (step * (k - seg.start)));
+            }
+        }
+        else
+        {
+            const float value = seg.value;
+            for (int32_t k = seg.start; k < seg.stop; ++k)
+            {
+                dassert(!isnan(dest_contents[k]));
+                dest_contents[k] += value;
+            }
+        }
     }
 
     bool result_is_const_final = (buffer_has_final_value && in_has_final_value);
@@ -353,6 +566,21 @@ void Work_buffer_mix(
             dest_contents[i] = -INFINITY;
     }
 
+    // Combine linear parts of the inputs
+    {
+        int32_t src_lin_start = INT32_MAX;
+        int32_t src_lin_stop = INT32_MAX;
+        float src_lin_step = 0;
+        get_linear_area(src, &src_lin_start, &src_lin_stop, &src_lin_step);
+
+        const int32_t ramp_start = max(dest_lin_start, src_lin_start);
+        const int32_t ramp_stop = min(min(dest_lin_stop, src_lin_stop), new_const_start);
+        if (ramp_start < ramp_stop)
+            Work_buffer_set_ramp(dest, ramp_start, ramp_stop, dest_lin_step + src_lin_step);
+        else
+            Work_buffer_clear_ramp(dest);
+    }
+
     Work_buffer_mark_valid(dest);
     Work_buffer_set_const_start(dest, new_const_start);
     Work_buffer_set_final(dest, result_is_const_final);
@@ -394,6 +622,7 @@ void Work_buffer_mix_shifted(
 
         Work_buffer_mark_valid(dest);
         Work_buffer_set_const_start(dest, shifted_src_const_start);
+        Work_buffer_clear_ramp(dest);
         Work_buffer_set_final(dest, Work_buffer_is_final(src));
 
         return;
@@ -444,6 +673,7 @@ void Work_buffer_mix_shifted(
 
     Work_buffer_mark_valid(dest);
     Work_buffer_set_const_start(dest, new_const_start);
+    Work_buffer_clear_ramp(dest);
     Work_buffer_set_final(dest, result_is_const_final);
 
     return;
@@ -455,7 +685,8 @@ void del_Work_buffer(Work_buffer* buffer)
     if (buffer == NULL)
         return;
 
-    memory_free_aligned(buffer->contents);
+    if (buffer->contents != NULL)
+        free_contents(buffer->arena, buffer->contents, buffer->size);
     memory_free(buffer);
 
     return;
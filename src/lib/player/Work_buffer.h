@@ -30,6 +30,33 @@
     ((INT32_MAX / WORK_BUFFER_ELEM_SIZE) - 3)
 
 
+/**
+ * Segment types of Work buffer contents.
+ */
+typedef enum
+{
+    WORK_BUFFER_SEGMENT_ARRAY = 0, ///< Arbitrary values.
+    WORK_BUFFER_SEGMENT_RAMP,      ///< Linearly changing values.
+    WORK_BUFFER_SEGMENT_CONST,     ///< Constant values.
+} Work_buffer_segment_type;
+
+
+/**
+ * A description of a contiguous area of Work buffer contents.
+ *
+ * For ramp and constant segments, the value at index \c i is
+ * \a value + (\c i - \a start) * \a step.
+ */
+typedef struct Work_buffer_segment
+{
+    Work_buffer_segment_type type;
+    int32_t start;
+    int32_t stop;
+    float value;
+    float step;
+} Work_buffer_segment;
+
+
 /**
  * Create a new Work buffer.
  *
@@ -41,6 +68,20 @@
 Work_buffer* new_Work_buffer(int32_t size);
 
 
+/**
+ * Create a new Work buffer with contents allocated from a Thread arena.
+ *
+ * \param size    The buffer size -- must be > \c 0 and
+ *                 <= \c WORK_BUFFER_SIZE_MAX.
+ * \param arena   The Thread arena, or \c NULL if the contents should be
+ *                 allocated from the general heap.
+ *
+ * \return   The new Work buffer if successful, or \c NULL if memory allocation
+ *           failed.
+ */
+Work_buffer* new_Work_buffer_in_arena(int32_t size, Thread_arena* arena);
+
+
 /**
  * Initialise a Work buffer with externally allocated space.
  *
@@ -143,11 +184,11 @@ const float* Work_buffer_get_contents(const Work_buffer* buffer)
 /**
  * Get the mutable contents of the Work buffer.
  *
- * Note: This function clears the const start index and final status of the
- *       buffer as it no longer makes any assumptions of the buffer contents.
- *       If you wish to utilise these optimisation features, retrieve them
- *       first by calling \a Work_buffer_get_const_start and
- *       \a Work_buffer_is_final.
+ * Note: This function clears the const start index, ramp and final status of
+ *       the buffer as it no longer makes any assumptions of the buffer
+ *       contents. If you wish to utilise these optimisation features, retrieve
+ *       them first by calling \a Work_buffer_get_const_start,
+ *       \a Work_buffer_get_ramp_start and \a Work_buffer_is_final.
  *
  * \param buffer   The Work buffer -- must not be \c NULL.
  *
@@ -226,6 +267,89 @@ void Work_buffer_clear_const_start(Work_buffer* buffer);
 int32_t Work_buffer_get_const_start(const Work_buffer* buffer);
 
 
+/**
+ * Mark a part of Work buffer contents as a linear ramp.
+ *
+ * NOTE: This is used as optional information for performance optimisation.
+ * The caller must still fill the marked buffer area with the ramp values for
+ * code that does not take advantage of this information. The ramp must not
+ * extend into the constant-value part of the buffer.
+ *
+ * \param buffer   The Work buffer -- must not be \c NULL.
+ * \param start    The start index of the ramp -- must be non-negative.
+ * \param stop     The stop index of the ramp -- must be >= \a start.
+ * \param step     The difference between consecutive values -- must be finite.
+ */
+void Work_buffer_set_ramp(Work_buffer* buffer, int32_t start, int32_t stop, float step);
+
+
+/**
+ * Clear Work buffer ramp marker.
+ *
+ * \param buffer   The Work buffer -- must not be \c NULL.
+ */
+void Work_buffer_clear_ramp(Work_buffer* buffer);
+
+
+/**
+ * Get Work buffer ramp start marker.
+ *
+ * \param buffer   The Work buffer -- must not be \c NULL.
+ *
+ * \return   The start index of the ramp, or \c INT32_MAX if not set.
+ */
+int32_t Work_buffer_get_ramp_start(const Work_buffer* buffer);
+
+
+/**
+ * Get Work buffer ramp stop marker.
+ *
+ * \param buffer   The Work buffer -- must not be \c NULL.
+ *
+ * \return   The stop index of the ramp, or \c INT32_MAX if not set.
+ */
+int32_t Work_buffer_get_ramp_stop(const Work_buffer* buffer);
+
+
+/**
+ * Get Work buffer ramp step.
+ *
+ * \param buffer   The Work buffer -- must not be \c NULL.
+ *
+ * \return   The difference between consecutive values in the ramp.
+ */
+float Work_buffer_get_ramp_step(const Work_buffer* buffer);
+
+
+/**
+ * Get the segment of the Work buffer that starts at the given index.
+ *
+ * A typical use case is a loop that handles each segment type separately:
+ *
+ * \code
+ * Work_buffer_segment seg;
+ * for (int32_t i = buf_start; i < buf_stop; i = seg.stop)
+ * {
+ *     Work_buffer_get_segment(wb, i, buf_stop, &seg);
+ *     ...
+ * }
+ * \endcode
+ *
+ * \param buffer   The Work buffer -- must not be \c NULL and must be valid.
+ * \param start    The start index of the segment -- must be >= \c 0.
+ * \param stop     The maximum stop index of the segment -- must be > \a start
+ *                 and less than or equal to the buffer size.
+ * \param seg      The destination segment -- must not be \c NULL.
+ *
+ * \return   The parameter \a seg.
+ */
+Work_buffer_segment* Work_buffer_get_segment(
+        const Work_buffer* buffer,
+        int32_t start,
+        int32_t stop,
+        Work_buffer_segment* seg);
+
+
 /**
  * Mark the constant trail of the buffer as final value.
  *
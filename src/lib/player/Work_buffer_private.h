@@ -16,6 +16,7 @@
 #define KQT_WORK_BUFFER_PRIVATE_H
 
 
+#include <decl.h>
 #include <player/Work_buffer.h>
 
 #include <stdbool.h>
@@ -24,9 +25,13 @@
 
 struct Work_buffer
 {
+    Thread_arena* arena;
     void* contents;
     int32_t size;
     int32_t const_start;
+    int32_t ramp_start;
+    int32_t ramp_stop;
+    float ramp_step;
     uint8_t is_valid : 1;
     uint8_t is_final : 1;
 };
@@ -26,11 +26,12 @@
 
 struct Work_buffers
 {
+    Thread_arena* arena;
     Work_buffer* buffers[WORK_BUFFER_COUNT_];
 };
 
 
-Work_buffers* new_Work_buffers(int32_t buf_size)
+Work_buffers* new_Work_buffers(int32_t buf_size, Thread_arena* arena)
 {
     rassert(buf_size >= 0);
     rassert(buf_size <= WORK_BUFFER_SIZE_MAX);
@@ -40,6 +41,7 @@ Work_buffers* new_Work_buffers(int32_t buf_size)
         return NULL;
 
     // Sanitise fields
+    buffers->arena = arena;
     for (int i = 0; i < WORK_BUFFER_COUNT_; ++i)
         buffers->buffers[i] = NULL;
 
@@ -48,7 +50,7 @@ Work_buffers* new_Work_buffers(int32_t buf_size)
     {
         for (int i = 0; i < WORK_BUFFER_COUNT_; ++i)
         {
-            buffers->buffers[i] = new_Work_buffer(buf_size);
+            buffers->buffers[i] = new_Work_buffer_in_arena(buf_size, arena);
             if (buffers->buffers[i] == NULL)
             {
                 del_Work_buffers(buffers);
@@ -71,7 +73,7 @@ bool Work_buffers_resize(Work_buffers* buffers, int32_t new_size)
     {
         if (buffers->buffers[i] == NULL)
         {
-            buffers->buffers[i] = new_Work_buffer(new_size);
+            buffers->buffers[i] = new_Work_buffer_in_arena(new_size, buffers->arena);
             if (buffers->buffers[i] == NULL)
                 return false;
         }
@@ -45,11 +45,12 @@ typedef enum
  *                   <= \c WORK_BUFFER_SIZE_MAX.
  *                   NOTE: Work buffers with size \c 0 must not be requested for
  *                   buffer retrieval.
+ * \param arena      The Thread arena used for buffer contents, or \c NULL.
  *
  * \return   The new Work buffers if successful, or \c NULL if memory
  *           allocation failed.
  */
-Work_buffers* new_Work_buffers(int32_t buf_size);
+Work_buffers* new_Work_buffers(int32_t buf_size, Thread_arena* arena);
 
 
 /**
@@ -42,6 +42,7 @@ bool Device_state_init(
 
     ds->audio_rate = audio_rate;
     ds->audio_buffer_size = audio_buffer_size;
+    ds->control_period = 1;
 
     ds->set_audio_rate = NULL;
     ds->set_audio_buffer_size = NULL;
@@ -107,6 +108,25 @@ int32_t Device_state_get_audio_rate(const Device_state* ds)
 }
 
 
+void Device_state_set_control_period(Device_state* ds, int32_t period)
+{
+    rassert(ds != NULL);
+    rassert(period >= 1);
+    rassert(period <= KQT_CONTROL_PERIOD_MAX);
+
+    ds->control_period = period;
+
+    return;
+}
+
+
+int32_t Device_state_get_control_period(const Device_state* ds)
+{
+    rassert(ds != NULL);
+    return ds->control_period;
+}
+
+
 bool Device_state_set_audio_buffer_size(Device_state* ds, int32_t size)
 {
     rassert(ds != NULL);
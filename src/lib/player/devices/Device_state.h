@@ -57,6 +57,7 @@ struct Device_state
 
     int32_t audio_rate;
     int32_t audio_buffer_size;
+    int32_t control_period;
 
     // Protected interface
     Device_state_set_audio_rate_func* set_audio_rate;
@@ -137,6 +138,30 @@ bool Device_state_set_audio_rate(Device_state* ds, int32_t audio_rate);
 int32_t Device_state_get_audio_rate(const Device_state* ds);
 
 
+/**
+ * Set the control period.
+ *
+ * Control streams (slides and oscillations) are evaluated once per control
+ * period and linearly interpolated inside each period. A period of \c 1
+ * evaluates the controls at audio rate.
+ *
+ * \param ds       The Device state -- must not be \c NULL.
+ * \param period   The control period in frames -- must be >= \c 1 and
+ *                 <= \c KQT_CONTROL_PERIOD_MAX.
+ */
+void Device_state_set_control_period(Device_state* ds, int32_t period);
+
+
+/**
+ * Get the control period.
+ *
+ * \param ds   The Device state -- must not be \c NULL.
+ *
+ * \return   The control period in frames.
+ */
+int32_t Device_state_get_control_period(const Device_state* ds);
+
+
 /**
  * Set the audio buffer size.
  *
@@ -27,7 +27,7 @@
 
 
 Device_thread_state* new_Device_thread_state(
-         const Device* device, int32_t audio_buffer_size)
+         const Device* device, int32_t audio_buffer_size, Thread_arena* arena)
 {
     rassert(device != NULL);
     rassert(audio_buffer_size >= 0);
@@ -39,6 +39,7 @@ Device_thread_state* new_Device_thread_state(
     ts->device_id = Device_get_id(device);
     ts->device = device;
     ts->audio_buffer_size = audio_buffer_size;
+    ts->arena = arena;
     ts->node_state = DEVICE_NODE_STATE_NEW;
     ts->has_mixed_audio = false;
     ts->in_connected = NULL;
@@ -138,7 +139,7 @@ static bool Device_thread_state_add_buffer(
     if (Etable_get(ts->buffers[buf_type][port_type], port) != NULL)
         return true;
 
-    Work_buffer* wb = new_Work_buffer(ts->audio_buffer_size);
+    Work_buffer* wb = new_Work_buffer_in_arena(ts->audio_buffer_size, ts->arena);
     if ((wb == NULL) || !Etable_set(ts->buffers[buf_type][port_type], port, wb))
     {
         del_Work_buffer(wb);
@@ -462,13 +463,15 @@ bool Device_thread_state_has_mixed_audio(const Device_thread_state* ts)
 
 void Device_thread_state_combine_mixed_audio(
         Device_thread_state* dest_ts,
-        const Device_thread_state* src_ts,
+        int src_count,
+        const Device_thread_state* src_tss[],
         int32_t buf_start,
         int32_t buf_stop)
 {
     rassert(dest_ts != NULL);
-    rassert(src_ts != NULL);
-    rassert(dest_ts->device_id == src_ts->device_id);
+    rassert(src_count >= 0);
+    rassert(src_count < KQT_THREADS_MAX);
+    rassert(src_tss != NULL);
     rassert(buf_start >= 0);
     rassert(buf_stop >= buf_start);
 
@@ -477,27 +480,44 @@ void Device_thread_state_combine_mixed_audio(
         // TODO: Consider clearing the buffer here
     }
 
-    if (!Device_thread_state_has_mixed_audio(src_ts))
+    // Only visit the sources that have something to contribute
+    const Etable* src_buffer_tables[KQT_THREADS_MAX] = { NULL };
+    int used_src_count = 0;
+    for (int si = 0; si < src_count; ++si)
+    {
+        const Device_thread_state* src_ts = src_tss[si];
+        rassert(src_ts != NULL);
+        rassert(src_ts->device_id == dest_ts->device_id);
+
+        if (!Device_thread_state_has_mixed_audio(src_ts))
+            continue;
+
+        src_buffer_tables[used_src_count] =
+            src_ts->buffers[DEVICE_BUFFER_MIXED][DEVICE_PORT_TYPE_SEND];
+        rassert(src_buffer_tables[used_src_count] != NULL);
+        ++used_src_count;
+    }
+
+    if (used_src_count == 0)
         return;
 
     Etable* dest_buffers = dest_ts->buffers[DEVICE_BUFFER_MIXED][DEVICE_PORT_TYPE_SEND];
     rassert(dest_buffers != NULL);
     const int check_stop = Etable_get_capacity(dest_buffers);
 
-    const Etable* src_buffers =
-        src_ts->buffers[DEVICE_BUFFER_MIXED][DEVICE_PORT_TYPE_SEND];
-    rassert(src_buffers != NULL);
-
     for (int i = 0; i < check_stop; ++i)
     {
         Work_buffer* dest_buffer = Etable_get(dest_buffers, i);
         if (dest_buffer == NULL)
             continue;
 
-        const Work_buffer* src_buffer = Etable_get(src_buffers, i);
-        rassert(src_buffer != NULL);
+        for (int si = 0; si < used_src_count; ++si)
+        {
+            const Work_buffer* src_buffer = Etable_get(src_buffer_tables[si], i);
+            rassert(src_buffer != NULL);
 
-        Work_buffer_mix(dest_buffer, src_buffer, buf_start, buf_stop);
+            Work_buffer_mix(dest_buffer, src_buffer, buf_start, buf_stop);
+        }
     }
 
     return;
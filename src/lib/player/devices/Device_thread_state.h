@@ -40,6 +40,7 @@ struct Device_thread_state
     const Device* device;
 
     int32_t audio_buffer_size;
+    Thread_arena* arena;
 
     Device_node_state node_state;
 
@@ -62,12 +63,14 @@ struct Device_thread_state
  *
  * \param device              The Device -- must not be \c NULL.
  * \param audio_buffer_size   The audio buffer size -- must be >= \c 0.
+ * \param arena               The Thread arena used for buffer contents,
+ *                            or \c NULL.
  *
  * \return   The new Device thread state if successful, or \c NULL if memory
  *           allocation failed.
  */
 Device_thread_state* new_Device_thread_state(
-        const Device* device, int32_t audio_buffer_size);
+        const Device* device, int32_t audio_buffer_size, Thread_arena* arena);
 
 
 /**
@@ -264,18 +267,25 @@ bool Device_thread_state_has_mixed_audio(const Device_thread_state* ts);
 
 
 /**
- * Combine mixed audio of one Device thread state with another.
+ * Combine mixed audio of Device thread states into another.
+ *
+ * Each output port of \a dest_ts is processed in a single pass over all the
+ * sources.
  *
  * \param dest_ts     The destination Device thread state -- must not be \c NULL.
- * \param src_ts      The source Device thread state -- must not be \c NULL and
- *                    must be associated with the same device as \a dest_ts.
+ * \param src_count   The number of source Device thread states -- must be
+ *                    >= \c 0.
+ * \param src_tss     The source Device thread states -- must not be \c NULL
+ *                    and must be associated with the same device as
+ *                    \a dest_ts.
  * \param buf_start   The start index of mixing -- must be >= \c 0.
  * \param buf_stop    The stop index of mixing -- must be less than or equal
  *                    to the audio buffer size.
  */
 void Device_thread_state_combine_mixed_audio(
         Device_thread_state* dest_ts,
-        const Device_thread_state* src_ts,
+        int src_count,
+        const Device_thread_state* src_tss[],
         int32_t buf_start,
         int32_t buf_stop);
 
@@ -76,6 +76,7 @@ Voice_state* Voice_state_clear(Voice_state* state)
     state->active = false;
     state->keep_alive_stop = 0;
     state->ramp_attack = 0;
+    state->force_estimate = NAN;
 
     state->expr_filters_applied = false;
     memset(state->ch_expr_name, '\0', KQT_VAR_NAME_MAX + 1);
@@ -74,6 +74,7 @@ struct Voice_state
     char test_proc_param[KQT_VAR_NAME_MAX + 1];
 
     double ramp_attack;            ///< The current state of volume ramp during attack.
+    float force_estimate;          ///< The last rendered force in dB, or NAN if unknown.
 
     int hit_index;                 ///< The hit index (negative for normal notes).
 
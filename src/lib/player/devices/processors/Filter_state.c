@@ -130,15 +130,37 @@ static void Filter_state_impl_apply_input_buffers(
             const float* resonance_buf = Work_buffer_get_contents(resonance_wb);
 
             // Get resonance values from input
-            for (int32_t i = 0; i < fast_res_stop; ++i)
+            Work_buffer_segment seg;
+            for (int32_t i = 0; i < fast_res_stop; i = seg.stop)
             {
-                const double res_param = resonance_buf[i];
-                const double biased_res_exp =
-                    fast_exp2(res_bias_base_log2 * (100 - res_param) / 100.0);
-                const float biased_res =
-                    (float)((biased_res_exp - 1) * 2.0 / (res_bias_base - 1));
-
-                resonances[i] = biased_res;
+                Work_buffer_get_segment(resonance_wb, i, fast_res_stop, &seg);
+                if (seg.type == WORK_BUFFER_SEGMENT_RAMP)
+                {
+                    // Exponentiate linear resonance slides incrementally
+                    double biased_res_exp =
+                        exp2(res_bias_base_log2 * (100 - seg.value) / 100.0);
+                    const double ratio = exp2(-res_bias_base_log2 * seg.step / 100.0);
+
+                    for (int32_t k = seg.start; k < seg.stop; ++k)
+                    {
+                        resonances[k] =
+                            (float)((biased_res_exp - 1) * 2.0 / (res_bias_base - 1));
+                        biased_res_exp *= ratio;
+                    }
+
+                    continue;
+                }
+
+                for (int32_t k = seg.start; k < seg.stop; ++k)
+                {
+                    const double res_param = resonance_buf[k];
+                    const double biased_res_exp =
+                        fast_exp2(res_bias_base_log2 * (100 - res_param) / 100.0);
+                    const float biased_res =
+                        (float)((biased_res_exp - 1) * 2.0 / (res_bias_base - 1));
+
+                    resonances[k] = biased_res;
+                }
             }
 
             if (fast_res_stop < frame_count)
@@ -21,6 +21,7 @@
 #include <mathnum/common.h>
 #include <mathnum/conversions.h>
 #include <mathnum/Random.h>
+#include <player/devices/Device_state.h>
 #include <player/devices/Device_thread_state.h>
 #include <player/devices/processors/Proc_state_utils.h>
 #include <player/Force_controls.h>
@@ -140,74 +141,27 @@ int32_t Force_vstate_render_voice(
     Force_controls_set_audio_rate(fc, dstate->audio_rate);
     Force_controls_set_tempo(fc, tempo);
 
-    int32_t const_start = 0;
-
     int32_t new_buf_stop = frame_count;
 
-    // Apply force slide & fixed adjust
-    {
-        const double fixed_adjust = fvstate->fixed_adjust;
-
-        int32_t cur_pos = 0;
-        while (cur_pos < frame_count)
-        {
-            const int32_t estimated_steps =
-                Slider_estimate_active_steps_left(&fc->slider);
-            if (estimated_steps > 0)
-            {
-                int32_t slide_stop = frame_count;
-                if (estimated_steps < frame_count - cur_pos)
-                    slide_stop = cur_pos + estimated_steps;
-
-                double new_force = fc->force;
-                for (int32_t i = cur_pos; i < slide_stop; ++i)
-                {
-                    new_force = Slider_step(&fc->slider);
-                    out_buf[i] = (float)(new_force + fixed_adjust);
-                }
-                fc->force = new_force;
+    const int32_t ctl_period = Device_state_get_control_period(dstate);
 
-                const_start = slide_stop;
-                cur_pos = slide_stop;
-            }
-            else
-            {
-                const float actual_force = (float)(fc->force + fixed_adjust);
-                for (int32_t i = cur_pos; i < frame_count; ++i)
-                    out_buf[i] = actual_force;
+    const double slide_step = Slider_get_step(&fc->slider);
+    const bool is_tremolo_active = (LFO_estimate_active_steps_left(&fc->tremolo) > 0);
 
-                cur_pos = frame_count;
-            }
-        }
-    }
+    // Apply force slide & fixed adjust
+    int32_t const_start = Slider_fill_values(
+            &fc->slider,
+            &fc->force,
+            fvstate->fixed_adjust,
+            out_buf,
+            0,
+            frame_count,
+            ctl_period);
 
     // Apply tremolo
     {
-        int32_t cur_pos = 0;
-        int32_t final_lfo_stop = 0;
-        while (cur_pos < frame_count)
-        {
-            const int32_t estimated_steps =
-                LFO_estimate_active_steps_left(&fc->tremolo);
-            if (estimated_steps > 0)
-            {
-                int32_t lfo_stop = frame_count;
-                if (estimated_steps < frame_count - cur_pos)
-                    lfo_stop = cur_pos + estimated_steps;
-
-                for (int32_t i = cur_pos; i < lfo_stop; ++i)
-                    out_buf[i] += (float)LFO_step(&fc->tremolo);
-
-                final_lfo_stop = lfo_stop;
-                cur_pos = lfo_stop;
-            }
-            else
-            {
-                final_lfo_stop = cur_pos;
-                break;
-            }
-        }
-
+        const int32_t final_lfo_stop =
+            LFO_mix_values(&fc->tremolo, out_buf, 0, frame_count, ctl_period);
         const_start = max(const_start, final_lfo_stop);
     }
 
@@ -365,8 +319,17 @@ int32_t Force_vstate_render_voice(
     Work_buffer_set_const_start(out_wb, const_start);
     Work_buffer_set_final(out_wb, keep_alive_stop < frame_count);
 
+    // Mark linear part of the slide, excluding the last frame snapped to target
+    const bool is_force_env_applied =
+        (force->is_force_env_enabled && (force->force_env != NULL));
+    if (vstate->note_on && !is_tremolo_active && !is_force_env_applied)
+        Work_buffer_set_ramp(out_wb, 0, max(0, const_start - 1), (float)slide_step);
+
     Voice_state_set_keep_alive_stop(vstate, keep_alive_stop);
 
+    // Provide a loudness estimate for voice allocation
+    vstate->force_estimate = out_buf[frame_count - 1];
+
     return frame_count;
 }
 
@@ -49,24 +49,29 @@ static void distort(
         {
             // Asymmetric distortion
             for (int32_t i = 0; i < frame_count; ++i)
-            {
-                const float clamped_in_value = clamp(in_values[i], -1.0f, 1.0f);
-                out_values[i] = (float)Envelope_get_value(gc->map, clamped_in_value);
-            }
+                out_values[i] = clamp(in_values[i], -1.0f, 1.0f);
+
+            Envelope_get_values(gc->map, out_values, out_values, frame_count);
         }
         else
         {
-            // Symmetric distortion
-            for (int32_t i = 0; i < frame_count; ++i)
+            // Symmetric distortion, in chunks as the input may be the output buffer
+            float abs_values[256];
+            const int32_t chunk_size_max = (int32_t)(sizeof(abs_values) / sizeof(float));
+
+            for (int32_t start = 0; start < frame_count; start += chunk_size_max)
             {
-                const float in_value = in_values[i];
-                const float abs_value = fabsf(in_value);
+                const int32_t chunk_size = min(frame_count - start, chunk_size_max);
+                const float* chunk_in = in_values + start;
+                float* chunk_out = out_values + start;
+
+                for (int32_t i = 0; i < chunk_size; ++i)
+                    abs_values[i] = min(fabsf(chunk_in[i]), 1.0f);
 
-                float out_value = (float)Envelope_get_value(gc->map, min(abs_value, 1));
-                if (in_value < 0)
-                    out_value = -out_value;
+                Envelope_get_values(gc->map, abs_values, abs_values, chunk_size);
 
-                out_values[i] = out_value;
+                for (int32_t i = 0; i < chunk_size; ++i)
+                    chunk_out[i] = (chunk_in[i] < 0) ? -abs_values[i] : abs_values[i];
             }
         }
     }
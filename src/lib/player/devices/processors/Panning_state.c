@@ -23,6 +23,7 @@
 #include <player/devices/processors/Proc_state_utils.h>
 #include <player/Work_buffers.h>
 
+#include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -65,11 +66,31 @@ static void apply_panning(
 
     if (pan_const_start > 0)
     {
+        const int32_t var_stop = min(pan_const_start, frame_count);
+
+        // Find a linear pan slide that does not need clamping
+        int32_t ramp_start = min(Work_buffer_get_ramp_start(pan_wb), var_stop);
+        int32_t ramp_stop = clamp(Work_buffer_get_ramp_stop(pan_wb), ramp_start, var_stop);
+        const float ramp_step = Work_buffer_get_ramp_step(pan_wb);
+        float ramp_first = 0;
+        if (ramp_start < ramp_stop)
+        {
+            ramp_first = Work_buffer_get_contents(pan_wb)[ramp_start];
+            const float ramp_last = ramp_first + (float)(ramp_stop - ramp_start - 1) * ramp_step;
+            if ((fabsf(ramp_first) > 1) || (fabsf(ramp_last) > 1))
+                ramp_start = ramp_stop = var_stop;
+        }
+
         float* pan = Work_buffer_get_contents_mut(pan_wb);
 
-        const int32_t var_stop = min(pan_const_start, frame_count);
+        for (int32_t i = 0; i < ramp_start; ++i)
+        {
+            float pan_value = pan[i];
+            pan_value = clamp(pan_value, -1, 1);
+            pan[i] = pan_value;
+        }
 
-        for (int32_t i = 0; i < var_stop; ++i)
+        for (int32_t i = ramp_stop; i < var_stop; ++i)
         {
             float pan_value = pan[i];
             pan_value = clamp(pan_value, -1, 1);
@@ -86,8 +107,18 @@ static void apply_panning(
             const float* in = Work_buffer_get_contents(in_wbs[ch]);
             float* out = Work_buffer_get_contents_mut(out_wbs[ch]);
 
-            for (int32_t i = 0; i < var_stop; ++i)
-                *out++ = *in++ * (1 + (pan_mult[ch] * pan[i]));
+            for (int32_t i = 0; i < ramp_start; ++i)
+                out[i] = in[i] * (1 + (pan_mult[ch] * pan[i]));
+
+            // Apply the slide without reading the pan values
+            for (int32_t i = ramp_start; i < ramp_stop; ++i)
+            {
+                const float pan_value = ramp_first + (float)(i - ramp_start) * ramp_step;
+                out[i] = in[i] * (1 + (pan_mult[ch] * pan_value));
+            }
+
+            for (int32_t i = ramp_stop; i < var_stop; ++i)
+                out[i] = in[i] * (1 + (pan_mult[ch] * pan[i]));
         }
     }
 
@@ -26,6 +26,8 @@
 #include <player/devices/Voice_state.h>
 #include <player/Work_buffers.h>
 
+#include <math.h>
+#include <stdbool.h>
 #include <stdlib.h>
 
 
@@ -106,6 +108,25 @@ void Proc_ramp_attack(
 }
 
 
+static void fill_geometric(
+        float* values, int32_t start, int32_t stop, double first, double ratio)
+{
+    rassert(values != NULL);
+    rassert(start <= stop);
+    rassert(isfinite(first));
+    rassert(isfinite(ratio));
+
+    double value = first;
+    for (int32_t i = start; i < stop; ++i)
+    {
+        values[i] = (float)value;
+        value *= ratio;
+    }
+
+    return;
+}
+
+
 void Proc_fill_freq_buffer(
         Work_buffer* freqs,
         Work_buffer* pitches,
@@ -123,12 +144,30 @@ void Proc_fill_freq_buffer(
         const int32_t const_start = Work_buffer_get_const_start(pitches);
         float* freqs_data = Work_buffer_get_contents_mut(freqs);
 
-        float* pitches_data = Work_buffer_get_contents_mut(pitches);
+        const float* pitches_data = Work_buffer_get_contents(pitches);
 
         const int32_t fast_stop = clamp(const_start, buf_start, buf_stop);
 
-        for (int32_t i = buf_start; i < fast_stop; ++i)
-            freqs_data[i] = (float)fast_cents_to_Hz(pitches_data[i]);
+        // Exponentiate linear pitch slides incrementally
+        Work_buffer_segment seg;
+        for (int32_t i = buf_start; i < fast_stop; i = seg.stop)
+        {
+            Work_buffer_get_segment(pitches, i, fast_stop, &seg);
+            if (seg.type == WORK_BUFFER_SEGMENT_RAMP)
+            {
+                fill_geometric(
+                        freqs_data,
+                        seg.start,
+                        seg.stop,
+                        cents_to_Hz(seg.value),
+                        exp2(seg.step / 1200.0));
+            }
+            else
+            {
+                for (int32_t k = seg.start; k < seg.stop; ++k)
+                    freqs_data[k] = (float)fast_cents_to_Hz(pitches_data[k]);
+            }
+        }
 
         //fprintf(stdout, "%d %d %d\n", (int)buf_start, (int)fast_stop, (int)buf_stop);
 
@@ -156,6 +195,46 @@ void Proc_fill_freq_buffer(
 }
 
 
+static void fill_scales(
+        float* scales_data, float* dBs_data, int32_t start, int32_t stop)
+{
+    rassert(scales_data != NULL);
+    rassert(dBs_data != NULL);
+    rassert(start >= 0);
+
+    if (start >= stop)
+        return;
+
+#if KQT_SSE4_1
+    {
+        const __m128 min_dB = _mm_set1_ps(-500);
+        const __m128 max_dB = _mm_set1_ps(500);
+
+        for (int32_t i = start - (start % 4); i < stop; i += 4)
+        {
+            const __m128 dB = _mm_load_ps(dBs_data + i);
+            const __m128 clamped_dB = _mm_min_ps(_mm_max_ps(min_dB, dB), max_dB);
+            const __m128 scale = fast_dB_to_scale_f4(clamped_dB);
+            _mm_store_ps(scales_data + i, scale);
+        }
+    }
+#else
+    // Sanitise input values
+    {
+        const float bound = 10000.0f;
+
+        for (int32_t i = start; i < stop; ++i)
+            dBs_data[i] = clamp(dBs_data[i], -bound, bound);
+    }
+
+    for (int32_t i = start; i < stop; ++i)
+        scales_data[i] = (float)fast_dB_to_scale(dBs_data[i]);
+#endif
+
+    return;
+}
+
+
 void Proc_fill_scale_buffer(Work_buffer* scales, Work_buffer* dBs, int32_t frame_count)
 {
     rassert(scales != NULL);
@@ -164,45 +243,41 @@ void Proc_fill_scale_buffer(Work_buffer* scales, Work_buffer* dBs, int32_t frame
     if (Work_buffer_is_valid(dBs))
     {
         const int32_t const_start = Work_buffer_get_const_start(dBs);
-        float* scales_data = Work_buffer_get_contents_mut(scales);
-
-        float* dBs_data = Work_buffer_get_contents_mut(dBs);
-
         const int32_t fast_stop = min(const_start, frame_count);
 
-        float const_dB = -INFINITY;
-
-#if KQT_SSE4_1
+        // Find a linear dB slide that does not need sanitising
+        int32_t ramp_start = min(Work_buffer_get_ramp_start(dBs), fast_stop);
+        int32_t ramp_stop = clamp(Work_buffer_get_ramp_stop(dBs), ramp_start, fast_stop);
+        const double ramp_step = Work_buffer_get_ramp_step(dBs);
+        if (ramp_start < ramp_stop)
         {
-            if (fast_stop < frame_count)
-                const_dB = clamp(dBs_data[fast_stop], -10000.0f, 10000.0f);
-
-            const __m128 min_dB = _mm_set1_ps(-500);
-            const __m128 max_dB = _mm_set1_ps(500);
-
-            for (int32_t i = 0; i < fast_stop; i += 4)
-            {
-                const __m128 dB = _mm_load_ps(dBs_data + i);
-                const __m128 clamped_dB = _mm_min_ps(_mm_max_ps(min_dB, dB), max_dB);
-                const __m128 scale = fast_dB_to_scale_f4(clamped_dB);
-                _mm_store_ps(scales_data + i, scale);
-            }
+            const float* dBs_data = Work_buffer_get_contents(dBs);
+            const double first = dBs_data[ramp_start];
+            const double last = first + ramp_step * (ramp_stop - ramp_start - 1);
+            if ((fabs(first) > 500) || (fabs(last) > 500))
+                ramp_start = ramp_stop = fast_stop;
         }
-#else
-        // Sanitise input values
-        {
-            const float bound = 10000.0f;
 
-            for (int32_t i = 0; i < fast_stop; ++i)
-                dBs_data[i] = clamp(dBs_data[i], -bound, bound);
+        float* scales_data = Work_buffer_get_contents_mut(scales);
+        float* dBs_data = Work_buffer_get_contents_mut(dBs);
+
+        fill_scales(scales_data, dBs_data, 0, ramp_start);
+        fill_scales(scales_data, dBs_data, ramp_stop, fast_stop);
 
-            if (fast_stop < frame_count)
-                const_dB = clamp(dBs_data[fast_stop], -bound, bound);
+        if (ramp_start < ramp_stop)
+        {
+            // Exponentiate the linear slide incrementally
+            fill_geometric(
+                    scales_data,
+                    ramp_start,
+                    ramp_stop,
+                    dB_to_scale(dBs_data[ramp_start]),
+                    dB_to_scale(ramp_step));
         }
 
-        for (int32_t i = 0; i < fast_stop; ++i)
-            scales_data[i] = (float)fast_dB_to_scale(dBs_data[i]);
-#endif
+        float const_dB = -INFINITY;
+        if (fast_stop < frame_count)
+            const_dB = clamp(dBs_data[fast_stop], -10000.0f, 10000.0f);
 
         //fprintf(stdout, "%d %d %d\n", 0, (int)fast_stop, (int)frame_count);
 
@@ -241,6 +316,19 @@ void Proc_clamp_pitch_values(Work_buffer* pitches, int32_t buf_start, int32_t bu
 
     const float bound = 2000000.0f;
 
+    // Linear slides inside the bounds are not affected by clamping
+    const int32_t ramp_start = Work_buffer_get_ramp_start(pitches);
+    const int32_t ramp_stop = min(Work_buffer_get_ramp_stop(pitches), const_start);
+    const float ramp_step = Work_buffer_get_ramp_step(pitches);
+    bool keep_ramp = false;
+    if (ramp_start < ramp_stop)
+    {
+        const float* ramp_data = Work_buffer_get_contents(pitches);
+        const float first = ramp_data[ramp_start];
+        const float last = ramp_data[ramp_stop - 1];
+        keep_ramp = (fabsf(first) <= bound) && (fabsf(last) <= bound);
+    }
+
     float* pitches_data = Work_buffer_get_contents_mut(pitches);
 
     for (int32_t i = buf_start; i < fast_stop; ++i)
@@ -254,6 +342,8 @@ void Proc_clamp_pitch_values(Work_buffer* pitches, int32_t buf_start, int32_t bu
     }
 
     Work_buffer_set_const_start(pitches, const_start);
+    if (keep_ramp)
+        Work_buffer_set_ramp(pitches, ramp_start, ramp_stop, ramp_step);
 
     return;
 }
@@ -201,16 +201,31 @@ static void apply_envelope_range(
     const float* in = Work_buffer_get_contents(in_wb);
     float* out = Work_buffer_get_contents_mut(out_wb);
 
-    for (int32_t i = 0; i < frame_count; ++i)
+    // Map the values inside the envelope range in chunks of consecutive values
+    int32_t i = 0;
+    while (i < frame_count)
     {
         const float in_val = in[i];
 
         if (in_val < env_min)
+        {
             out[i] = (mul * in_val) + add;
+            ++i;
+        }
         else if (in_val > env_max)
+        {
             out[i] = (mul2 * in_val) + add2;
+            ++i;
+        }
         else
-            out[i] = (float)Envelope_get_value(envelope, in_val);
+        {
+            int32_t stop = i + 1;
+            while ((stop < frame_count) && (in[stop] >= env_min) && (in[stop] <= env_max))
+                ++stop;
+
+            Envelope_get_values(envelope, in + i, out + i, stop - i);
+            i = stop;
+        }
     }
 
     return;
@@ -22,6 +22,7 @@
 #include <mathnum/conversions.h>
 #include <player/devices/Device_thread_state.h>
 #include <player/devices/processors/Proc_state_utils.h>
+#include <player/devices/processors/Sample_stream_render.h>
 #include <player/Work_buffers.h>
 #include <string/common.h>
 #include <string/Streader.h>
@@ -40,6 +41,8 @@ typedef struct Sample_vstate
     double freq;
     double volume;
     double middle_tone;
+    int stream;
+    int stream_gen;
 } Sample_vstate;
 
 
@@ -71,6 +74,66 @@ static const int SAMPLE_WB_FIXED_PITCH = WORK_BUFFER_IMPL_4;
 static const int SAMPLE_WB_FIXED_FORCE = WORK_BUFFER_IMPL_5;
 
 
+static void Sample_vstate_close_stream(Sample_vstate* sample_state, const Sample* sample)
+{
+    rassert(sample_state != NULL);
+    rassert(sample != NULL);
+
+    Sample_close_stream(sample, &sample_state->stream, sample_state->stream_gen);
+
+    return;
+}
+
+
+
+static void Sample_finish_render(
+        const Sample* sample,
+        Voice_state* vstate,
+        float* abufs[KQT_BUFFERS_MAX],
+        Work_buffer* out_wbs[2],
+        int32_t new_buf_stop,
+        int32_t frame_count,
+        int32_t new_pos,
+        double new_pos_rem)
+{
+    rassert(sample != NULL);
+    rassert(vstate != NULL);
+    rassert(abufs != NULL);
+    rassert(out_wbs != NULL);
+
+    // Copy mono signal to the right channel
+    if ((sample->channels == 1) && (abufs[0] != NULL) && (abufs[1] != NULL))
+    {
+        const int32_t new_frame_count = new_buf_stop;
+        rassert(new_frame_count >= 0);
+        memcpy(abufs[1],
+                abufs[0],
+                sizeof(float) * (size_t)new_frame_count);
+    }
+
+    // Update position information
+    vstate->pos = new_pos;
+    vstate->pos_rem = new_pos_rem;
+
+    // Clear output buffers after sample end, FIXME: We should be able to get rid of this
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        Work_buffer* out_wb = out_wbs[ch];
+        if (out_wb == NULL)
+            continue;
+
+        float* out_buf = Work_buffer_get_contents_mut(out_wb);
+
+        //fprintf(stderr, "Clearing ch %d, [%d,%d)\n", ch, (int)new_buf_stop, (int)frame_count);
+
+        for (int32_t i = new_buf_stop; i < frame_count; ++i)
+            out_buf[i] = 0;
+    }
+
+    return;
+}
+
+
 static int32_t Sample_render(
         const Sample* sample,
         const Sample_params* params,
@@ -133,6 +196,7 @@ static int32_t Sample_render(
             (Work_buffer_get_contents(dBs_wb)[0] == -INFINITY))
     {
         // We are only getting silent force from this point onwards
+        Sample_vstate_close_stream((Sample_vstate*)vstate, sample);
         vstate->active = false;
         return 0;
     }
@@ -190,8 +254,38 @@ static int32_t Sample_render(
     if ((params->loop_end > sample->len) || (params->loop_start >= params->loop_end))
         loop_mode = SAMPLE_LOOP_OFF;
 
-    // Apply loop and length constraints to sample positions
     int32_t new_buf_stop = frame_count;
+
+    if ((sample->streamer != NULL) &&
+            (((loop_mode == SAMPLE_LOOP_OFF) ? sample->len : params->loop_end) >
+                sample->resident_len))
+    {
+        // Part of the playable area is not resident
+        new_buf_stop = Sample_render_streamed(
+                sample,
+                params,
+                loop_mode,
+                &((Sample_vstate*)vstate)->stream,
+                &((Sample_vstate*)vstate)->stream_gen,
+                positions,
+                positions_rem,
+                force_scales,
+                abufs,
+                frame_count,
+                vol_scale);
+        if (new_buf_stop == 0)
+        {
+            vstate->active = false;
+            return 0;
+        }
+
+        Sample_finish_render(
+                sample, vstate, abufs, out_wbs, new_buf_stop, frame_count, new_pos, new_pos_rem);
+
+        return new_buf_stop;
+    }
+
+    // Apply loop and length constraints to sample positions
     switch (loop_mode)
     {
         case SAMPLE_LOOP_OFF:
@@ -419,34 +513,8 @@ static int32_t Sample_render(
 
 #undef get_item
 
-    // Copy mono signal to the right channel
-    if ((sample->channels == 1) && (abufs[0] != NULL) && (abufs[1] != NULL))
-    {
-        const int32_t new_frame_count = new_buf_stop;
-        rassert(new_frame_count >= 0);
-        memcpy(abufs[1],
-                abufs[0],
-                sizeof(float) * (size_t)new_frame_count);
-    }
-
-    // Update position information
-    vstate->pos = new_pos;
-    vstate->pos_rem = new_pos_rem;
-
-    // Clear output buffers after sample end, FIXME: We should be able to get rid of this
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        Work_buffer* out_wb = out_wbs[ch];
-        if (out_wb == NULL)
-            continue;
-
-        float* out_buf = Work_buffer_get_contents_mut(out_wb);
-
-        //fprintf(stderr, "Clearing ch %d, [%d,%d)\n", ch, (int)new_buf_stop, (int)frame_count);
-
-        for (int32_t i = new_buf_stop; i < frame_count; ++i)
-            out_buf[i] = 0;
-    }
+    Sample_finish_render(
+            sample, vstate, abufs, out_wbs, new_buf_stop, frame_count, new_pos, new_pos_rem);
 
     return new_buf_stop;
 }
@@ -685,6 +753,8 @@ void Sample_vstate_init(Voice_state* vstate, const Proc_state* proc_state)
     sample_state->freq = 0;
     sample_state->volume = 0;
     sample_state->middle_tone = 0;
+    sample_state->stream = -1;
+    sample_state->stream_gen = 0;
 
     return;
 }
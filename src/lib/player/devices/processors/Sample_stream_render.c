@@ -0,0 +1,206 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/devices/processors/Sample_stream_render.h>
+
+#include <debug/assert.h>
+#include <init/Sample_streamer.h>
+#include <mathnum/common.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+void Sample_close_stream(const Sample* sample, int* stream, int stream_gen)
+{
+    rassert(sample != NULL);
+    rassert(stream != NULL);
+
+    if ((*stream >= 0) && (sample->streamer != NULL))
+        Sample_streamer_close_stream(sample->streamer, *stream, stream_gen);
+
+    *stream = -1;
+
+    return;
+}
+
+
+static float get_resident_frame(const Sample* sample, int ch, int64_t pos)
+{
+    rassert(sample != NULL);
+    rassert(ch >= 0);
+    rassert(ch < sample->channels);
+    rassert(pos >= 0);
+    rassert(pos < sample->resident_len);
+
+    if (sample->is_float)
+        return ((const float*)sample->data[ch])[pos];
+
+    switch (sample->bits)
+    {
+        case 8:
+            return (float)(((const int8_t*)sample->data[ch])[pos] * (1.0 / 0x80));
+
+        case 16:
+            return (float)(((const int16_t*)sample->data[ch])[pos] * (1.0 / 0x8000UL));
+
+        case 32:
+            return (float)(((const int32_t*)sample->data[ch])[pos] * (1.0 / 0x80000000UL));
+
+        default:
+            rassert(false);
+    }
+
+    return 0;
+}
+
+
+static float get_stream_frame(
+        const Sample* sample,
+        int ch,
+        const Sample_stream_view* view,
+        int64_t direct_len,
+        int64_t pos)
+{
+    if (pos < direct_len)
+        return get_resident_frame(sample, ch, pos);
+
+    if ((view->start <= pos) && (pos < view->stop))
+        return view->ring[ch][pos & (SAMPLE_STREAMER_RING_LEN - 1)];
+
+    return 0;
+}
+
+
+int32_t Sample_render_streamed(
+        const Sample* sample,
+        const Sample_params* params,
+        Sample_loop loop_mode,
+        int* stream,
+        int* stream_gen,
+        const int32_t* positions,
+        const float* positions_rem,
+        const float* force_scales,
+        float* abufs[KQT_BUFFERS_MAX],
+        int32_t frame_count,
+        double vol_scale)
+{
+    rassert(sample != NULL);
+    rassert(sample->streamer != NULL);
+    rassert(params != NULL);
+    rassert(stream != NULL);
+    rassert(stream_gen != NULL);
+    rassert(positions != NULL);
+    rassert(positions_rem != NULL);
+    rassert(force_scales != NULL);
+    rassert(abufs != NULL);
+    rassert(frame_count > 0);
+
+    Sample_streamer* streamer = sample->streamer;
+
+    // Find the sample end
+    int32_t new_buf_stop = frame_count;
+    if (loop_mode == SAMPLE_LOOP_OFF)
+    {
+        const int32_t length = (int32_t)sample->len;
+
+        if (positions[0] >= length)
+        {
+            Sample_close_stream(sample, stream, *stream_gen);
+            return 0;
+        }
+
+        for (int32_t i = 0; i < frame_count; ++i)
+        {
+            if (positions[i] >= length)
+            {
+                new_buf_stop = i;
+                break;
+            }
+        }
+    }
+
+    // Frames before this position are read directly from the resident part
+    int64_t direct_len = sample->resident_len;
+    if (loop_mode == SAMPLE_LOOP_UNI)
+        direct_len = min(direct_len, params->loop_end);
+    else if (loop_mode == SAMPLE_LOOP_BI)
+        direct_len = min(direct_len, params->loop_end - 1);
+
+    // Get the frames read by the Sample streamer
+    Sample_stream_view view = { .start = 0, .stop = 0, .ring = { NULL, NULL } };
+    if ((*stream < 0) || !Sample_streamer_get_view(streamer, *stream, *stream_gen, &view))
+    {
+        *stream = Sample_streamer_open_stream(
+                streamer,
+                sample,
+                loop_mode,
+                params->loop_start,
+                params->loop_end,
+                max(direct_len, (int64_t)positions[0]),
+                stream_gen);
+        if (*stream >= 0)
+            Sample_streamer_get_view(streamer, *stream, *stream_gen, &view);
+    }
+
+    {
+        int64_t missing_count = 0;
+        for (int32_t i = 0; i < new_buf_stop; ++i)
+        {
+            const int64_t pos = positions[i];
+            if ((pos >= direct_len) && ((pos < view.start) || (pos >= view.stop)))
+                ++missing_count;
+        }
+        Sample_streamer_add_underruns(streamer, missing_count);
+    }
+
+    const int64_t last_pos = sample->len - 1;
+
+    for (int ch = 0; ch < sample->channels; ++ch)
+    {
+        float* audio_buffer = abufs[ch];
+        if (audio_buffer == NULL)
+            continue;
+
+        for (int32_t i = 0; i < new_buf_stop; ++i)
+        {
+            const int64_t cur_pos = positions[i];
+            int64_t next_pos = cur_pos + 1;
+            if (loop_mode == SAMPLE_LOOP_OFF)
+                next_pos = min(next_pos, last_pos);
+
+            const float cur_value =
+                get_stream_frame(sample, ch, &view, direct_len, cur_pos);
+            const float next_value =
+                get_stream_frame(sample, ch, &view, direct_len, next_pos);
+            const float item = cur_value + (positions_rem[i] * (next_value - cur_value));
+
+            audio_buffer[i] = (float)(item * vol_scale * force_scales[i]);
+        }
+    }
+
+    if (new_buf_stop < frame_count)
+    {
+        Sample_close_stream(sample, stream, *stream_gen);
+    }
+    else if (*stream >= 0)
+    {
+        Sample_streamer_advance(streamer, *stream, *stream_gen, positions[new_buf_stop]);
+    }
+
+    return new_buf_stop;
+}
+
+
@@ -0,0 +1,84 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_SAMPLE_STREAM_RENDER_H
+#define KQT_SAMPLE_STREAM_RENDER_H
+
+
+#include <init/devices/param_types/Sample.h>
+#include <init/devices/param_types/Sample_params.h>
+#include <kunquat/limits.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * Close the stream opened by a voice.
+ *
+ * \param sample       The Sample -- must not be \c NULL.
+ * \param stream       The stream index of the voice, or \c -1 if the voice
+ *                     has no stream -- must not be \c NULL. This will be set
+ *                     to \c -1.
+ * \param stream_gen   The generation of the stream.
+ */
+void Sample_close_stream(const Sample* sample, int* stream, int stream_gen);
+
+
+/**
+ * Render a Sample whose playable area is partially stored in a Sample streamer.
+ *
+ * The frames in the resident part are read directly from the Sample, and
+ * the rest are read from the stream of the voice, which is opened if needed.
+ * Frames that the Sample streamer has not read yet are rendered as silence
+ * and counted as underruns.
+ *
+ * \param sample          The Sample -- must not be \c NULL and must be
+ *                        attached to a Sample streamer.
+ * \param params          The Sample parameters -- must not be \c NULL.
+ * \param loop_mode       The validated loop mode.
+ * \param stream          The stream index of the voice, or \c -1 if the voice
+ *                        has no stream -- must not be \c NULL.
+ * \param stream_gen      The generation of the stream -- must not be \c NULL.
+ * \param positions       The sample positions in playback order -- must not
+ *                        be \c NULL and must contain \a frame_count + 1 items.
+ * \param positions_rem   The fractional parts of the positions -- must not
+ *                        be \c NULL.
+ * \param force_scales    The force scales -- must not be \c NULL.
+ * \param abufs           The output buffers -- must not be \c NULL. Buffers
+ *                        set to \c NULL are skipped.
+ * \param frame_count     The number of frames to be rendered -- must be
+ *                        > \c 0.
+ * \param vol_scale       The volume scale.
+ *
+ * \return   The number of frames rendered before the end of the Sample, or
+ *           \c 0 if the playback position is already past the end.
+ */
+int32_t Sample_render_streamed(
+        const Sample* sample,
+        const Sample_params* params,
+        Sample_loop loop_mode,
+        int* stream,
+        int* stream_gen,
+        const int32_t* positions,
+        const float* positions_rem,
+        const float* force_scales,
+        float* abufs[KQT_BUFFERS_MAX],
+        int32_t frame_count,
+        double vol_scale);
+
+
+#endif // KQT_SAMPLE_STREAM_RENDER_H
+
+
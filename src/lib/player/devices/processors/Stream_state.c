@@ -18,6 +18,7 @@
 #include <init/devices/Device.h>
 #include <init/devices/processors/Proc_stream.h>
 #include <memory.h>
+#include <player/devices/Device_state.h>
 #include <player/devices/Device_thread_state.h>
 #include <player/devices/Proc_state.h>
 #include <player/devices/Voice_state.h>
@@ -26,6 +27,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 enum
@@ -37,14 +39,18 @@ enum
 
 static void apply_controls(
         Linear_controls* controls,
+        const Device_state* dstate,
         Work_buffer* out_wb,
         int32_t frame_count,
         double tempo)
 {
     rassert(controls != NULL);
+    rassert(dstate != NULL);
     rassert(frame_count > 0);
 
     Linear_controls_set_tempo(controls, tempo);
+    Linear_controls_set_control_period(
+            controls, Device_state_get_control_period(dstate));
 
     if (out_wb != NULL)
         Linear_controls_fill_work_buffer(controls, out_wb, 0, frame_count);
@@ -63,6 +69,9 @@ typedef struct Stream_pstate
     double init_osc_speed;
     double init_osc_depth;
     Linear_controls controls;
+
+    const float* automation;
+    int32_t automation_const_start;
 } Stream_pstate;
 
 
@@ -118,7 +127,24 @@ static void Stream_pstate_render_mixed(
     Work_buffer* out_wb = Device_thread_state_get_mixed_buffer(
             proc_ts, DEVICE_PORT_TYPE_SEND, PORT_OUT_STREAM);
 
-    apply_controls(&spstate->controls, out_wb, frame_count, tempo);
+    if (spstate->automation != NULL)
+    {
+        if (out_wb != NULL)
+        {
+            float* out = Work_buffer_get_contents_mut(out_wb);
+            memcpy(out, spstate->automation, sizeof(float) * (size_t)frame_count);
+            if (spstate->automation_const_start < frame_count)
+                Work_buffer_set_const_start(out_wb, spstate->automation_const_start);
+        }
+
+        // Continue from the last external value after automation ends
+        Linear_controls_set_value(
+                &spstate->controls, spstate->automation[frame_count - 1]);
+
+        return;
+    }
+
+    apply_controls(&spstate->controls, dstate, out_wb, frame_count, tempo);
 
     return;
 }
@@ -149,6 +175,9 @@ Device_state* new_Stream_pstate(
     spstate->init_osc_speed = 0;
     spstate->init_osc_depth = 0;
 
+    spstate->automation = NULL;
+    spstate->automation_const_start = 0;
+
     Linear_controls_init(&spstate->controls);
     Linear_controls_set_audio_rate(&spstate->controls, audio_rate);
     Linear_controls_set_tempo(&spstate->controls, 120);
@@ -303,6 +332,31 @@ void Stream_pstate_set_osc_depth_slide(Device_state* dstate, const Tstamp* lengt
 }
 
 
+void Stream_pstate_set_automation(
+        Device_state* dstate, const float* values, int32_t const_start)
+{
+    rassert(dstate != NULL);
+    rassert(const_start >= 0);
+
+    Stream_pstate* spstate = (Stream_pstate*)dstate;
+
+    spstate->automation = values;
+    spstate->automation_const_start = const_start;
+
+    return;
+}
+
+
+double Stream_pstate_get_value(const Device_state* dstate)
+{
+    rassert(dstate != NULL);
+
+    const Stream_pstate* spstate = (const Stream_pstate*)dstate;
+
+    return Linear_controls_get_value(&spstate->controls);
+}
+
+
 typedef struct Stream_vstate
 {
     Voice_state parent;
@@ -345,7 +399,8 @@ int32_t Stream_vstate_render_voice(
         return 0;
     }
 
-    apply_controls(&svstate->controls, out_wb, frame_count, tempo);
+    apply_controls(
+            &svstate->controls, &proc_state->parent, out_wb, frame_count, tempo);
 
     return frame_count;
 }
@@ -36,6 +36,10 @@ void Stream_pstate_set_osc_depth(Device_state* dstate, double depth);
 void Stream_pstate_set_osc_speed_slide(Device_state* dstate, const Tstamp* length);
 void Stream_pstate_set_osc_depth_slide(Device_state* dstate, const Tstamp* length);
 
+void Stream_pstate_set_automation(
+        Device_state* dstate, const float* values, int32_t const_start);
+double Stream_pstate_get_value(const Device_state* dstate);
+
 
 Voice_state_get_size_func Stream_vstate_get_size;
 Voice_state_init_func Stream_vstate_init;
@@ -16,16 +16,107 @@
 
 #include <debug/assert.h>
 #include <kunquat/limits.h>
+#include <mathnum/common.h>
 
 #include <ctype.h>
 #include <inttypes.h>
 #include <limits.h>
 #include <math.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
 
+/*
+ * Character classification used by the hot paths of the reader.
+ *
+ * These match the C locale versions of the standard functions but do not
+ * depend on the current locale and are cheap enough to be inlined.
+ */
+
+static inline bool is_space_char(char ch)
+{
+    return (ch == ' ') || ((ch >= '\t') && (ch <= '\r'));
+}
+
+
+static inline bool is_digit_char(char ch)
+{
+    return (unsigned char)(ch - '0') < 10;
+}
+
+
+static inline bool is_alpha_char(char ch)
+{
+    return (unsigned char)((ch | 0x20) - 'a') < 26;
+}
+
+
+static inline bool is_alnum_char(char ch)
+{
+    return is_digit_char(ch) || is_alpha_char(ch);
+}
+
+
+static inline bool is_string_special_char(char ch)
+{
+    return (ch == '\"') || (ch == '\\') || ((unsigned char)ch < 0x20) || (ch == 0x7f);
+}
+
+
+/**
+ * Get the length of the initial part of string data that can be copied as is.
+ *
+ * The data is scanned a word at a time for double quotes, backslashes and
+ * control characters.
+ *
+ * \param str   The string data -- must not be \c NULL.
+ * \param len   The length of \a str -- must be >= \c 0.
+ *
+ * \return   The number of characters before the first special character, or
+ *           \a len if there are no special characters.
+ */
+static int64_t get_plain_string_length(const char* str, int64_t len)
+{
+    rassert(str != NULL);
+    rassert(len >= 0);
+
+#define BYTES(b) (UINT64_C(0x0101010101010101) * (b))
+
+    int64_t pos = 0;
+
+    while (len - pos >= (int64_t)sizeof(uint64_t))
+    {
+        uint64_t word = 0;
+        memcpy(&word, str + pos, sizeof(word));
+
+        const uint64_t quotes = word ^ BYTES('"');
+        const uint64_t backslashes = word ^ BYTES('\\');
+        const uint64_t deletes = word ^ BYTES(0x7f);
+
+        // Each term has its high bit set in a byte that is zero or below 0x20
+        const uint64_t found =
+            ((quotes - BYTES(0x01)) & ~quotes) |
+            ((backslashes - BYTES(0x01)) & ~backslashes) |
+            ((deletes - BYTES(0x01)) & ~deletes) |
+            ((word - BYTES(0x20)) & ~word);
+
+        if ((found & BYTES(0x80)) != 0)
+            break;
+
+        pos += (int64_t)sizeof(uint64_t);
+    }
+
+#undef BYTES
+
+    while ((pos < len) && !is_string_special_char(str[pos]))
+        ++pos;
+
+    return pos;
+}
+
+
 Streader* Streader_init(Streader* sr, const char* str, int64_t len)
 {
     rassert(sr != NULL);
@@ -36,7 +127,11 @@ Streader* Streader_init(Streader* sr, const char* str, int64_t len)
     sr->len = len;
     sr->line = 1;
     sr->str = str;
-    sr->error = *ERROR_AUTO;
+
+    // Only the terminating bytes are needed to mark the error as unset
+    sr->error.desc[0] = '\0';
+    sr->error.message[0] = '\0';
+    sr->error.type = ERROR_COUNT_;
 
     return sr;
 }
@@ -96,7 +191,11 @@ void Streader_set_memory_error(Streader* sr, const char* format, ...)
 void Streader_clear_error(Streader* sr)
 {
     rassert(sr != NULL);
-    Error_clear(&sr->error);
+
+    // Error descriptions are always written into a fully cleared Error,
+    // so clearing just the terminating bytes is enough here
+    sr->error.desc[0] = '\0';
+    sr->error.message[0] = '\0';
     return;
 }
 
@@ -144,14 +243,18 @@ bool Streader_skip_whitespace(Streader* sr)
     if (Streader_is_error_set(sr))
         return false;
 
-    while (!Streader_end_reached(sr) && isspace(CUR_CH))
+    const char* str = sr->str;
+    int64_t pos = sr->pos;
+    while ((pos < sr->len) && is_space_char(str[pos]))
     {
-        if (CUR_CH == '\n')
+        if (str[pos] == '\n')
             ++sr->line;
 
-        ++sr->pos;
+        ++pos;
     }
 
+    sr->pos = pos;
+
     rassert(sr->pos <= sr->len);
 
     return true;
@@ -254,7 +357,7 @@ static bool Streader_match_char_seq(Streader* sr, const char* seq)
         ++sr->pos;
     }
 
-    if (!Streader_end_reached(sr) && isalnum(CUR_CH))
+    if (!Streader_end_reached(sr) && is_alnum_char(CUR_CH))
     {
         Streader_set_error(
                 sr, "Unexpected character after expected string `%s`", seq);
@@ -409,7 +512,7 @@ bool Streader_read_int(Streader* sr, int64_t* dest)
     if (CUR_CH == '0')
     {
         ++sr->pos;
-        if (!Streader_end_reached(sr) && isalnum(CUR_CH))
+        if (!Streader_end_reached(sr) && is_alnum_char(CUR_CH))
         {
             Streader_set_error(sr, "Unexpected characters after initial zero");
             return false;
@@ -421,7 +524,7 @@ bool Streader_read_int(Streader* sr, int64_t* dest)
         {
             static const int64_t safe_lower = INT64_MIN / 10;
 
-            while (!Streader_end_reached(sr) && isdigit(CUR_CH))
+            while (!Streader_end_reached(sr) && is_digit_char(CUR_CH))
             {
                 // Check for multiplication overflow
                 if (result < safe_lower)
@@ -448,7 +551,7 @@ bool Streader_read_int(Streader* sr, int64_t* dest)
         {
             static const int64_t safe_upper = INT64_MAX / 10;
 
-            while (!Streader_end_reached(sr) && isdigit(CUR_CH))
+            while (!Streader_end_reached(sr) && is_digit_char(CUR_CH))
             {
                 // Check for multiplication overflow
                 if (result > safe_upper)
@@ -486,6 +589,14 @@ bool Streader_read_int(Streader* sr, int64_t* dest)
 
 
 #define SIGNIFICANT_MAX 17
+#define EXACT_SIGNIFICAND_MAX (INT64_C(1) << 53)
+#define EXACT_SHIFT_MAX 22
+
+static const double exact_powers_of_ten[EXACT_SHIFT_MAX + 1] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
 
 bool Streader_read_float(Streader* sr, double* dest)
 {
@@ -502,6 +613,7 @@ bool Streader_read_float(Streader* sr, double* dest)
     int64_t significand = 0;
     int significand_shift = 0;
     int significant_digits_read = 0;
+    bool digits_dropped = false;
 
     int exponent = 0;
     bool exponent_is_negative = false;
@@ -523,7 +635,7 @@ bool Streader_read_float(Streader* sr, double* dest)
     }
     else if (strchr(NONZERO_DIGITS, CUR_CH) != NULL)
     {
-        while (!Streader_end_reached(sr) && isdigit(CUR_CH))
+        while (!Streader_end_reached(sr) && is_digit_char(CUR_CH))
         {
             if (significant_digits_read < SIGNIFICANT_MAX)
             {
@@ -537,6 +649,7 @@ bool Streader_read_float(Streader* sr, double* dest)
             {
                 // We have run out of accuracy, just update magnitude
                 ++significand_shift;
+                digits_dropped = digits_dropped || (CUR_CH != '0');
             }
 
             ++sr->pos;
@@ -553,7 +666,7 @@ bool Streader_read_float(Streader* sr, double* dest)
     {
         ++sr->pos;
 
-        while (!Streader_end_reached(sr) && isdigit(CUR_CH))
+        while (!Streader_end_reached(sr) && is_digit_char(CUR_CH))
         {
             if (significant_digits_read < SIGNIFICANT_MAX)
             {
@@ -566,6 +679,10 @@ bool Streader_read_float(Streader* sr, double* dest)
                 if (significand != 0)
                     ++significant_digits_read;
             }
+            else
+            {
+                digits_dropped = digits_dropped || (CUR_CH != '0');
+            }
 
             ++sr->pos;
         }
@@ -601,7 +718,7 @@ bool Streader_read_float(Streader* sr, double* dest)
             ++sr->pos;
         }
 
-        while (!Streader_end_reached(sr) && isdigit(CUR_CH))
+        while (!Streader_end_reached(sr) && is_digit_char(CUR_CH))
         {
             rassert(exponent < INT_MAX / 10);
             exponent *= 10;
@@ -611,14 +728,14 @@ bool Streader_read_float(Streader* sr, double* dest)
         }
 
         // Require at least one digit
-        if (!isdigit(sr->str[sr->pos - 1]))
+        if (!is_digit_char(sr->str[sr->pos - 1]))
         {
             Streader_set_error(sr, "No digits found after exponent indicator");
             return false;
         }
     }
 
-    if (!Streader_end_reached(sr) && isalpha(CUR_CH))
+    if (!Streader_end_reached(sr) && is_alpha_char(CUR_CH))
     {
         Streader_set_error(sr, "Trailing letters after a number");
         return false;
@@ -641,11 +758,25 @@ bool Streader_read_float(Streader* sr, double* dest)
 
     double result = (double)significand;
 
-    double abs_magnitude = pow(10, abs(final_shift));
-    if (final_shift >= 0)
-        result *= abs_magnitude;
+    if ((significand <= EXACT_SIGNIFICAND_MAX) &&
+            (abs(final_shift) <= EXACT_SHIFT_MAX) &&
+            !digits_dropped)
+    {
+        // Both the significand and the power of ten are exact, so a single
+        // correctly rounded operation gives the correctly rounded result
+        if (final_shift >= 0)
+            result *= exact_powers_of_ten[final_shift];
+        else
+            result /= exact_powers_of_ten[-final_shift];
+    }
     else
-        result /= abs_magnitude;
+    {
+        double abs_magnitude = pow(10, abs(final_shift));
+        if (final_shift >= 0)
+            result *= abs_magnitude;
+        else
+            result /= abs_magnitude;
+    }
 
     if (is_negative)
         result = -result;
@@ -657,6 +788,8 @@ bool Streader_read_float(Streader* sr, double* dest)
 }
 
 #undef SIGNIFICANT_MAX
+#undef EXACT_SIGNIFICAND_MAX
+#undef EXACT_SHIFT_MAX
 
 
 bool Streader_read_string(Streader* sr, int64_t max_bytes, char* dest)
@@ -736,7 +869,7 @@ bool Streader_read_string(Streader* sr, int64_t max_bytes, char* dest)
                     }
 
                     int32_t value = -1;
-                    if (isdigit(CUR_CH))
+                    if (is_digit_char(CUR_CH))
                         value = CUR_CH - '0';
                     else if (strchr(upper_hex_digits, CUR_CH) != NULL)
                         value = (int32_t)(strchr(upper_hex_digits, CUR_CH) -
@@ -798,17 +931,32 @@ bool Streader_read_string(Streader* sr, int64_t max_bytes, char* dest)
             if (dest != NULL && write_pos < max_bytes - 1)
                 dest[write_pos++] = special_ch;
         }
-        else if (iscntrl(CUR_CH))
+        else if (is_string_special_char(CUR_CH))
         {
-            Streader_set_error(sr, "Control character %#2x in string");
+            Streader_set_error(
+                    sr, "Control character %#2x in string", (unsigned)CUR_CH);
             return false;
         }
         else
         {
-            // Normal characters
+            // Normal characters, copied up to the next special character
             // TODO: check Unicode if needed
-            if (dest != NULL && write_pos + 1 < max_bytes)
-                dest[write_pos++] = CUR_CH;
+            const int64_t run_len =
+                get_plain_string_length(&sr->str[sr->pos], sr->len - sr->pos);
+            rassert(run_len > 0);
+
+            if (dest != NULL)
+            {
+                const int64_t copy_len = min(run_len, max_bytes - 1 - write_pos);
+                if (copy_len > 0)
+                {
+                    memcpy(&dest[write_pos], &sr->str[sr->pos], (size_t)copy_len);
+                    write_pos += copy_len;
+                }
+            }
+
+            sr->pos += run_len;
+            continue;
         }
         ++sr->pos;
     }
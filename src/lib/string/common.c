@@ -113,3 +113,18 @@ int string_extract_index(
 }
 
 
+uint32_t string_hash(const char* str)
+{
+    rassert(str != NULL);
+
+    uint32_t hash = STRING_HASH_INIT;
+    while (*str != '\0')
+    {
+        hash = string_hash_add(hash, *str);
+        ++str;
+    }
+
+    return hash;
+}
+
+
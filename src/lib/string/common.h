@@ -17,9 +17,16 @@
 
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 
+/**
+ * The initial value of a string hash, see \a string_hash_add.
+ */
+#define STRING_HASH_INIT ((uint32_t)2166136261u)
+
+
 /**
  * Check for equality between strings.
  *
@@ -76,6 +83,32 @@ int string_extract_index(
         const char* path, const char* prefix, int digits, const char* after);
 
 
+/**
+ * Add a character to a string hash.
+ *
+ * This allows calculating the hashes of all prefixes of a string in one pass.
+ *
+ * \param hash   The hash of the preceding characters, or \c STRING_HASH_INIT.
+ * \param c      The character to be added.
+ *
+ * \return   The updated hash.
+ */
+static inline uint32_t string_hash_add(uint32_t hash, char c)
+{
+    return (hash ^ (uint8_t)c) * (uint32_t)16777619u;
+}
+
+
+/**
+ * Calculate a hash of a string.
+ *
+ * \param str   The string -- must not be \c NULL.
+ *
+ * \return   The hash of \a str.
+ */
+uint32_t string_hash(const char* str);
+
+
 #endif // KQT_STRING_COMMON_H
 
 
@@ -17,14 +17,58 @@
 #include <debug/assert.h>
 #include <mathnum/common.h>
 
-#include <inttypes.h>
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 
 #define INT_BUF_SIZE 32
+#define FLOAT_BUF_SIZE 32
+#define SIGNIFICANT_MAX 17
+
+
+static int copy_chars(char* dest, int size, const char* src, int len)
+{
+    rassert(dest != NULL);
+    rassert(size > 0);
+    rassert(src != NULL);
+    rassert(len >= 0);
+
+    const int copy_len = min(len, size - 1);
+    memcpy(dest, src, (size_t)copy_len);
+    dest[copy_len] = '\0';
+
+    return copy_len;
+}
+
+
+// Writes at most INT_BUF_SIZE characters without a terminating byte
+static int write_int(char* dest, int64_t value)
+{
+    rassert(dest != NULL);
+
+    const bool is_negative = (value < 0);
+    uint64_t left = is_negative ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+
+    // Write digits in reverse order
+    char digits[INT_BUF_SIZE - 1];
+    int digit_count = 0;
+    do
+    {
+        digits[digit_count] = (char)('0' + (left % 10));
+        left /= 10;
+        ++digit_count;
+    } while (left != 0);
+
+    int length = 0;
+    if (is_negative)
+        dest[length++] = '-';
+
+    for (int i = digit_count - 1; i >= 0; --i)
+        dest[length++] = digits[i];
+
+    return length;
+}
 
 
 int serialise_bool(char* dest, int size, bool value)
@@ -32,9 +76,10 @@ int serialise_bool(char* dest, int size, bool value)
     rassert(dest != NULL);
     rassert(size > 0);
 
-    int printed = snprintf(dest, (size_t)size, "%s", value ? "true" : "false");
+    if (value)
+        return copy_chars(dest, size, "true", 4);
 
-    return min(printed, size - 1);
+    return copy_chars(dest, size, "false", 5);
 }
 
 
@@ -43,238 +88,501 @@ int serialise_int(char* dest, int size, int64_t value)
     rassert(dest != NULL);
     rassert(size > 0);
 
-    char result[INT_BUF_SIZE] = "";
-    int length = 0;
+    char result[INT_BUF_SIZE];
+    const int length = write_int(result, value);
 
-    if (value == 0)
-    {
-        result[0] = '0';
-    }
-    else
-    {
-        const bool is_negative = (value < 0);
+    return copy_chars(dest, size, result, length);
+}
 
-        // Make sure we can get an absolute value
-        const bool is_smallest = (value == INT64_MIN);
-        const int64_t safe_value = is_smallest ? value + 1 : value;
 
-        const int64_t abs_value = imaxabs(safe_value);
+/*
+ * Shortest round-trip conversion of doubles to decimal digits.
+ *
+ * This is the Grisu2 algorithm by Florian Loitsch, "Printing Floating-Point
+ * Numbers Quickly and Accurately with Integers" (PLDI 2010). The generated
+ * digits are always parsed back to the original value, and in nearly all
+ * cases they are also the shortest such sequence. Only integer arithmetic
+ * is used, so the result does not depend on the locale or the rounding mode.
+ */
 
-        // Write digits and sign in reverse order
-        int64_t left = abs_value;
-        while (left != 0)
-        {
-            rassert(length < INT_BUF_SIZE);
 
-            const int64_t digit = left % 10;
-            result[length] = (char)(digit + '0');
+typedef struct Diy_fp
+{
+    uint64_t f;
+    int e;
+} Diy_fp;
 
-            left /= 10;
-            ++length;
-        }
 
-        if (is_negative)
-        {
-            rassert(length < INT_BUF_SIZE);
-            result[length] = '-';
-            ++length;
-        }
+typedef struct Cached_power
+{
+    uint64_t f;
+    int16_t e;
+    int16_t k;
+} Cached_power;
 
-        // Fix smallest value
-        if (is_smallest)
-        {
-            rassert(result[0] != '9'); // magnitude is a power of 2
-            ++result[0];
-        }
 
-        // Reverse contents
-        for (int i = 0; i < length / 2; ++i)
-        {
-            int other_index = length - i - 1;
-            char tmp = result[i];
-            result[i] = result[other_index];
-            result[other_index] = tmp;
-        }
-    }
+// Normalised significands and binary exponents of 10^k, k = -348, -340, ..., 340
+static const Cached_power cached_powers[] =
+{
+    { UINT64_C(0xfa8fd5a0081c0288), -1220, -348 },
+    { UINT64_C(0xbaaee17fa23ebf76), -1193, -340 },
+    { UINT64_C(0x8b16fb203055ac76), -1166, -332 },
+    { UINT64_C(0xcf42894a5dce35ea), -1140, -324 },
+    { UINT64_C(0x9a6bb0aa55653b2d), -1113, -316 },
+    { UINT64_C(0xe61acf033d1a45df), -1087, -308 },
+    { UINT64_C(0xab70fe17c79ac6ca), -1060, -300 },
+    { UINT64_C(0xff77b1fcbebcdc4f), -1034, -292 },
+    { UINT64_C(0xbe5691ef416bd60c), -1007, -284 },
+    { UINT64_C(0x8dd01fad907ffc3c),  -980, -276 },
+    { UINT64_C(0xd3515c2831559a83),  -954, -268 },
+    { UINT64_C(0x9d71ac8fada6c9b5),  -927, -260 },
+    { UINT64_C(0xea9c227723ee8bcb),  -901, -252 },
+    { UINT64_C(0xaecc49914078536d),  -874, -244 },
+    { UINT64_C(0x823c12795db6ce57),  -847, -236 },
+    { UINT64_C(0xc21094364dfb5637),  -821, -228 },
+    { UINT64_C(0x9096ea6f3848984f),  -794, -220 },
+    { UINT64_C(0xd77485cb25823ac7),  -768, -212 },
+    { UINT64_C(0xa086cfcd97bf97f4),  -741, -204 },
+    { UINT64_C(0xef340a98172aace5),  -715, -196 },
+    { UINT64_C(0xb23867fb2a35b28e),  -688, -188 },
+    { UINT64_C(0x84c8d4dfd2c63f3b),  -661, -180 },
+    { UINT64_C(0xc5dd44271ad3cdba),  -635, -172 },
+    { UINT64_C(0x936b9fcebb25c996),  -608, -164 },
+    { UINT64_C(0xdbac6c247d62a584),  -582, -156 },
+    { UINT64_C(0xa3ab66580d5fdaf6),  -555, -148 },
+    { UINT64_C(0xf3e2f893dec3f126),  -529, -140 },
+    { UINT64_C(0xb5b5ada8aaff80b8),  -502, -132 },
+    { UINT64_C(0x87625f056c7c4a8b),  -475, -124 },
+    { UINT64_C(0xc9bcff6034c13053),  -449, -116 },
+    { UINT64_C(0x964e858c91ba2655),  -422, -108 },
+    { UINT64_C(0xdff9772470297ebd),  -396, -100 },
+    { UINT64_C(0xa6dfbd9fb8e5b88f),  -369,  -92 },
+    { UINT64_C(0xf8a95fcf88747d94),  -343,  -84 },
+    { UINT64_C(0xb94470938fa89bcf),  -316,  -76 },
+    { UINT64_C(0x8a08f0f8bf0f156b),  -289,  -68 },
+    { UINT64_C(0xcdb02555653131b6),  -263,  -60 },
+    { UINT64_C(0x993fe2c6d07b7fac),  -236,  -52 },
+    { UINT64_C(0xe45c10c42a2b3b06),  -210,  -44 },
+    { UINT64_C(0xaa242499697392d3),  -183,  -36 },
+    { UINT64_C(0xfd87b5f28300ca0e),  -157,  -28 },
+    { UINT64_C(0xbce5086492111aeb),  -130,  -20 },
+    { UINT64_C(0x8cbccc096f5088cc),  -103,  -12 },
+    { UINT64_C(0xd1b71758e219652c),   -77,   -4 },
+    { UINT64_C(0x9c40000000000000),   -50,    4 },
+    { UINT64_C(0xe8d4a51000000000),   -24,   12 },
+    { UINT64_C(0xad78ebc5ac620000),     3,   20 },
+    { UINT64_C(0x813f3978f8940984),    30,   28 },
+    { UINT64_C(0xc097ce7bc90715b3),    56,   36 },
+    { UINT64_C(0x8f7e32ce7bea5c70),    83,   44 },
+    { UINT64_C(0xd5d238a4abe98068),   109,   52 },
+    { UINT64_C(0x9f4f2726179a2245),   136,   60 },
+    { UINT64_C(0xed63a231d4c4fb27),   162,   68 },
+    { UINT64_C(0xb0de65388cc8ada8),   189,   76 },
+    { UINT64_C(0x83c7088e1aab65db),   216,   84 },
+    { UINT64_C(0xc45d1df942711d9a),   242,   92 },
+    { UINT64_C(0x924d692ca61be758),   269,  100 },
+    { UINT64_C(0xda01ee641a708dea),   295,  108 },
+    { UINT64_C(0xa26da3999aef774a),   322,  116 },
+    { UINT64_C(0xf209787bb47d6b85),   348,  124 },
+    { UINT64_C(0xb454e4a179dd1877),   375,  132 },
+    { UINT64_C(0x865b86925b9bc5c2),   402,  140 },
+    { UINT64_C(0xc83553c5c8965d3d),   428,  148 },
+    { UINT64_C(0x952ab45cfa97a0b3),   455,  156 },
+    { UINT64_C(0xde469fbd99a05fe3),   481,  164 },
+    { UINT64_C(0xa59bc234db398c25),   508,  172 },
+    { UINT64_C(0xf6c69a72a3989f5c),   534,  180 },
+    { UINT64_C(0xb7dcbf5354e9bece),   561,  188 },
+    { UINT64_C(0x88fcf317f22241e2),   588,  196 },
+    { UINT64_C(0xcc20ce9bd35c78a5),   614,  204 },
+    { UINT64_C(0x98165af37b2153df),   641,  212 },
+    { UINT64_C(0xe2a0b5dc971f303a),   667,  220 },
+    { UINT64_C(0xa8d9d1535ce3b396),   694,  228 },
+    { UINT64_C(0xfb9b7cd9a4a7443c),   720,  236 },
+    { UINT64_C(0xbb764c4ca7a44410),   747,  244 },
+    { UINT64_C(0x8bab8eefb6409c1a),   774,  252 },
+    { UINT64_C(0xd01fef10a657842c),   800,  260 },
+    { UINT64_C(0x9b10a4e5e9913129),   827,  268 },
+    { UINT64_C(0xe7109bfba19c0c9d),   853,  276 },
+    { UINT64_C(0xac2820d9623bf429),   880,  284 },
+    { UINT64_C(0x80444b5e7aa7cf85),   907,  292 },
+    { UINT64_C(0xbf21e44003acdd2d),   933,  300 },
+    { UINT64_C(0x8e679c2f5e44ff8f),   960,  308 },
+    { UINT64_C(0xd433179d9c8cb841),   986,  316 },
+    { UINT64_C(0x9e19db92b4e31ba9),  1013,  324 },
+    { UINT64_C(0xeb96bf6ebadf77d9),  1039,  332 },
+    { UINT64_C(0xaf87023b9bf0ee6b),  1066,  340 },
+};
+
+
+#define CACHED_POWER_MIN_K (-348)
+#define CACHED_POWER_STEP 8
+
+
+static const uint64_t pow10_table[] =
+{
+    UINT64_C(1),
+    UINT64_C(10),
+    UINT64_C(100),
+    UINT64_C(1000),
+    UINT64_C(10000),
+    UINT64_C(100000),
+    UINT64_C(1000000),
+    UINT64_C(10000000),
+    UINT64_C(100000000),
+    UINT64_C(1000000000),
+    UINT64_C(10000000000),
+    UINT64_C(100000000000),
+    UINT64_C(1000000000000),
+    UINT64_C(10000000000000),
+    UINT64_C(100000000000000),
+    UINT64_C(1000000000000000),
+    UINT64_C(10000000000000000),
+    UINT64_C(100000000000000000),
+    UINT64_C(1000000000000000000),
+    UINT64_C(10000000000000000000),
+};
+
+
+#define SIGNIFICAND_BITS 52
+#define HIDDEN_BIT (UINT64_C(1) << SIGNIFICAND_BITS)
+#define EXPONENT_BIAS (1023 + SIGNIFICAND_BITS)
+
+
+static Diy_fp Diy_fp_mul(Diy_fp x, Diy_fp y)
+{
+    const uint64_t mask32 = UINT64_C(0xffffffff);
 
-    int printed = snprintf(dest, (size_t)size, "%s", result);
+    const uint64_t a = x.f >> 32;
+    const uint64_t b = x.f & mask32;
+    const uint64_t c = y.f >> 32;
+    const uint64_t d = y.f & mask32;
 
-    return min(printed, size - 1);
+    const uint64_t ac = a * c;
+    const uint64_t bc = b * c;
+    const uint64_t ad = a * d;
+    const uint64_t bd = b * d;
+
+    uint64_t mid = (bd >> 32) + (ad & mask32) + (bc & mask32);
+    mid += UINT64_C(1) << 31; // round
+
+    Diy_fp result = { ac + (ad >> 32) + (bc >> 32) + (mid >> 32), x.e + y.e + 64 };
+    return result;
 }
 
 
-#define SIGNIFICANT_MAX 17
+static Diy_fp Diy_fp_normalise(Diy_fp x)
+{
+    rassert(x.f != 0);
 
-int serialise_float(char* dest, int size, double value)
+    while ((x.f & (UINT64_C(1) << 63)) == 0)
+    {
+        x.f <<= 1;
+        --x.e;
+    }
+
+    return x;
+}
+
+
+static Diy_fp Diy_fp_from_double(double value)
 {
-    rassert(dest != NULL);
-    rassert(size > 0);
-    rassert(isfinite(value));
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
 
-    // Note: Not the most accurate conversion, this is a temporary solution...
+    const int biased_exp = (int)((bits >> SIGNIFICAND_BITS) & 0x7ff);
+    const uint64_t significand = bits & (HIDDEN_BIT - 1);
 
-    if (value == 0.0)
+    Diy_fp result = { significand, 1 - EXPONENT_BIAS };
+    if (biased_exp != 0)
     {
-        dest[0] = '0';
-        if (size > 1)
-            dest[1] = '\0';
-        return 1;
+        result.f = significand + HIDDEN_BIT;
+        result.e = biased_exp - EXPONENT_BIAS;
     }
 
-    const bool is_negative = (value < 0);
-    const double abs_value = fabs(value);
-    const int shift = (int)floor(log10(abs_value));
+    return result;
+}
+
+
+static Cached_power get_cached_power(int e, int* K)
+{
+    rassert(K != NULL);
 
-    // Get our most significant digits
-    char digits[SIGNIFICANT_MAX + 1] = "";
+    // Find the smallest 10^k that brings the exponent into the range [-60, -32]
+    const double dk = (-61 - e) * 0.30102999566398114 - CACHED_POWER_MIN_K - 1;
+    int k = (int)dk;
+    if (dk - k > 0.0)
+        ++k;
 
-    if (abs_value >= 1)
+    const int index = (k / CACHED_POWER_STEP) + 1;
+    rassert(index >= 0);
+    rassert(index < (int)(sizeof(cached_powers) / sizeof(*cached_powers)));
+
+    const Cached_power power = cached_powers[index];
+    *K = -power.k;
+
+    return power;
+}
+
+
+static void round_last_digit(
+        char* digits,
+        int length,
+        uint64_t delta,
+        uint64_t rest,
+        uint64_t ten_kappa,
+        uint64_t wp_w)
+{
+    while ((rest < wp_w) &&
+            (delta - rest >= ten_kappa) &&
+            ((rest + ten_kappa < wp_w) ||
+             (wp_w - rest > rest + ten_kappa - wp_w)))
     {
-        // Normalise so that SIGNIFICANT_MAX digits are above the decimal point
-        const double scale_factor = pow(10, SIGNIFICANT_MAX - shift - 1);
-        int64_t scaled = (int64_t)round(abs_value * scale_factor);
-        rassert(scaled >= 0);
+        --digits[length - 1];
+        rest += ten_kappa;
+    }
+
+    return;
+}
 
-        bool nonzero_found = false;
-        for (int i = SIGNIFICANT_MAX - 1; i >= 0; --i)
+
+static int generate_digits(Diy_fp w, Diy_fp mp, uint64_t delta, char* digits, int* K)
+{
+    const Diy_fp one = { UINT64_C(1) << -mp.e, mp.e };
+    const uint64_t wp_w = mp.f - w.f;
+
+    uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+    uint64_t p2 = mp.f & (one.f - 1);
+
+    int kappa = 1;
+    while ((kappa < 10) && (p1 >= pow10_table[kappa]))
+        ++kappa;
+
+    int length = 0;
+
+    // Integral part
+    while (kappa > 0)
+    {
+        const uint32_t divisor = (uint32_t)pow10_table[kappa - 1];
+        const uint32_t digit = p1 / divisor;
+        p1 %= divisor;
+
+        if ((digit != 0) || (length > 0))
+            digits[length++] = (char)('0' + digit);
+
+        --kappa;
+
+        const uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+        if (rest <= delta)
         {
-            const int64_t digit = scaled % 10;
-            if (digit != 0 || nonzero_found)
-            {
-                nonzero_found = true;
-                digits[i] = (char)(digit + '0');
-            }
-
-            scaled /= 10;
+            *K += kappa;
+            round_last_digit(
+                    digits, length, delta, rest, pow10_table[kappa] << -one.e, wp_w);
+            return length;
         }
     }
-    else
-    {
-        // Normalise to form 0.d1d2d3..., d1 != 0
-        double scaled = abs_value / pow(10, shift + 1);
 
-        for (int i = 0; i < SIGNIFICANT_MAX; ++i)
-        {
-            if (scaled == 0)
-                break;
+    // Fractional part
+    for (;;)
+    {
+        p2 *= 10;
+        delta *= 10;
 
-            scaled *= 10;
-            rassert(scaled < 10);
+        const char digit = (char)(p2 >> -one.e);
+        if ((digit != 0) || (length > 0))
+            digits[length++] = (char)('0' + digit);
 
-            double digit = floor(scaled);
-            digits[i] = (char)(digit + '0');
+        p2 &= one.f - 1;
+        --kappa;
 
-            scaled -= digit;
-            rassert(scaled >= 0);
+        if (p2 < delta)
+        {
+            *K += kappa;
+            const int index = -kappa;
+            const uint64_t unit = (index < 20) ? pow10_table[index] : 0;
+            round_last_digit(digits, length, delta, p2, one.f, wp_w * unit);
+            return length;
         }
+    }
+}
 
-        // Remove trailing zeros
-        for (int i = (int)strlen(digits) - 1; i >= 1; --i)
-        {
-            if (digits[i] != '0')
-                break;
 
-            digits[i] = '\0';
-        }
+/**
+ * Write the shortest decimal digits of a positive finite value.
+ *
+ * Grisu2 does not always find the shortest digits: about 0.19% of the
+ * results have more digits than needed, but they still parse back to the
+ * same value.
+ *
+ * \param value    The value -- must be positive and finite.
+ * \param digits   The destination for the digits without a terminating
+ *                 byte -- must have space for \c 18 characters.
+ * \param K        Destination for the decimal exponent of the last digit
+ *                 -- must not be \c NULL.
+ *
+ * \return   The number of digits written.
+ */
+static int get_shortest_digits(double value, char* digits, int* K)
+{
+    rassert(value > 0);
+    rassert(isfinite(value));
+    rassert(digits != NULL);
+    rassert(K != NULL);
+
+    const Diy_fp v = Diy_fp_from_double(value);
+
+    // Boundaries halfway to the neighbouring values
+    const Diy_fp plus = Diy_fp_normalise((Diy_fp){ (v.f << 1) + 1, v.e - 1 });
+    Diy_fp minus = (v.f == HIDDEN_BIT)
+        ? (Diy_fp){ (v.f << 2) - 1, v.e - 2 }
+        : (Diy_fp){ (v.f << 1) - 1, v.e - 1 };
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    const Cached_power power = get_cached_power(plus.e, K);
+    const Diy_fp c_mk = { power.f, power.e };
+
+    const Diy_fp w = Diy_fp_mul(Diy_fp_normalise(v), c_mk);
+    Diy_fp wp = Diy_fp_mul(plus, c_mk);
+    Diy_fp wm = Diy_fp_mul(minus, c_mk);
+    ++wm.f;
+    --wp.f;
+
+    int length = generate_digits(w, wp, wp.f - wm.f, digits, K);
+    rassert(length > 0);
+    rassert(length <= SIGNIFICANT_MAX);
+
+    // Remove trailing zeros
+    while ((length > 1) && (digits[length - 1] == '0'))
+    {
+        --length;
+        ++*K;
     }
 
-    rassert(strlen(digits) > 0);
+    return length;
+}
 
-    // buffer size: '-' + significand + '.' + 'e' + exp + '\0' + safety
-    char result[1 + SIGNIFICANT_MAX + 1 + 1 + 3 + 1 + 8] = "";
 
-    if (is_negative)
-        result[0] = '-';
+int serialise_float(char* dest, int size, double value)
+{
+    rassert(dest != NULL);
+    rassert(size > 0);
+    rassert(isfinite(value));
+
+    if (value == 0.0)
+        return copy_chars(dest, size, "0", 1);
+
+    char digits[SIGNIFICANT_MAX + 1];
+    int K = 0;
+    const int digit_count = get_shortest_digits(fabs(value), digits, &K);
+
+    // Decimal exponent of the first digit
+    const int shift = digit_count + K - 1;
+
+    // Leave room for an exponent written by write_int after the significand
+    char result[FLOAT_BUF_SIZE + INT_BUF_SIZE];
+    int length = 0;
+
+    if (value < 0)
+        result[length++] = '-';
 
     if (shift > 15 || shift < -4)
     {
-        // Exponential notation
-
-        // d1.d2d3...
-        result[strlen(result)] = digits[0];
+        // Exponential notation: d1.d2d3...e<exponent>
+        result[length++] = digits[0];
 
-        if (strlen(digits) > 1)
+        if (digit_count > 1)
         {
-            strcat(result, ".");
-            strcat(result, &digits[1]);
+            result[length++] = '.';
+            memcpy(result + length, digits + 1, (size_t)(digit_count - 1));
+            length += digit_count - 1;
         }
 
-        // e<exponent>
-        strcat(result, "e");
-        const size_t cur_len = strlen(result);
-        rassert(cur_len < sizeof(result));
-        serialise_int(&result[cur_len], (int)(sizeof(result) - cur_len - 1), shift);
+        result[length++] = 'e';
+        length += write_int(result + length, shift);
     }
     else if (shift >= 0)
     {
         const int before_point = shift + 1;
-        const int available = (int)strlen(digits);
-        strncat(result, digits, (size_t)before_point);
+        const int copy_count = min(before_point, digit_count);
+        memcpy(result + length, digits, (size_t)copy_count);
+        length += copy_count;
 
-        if (before_point >= available)
+        if (before_point >= digit_count)
         {
-            const int add_zeroes = before_point - available;
-            for (int i = 0; i < add_zeroes; ++i)
-                strcat(result, "0");
+            for (int i = digit_count; i < before_point; ++i)
+                result[length++] = '0';
         }
         else
         {
-            strcat(result, ".");
-            strcat(result, &digits[before_point]);
+            result[length++] = '.';
+            memcpy(result + length, digits + before_point,
+                    (size_t)(digit_count - before_point));
+            length += digit_count - before_point;
         }
     }
     else
     {
         // Leading zeros
-        strcat(result, "0.");
+        result[length++] = '0';
+        result[length++] = '.';
         for (int i = shift + 1; i < 0; ++i)
-            strcat(result, "0");
+            result[length++] = '0';
 
-        strcat(result, digits);
+        memcpy(result + length, digits, (size_t)digit_count);
+        length += digit_count;
     }
 
-    const int copy_amount = min(size - 1, (int)strlen(result));
-    strncpy(dest, result, (size_t)copy_amount);
-    dest[copy_amount] = '\0';
-    return copy_amount;
+    rassert(length < FLOAT_BUF_SIZE);
+
+    return copy_chars(dest, size, result, length);
 }
 
+
+#undef SIGNIFICAND_BITS
+#undef HIDDEN_BIT
+#undef EXPONENT_BIAS
+#undef CACHED_POWER_MIN_K
+#undef CACHED_POWER_STEP
 #undef SIGNIFICANT_MAX
 
 
-int serialise_Pat_inst_ref(char* dest, int size, const Pat_inst_ref* value)
+static int serialise_int_pair(char* dest, int size, int64_t first, int64_t second)
 {
     rassert(dest != NULL);
     rassert(size > 0);
-    rassert(value != NULL);
 
-    char pat_buf[INT_BUF_SIZE] = "";
-    char inst_buf[INT_BUF_SIZE] = "";
-
-    serialise_int(pat_buf, INT_BUF_SIZE, value->pat);
-    serialise_int(inst_buf, INT_BUF_SIZE, value->inst);
+    char result[INT_BUF_SIZE * 2 + 4];
+    int length = 0;
 
-    int printed = snprintf(dest, (size_t)size, "[%s, %s]", pat_buf, inst_buf);
+    result[length++] = '[';
+    length += write_int(result + length, first);
+    result[length++] = ',';
+    result[length++] = ' ';
+    length += write_int(result + length, second);
+    result[length++] = ']';
 
-    return min(printed, size - 1);
+    return copy_chars(dest, size, result, length);
 }
 
 
-int serialise_Tstamp(char* dest, int size, const Tstamp* value)
+int serialise_Pat_inst_ref(char* dest, int size, const Pat_inst_ref* value)
 {
     rassert(dest != NULL);
     rassert(size > 0);
     rassert(value != NULL);
 
-    char beats_buf[INT_BUF_SIZE] = "";
-    char rem_buf[INT_BUF_SIZE] = "";
+    return serialise_int_pair(dest, size, value->pat, value->inst);
+}
 
-    serialise_int(beats_buf, INT_BUF_SIZE, Tstamp_get_beats(value));
-    serialise_int(rem_buf, INT_BUF_SIZE, Tstamp_get_rem(value));
 
-    int printed = snprintf(dest, (size_t)size, "[%s, %s]", beats_buf, rem_buf);
+int serialise_Tstamp(char* dest, int size, const Tstamp* value)
+{
+    rassert(dest != NULL);
+    rassert(size > 0);
+    rassert(value != NULL);
 
-    return min(printed, size - 1);
+    return serialise_int_pair(
+            dest, size, Tstamp_get_beats(value), Tstamp_get_rem(value));
 }
 
 
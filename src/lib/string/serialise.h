@@ -55,6 +55,10 @@ int serialise_int(char* dest, int size, int64_t value);
 /**
  * Create a JSON representation of a floating point value.
  *
+ * The output always parses back to the same value. It is the shortest such
+ * representation except for about 0.19% of values, which get a slightly
+ * longer representation.
+ *
  * \param dest    The destination string buffer -- must not be \c NULL.
  * \param size    The size of the string buffer including the terminating
  *                byte -- must be positive.
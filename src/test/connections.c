@@ -18,6 +18,8 @@
 #include <kunquat/Handle.h>
 #include <kunquat/Player.h>
 
+#include <math.h>
+
 
 #define buf_len 128
 
@@ -183,6 +185,225 @@ START_TEST(Effect_with_double_volume_dsp_and_bypass_triples_volume)
 END_TEST
 
 
+START_TEST(Float_parameter_update_does_not_require_validation)
+{
+    set_audio_rate(220);
+    set_mix_volume(0);
+    pause();
+
+    set_data("p_control_map.json", "[0, [ [0, 0] ]]");
+    set_data("control_00/p_manifest.json", "[0, {}]");
+
+    make_debug_instrument();
+
+    set_data("au_01/p_manifest.json", "[0, { \"type\": \"effect\" }]");
+    set_data("au_01/in_00/p_manifest.json", "[0, {}]");
+    set_data("au_01/out_00/p_manifest.json", "[0, {}]");
+    set_data("au_01/proc_00/p_manifest.json", "[0, { \"type\": \"volume\" }]");
+    set_data("au_01/proc_00/p_signal_type.json", "[0, \"mixed\"]");
+    set_data("au_01/proc_00/in_00/p_manifest.json", "[0, {}]");
+    set_data("au_01/proc_00/out_00/p_manifest.json", "[0, {}]");
+    set_data("au_01/p_connections.json",
+            "[0,"
+            "[ [\"in_00\", \"out_00\"],"
+            "  [\"in_00\", \"proc_00/C/in_00\"],"
+            "  [\"proc_00/C/out_00\", \"out_00\"] ]"
+            "]");
+
+    set_data("out_00/p_manifest.json", "[0, {}]");
+    set_data("p_connections.json",
+            "[0,"
+            "[ [\"au_00/out_00\", \"au_01/in_00\"],"
+            "  [\"au_01/out_00\", \"out_00\"] ]"
+            "]");
+
+    validate();
+
+    ck_assert_msg(
+            kqt_Handle_set_data_float(handle, "au_01/proc_00/c/p_f_volume.json", 6) == 1,
+            "Setting a float parameter failed: %s", kqt_Handle_get_error(handle));
+
+    ck_assert_msg(
+            kqt_Handle_set_data_float(handle, "au_01/p_connections.json", 6) == 0,
+            "Float value was accepted for a non-parameter key");
+    kqt_Handle_clear_error(handle);
+    ck_assert_msg(
+            kqt_Handle_set_data_float(
+                handle, "au_01/proc_00/c/p_f_volume.json", INFINITY) == 0,
+            "Non-finite float value was accepted");
+    kqt_Handle_clear_error(handle);
+
+    float actual_buf[buf_len] = { 0.0f };
+    kqt_Handle_fire_event(handle, 0, Note_On_55_Hz);
+    check_unexpected_error();
+    mix_and_fill(actual_buf, buf_len);
+
+    float expected_buf[buf_len] = { 0.0f };
+    float seq[] = { 3.0f, 1.5f, 1.5f, 1.5f };
+    repeat_seq_local(expected_buf, 10, seq);
+
+    check_buffers_equal(expected_buf, actual_buf, buf_len, 0.0f);
+}
+END_TEST
+
+
+START_TEST(Automation_lane_drives_stream_output)
+{
+    set_audio_rate(220);
+    set_mix_volume(0);
+    pause();
+
+    set_data("p_dc_blocker_enabled.json", "[0, false]");
+
+    set_data("au_00/p_manifest.json", "[0, { \"type\": \"effect\" }]");
+    set_data("au_00/out_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/proc_00/p_manifest.json", "[0, { \"type\": \"stream\" }]");
+    set_data("au_00/proc_00/p_signal_type.json", "[0, \"mixed\"]");
+    set_data("au_00/proc_00/out_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/p_streams.json", "[0, [ [\"level\", 0] ]]");
+    set_data("au_00/p_connections.json",
+            "[0, [ [\"proc_00/C/out_00\", \"out_00\"] ]]");
+
+    set_data("out_00/p_manifest.json", "[0, {}]");
+    set_data("p_connections.json", "[0, [ [\"au_00/out_00\", \"out_00\"] ]]");
+
+    validate();
+
+    ck_assert_msg(kqt_Handle_add_automation_lane(handle, "au_00", "missing") == -1,
+            "Automation lane was added for a missing stream");
+    kqt_Handle_clear_error(handle);
+
+    const int lane = kqt_Handle_add_automation_lane(handle, "au_00", "level");
+    ck_assert_msg(lane >= 0,
+            "Adding automation lane failed: %s", kqt_Handle_get_error(handle));
+
+    const float values[] = { 0.5f, 0.25f };
+    ck_assert_msg(kqt_Handle_set_automation_values(handle, lane, 2, values) == 1,
+            "Setting automation values failed: %s", kqt_Handle_get_error(handle));
+    ck_assert_msg(kqt_Handle_add_automation_point(handle, lane, 5, 1.25) == 1,
+            "Adding automation point failed: %s", kqt_Handle_get_error(handle));
+    ck_assert_msg(kqt_Handle_add_automation_point(handle, lane, 4, 0) == 0,
+            "Automation point was accepted before written values");
+    kqt_Handle_clear_error(handle);
+
+    float actual_buf[16] = { 0.0f };
+    mix_and_fill(actual_buf, 8);
+    mix_and_fill(actual_buf + 8, 8);
+
+    // The last value is held after the automated render call
+    float expected_buf[16] = { 0.5f, 0.25f, 0.5f, 0.75f, 1.0f };
+    for (int i = 5; i < 16; ++i)
+        expected_buf[i] = 1.25f;
+
+    check_buffers_equal(expected_buf, actual_buf, 16, 0.0f);
+
+    ck_assert_msg(kqt_Handle_remove_automation_lane(handle, lane) == 1,
+            "Removing automation lane failed: %s", kqt_Handle_get_error(handle));
+    ck_assert_msg(kqt_Handle_set_automation_values(handle, lane, 2, values) == 0,
+            "Removed automation lane was accepted");
+    kqt_Handle_clear_error(handle);
+}
+END_TEST
+
+
+START_TEST(Input_audio_is_mixed_directly_and_through_effect)
+{
+    set_audio_rate(220);
+    set_mix_volume(0);
+    pause();
+
+    set_data("p_dc_blocker_enabled.json", "[0, false]");
+
+    set_data("au_00/p_manifest.json", "[0, { \"type\": \"effect\" }]");
+    set_data("au_00/in_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/out_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/p_connections.json", "[0, [ [\"in_00\", \"out_00\"] ]]");
+
+    set_data("in_00/p_manifest.json", "[0, {}]");
+    set_data("out_00/p_manifest.json", "[0, {}]");
+    set_data("p_connections.json",
+            "[0,"
+            "[ [\"in_00\", \"au_00/in_00\"],"
+            "  [\"au_00/out_00\", \"out_00\"],"
+            "  [\"in_00\", \"out_00\"] ]"
+            "]");
+
+    validate();
+
+    ck_assert_msg(kqt_Handle_set_input_audio(handle, 0, -1, NULL) == 0,
+            "Negative input frame count was accepted");
+    kqt_Handle_clear_error(handle);
+
+    const float input[] = { 0.5f, -0.25f, 1.0f, 0.75f };
+    ck_assert_msg(kqt_Handle_set_input_audio(handle, 0, 4, input) == 1,
+            "Setting input audio failed: %s", kqt_Handle_get_error(handle));
+
+    float actual_buf[16] = { 0.0f };
+    mix_and_fill(actual_buf, 8);
+    mix_and_fill(actual_buf + 8, 8);
+
+    // The input is silent after its frames and is consumed by the render call
+    float expected_buf[16] = { 1.0f, -0.5f, 2.0f, 1.5f };
+
+    check_buffers_equal(expected_buf, actual_buf, 16, 0.0f);
+}
+END_TEST
+
+
+START_TEST(Master_output_port_pairs_form_buses)
+{
+    set_audio_rate(220);
+    set_mix_volume(0);
+    pause();
+
+    set_data("p_dc_blocker_enabled.json", "[0, false]");
+
+    set_data("in_00/p_manifest.json", "[0, {}]");
+    set_data("out_00/p_manifest.json", "[0, {}]");
+    set_data("out_01/p_manifest.json", "[0, {}]");
+    set_data("out_03/p_manifest.json", "[0, {}]");
+    set_data("p_connections.json",
+            "[0, [ [\"in_00\", \"out_00\"], [\"in_00\", \"out_03\"] ]]");
+
+    validate();
+
+    const int bus_count = kqt_Handle_get_bus_count(handle);
+    ck_assert_msg(bus_count == 2, "Expected 2 buses, got %d", bus_count);
+
+    const float input[] = { 0.5f, -0.25f, 1.0f, 0.75f };
+    kqt_Handle_set_input_audio(handle, 0, 4, input);
+    check_unexpected_error();
+
+    kqt_Handle_play(handle, 4);
+    check_unexpected_error();
+
+    const float* main_buf = kqt_Handle_get_audio(handle);
+    const float* bus_buf = kqt_Handle_get_bus_audio(handle, 1);
+    check_unexpected_error();
+
+    for (int i = 0; i < 4; ++i)
+    {
+        ck_assert_msg(main_buf[i * 2] == input[i],
+                "Main output frame %d is %.4f instead of %.4f",
+                i, main_buf[i * 2], input[i]);
+        ck_assert_msg(main_buf[i * 2 + 1] == 0,
+                "Unconnected main output channel contains %.4f at frame %d",
+                main_buf[i * 2 + 1], i);
+        ck_assert_msg(bus_buf[i * 2] == 0,
+                "Unconnected bus channel contains %.4f at frame %d",
+                bus_buf[i * 2], i);
+        ck_assert_msg(bus_buf[i * 2 + 1] == input[i],
+                "Bus output frame %d is %.4f instead of %.4f",
+                i, bus_buf[i * 2 + 1], input[i]);
+    }
+
+    ck_assert_msg(kqt_Handle_get_bus_audio(handle, 2) == NULL,
+            "Nonexistent bus was returned");
+    kqt_Handle_clear_error(handle);
+}
+END_TEST
+
+
 START_TEST(Connect_instrument_effect_with_unconnected_dsp_and_mix)
 {
     assert(handle != 0);
@@ -232,6 +453,10 @@ static Suite* Connections_suite(void)
     tcase_add_test(
             tc_effects,
             Effect_with_double_volume_dsp_and_bypass_triples_volume);
+    tcase_add_test(tc_effects, Float_parameter_update_does_not_require_validation);
+    tcase_add_test(tc_effects, Automation_lane_drives_stream_output);
+    tcase_add_test(tc_effects, Input_audio_is_mixed_directly_and_through_effect);
+    tcase_add_test(tc_effects, Master_output_port_pairs_form_buses);
     tcase_add_test(
             tc_effects,
             Connect_instrument_effect_with_unconnected_dsp_and_mix);
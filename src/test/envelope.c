@@ -0,0 +1,336 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <test_common.h>
+
+#include <init/devices/param_types/Envelope.h>
+#include <mathnum/common.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+#define NODE_COUNT 12
+#define STEP_COUNT 4096
+
+
+// Unevenly spaced nodes with several nodes inside a single grid cell
+static const double node_coords[NODE_COUNT][2] =
+{
+    { -3.0,     0.5 },
+    { -2.5,     1.0 },
+    { -2.4999, -1.0 },
+    { -2.4998,  0.25 },
+    { -1.0,     0.75 },
+    {  0.0,     0.0 },
+    {  0.3,     2.0 },
+    {  0.3001,  2.0 },
+    {  1.7,    -0.5 },
+    {  4.0,     1.5 },
+    {  8.5,     1.0 },
+    { 13.0,    -2.0 },
+};
+
+
+static Envelope* compiled = NULL;
+static Envelope* searched = NULL;
+
+
+static Envelope* create_envelope(Envelope_int interp)
+{
+    Envelope* env = new_Envelope(NODE_COUNT, -INFINITY, INFINITY, 0, -INFINITY, INFINITY, 0);
+    ck_assert_msg(env != NULL, "Could not allocate memory for Envelope");
+
+    for (int i = 0; i < NODE_COUNT; ++i)
+    {
+        const int index = Envelope_set_node(env, node_coords[i][0], node_coords[i][1]);
+        ck_assert_msg(index == i,
+                "Node was added to a wrong index" KT_VALUES("%d", i, index));
+    }
+
+    Envelope_set_interp(env, interp);
+
+    return env;
+}
+
+
+static void setup_envelopes(Envelope_int interp)
+{
+    assert(compiled == NULL);
+    assert(searched == NULL);
+
+    compiled = create_envelope(interp);
+    Envelope_compile(compiled);
+    searched = create_envelope(interp);
+
+    return;
+}
+
+
+void teardown_envelopes(void)
+{
+    del_Envelope(compiled);
+    compiled = NULL;
+    del_Envelope(searched);
+    searched = NULL;
+    return;
+}
+
+
+static double get_test_pos(int step)
+{
+    const double first_x = node_coords[0][0];
+    const double last_x = node_coords[NODE_COUNT - 1][0];
+    const double margin = 1;
+
+    return (first_x - margin) +
+        (last_x - first_x + 2 * margin) * step / (double)(STEP_COUNT - 1);
+}
+
+
+static void check_value(const Envelope* env, double x, double actual)
+{
+    const double expected = Envelope_get_value(searched, x);
+    if (isnan(expected))
+    {
+        ck_assert_msg(isnan(actual),
+                "Envelope is unexpectedly defined at %.17g"
+                "\n    Expected: %.17g"
+                "\n      Actual: %.17g",
+                x, expected, actual);
+        return;
+    }
+
+    ck_assert_msg(actual == expected,
+            "Wrong value at %.17g with %s interpolation"
+            "\n    Expected: %.17g"
+            "\n      Actual: %.17g",
+            x,
+            (Envelope_get_interp(env) == ENVELOPE_INT_NEAREST) ? "nearest" : "linear",
+            expected,
+            actual);
+
+    return;
+}
+
+
+static void check_segment(double x, int segment)
+{
+    int expected = 0;
+    while ((expected < NODE_COUNT - 1) && (node_coords[expected + 1][0] <= x))
+        ++expected;
+
+    ck_assert_msg(segment == expected,
+            "Wrong segment at %.17g"
+            "\n    Expected: %d"
+            "\n      Actual: %d",
+            x, expected, segment);
+
+    return;
+}
+
+
+START_TEST(Compiled_values_match_search_based_values)
+{
+    setup_envelopes((Envelope_int)_i);
+
+    for (int step = 0; step < STEP_COUNT; ++step)
+    {
+        const double x = get_test_pos(step);
+        check_value(compiled, x, Envelope_get_value(compiled, x));
+    }
+
+    for (int i = 0; i < NODE_COUNT; ++i)
+    {
+        const double x = node_coords[i][0];
+        check_value(compiled, x, Envelope_get_value(compiled, x));
+
+        if (i < NODE_COUNT - 1)
+        {
+            const double mid_x = (x + node_coords[i + 1][0]) / 2;
+            check_value(compiled, mid_x, Envelope_get_value(compiled, mid_x));
+        }
+    }
+}
+END_TEST
+
+
+START_TEST(Buffer_values_match_search_based_values)
+{
+    setup_envelopes((Envelope_int)_i);
+
+    const double first_x = node_coords[0][0];
+    const double last_x = node_coords[NODE_COUNT - 1][0];
+
+    float in_values[STEP_COUNT] = { 0 };
+    for (int step = 0; step < STEP_COUNT; ++step)
+        in_values[step] = (float)get_test_pos(step);
+
+    float out_compiled[STEP_COUNT] = { 0 };
+    float out_searched[STEP_COUNT] = { 0 };
+    Envelope_get_values(compiled, in_values, out_compiled, STEP_COUNT);
+    Envelope_get_values(searched, in_values, out_searched, STEP_COUNT);
+
+    for (int i = 0; i < STEP_COUNT; ++i)
+    {
+        // Positions outside the Envelope are clamped to the end nodes
+        const double x = clamp((double)in_values[i], first_x, last_x);
+        const float expected = (float)Envelope_get_value(searched, x);
+
+        ck_assert_msg(out_compiled[i] == expected,
+                "Wrong compiled buffer value at %.9g"
+                "\n    Expected: %.9g"
+                "\n      Actual: %.9g",
+                in_values[i], expected, out_compiled[i]);
+        ck_assert_msg(out_searched[i] == expected,
+                "Wrong search-based buffer value at %.9g"
+                "\n    Expected: %.9g"
+                "\n      Actual: %.9g",
+                in_values[i], expected, out_searched[i]);
+    }
+}
+END_TEST
+
+
+START_TEST(Segment_cursor_follows_positions_across_nodes)
+{
+    setup_envelopes((Envelope_int)_i);
+
+    // Forwards
+    int segment = -1;
+    for (int step = 0; step < STEP_COUNT; ++step)
+    {
+        const double x = get_test_pos(step);
+        const double actual = Envelope_get_value_from(compiled, x, &segment);
+        check_value(compiled, x, actual);
+        if (!isnan(actual))
+            check_segment(x, segment);
+    }
+
+    // Backwards
+    for (int step = STEP_COUNT - 1; step >= 0; --step)
+    {
+        const double x = get_test_pos(step);
+        const double actual = Envelope_get_value_from(compiled, x, &segment);
+        check_value(compiled, x, actual);
+        if (!isnan(actual))
+            check_segment(x, segment);
+    }
+
+    // Exactly at the nodes
+    for (int i = 0; i < NODE_COUNT; ++i)
+    {
+        const double x = node_coords[i][0];
+        const double actual = Envelope_get_value_from(compiled, x, &segment);
+        check_value(compiled, x, actual);
+        check_segment(x, segment);
+    }
+
+    // Jumps across several nodes, starting from a stale cursor
+    segment = NODE_COUNT + 5;
+    for (int step = 0; step < STEP_COUNT; ++step)
+    {
+        const double x = get_test_pos((step * 1543) % STEP_COUNT);
+        const double actual = Envelope_get_value_from(compiled, x, &segment);
+        check_value(compiled, x, actual);
+        if (!isnan(actual))
+            check_segment(x, segment);
+    }
+}
+END_TEST
+
+
+START_TEST(Modified_envelope_is_not_evaluated_with_stale_tables)
+{
+    setup_envelopes((Envelope_int)_i);
+
+    double* node = Envelope_move_node(compiled, 5, 0.1, 3.0);
+    ck_assert_msg(node != NULL, "Could not move a node");
+    node = Envelope_move_node(searched, 5, 0.1, 3.0);
+    ck_assert_msg(node != NULL, "Could not move a node");
+
+    int segment = -1;
+    for (int step = 0; step < STEP_COUNT; ++step)
+    {
+        const double x = get_test_pos(step);
+        check_value(compiled, x, Envelope_get_value(compiled, x));
+        check_value(compiled, x, Envelope_get_value_from(compiled, x, &segment));
+    }
+
+    Envelope_compile(compiled);
+
+    segment = -1;
+    for (int step = 0; step < STEP_COUNT; ++step)
+    {
+        const double x = get_test_pos(step);
+        check_value(compiled, x, Envelope_get_value(compiled, x));
+        check_value(compiled, x, Envelope_get_value_from(compiled, x, &segment));
+    }
+}
+END_TEST
+
+
+static Suite* Envelope_suite(void)
+{
+    Suite* s = suite_create("Envelope");
+
+    static const int timeout = DEFAULT_TIMEOUT;
+
+    TCase* tc_compiled = tcase_create("compiled");
+    suite_add_tcase(s, tc_compiled);
+    tcase_set_timeout(tc_compiled, timeout);
+    tcase_add_checked_fixture(tc_compiled, NULL, teardown_envelopes);
+
+    tcase_add_loop_test(
+            tc_compiled,
+            Compiled_values_match_search_based_values,
+            ENVELOPE_INT_NEAREST,
+            ENVELOPE_INT_CURVE);
+    tcase_add_loop_test(
+            tc_compiled,
+            Buffer_values_match_search_based_values,
+            ENVELOPE_INT_NEAREST,
+            ENVELOPE_INT_CURVE);
+    tcase_add_loop_test(
+            tc_compiled,
+            Segment_cursor_follows_positions_across_nodes,
+            ENVELOPE_INT_NEAREST,
+            ENVELOPE_INT_CURVE);
+    tcase_add_loop_test(
+            tc_compiled,
+            Modified_envelope_is_not_evaluated_with_stale_tables,
+            ENVELOPE_INT_NEAREST,
+            ENVELOPE_INT_CURVE);
+
+    return s;
+}
+
+
+int main(void)
+{
+    Suite* suite = Envelope_suite();
+    SRunner* sr = srunner_create(suite);
+#ifdef K_MEM_DEBUG
+    srunner_set_fork_status(sr, CK_NOFORK);
+#endif
+    srunner_run_all(sr, CK_NORMAL);
+    const int fail_count = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    exit(fail_count > 0);
+}
+
+
@@ -17,6 +17,7 @@
 #include <mathnum/common.h>
 #include <mathnum/fft.h>
 #include <mathnum/Random.h>
+#include <memory.h>
 
 #include <math.h>
 #include <stdint.h>
@@ -135,6 +136,38 @@ START_TEST(Forward_and_inverse_transform_return_scaled_original)
 END_TEST
 
 
+START_TEST(Long_transform_returns_scaled_original)
+{
+    static const int32_t test_length = 262144;
+
+    FFT_worker* long_fw = FFT_worker_init(FFT_WORKER_AUTO, test_length);
+    float* orig_data = memory_alloc_items(float, test_length);
+    float* data = memory_alloc_items(float, test_length);
+    ck_assert_msg(long_fw != NULL && orig_data != NULL && data != NULL,
+            "Could not allocate memory for long transform test");
+
+    fill_data_noise(orig_data, test_length);
+    memcpy(data, orig_data, sizeof(float) * (size_t)test_length);
+
+    FFT_worker_rfft(long_fw, data, test_length);
+    FFT_worker_irfft(long_fw, data, test_length);
+
+    for (int32_t i = 0; i < test_length; ++i)
+    {
+        const float converted = data[i] / (float)test_length;
+        ck_assert_msg(fabsf(converted - orig_data[i]) <= 0.001f,
+                "Absolute value is too large at index %d:"
+                " converted %.7g, original %.7g",
+                (int)i, converted, orig_data[i]);
+    }
+
+    memory_free(data);
+    memory_free(orig_data);
+    FFT_worker_deinit(long_fw);
+}
+END_TEST
+
+
 static Suite* FFT_suite(void)
 {
     Suite* s = suite_create("FFT");
@@ -152,6 +185,7 @@ static Suite* FFT_suite(void)
             Forward_and_inverse_transform_return_scaled_original,
             1,
             max_test_length + 1);
+    tcase_add_test(tc_correctness, Long_transform_returns_scaled_original);
 
     return s;
 }
@@ -115,6 +115,286 @@ START_TEST(Set_audio_rate)
 END_TEST
 
 
+START_TEST(Sample_streaming_settings_are_validated)
+{
+    ck_assert_msg(kqt_Handle_set_sample_streaming(handle, -1, NULL) == 0,
+            "Negative preload length was accepted");
+    ck_assert_msg(strcmp(kqt_Handle_get_error(handle), "") != 0,
+            "No error was set for negative preload length");
+    kqt_Handle_clear_error(handle);
+
+    ck_assert_msg(kqt_Handle_set_sample_streaming(handle, 65536, NULL) == 1,
+            "Enabling sample streaming failed: %s", kqt_Handle_get_error(handle));
+    ck_assert_msg(kqt_Handle_set_sample_streaming(handle, 4096, NULL) == 1,
+            "Changing sample streaming without samples failed: %s",
+            kqt_Handle_get_error(handle));
+
+    kqt_Handle_play(handle, 128);
+    check_unexpected_error();
+
+    ck_assert_msg(kqt_Handle_set_sample_streaming(handle, 0, NULL) == 1,
+            "Disabling sample streaming failed: %s", kqt_Handle_get_error(handle));
+}
+END_TEST
+
+
+START_TEST(Cache_dir_can_be_set_and_cleared)
+{
+    ck_assert_msg(kqt_Handle_set_cache_dir(handle, ".") == 1,
+            "Setting cache directory failed: %s", kqt_Handle_get_error(handle));
+
+    kqt_Handle_play(handle, 128);
+    check_unexpected_error();
+
+    ck_assert_msg(kqt_Handle_set_cache_dir(handle, "") == 1,
+            "Clearing cache directory with empty string failed: %s",
+            kqt_Handle_get_error(handle));
+    ck_assert_msg(kqt_Handle_set_cache_dir(handle, NULL) == 1,
+            "Clearing cache directory with NULL failed: %s",
+            kqt_Handle_get_error(handle));
+}
+END_TEST
+
+
+START_TEST(Audio_unit_render_places_notes_at_exact_frames)
+{
+    set_mix_volume(0);
+    setup_debug_single_pulse();
+
+    const int note_on = kqt_Handle_get_event_id(handle, "n+");
+    check_unexpected_error();
+
+    const long event_frames[] = { 3, 40, 40 };
+    const int event_ids[] = { note_on, note_on, note_on };
+    const double event_args[] = { 0, 0, 0 };
+
+    enum { frame_count = 64 };
+    float dest[frame_count * 2] = { 0.0f };
+    ck_assert_msg(kqt_Handle_render_audio_unit(
+                handle, 0, 3, event_frames, event_ids, event_args, frame_count, dest),
+            "Rendering audio unit failed: %s", kqt_Handle_get_error(handle));
+
+    for (int i = 0; i < frame_count; ++i)
+    {
+        const float expected = (i == 3) ? 1.0f : (i == 40) ? 2.0f : 0.0f;
+        ck_assert_msg(dest[i * 2] == expected,
+                "Expected %.1f at frame %d, got %.1f", expected, i, dest[i * 2]);
+    }
+
+    ck_assert_msg(kqt_Handle_get_position(handle) == 0,
+            "Rendering audio unit changed playback position");
+
+    const long bad_frames[] = { 40, 3 };
+    ck_assert_msg(kqt_Handle_render_audio_unit(
+                handle, 0, 2, bad_frames, event_ids, NULL, frame_count, dest) == 0,
+            "Unordered events were accepted");
+    kqt_Handle_clear_error(handle);
+
+    ck_assert_msg(kqt_Handle_render_audio_unit(
+                handle, 1, 0, NULL, NULL, NULL, frame_count, dest) == 0,
+            "Audio unit without control was accepted");
+    kqt_Handle_clear_error(handle);
+}
+END_TEST
+
+
+START_TEST(Shared_handle_outlives_source)
+{
+    set_mix_volume(0);
+    setup_debug_single_pulse();
+
+    kqt_Handle shared = kqt_new_Handle_sharing(handle);
+    ck_assert_msg(shared != 0,
+            "Couldn't create shared handle: %s", kqt_Handle_get_error(0));
+
+    ck_assert_msg(kqt_Handle_set_data(handle, "p_dc_blocker_enabled.json", "", 0) == 0,
+            "Shared module was modified");
+    kqt_Handle_clear_error(handle);
+
+    // Replace the source so that the teardown destroys the shared handle
+    kqt_del_Handle(handle);
+    handle = shared;
+
+    pause();
+    kqt_Handle_fire_event(handle, 0, "[\"n+\", 0]");
+    check_unexpected_error();
+    kqt_Handle_play(handle, 16);
+    check_unexpected_error();
+
+    const float* buf = kqt_Handle_get_audio(handle);
+    check_unexpected_error();
+    ck_assert_msg(buf[0] == 1.0f,
+            "Shared handle produced %.1f instead of a pulse", buf[0]);
+
+    ck_assert_msg(kqt_Handle_set_data(handle, "p_dc_blocker_enabled.json", "", 0) == 1,
+            "Module could not be modified after sharing ended: %s",
+            kqt_Handle_get_error(handle));
+}
+END_TEST
+
+
+START_TEST(Shared_handle_keeps_sample_streaming_of_module)
+{
+    set_mix_volume(0);
+    setup_debug_single_pulse();
+
+    ck_assert_msg(kqt_Handle_set_sample_streaming(handle, 4096, NULL) == 1,
+            "Enabling sample streaming failed: %s", kqt_Handle_get_error(handle));
+
+    kqt_Handle shared = kqt_new_Handle_sharing(handle);
+    ck_assert_msg(shared != 0,
+            "Couldn't create shared handle: %s", kqt_Handle_get_error(0));
+
+    ck_assert_msg(kqt_Handle_set_sample_streaming(shared, 0, NULL) == 0,
+            "Sample streaming of a shared module was changed");
+    kqt_Handle_clear_error(shared);
+
+    // The Sample streamer must remain usable after the source is gone
+    kqt_del_Handle(handle);
+    handle = shared;
+
+    pause();
+    kqt_Handle_fire_event(handle, 0, "[\"n+\", 0]");
+    check_unexpected_error();
+    kqt_Handle_play(handle, 16);
+    check_unexpected_error();
+
+    const float* buf = kqt_Handle_get_audio(handle);
+    check_unexpected_error();
+    ck_assert_msg(buf[0] == 1.0f,
+            "Shared handle produced %.1f instead of a pulse", buf[0]);
+
+    ck_assert_msg(kqt_Handle_set_sample_streaming(handle, 0, NULL) == 1,
+            "Disabling sample streaming after sharing ended failed: %s",
+            kqt_Handle_get_error(handle));
+}
+END_TEST
+
+
+START_TEST(Queued_events_are_fired_at_frame_offsets)
+{
+    set_mix_volume(0);
+    pause();
+    setup_debug_single_pulse();
+
+    const int note_on = kqt_Handle_get_event_id(handle, "n+");
+    check_unexpected_error();
+
+    // Queue out of order to check that offsets are respected
+    const long offsets[] = { 20, 5, 40 };
+    for (int i = 0; i < 3; ++i)
+    {
+        ck_assert_msg(kqt_Handle_queue_event(handle, offsets[i], 0, note_on, 0) == 1,
+                "Queueing event failed");
+    }
+
+    ck_assert_msg(kqt_Handle_queue_event(handle, -1, 0, note_on, 0) == -1,
+            "Negative frame offset was accepted");
+    ck_assert_msg(kqt_Handle_queue_channel_mute(handle, 0, 0, 2) == -1,
+            "Invalid mute state was accepted");
+    check_unexpected_error();
+
+    enum { frame_count = 32 };
+    for (int call = 0; call < 2; ++call)
+    {
+        kqt_Handle_play(handle, frame_count);
+        check_unexpected_error();
+        ck_assert_msg(kqt_Handle_get_frames_available(handle) == frame_count,
+                "Wrong number of frames rendered");
+
+        const float* buf = kqt_Handle_get_audio(handle);
+        for (int i = 0; i < frame_count; ++i)
+        {
+            const long frame = (call * frame_count) + i;
+            const float expected =
+                (frame == 5 || frame == 20 || frame == 40) ? 1.0f : 0.0f;
+            ck_assert_msg(buf[i * 2] == expected,
+                    "Expected %.1f at frame %ld, got %.1f",
+                    expected, frame, buf[i * 2]);
+        }
+    }
+}
+END_TEST
+
+
+START_TEST(Seeking_discards_pending_events)
+{
+    set_mix_volume(0);
+    pause();
+    setup_debug_single_pulse();
+
+    const int note_on = kqt_Handle_get_event_id(handle, "n+");
+    check_unexpected_error();
+
+    enum { frame_count = 32 };
+    ck_assert_msg(kqt_Handle_queue_event(handle, frame_count + 8, 0, note_on, 0) == 1,
+            "Queueing event failed");
+    ck_assert_msg(kqt_Handle_fire_event_at(handle, frame_count + 16, 0, "[\"n+\", 0]") == 1,
+            "Firing event failed: %s", kqt_Handle_get_error(handle));
+
+    kqt_Handle_play(handle, frame_count);
+    check_unexpected_error();
+
+    kqt_Handle_set_position(handle, 0, 0);
+    check_unexpected_error();
+    pause();
+
+    for (int call = 0; call < 2; ++call)
+    {
+        kqt_Handle_play(handle, frame_count);
+        check_unexpected_error();
+        ck_assert_msg(kqt_Handle_get_frames_available(handle) == frame_count,
+                "Wrong number of frames rendered");
+
+        const float* buf = kqt_Handle_get_audio(handle);
+        for (int i = 0; i < frame_count; ++i)
+        {
+            const long frame = (call * frame_count) + i;
+            ck_assert_msg(buf[i * 2] == 0.0f,
+                    "Expected 0.0 at frame %ld, got %.1f", frame, buf[i * 2]);
+        }
+    }
+}
+END_TEST
+
+
+START_TEST(Events_fired_at_offsets_split_rendering)
+{
+    set_mix_volume(0);
+    pause();
+    setup_debug_single_pulse();
+
+    ck_assert_msg(kqt_Handle_fire_event_at(handle, 7, 0, "[\"n+\", 0]") == 1,
+            "Firing event failed: %s", kqt_Handle_get_error(handle));
+    ck_assert_msg(kqt_Handle_fire_event_at(handle, 19, 0, "[\"n+\", 0]") == 1,
+            "Firing event failed: %s", kqt_Handle_get_error(handle));
+
+    ck_assert_msg(kqt_Handle_fire_event_at(handle, 3, 0, "[\"n+\", ]") == 0,
+            "Invalid event description was accepted");
+    kqt_Handle_clear_error(handle);
+
+    enum { frame_count = 16 };
+    for (int call = 0; call < 2; ++call)
+    {
+        kqt_Handle_play(handle, frame_count);
+        check_unexpected_error();
+        ck_assert_msg(kqt_Handle_get_frames_available(handle) == frame_count,
+                "Wrong number of frames rendered");
+
+        const float* buf = kqt_Handle_get_audio(handle);
+        for (int i = 0; i < frame_count; ++i)
+        {
+            const long frame = (call * frame_count) + i;
+            const float expected = (frame == 7 || frame == 19) ? 1.0f : 0.0f;
+            ck_assert_msg(buf[i * 2] == expected,
+                    "Expected %.1f at frame %ld, got %.1f",
+                    expected, frame, buf[i * 2]);
+        }
+    }
+}
+END_TEST
+
+
 static Suite* Handle_suite(void)
 {
     Suite* s = suite_create("Handle");
@@ -138,6 +418,8 @@ static Suite* Handle_suite(void)
             tc_empty, Empty_composition_has_zero_duration,
             0, SONG_SELECTION_COUNT);
     tcase_add_test(tc_empty, Default_audio_rate_is_correct);
+    tcase_add_test(tc_empty, Sample_streaming_settings_are_validated);
+    tcase_add_test(tc_empty, Cache_dir_can_be_set_and_cleared);
     tcase_add_loop_test(
             tc_empty, Set_audio_rate,
             0, MIXING_RATE_COUNT);
@@ -149,6 +431,12 @@ static Suite* Handle_suite(void)
     tcase_add_checked_fixture(tc_render, setup_debug_instrument, NULL);
 
     tcase_add_test(tc_render, Do_nothing);
+    tcase_add_test(tc_render, Audio_unit_render_places_notes_at_exact_frames);
+    tcase_add_test(tc_render, Shared_handle_outlives_source);
+    tcase_add_test(tc_render, Shared_handle_keeps_sample_streaming_of_module);
+    tcase_add_test(tc_render, Queued_events_are_fired_at_frame_offsets);
+    tcase_add_test(tc_render, Seeking_discards_pending_events);
+    tcase_add_test(tc_render, Events_fired_at_offsets_split_rendering);
     tcase_add_loop_test(
             tc_render, Set_audio_rate,
             0, MIXING_RATE_COUNT);
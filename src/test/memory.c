@@ -18,6 +18,7 @@
 #include <kunquat/Handle.h>
 #include <kunquat/testing.h>
 #include <memory.h>
+#include <player/Thread_arena.h>
 
 #include <stdint.h>
 #include <stdlib.h>
@@ -114,6 +115,156 @@ START_TEST(Aligned_alloc_returns_proper_base_address)
 END_TEST
 
 
+START_TEST(Thread_arena_returns_aligned_zeroed_blocks)
+{
+    kqt_fake_out_of_memory(-1);
+
+    Thread_arena* arena = new_Thread_arena(false);
+    ck_assert_msg(arena != NULL, "Could not create a Thread arena");
+
+    static const int64_t sizes[] = { 1, 100, 16396, 5000000, 64 };
+    static const int size_count = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    char* blocks[sizeof(sizes) / sizeof(sizes[0])] = { NULL };
+
+    for (int i = 0; i < size_count; ++i)
+    {
+        blocks[i] = Thread_arena_alloc(arena, sizes[i]);
+        ck_assert_msg(blocks[i] != NULL,
+                "Could not allocate %ld bytes from a Thread arena", (long)sizes[i]);
+        ck_assert_msg((intptr_t)blocks[i] % THREAD_ARENA_ALIGNMENT == 0,
+                "Incorrect alignment: got address %p", (void*)blocks[i]);
+
+        for (int64_t k = 0; k < sizes[i]; ++k)
+        {
+            ck_assert_msg(blocks[i][k] == 0,
+                    "Byte %ld of a new block of %ld bytes is not zero",
+                    (long)k, (long)sizes[i]);
+        }
+
+        memset(blocks[i], 0x55, (size_t)sizes[i]);
+    }
+
+    Thread_arena_touch(arena);
+
+    // Blocks must not overlap
+    for (int i = 0; i < size_count; ++i)
+    {
+        for (int64_t k = 0; k < sizes[i]; ++k)
+        {
+            ck_assert_msg(blocks[i][k] == 0x55,
+                    "Block %d was modified by another allocation", i);
+        }
+    }
+
+    ck_assert_msg(Thread_arena_get_reserved_size(arena) >= 5000000 + 16396,
+            "Thread arena reports too little reserved memory");
+
+    del_Thread_arena(arena);
+}
+END_TEST
+
+
+START_TEST(Thread_arena_reuses_released_blocks)
+{
+    kqt_fake_out_of_memory(-1);
+
+    Thread_arena* arena = new_Thread_arena(false);
+    ck_assert_msg(arena != NULL, "Could not create a Thread arena");
+
+    char* first = Thread_arena_alloc(arena, 4099 * 4);
+    ck_assert_msg(first != NULL, "Could not allocate from a Thread arena");
+    memset(first, 0x7f, 4099 * 4);
+
+    const int64_t reserved = Thread_arena_get_reserved_size(arena);
+
+    Thread_arena_free(arena, first, 4099 * 4);
+
+    char* second = Thread_arena_alloc(arena, 4099 * 4);
+    ck_assert_msg(second == first,
+            "Thread arena did not reuse a released block of equal size");
+    for (int k = 0; k < 4099 * 4; ++k)
+        ck_assert_msg(second[k] == 0, "Reused block is not cleared at byte %d", k);
+
+    ck_assert_msg(Thread_arena_get_reserved_size(arena) == reserved,
+            "Thread arena reserved more memory when reusing a block");
+
+    del_Thread_arena(arena);
+}
+END_TEST
+
+
+START_TEST(Thread_arena_releases_unused_memory)
+{
+    kqt_fake_out_of_memory(-1);
+
+    Thread_arena* arena = new_Thread_arena(false);
+    ck_assert_msg(arena != NULL, "Could not create a Thread arena");
+
+    char* small = Thread_arena_alloc(arena, 4096);
+    ck_assert_msg(small != NULL, "Could not allocate from a Thread arena");
+
+    const int64_t reserved = Thread_arena_get_reserved_size(arena);
+
+    // A block of this size requires a memory area of its own
+    static const int64_t large_size = 6000000;
+    char* large = Thread_arena_alloc(arena, large_size);
+    ck_assert_msg(large != NULL, "Could not allocate from a Thread arena");
+    ck_assert_msg(Thread_arena_get_reserved_size(arena) > reserved,
+            "Thread arena did not reserve memory for a large block");
+
+    Thread_arena_free(arena, large, large_size);
+    ck_assert_msg(Thread_arena_get_reserved_size(arena) == reserved,
+            "Thread arena did not release the memory of a large block"
+            KT_VALUES("%ld", (long)reserved, (long)Thread_arena_get_reserved_size(arena)));
+
+    // The last block is returned directly to the memory area
+    memset(small, 0x7f, 4096);
+    Thread_arena_free(arena, small, 4096);
+    char* other = Thread_arena_alloc(arena, 8192);
+    ck_assert_msg(other == small,
+            "Thread arena did not reuse the memory of the last released block");
+    for (int k = 0; k < 8192; ++k)
+        ck_assert_msg(other[k] == 0, "Reused memory is not cleared at byte %d", k);
+
+    del_Thread_arena(arena);
+}
+END_TEST
+
+
+START_TEST(Thread_arena_memory_is_accounted)
+{
+    kqt_fake_out_of_memory(-1);
+
+    Thread_arena* arena = new_Thread_arena(false);
+    ck_assert_msg(arena != NULL, "Could not create a Thread arena");
+
+    // Allocating the first block requires a chunk descriptor and its memory
+    const long alloc_count = kqt_get_memory_alloc_count();
+    char* block = Thread_arena_alloc(arena, 64);
+    ck_assert_msg(block != NULL, "Could not allocate from a Thread arena");
+    ck_assert_msg(kqt_get_memory_alloc_count() == alloc_count + 2,
+            "Wrong number of memory allocations"
+            KT_VALUES("%ld", alloc_count + 2, kqt_get_memory_alloc_count()));
+
+    del_Thread_arena(arena);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        arena = new_Thread_arena(false);
+        ck_assert_msg(arena != NULL, "Could not create a Thread arena");
+
+        kqt_fake_out_of_memory(i);
+        block = Thread_arena_alloc(arena, 64);
+        kqt_fake_out_of_memory(-1);
+        ck_assert_msg(block == NULL,
+                "Thread arena ignored a simulated allocation failure at step %d", i);
+
+        del_Thread_arena(arena);
+    }
+}
+END_TEST
+
+
 Suite* Memory_suite(void)
 {
     Suite* s = suite_create("Memory");
@@ -129,6 +280,10 @@ Suite* Memory_suite(void)
     suite_add_tcase(s, tc_aligned);
     tcase_set_timeout(tc_aligned, timeout);
 
+    TCase* tc_arena = tcase_create("arena");
+    suite_add_tcase(s, tc_arena);
+    tcase_set_timeout(tc_arena, timeout);
+
 #ifdef KQT_LONG_TESTS
     tcase_set_timeout(tc_oom, LONG_TIMEOUT);
     tcase_add_test(tc_oom, Out_of_memory_at_handle_creation_fails_cleanly);
@@ -136,6 +291,11 @@ Suite* Memory_suite(void)
 
     tcase_add_loop_test(tc_aligned, Aligned_alloc_returns_proper_base_address, 2, 64);
 
+    tcase_add_test(tc_arena, Thread_arena_returns_aligned_zeroed_blocks);
+    tcase_add_test(tc_arena, Thread_arena_reuses_released_blocks);
+    tcase_add_test(tc_arena, Thread_arena_releases_unused_memory);
+    tcase_add_test(tc_arena, Thread_arena_memory_is_accounted);
+
     return s;
 }
 
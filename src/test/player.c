@@ -18,6 +18,7 @@
 #include <kunquat/Handle.h>
 #include <string/Streader.h>
 
+#include <math.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -80,6 +81,51 @@ START_TEST(Note_off_stops_the_note_correctly)
 END_TEST
 
 
+START_TEST(Events_fired_by_id_match_json_events)
+{
+    set_audio_rate(220);
+    set_mix_volume(0);
+    setup_debug_instrument();
+    pause();
+
+    const int note_on_id = kqt_Handle_get_event_id(handle, "n+");
+    check_unexpected_error();
+    ck_assert_msg(note_on_id > 0, "Note On event has no identifier");
+
+    const int note_off_id = kqt_Handle_get_event_id(handle, "n-");
+    check_unexpected_error();
+    ck_assert_msg(note_off_id > 0, "Note Off event has no identifier");
+
+    ck_assert_msg(
+            kqt_Handle_get_event_id(handle, "nonexistent") == 0,
+            "Unsupported event name was given an identifier");
+    ck_assert_msg(
+            kqt_Handle_fire_event_id(handle, 0, note_on_id) == 0,
+            "Note On was fired without an argument");
+    kqt_Handle_clear_error(handle);
+
+    float actual_buf[buf_len] = { 0.0f };
+    const int note_off_frame = 20;
+
+    kqt_Handle_fire_event_id_float(handle, 0, note_on_id, -3600);
+    check_unexpected_error();
+    mix_and_fill(actual_buf, note_off_frame);
+
+    kqt_Handle_fire_event_id(handle, 0, note_off_id);
+    check_unexpected_error();
+    mix_and_fill(actual_buf + note_off_frame, buf_len - note_off_frame);
+
+    float expected_buf[buf_len] = { 0.0f };
+    float seq_on[] = { 1.0f, 0.5f, 0.5f, 0.5f };
+    int offset = repeat_seq_local(expected_buf, 5, seq_on);
+    float seq_off[] = { -1.0f, -0.5f, -0.5f, -0.5f };
+    repeat_seq_local(expected_buf + offset, 2, seq_off);
+
+    check_buffers_equal(expected_buf, actual_buf, buf_len, 0.0f);
+}
+END_TEST
+
+
 START_TEST(Note_end_is_reached_correctly_during_note_off)
 {
     set_audio_rate(440);
@@ -174,6 +220,73 @@ START_TEST(Independent_notes_mix_correctly)
 END_TEST
 
 
+START_TEST(Notes_mix_correctly_after_thread_count_changes)
+{
+    set_audio_rate(220);
+    set_mix_volume(0);
+    setup_debug_instrument();
+    pause();
+
+    static const int thread_counts[] = { 4, 2, 3 };
+    for (int i = 0; i < (int)(sizeof(thread_counts) / sizeof(thread_counts[0])); ++i)
+    {
+        kqt_Handle_set_player_thread_count(handle, thread_counts[i]);
+        check_unexpected_error();
+    }
+
+    float actual_buf[buf_len] = { 0.0f };
+    const int note_2_frame = 2;
+
+    kqt_Handle_fire_event(handle, 0, Note_On_55_Hz);
+    check_unexpected_error();
+    mix_and_fill(actual_buf, note_2_frame);
+
+    kqt_Handle_fire_event(handle, 1, Note_On_55_Hz);
+    check_unexpected_error();
+    mix_and_fill(actual_buf + note_2_frame, buf_len - note_2_frame);
+
+    float expected_buf[buf_len] = { 0.0f };
+    float single_seq[] = { 1.0f, 0.5f, 0.5f, 0.5f };
+    repeat_seq_local(expected_buf, 10, single_seq);
+    for (int i = 40; i >= 0; --i)
+        expected_buf[i + note_2_frame] += expected_buf[i];
+
+    check_buffers_equal(expected_buf, actual_buf, buf_len, 0.0f);
+}
+END_TEST
+
+
+START_TEST(Notes_on_many_channels_mix_correctly_with_threads)
+{
+    set_audio_rate(220);
+    set_mix_volume(0);
+    setup_debug_instrument();
+    pause();
+
+    kqt_Handle_set_player_thread_count(handle, 4);
+    check_unexpected_error();
+
+    const int note_count = 8;
+    for (int ch = 0; ch < note_count; ++ch)
+    {
+        kqt_Handle_fire_event(handle, ch, Note_On_55_Hz);
+        check_unexpected_error();
+    }
+
+    float actual_buf[buf_len] = { 0.0f };
+    mix_and_fill(actual_buf, buf_len);
+
+    float expected_buf[buf_len] = { 0.0f };
+    float single_seq[] = { 1.0f, 0.5f, 0.5f, 0.5f };
+    repeat_seq_local(expected_buf, 10, single_seq);
+    for (int i = 0; i < buf_len; ++i)
+        expected_buf[i] *= (float)note_count;
+
+    check_buffers_equal(expected_buf, actual_buf, buf_len, 0.0f);
+}
+END_TEST
+
+
 START_TEST(Debug_single_shot_renders_one_pulse)
 {
     set_mix_volume(0);
@@ -841,6 +954,367 @@ START_TEST(Jump_backwards_creates_a_loop)
 END_TEST
 
 
+static void setup_tempo_change_and_jump(int tempo)
+{
+    set_data("album/p_manifest.json", "[0, {}]");
+    set_data("album/p_tracks.json", "[0, [0]]");
+    set_data("song_00/p_manifest.json", "[0, {}]");
+    set_data("song_00/p_order_list.json", "[0, [ [0, 0] ]]");
+    set_data("pat_000/p_manifest.json", "[0, {}]");
+    set_data("pat_000/p_length.json", "[0, [4, 0]]");
+    set_data("pat_000/instance_000/p_manifest.json", "[0, {}]");
+
+    // Dense note rows that do not affect the duration
+    char notes[4096] = "[0, [";
+    for (int i = 0; i < 64; ++i)
+    {
+        char row[64] = "";
+        snprintf(row, sizeof(row),
+                "%s[[%d, %ld], [\"n+\", \"0\"]]",
+                (i > 0) ? ", " : "",
+                i / 16,
+                (long)(i % 16) * (KQT_TSTAMP_BEAT / 16));
+        strcat(notes, row);
+    }
+    strcat(notes, "]]");
+    set_data("pat_000/col_00/p_triggers.json", notes);
+
+    char triggers[256] = "";
+    snprintf(triggers, sizeof(triggers),
+            "[0,"
+            "[ [[1, 0], [\"m.t\", \"%d\"]],"
+            "  [[2, 0], [\"m.jc\", \"1\"]],"
+            "  [[2, 0], [\"mj\", null]] ]"
+            "]",
+            tempo);
+    set_data("pat_000/col_01/p_triggers.json", triggers);
+
+    validate();
+
+    return;
+}
+
+
+START_TEST(Duration_follows_tempo_and_jumps_between_note_rows)
+{
+    int tempos[] = { 30, 60, 120, 240, 0 }; // 0 is guard, shouldn't be used
+
+    setup_tempo_change_and_jump(tempos[_i]);
+
+    const long long dur = kqt_Handle_get_duration(handle, 0);
+    check_unexpected_error();
+
+    // One beat in the initial tempo of 120, five beats in the new tempo
+    const long long expected = 500000000LL + 5LL * 60000000000LL / tempos[_i];
+    ck_assert_msg(llabs(dur - expected) < 1000,
+            "Wrong duration"
+            KT_VALUES("%lld", expected, dur));
+}
+END_TEST
+
+
+void setup_tempo_change_from_bind_source(void)
+{
+    set_data("album/p_manifest.json", "[0, {}]");
+    set_data("album/p_tracks.json", "[0, [0]]");
+    set_data("song_00/p_manifest.json", "[0, {}]");
+    set_data("song_00/p_order_list.json", "[0, [ [0, 0] ]]");
+    set_data("pat_000/p_manifest.json", "[0, {}]");
+    set_data("pat_000/p_length.json", "[0, [4, 0]]");
+    set_data("pat_000/instance_000/p_manifest.json", "[0, {}]");
+
+    // A row with only a channel event
+    set_data("pat_000/col_00/p_triggers.json",
+            "[0, [ [[1, 0], [\"n+\", \"0\"]] ]]");
+
+    validate();
+
+    return;
+}
+
+
+void setup_tempo_change_from_bind(int tempo)
+{
+    setup_tempo_change_from_bind_source();
+
+    // Bind the channel event to a tempo change
+    char bind[128] = "";
+    snprintf(bind, sizeof(bind),
+            "[0, [[\"n+\", [], [[0, [\"m.t\", \"%d\"]]]]]]",
+            tempo);
+    set_data("p_bind.json", bind);
+
+    validate();
+
+    return;
+}
+
+
+START_TEST(Duration_follows_tempo_changes_fired_by_bind)
+{
+    int tempos[] = { 30, 60, 120, 240, 0 }; // 0 is guard, shouldn't be used
+
+    setup_tempo_change_from_bind(tempos[_i]);
+
+    const long long dur = kqt_Handle_get_duration(handle, 0);
+    check_unexpected_error();
+
+    // One beat in the initial tempo of 120, three beats in the bound tempo
+    const long long expected = 500000000LL + 3LL * 60000000000LL / tempos[_i];
+    ck_assert_msg(llabs(dur - expected) < 1000,
+            "Wrong duration"
+            KT_VALUES("%lld", expected, dur));
+}
+END_TEST
+
+
+START_TEST(Seeking_follows_tempo_change_fired_by_bind)
+{
+    set_audio_rate(mixing_rates[MIXING_RATE_LOW]);
+    setup_tempo_change_from_bind(60);
+
+    // Skip past the bound note and half a beat in the bound tempo
+    static const long long second = 1000000000LL;
+    kqt_Handle_set_position(handle, 0, second);
+    check_unexpected_error();
+
+    // One and a half beats remain at the original tempo, and 2.5 seconds
+    // remain at the bound tempo
+    const long expected = mixing_rates[MIXING_RATE_LOW] * 5 / 2;
+    long rendered = 0;
+    while (!kqt_Handle_has_stopped(handle) && (rendered < expected * 2))
+    {
+        kqt_Handle_play(handle, buf_len);
+        check_unexpected_error();
+        rendered += kqt_Handle_get_frames_available(handle);
+    }
+
+    ck_assert_msg(labs(rendered - expected) <= 1,
+            "Wrong playback length after seeking"
+            KT_VALUES("%ld", expected, rendered));
+}
+END_TEST
+
+
+static void render_noise_after_seek(float* buf, long nframes, bool use_bind)
+{
+    assert(buf != NULL);
+    assert(nframes > 0);
+
+    set_audio_rate(mixing_rates[MIXING_RATE_LOW]);
+    set_mix_volume(0);
+
+    set_data("p_dc_blocker_enabled.json", "[0, false]");
+    set_data("out_00/p_manifest.json", "[0, {}]");
+    set_data("p_connections.json", "[0, [ [\"au_00/out_00\", \"out_00\"] ]]");
+
+    set_data("p_control_map.json", "[0, [[0, 0]]]");
+    set_data("control_00/p_manifest.json", "[0, {}]");
+
+    set_data("au_00/p_manifest.json", "[0, { \"type\": \"instrument\" }]");
+    set_data("au_00/out_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/p_connections.json",
+            "[0,"
+            "[ [\"proc_00/C/out_00\", \"out_00\"]"
+            ", [\"proc_01/C/out_00\", \"proc_00/C/in_00\"]"
+            "]"
+            "]");
+
+    set_data("au_00/proc_00/p_manifest.json", "[0, { \"type\": \"noise\" }]");
+    set_data("au_00/proc_00/p_signal_type.json", "[0, \"voice\"]");
+    set_data("au_00/proc_00/in_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/proc_00/out_00/p_manifest.json", "[0, {}]");
+
+    // The noise is scaled by the force of the voice
+    set_data("au_00/proc_01/p_manifest.json", "[0, { \"type\": \"force\" }]");
+    set_data("au_00/proc_01/p_signal_type.json", "[0, \"voice\"]");
+    set_data("au_00/proc_01/out_00/p_manifest.json", "[0, {}]");
+
+    // Bind the note to a tempo change that does not alter playback
+    if (use_bind)
+        setup_tempo_change_from_bind(120);
+    else
+        setup_tempo_change_from_bind_source();
+
+    static const long long second = 1000000000LL;
+    kqt_Handle_set_position(handle, 0, second);
+    check_unexpected_error();
+
+    kqt_Handle_fire_event(handle, 0, "[\"n+\", 0]");
+    check_unexpected_error();
+
+    mix_and_fill(buf, nframes);
+
+    return;
+}
+
+
+START_TEST(Seeking_past_bound_note_does_not_play_the_note)
+{
+    float expected_buf[buf_len] = { 0.0f };
+    render_noise_after_seek(expected_buf, buf_len, false);
+
+    bool is_silent = true;
+    for (long i = 0; i < buf_len; ++i)
+    {
+        if (expected_buf[i] != 0)
+        {
+            is_silent = false;
+            break;
+        }
+    }
+    ck_assert_msg(!is_silent, "Fired note did not produce any noise");
+
+    handle_teardown();
+    setup_empty();
+
+    float actual_buf[buf_len] = { 0.0f };
+    render_noise_after_seek(actual_buf, buf_len, true);
+
+    check_buffers_equal(expected_buf, actual_buf, buf_len, 0.0f);
+}
+END_TEST
+
+
+START_TEST(Timeline_maps_first_visits_of_positions_to_times)
+{
+    int tempos[] = { 30, 60, 120, 240, 0 }; // 0 is guard, shouldn't be used
+
+    setup_tempo_change_and_jump(tempos[_i]);
+
+    const long long beat_ns = 60000000000LL / tempos[_i];
+
+    const struct
+    {
+        int system;
+        long long beats;
+        long rem;
+        long long expected;
+    } positions[] =
+    {
+        { 0, 0, 0,                      0 },
+        { 0, 0, KQT_TSTAMP_BEAT / 2,    250000000LL },
+        { 0, 1, 0,                      500000000LL },
+        { 0, 1, KQT_TSTAMP_BEAT / 2,    500000000LL + beat_ns / 2 },
+        // Rows after the jump are first played in the second round
+        { 0, 2, 0,                      500000000LL + 3 * beat_ns },
+        { 0, 3, KQT_TSTAMP_BEAT / 4,    500000000LL + 4 * beat_ns + beat_ns / 4 },
+        // Positions that are never played
+        { 0, 4, 0,                      -1 },
+        { 1, 0, 0,                      -1 },
+    };
+
+    for (size_t i = 0; i < sizeof(positions) / sizeof(*positions); ++i)
+    {
+        const long long actual = kqt_Handle_get_time_at_position(
+                handle,
+                0,
+                positions[i].system,
+                positions[i].beats,
+                positions[i].rem);
+        check_unexpected_error();
+
+        const long long expected = positions[i].expected;
+        if (expected < 0)
+            ck_assert_msg(actual == -1,
+                    "Unexpected time for an unplayed position"
+                    KT_VALUES("%lld", expected, actual));
+        else
+            ck_assert_msg(llabs(actual - expected) < 1000,
+                    "Wrong time at position %d, %lld, %ld"
+                    "\n    Expected: %lld"
+                    "\n      Actual: %lld",
+                    positions[i].system,
+                    positions[i].beats,
+                    positions[i].rem,
+                    expected,
+                    actual);
+    }
+
+    // Half a beat after the jump back to the start of the pattern
+    int system = -1;
+    long long beats = -1;
+    long rem = -1;
+    const int found = kqt_Handle_get_position_at_time(
+            handle, 0, 500000000LL + beat_ns + beat_ns / 2, &system, &beats, &rem);
+    check_unexpected_error();
+    ck_assert_msg(found == 1, "Position was not found after the jump");
+    ck_assert_msg(system == 0,
+            "Wrong system after the jump"
+            KT_VALUES("%d", 0, system));
+    ck_assert_msg(beats == 0,
+            "Wrong beat after the jump"
+            KT_VALUES("%lld", 0LL, beats));
+    ck_assert_msg(labs(rem - KQT_TSTAMP_BEAT / 2) < KQT_TSTAMP_BEAT / 1000,
+            "Wrong beat remainder after the jump"
+            KT_VALUES("%ld", (long)KQT_TSTAMP_BEAT / 2, rem));
+
+    const long long dur = kqt_Handle_get_duration(handle, 0);
+    check_unexpected_error();
+    ck_assert_msg(kqt_Handle_get_position_at_time(
+                handle, 0, dur, &system, &beats, &rem) == 0,
+            "Position was found at the end of the track");
+    check_unexpected_error();
+}
+END_TEST
+
+
+START_TEST(Timeline_follows_tempo_changes_fired_by_bind)
+{
+    int tempos[] = { 30, 60, 120, 240, 0 }; // 0 is guard, shouldn't be used
+
+    setup_tempo_change_from_bind(tempos[_i]);
+
+    const long long beat_ns = 60000000000LL / tempos[_i];
+
+    const struct
+    {
+        long long beats;
+        long rem;
+        long long expected;
+    } positions[] =
+    {
+        { 0, KQT_TSTAMP_BEAT / 2,    250000000LL },
+        { 1, 0,                      500000000LL },
+        { 2, 0,                      500000000LL + beat_ns },
+        { 3, KQT_TSTAMP_BEAT / 2,    500000000LL + 2 * beat_ns + beat_ns / 2 },
+    };
+
+    for (size_t i = 0; i < sizeof(positions) / sizeof(*positions); ++i)
+    {
+        const long long actual = kqt_Handle_get_time_at_position(
+                handle, 0, 0, positions[i].beats, positions[i].rem);
+        check_unexpected_error();
+
+        const long long expected = positions[i].expected;
+        ck_assert_msg(llabs(actual - expected) < 1000,
+                "Wrong time at position %lld, %ld"
+                "\n    Expected: %lld"
+                "\n      Actual: %lld",
+                positions[i].beats,
+                positions[i].rem,
+                expected,
+                actual);
+    }
+
+    // Half a beat after the bound tempo change
+    int system = -1;
+    long long beats = -1;
+    long rem = -1;
+    const int found = kqt_Handle_get_position_at_time(
+            handle, 0, 500000000LL + beat_ns / 2, &system, &beats, &rem);
+    check_unexpected_error();
+    ck_assert_msg(found == 1, "Position was not found after the tempo change");
+    ck_assert_msg(beats == 1,
+            "Wrong beat after the tempo change"
+            KT_VALUES("%lld", 1LL, beats));
+    ck_assert_msg(labs(rem - KQT_TSTAMP_BEAT / 2) < KQT_TSTAMP_BEAT / 1000,
+            "Wrong beat remainder after the tempo change"
+            KT_VALUES("%ld", (long)KQT_TSTAMP_BEAT / 2, rem));
+}
+END_TEST
+
+
 START_TEST(Events_appear_in_event_buffer)
 {
     setup_debug_instrument();
@@ -1028,6 +1502,103 @@ START_TEST(Events_from_many_triggers_are_skipped_by_fire)
 END_TEST
 
 
+typedef struct Expected_args
+{
+    int count;
+    const double* values;
+} Expected_args;
+
+
+bool read_received_vs_events(Streader* sr, int32_t index, void* userdata)
+{
+    assert(sr != NULL);
+    (void)index;
+    assert(userdata != NULL);
+
+    Expected_args* expected = userdata;
+    double actual = NAN;
+
+    if (!(Streader_readf(sr, "[0, [") &&
+                Streader_match_string(sr, "vs") &&
+                Streader_readf(sr, ", %f]]", &actual))
+       )
+        return false;
+
+    if (expected->count <= 0)
+    {
+        Streader_set_error(sr, "Received unexpected argument %f", actual);
+        return false;
+    }
+
+    if (fabs(actual - expected->values[0]) > 0.0001)
+    {
+        Streader_set_error(
+                sr,
+                "Received argument %f instead of %f",
+                actual, expected->values[0]);
+        return false;
+    }
+
+    --expected->count;
+    ++expected->values;
+
+    return true;
+}
+
+
+START_TEST(Constant_and_evaluated_trigger_arguments_are_fired_in_order)
+{
+    set_audio_rate(mixing_rates[MIXING_RATE_LOW]);
+
+    set_data("album/p_manifest.json", "[0, {}]");
+    set_data("album/p_tracks.json", "[0, [0]]");
+    set_data("song_00/p_manifest.json", "[0, {}]");
+    set_data("song_00/p_order_list.json", "[0, [ [0, 0] ]]");
+    set_data("pat_000/p_manifest.json", "[0, {}]");
+    set_data("pat_000/p_length.json", "[0, [4, 0]]");
+    set_data("pat_000/instance_000/p_manifest.json", "[0, {}]");
+
+    // Mix constant and evaluated arguments, and store the rows out of order
+    set_data("pat_000/col_00/p_triggers.json",
+            "[0, ["
+            "[[1, 0], [\"vs\", \"2 + 3\"]], "
+            "[[1, 0], [\"vs\", \"7\"]], "
+            "[[0, 0], [\"vs\", \"1\"]], "
+            "[[0, 0], [\"vs\", \"2 * 2\"]], "
+            "[[2, 0], [\"vs\", \"-0.5\"]], "
+            "[[2, 0], [\"vs\", \"8 - 1.5\"]], "
+            "[[1, 0], [\"vs\", \"9\"]] "
+            "] ]");
+
+    validate();
+    check_unexpected_error();
+
+    const double expected_values[] = { 1, 4, 5, 7, 9, -0.5, 6.5 };
+    Expected_args expected =
+    {
+        .count = (int)(sizeof(expected_values) / sizeof(expected_values[0])),
+        .values = expected_values,
+    };
+
+    while (!kqt_Handle_has_stopped(handle))
+    {
+        kqt_Handle_play(handle, buf_len);
+        check_unexpected_error();
+
+        const char* events = kqt_Handle_receive_events(handle);
+        Streader* sr = Streader_init(STREADER_AUTO, events, (int64_t)strlen(events));
+        ck_assert_msg(Streader_read_list(sr, read_received_vs_events, &expected),
+                "Event list reading failed: %s",
+                Streader_get_error_desc(sr));
+    }
+
+    ck_assert_msg(expected.count == 0,
+            "%d expected events were not received",
+            expected.count);
+}
+END_TEST
+
+
 void setup_complex_bind(int event_count)
 {
     char* bind = malloc(sizeof(char) * 65536);
@@ -1280,6 +1851,105 @@ START_TEST(Query_final_location)
 END_TEST
 
 
+START_TEST(Binary_events_match_json_events)
+{
+    set_audio_rate(220);
+    pause();
+
+    long size = 0;
+
+    kqt_Handle_fire_event(handle, 3, Note_On_55_Hz);
+    check_unexpected_error();
+
+    const unsigned char* note_on = kqt_Handle_receive_events_binary(handle, &size);
+    check_unexpected_error();
+    ck_assert_msg(note_on != NULL, "No binary event data returned");
+    ck_assert_msg(size == 4 + 2 + 8,
+            "Note On data size is %ld instead of %d", size, 4 + 2 + 8);
+    ck_assert_msg(note_on[0] == 3, "Note On channel is %d", (int)note_on[0]);
+    ck_assert_msg(note_on[1] == KQT_EVENT_ARG_FLOAT,
+            "Note On argument type is %d", (int)note_on[1]);
+    ck_assert_msg((note_on[2] == 2) && (memcmp(note_on + 4, "n+", 2) == 0),
+            "Unexpected Note On event name");
+    ck_assert_msg(note_on[3] == sizeof(double),
+            "Note On argument size is %d", (int)note_on[3]);
+    double pitch = 0;
+    memcpy(&pitch, note_on + 6, sizeof(double));
+    ck_assert_msg(pitch == -3600, "Note On pitch is %f instead of -3600", pitch);
+
+    kqt_Handle_receive_events_binary(handle, &size);
+    check_unexpected_error();
+    ck_assert_msg(size == 0, "Received %ld bytes of extra event data", size);
+
+    kqt_Handle_fire_event(handle, 5, "[\"c.evn\", \"var\"]");
+    check_unexpected_error();
+
+    const unsigned char* set_name = kqt_Handle_receive_events_binary(handle, &size);
+    check_unexpected_error();
+    ck_assert_msg(size == 4 + 5 + 3,
+            "Variable name data size is %ld instead of %d", size, 4 + 5 + 3);
+    ck_assert_msg(set_name[0] == 5, "Variable name channel is %d", (int)set_name[0]);
+    ck_assert_msg(set_name[1] == KQT_EVENT_ARG_STRING,
+            "Variable name argument type is %d", (int)set_name[1]);
+    ck_assert_msg((set_name[2] == 5) && (memcmp(set_name + 4, "c.evn", 5) == 0),
+            "Unexpected variable name event name");
+    ck_assert_msg((set_name[3] == 3) && (memcmp(set_name + 9, "var", 3) == 0),
+            "Unexpected variable name argument");
+}
+END_TEST
+
+
+START_TEST(Cpu_budget_outside_valid_range_is_rejected)
+{
+    static const double invalid_budgets[] = { -0.1, 1.5, NAN };
+    for (int i = 0; i < (int)(sizeof(invalid_budgets) / sizeof(invalid_budgets[0])); ++i)
+    {
+        ck_assert_msg(kqt_Handle_set_cpu_budget(handle, invalid_budgets[i]) == 0,
+                "CPU budget %f was accepted", invalid_budgets[i]);
+        ck_assert_msg(strcmp(kqt_Handle_get_error(handle), "") != 0,
+                "No error was set for CPU budget %f", invalid_budgets[i]);
+        kqt_Handle_clear_error(handle);
+    }
+
+    ck_assert_msg(kqt_Handle_set_cpu_budget(handle, 0.5) == 1,
+            "Valid CPU budget was rejected");
+    ck_assert_msg(kqt_Handle_set_cpu_budget(handle, 0) == 1,
+            "Disabling the CPU budget failed");
+}
+END_TEST
+
+
+START_TEST(Exceeding_cpu_budget_reduces_polyphony_and_steals_voices)
+{
+    set_audio_rate(220);
+    setup_debug_instrument();
+    pause();
+
+    // No rendering can fit in this budget
+    kqt_Handle_set_cpu_budget(handle, 1e-12);
+    check_unexpected_error();
+
+    kqt_Handle_fire_event(handle, 0, Note_On_55_Hz);
+    kqt_Handle_play(handle, 1);
+    check_unexpected_error();
+
+    const char* events = kqt_Handle_receive_events(handle);
+
+    static const char* expected_parts[] =
+    {
+        "[0, [\"Aoverload\", ",
+        "[0, [\"Apolyphony\", 1]]",
+        "[0, [\"Avsteal\", 1]]",
+    };
+    for (int i = 0; i < (int)(sizeof(expected_parts) / sizeof(expected_parts[0])); ++i)
+    {
+        ck_assert_msg(strstr(events, expected_parts[i]) != NULL,
+                "Event list %s does not contain %s", events, expected_parts[i]);
+    }
+}
+END_TEST
+
+
 START_TEST(Query_voice_count_with_silence)
 {
     set_audio_rate(220);
@@ -1384,6 +2054,148 @@ START_TEST(Query_note_force)
 END_TEST
 
 
+static void render_force_slide(float* buf, long nframes, int control_period)
+{
+    assert(buf != NULL);
+    assert(nframes > 0);
+    assert(control_period >= 1);
+
+    set_audio_rate(1000);
+    set_mix_volume(0);
+    pause();
+
+    set_data("p_dc_blocker_enabled.json", "[0, false]");
+
+    char period_data[32] = "";
+    snprintf(period_data, 32, "[0, %d]", control_period);
+    set_data("p_control_period.json", period_data);
+
+    set_data("out_00/p_manifest.json", "[0, {}]");
+    set_data("p_connections.json", "[0, [ [\"au_00/out_00\", \"out_00\"] ]]");
+
+    set_data("p_control_map.json", "[0, [[0, 0]]]");
+    set_data("control_00/p_manifest.json", "[0, {}]");
+
+    set_data("au_00/p_manifest.json", "[0, { \"type\": \"instrument\" }]");
+    set_data("au_00/out_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/p_connections.json",
+            "[0, [ [\"proc_00/C/out_00\", \"out_00\"] ]]");
+
+    set_data("au_00/proc_00/p_manifest.json", "[0, { \"type\": \"force\" }]");
+    set_data("au_00/proc_00/p_signal_type.json", "[0, \"voice\"]");
+    set_data("au_00/proc_00/out_00/p_manifest.json", "[0, {}]");
+
+    validate();
+
+    kqt_Handle_fire_event(handle, 0, "[\"n+\", 0]");
+    check_unexpected_error();
+    kqt_Handle_fire_event(handle, 0, "[\"/=f\", [1, 0]]");
+    check_unexpected_error();
+    kqt_Handle_fire_event(handle, 0, "[\"/f\", -24]");
+    check_unexpected_error();
+
+    mix_and_fill(buf, nframes);
+
+    return;
+}
+
+
+START_TEST(Force_slide_with_control_period_matches_audio_rate)
+{
+    float expected_buf[buf_len * 4] = { 0.0f };
+    render_force_slide(expected_buf, buf_len * 4, 1);
+
+    handle_teardown();
+    setup_empty();
+
+    float actual_buf[buf_len * 4] = { 0.0f };
+    render_force_slide(actual_buf, buf_len * 4, 32);
+
+    check_buffers_equal(expected_buf, actual_buf, buf_len * 4, 0.0001f);
+}
+END_TEST
+
+
+START_TEST(Force_slide_output_is_linear_in_dB)
+{
+    float actual_buf[buf_len * 4] = { 0.0f };
+    render_force_slide(actual_buf, buf_len * 4, 1);
+
+    // The slide from 0 dB to -24 dB takes one beat, i.e. 500 frames
+    float expected_buf[buf_len * 4] = { 0.0f };
+    for (int i = 0; i < buf_len * 4; ++i)
+        expected_buf[i] = (i < 500) ? (float)(-24.0 * (i + 1) / 500.0) : -24.0f;
+
+    check_buffers_equal(expected_buf, actual_buf, buf_len * 4, 0.0001f);
+}
+END_TEST
+
+
+START_TEST(Panning_slide_from_stream_is_linear)
+{
+    set_audio_rate(1000);
+    set_mix_volume(0);
+    pause();
+
+    set_data("p_dc_blocker_enabled.json", "[0, false]");
+
+    set_data("out_00/p_manifest.json", "[0, {}]");
+    set_data("p_connections.json", "[0, [ [\"au_00/out_00\", \"out_00\"] ]]");
+
+    set_data("p_control_map.json", "[0, [[0, 0]]]");
+    set_data("control_00/p_manifest.json", "[0, {}]");
+
+    set_data("au_00/p_manifest.json", "[0, { \"type\": \"instrument\" }]");
+    set_data("au_00/out_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/p_streams.json", "[0, [ [\"pan\", 1] ]]");
+    set_data("au_00/p_connections.json",
+            "[0,"
+            "[ [\"proc_00/C/out_00\", \"proc_02/C/in_00\"]"
+            ", [\"proc_01/C/out_00\", \"proc_02/C/in_02\"]"
+            ", [\"proc_02/C/out_00\", \"out_00\"]"
+            "]"
+            "]");
+
+    // Constant input signal
+    set_data("au_00/proc_00/p_manifest.json", "[0, { \"type\": \"stream\" }]");
+    set_data("au_00/proc_00/p_signal_type.json", "[0, \"mixed\"]");
+    set_data("au_00/proc_00/out_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/proc_00/c/p_f_init_value.json", "[0, 1]");
+
+    set_data("au_00/proc_01/p_manifest.json", "[0, { \"type\": \"stream\" }]");
+    set_data("au_00/proc_01/p_signal_type.json", "[0, \"mixed\"]");
+    set_data("au_00/proc_01/out_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/proc_01/c/p_f_init_value.json", "[0, -1]");
+
+    set_data("au_00/proc_02/p_manifest.json", "[0, { \"type\": \"panning\" }]");
+    set_data("au_00/proc_02/p_signal_type.json", "[0, \"mixed\"]");
+    set_data("au_00/proc_02/in_00/p_manifest.json", "[0, {}]");
+    set_data("au_00/proc_02/in_01/p_manifest.json", "[0, {}]");
+    set_data("au_00/proc_02/in_02/p_manifest.json", "[0, {}]");
+    set_data("au_00/proc_02/out_00/p_manifest.json", "[0, {}]");
+
+    validate();
+
+    kqt_Handle_fire_event(handle, 0, "[\".sn\", \"pan\"]");
+    check_unexpected_error();
+    kqt_Handle_fire_event(handle, 0, "[\"a/=s\", [1, 0]]");
+    check_unexpected_error();
+    kqt_Handle_fire_event(handle, 0, "[\"a/s\", 1]");
+    check_unexpected_error();
+
+    float actual_buf[buf_len * 4] = { 0.0f };
+    mix_and_fill(actual_buf, buf_len * 4);
+
+    // The slide from full left to full right takes one beat, i.e. 500 frames
+    float expected_buf[buf_len * 4] = { 0.0f };
+    for (int i = 0; i < buf_len * 4; ++i)
+        expected_buf[i] = (i < 500) ? (float)(2.0 - 2.0 * (i + 1) / 500.0) : 0.0f;
+
+    check_buffers_equal(expected_buf, actual_buf, buf_len * 4, 0.0001f);
+}
+END_TEST
+
+
 static Suite* Player_suite(void)
 {
     Suite* s = suite_create("Player");
@@ -1407,10 +2219,16 @@ static Suite* Player_suite(void)
     // Note mixing
     tcase_add_test(tc_notes, Complete_debug_note_renders_correctly);
     tcase_add_test(tc_notes, Note_off_stops_the_note_correctly);
+    tcase_add_test(tc_notes, Events_fired_by_id_match_json_events);
     tcase_add_test(tc_notes, Note_end_is_reached_correctly_during_note_off);
     tcase_add_test(tc_notes, Implicit_note_off_is_triggered_correctly);
     tcase_add_test(tc_notes, Independent_notes_mix_correctly);
+    tcase_add_test(tc_notes, Notes_mix_correctly_after_thread_count_changes);
+    tcase_add_test(tc_notes, Notes_on_many_channels_mix_correctly_with_threads);
     tcase_add_test(tc_notes, Debug_single_shot_renders_one_pulse);
+    tcase_add_test(tc_notes, Force_slide_with_control_period_matches_audio_rate);
+    tcase_add_test(tc_notes, Force_slide_output_is_linear_in_dB);
+    tcase_add_test(tc_notes, Panning_slide_from_stream_is_linear);
 
     // Patterns
     tcase_add_loop_test(
@@ -1442,6 +2260,20 @@ static Suite* Player_suite(void)
     tcase_add_loop_test(
             tc_events, Tempo_slide_affects_playback_cursor,
             0, 4);
+    tcase_add_loop_test(
+            tc_events, Duration_follows_tempo_and_jumps_between_note_rows,
+            0, 4);
+    tcase_add_loop_test(
+            tc_events, Duration_follows_tempo_changes_fired_by_bind,
+            0, 4);
+    tcase_add_test(tc_events, Seeking_follows_tempo_change_fired_by_bind);
+    tcase_add_test(tc_events, Seeking_past_bound_note_does_not_play_the_note);
+    tcase_add_loop_test(
+            tc_events, Timeline_maps_first_visits_of_positions_to_times,
+            0, 4);
+    tcase_add_loop_test(
+            tc_events, Timeline_follows_tempo_changes_fired_by_bind,
+            0, 4);
     tcase_add_loop_test(
             tc_events, Jump_backwards_creates_a_loop,
             0, 4);
@@ -1452,6 +2284,9 @@ static Suite* Player_suite(void)
     tcase_add_test(
             tc_events,
             Events_from_many_triggers_are_skipped_by_fire);
+    tcase_add_test(
+            tc_events,
+            Constant_and_evaluated_trigger_arguments_are_fired_in_order);
     tcase_add_test(
             tc_events,
             Events_from_complex_bind_can_be_retrieved_with_multiple_receives);
@@ -1460,6 +2295,10 @@ static Suite* Player_suite(void)
             Fire_with_complex_bind_can_be_processed_with_multiple_receives);
     tcase_add_test(tc_events, Query_initial_location);
     tcase_add_test(tc_events, Query_final_location);
+    tcase_add_test(tc_events, Binary_events_match_json_events);
+    tcase_add_test(tc_events, Cpu_budget_outside_valid_range_is_rejected);
+    tcase_add_test(
+            tc_events, Exceeding_cpu_budget_reduces_polyphony_and_steals_voices);
     tcase_add_test(tc_events, Query_voice_count_with_silence);
     tcase_add_test(tc_events, Query_voice_count_with_note);
     tcase_add_test(tc_events, Query_note_force);
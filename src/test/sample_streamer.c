@@ -0,0 +1,675 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <test_common.h>
+
+#include <Error.h>
+#include <init/devices/param_types/Sample.h>
+#include <init/devices/param_types/Sample_params.h>
+#include <init/Sample_streamer.h>
+#include <kunquat/limits.h>
+#include <mathnum/common.h>
+#include <memory.h>
+#include <player/devices/processors/Sample_stream_render.h>
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+#define PRELOAD_LEN 1000
+#define SAMPLE_LEN (PRELOAD_LEN + 3 * SAMPLE_STREAMER_RING_LEN + 321)
+#define RING_MASK (SAMPLE_STREAMER_RING_LEN - 1)
+#define WAIT_TRIES_MAX 100000
+#define RENDER_LEN 701
+
+
+static Sample_streamer* streamer = NULL;
+static Sample* sample = NULL;
+
+
+static int16_t get_value(int ch, int64_t frame)
+{
+    return (int16_t)(((frame * 3 + ch * 12345) % 60000) - 30000);
+}
+
+
+static float get_expected(int ch, int64_t frame)
+{
+    return (float)(get_value(ch, frame) * (1.0 / 0x8000UL));
+}
+
+
+void setup_streamer(void)
+{
+    assert(streamer == NULL);
+    assert(sample == NULL);
+
+    Error* error = ERROR_AUTO;
+    streamer = new_Sample_streamer(PRELOAD_LEN, NULL, error);
+    ck_assert_msg(streamer != NULL,
+            "Could not create Sample streamer: %s", Error_get_desc(error));
+
+    sample = new_Sample();
+    ck_assert_msg(sample != NULL, "Could not allocate memory for Sample");
+    sample->channels = 2;
+    sample->bits = 16;
+    sample->is_float = false;
+    sample->len = SAMPLE_LEN;
+
+    Sample_streamer_reserve(streamer, sample);
+    ck_assert_msg(sample->streamer == streamer,
+            "Sample longer than the preload length was not streamed");
+    ck_assert_msg(Sample_get_resident_len(sample) == PRELOAD_LEN,
+            "Wrong resident length"
+            KT_VALUES("%lld", (long long)PRELOAD_LEN,
+                (long long)Sample_get_resident_len(sample)));
+
+    int16_t* frames = malloc(sizeof(int16_t) * SAMPLE_LEN);
+    ck_assert_msg(frames != NULL, "Could not allocate memory for test frames");
+
+    for (int ch = 0; ch < sample->channels; ++ch)
+    {
+        for (int64_t i = 0; i < SAMPLE_LEN; ++i)
+            frames[i] = get_value(ch, i);
+
+        int16_t* resident = memory_alloc_items(int16_t, PRELOAD_LEN);
+        ck_assert_msg(resident != NULL, "Could not allocate memory for Sample data");
+        for (int64_t i = 0; i < PRELOAD_LEN; ++i)
+            resident[i] = frames[i];
+        sample->data[ch] = resident;
+
+        ck_assert_msg(Sample_streamer_write(
+                    streamer,
+                    sample,
+                    ch,
+                    PRELOAD_LEN,
+                    SAMPLE_LEN - PRELOAD_LEN,
+                    frames + PRELOAD_LEN,
+                    error),
+                "Could not write to the sample cache: %s",
+                Error_get_desc(error));
+    }
+
+    free(frames);
+
+    return;
+}
+
+
+void teardown_streamer(void)
+{
+    del_Sample(sample);
+    sample = NULL;
+    del_Sample_streamer(streamer);
+    streamer = NULL;
+
+    return;
+}
+
+
+static void wait_a_moment(void)
+{
+#ifdef ENABLE_THREADS
+    const struct timespec delay = { .tv_sec = 0, .tv_nsec = 100000 };
+    nanosleep(&delay, NULL);
+#endif
+
+    return;
+}
+
+
+static bool wait_for_frames(int stream, int gen, int64_t stop, Sample_stream_view* view)
+{
+    assert(view != NULL);
+
+    for (int i = 0; i < WAIT_TRIES_MAX; ++i)
+    {
+        Sample_streamer_refill(streamer);
+        if (!Sample_streamer_get_view(streamer, stream, gen, view))
+            return false;
+
+        if (view->stop >= stop)
+            return true;
+
+        wait_a_moment();
+    }
+
+    return false;
+}
+
+
+typedef int64_t Frame_mapping(int64_t pos, int64_t loop_start, int64_t loop_end);
+
+
+static void check_stream(
+        Sample_loop loop,
+        int64_t loop_start,
+        int64_t loop_end,
+        int64_t start_pos,
+        int64_t stop_pos,
+        Frame_mapping* get_frame)
+{
+    assert(start_pos < stop_pos);
+    assert(get_frame != NULL);
+
+    int gen = -1;
+    const int stream = Sample_streamer_open_stream(
+            streamer, sample, loop, loop_start, loop_end, start_pos, &gen);
+    ck_assert_msg(stream >= 0, "Could not open a stream");
+
+    int64_t pos = start_pos;
+    while (pos < stop_pos)
+    {
+        // Read in uneven steps so that the reads cross the ring boundary
+        const int64_t step = min(stop_pos - pos, 1777);
+
+        Sample_stream_view* view = &(Sample_stream_view){ .start = 0 };
+        ck_assert_msg(wait_for_frames(stream, gen, pos + step, view),
+                "Stream did not provide frames up to %lld", (long long)(pos + step));
+        ck_assert_msg(view->start <= pos,
+                "Frame %lld is no longer available", (long long)pos);
+
+        for (int64_t i = pos; i < pos + step; ++i)
+        {
+            const int64_t frame = get_frame(i, loop_start, loop_end);
+            for (int ch = 0; ch < sample->channels; ++ch)
+            {
+                const float expected = get_expected(ch, frame);
+                const float actual = view->ring[ch][i & RING_MASK];
+                ck_assert_msg(actual == expected,
+                        "Wrong value at playback position %lld, channel %d"
+                        " (sample frame %lld)"
+                        "\n    Expected: %.9f"
+                        "\n      Actual: %.9f",
+                        (long long)i, ch, (long long)frame, expected, actual);
+            }
+        }
+
+        pos += step;
+        Sample_streamer_advance(streamer, stream, gen, pos);
+    }
+
+    Sample_streamer_close_stream(streamer, stream, gen);
+
+    return;
+}
+
+
+static int64_t get_frame_loop_off(int64_t pos, int64_t loop_start, int64_t loop_end)
+{
+    (void)loop_start;
+    (void)loop_end;
+    return pos;
+}
+
+
+static int64_t get_frame_loop_uni(int64_t pos, int64_t loop_start, int64_t loop_end)
+{
+    if (pos < loop_end)
+        return pos;
+
+    return loop_start + (pos - loop_start) % (loop_end - loop_start);
+}
+
+
+static int64_t get_frame_loop_bi(int64_t pos, int64_t loop_start, int64_t loop_end)
+{
+    if (pos < loop_start)
+        return pos;
+
+    // Move back and forth without repeating the end points
+    const int64_t span = loop_end - loop_start - 1;
+    const int64_t phase = (pos - loop_start) % (2 * span);
+    return loop_start + ((phase <= span) ? phase : 2 * span - phase);
+}
+
+
+START_TEST(Stream_provides_frames_of_unlooped_sample)
+{
+    // Start inside the resident part and wrap around the ring several times
+    check_stream(
+            SAMPLE_LOOP_OFF, 0, 0, PRELOAD_LEN - 100, SAMPLE_LEN, get_frame_loop_off);
+}
+END_TEST
+
+
+START_TEST(Stream_follows_unidirectional_loop)
+{
+    const int64_t loop_start = PRELOAD_LEN + 5000;
+    const int64_t loop_end = loop_start + 7003;
+
+    check_stream(
+            SAMPLE_LOOP_UNI,
+            loop_start,
+            loop_end,
+            PRELOAD_LEN,
+            loop_end + 3 * SAMPLE_STREAMER_RING_LEN,
+            get_frame_loop_uni);
+}
+END_TEST
+
+
+START_TEST(Stream_follows_bidirectional_loop)
+{
+    const int64_t loop_start = PRELOAD_LEN + 5000;
+    const int64_t loop_end = loop_start + 7003;
+
+    check_stream(
+            SAMPLE_LOOP_BI,
+            loop_start,
+            loop_end,
+            PRELOAD_LEN,
+            loop_end + 3 * SAMPLE_STREAMER_RING_LEN,
+            get_frame_loop_bi);
+}
+END_TEST
+
+
+START_TEST(Stream_loop_may_start_in_resident_part)
+{
+    const int64_t loop_start = PRELOAD_LEN - 300;
+    const int64_t loop_end = PRELOAD_LEN + 400;
+
+    check_stream(
+            SAMPLE_LOOP_BI,
+            loop_start,
+            loop_end,
+            PRELOAD_LEN - 10,
+            loop_end + 2 * SAMPLE_STREAMER_RING_LEN,
+            get_frame_loop_bi);
+}
+END_TEST
+
+
+START_TEST(Stream_skips_frames_not_read_in_time)
+{
+    int gen = -1;
+    const int stream = Sample_streamer_open_stream(
+            streamer, sample, SAMPLE_LOOP_OFF, 0, 0, PRELOAD_LEN, &gen);
+    ck_assert_msg(stream >= 0, "Could not open a stream");
+
+    // Move past everything the stream could have filled so far
+    const int64_t new_pos = PRELOAD_LEN + 2 * SAMPLE_STREAMER_RING_LEN + 55;
+    Sample_streamer_advance(streamer, stream, gen, new_pos);
+
+    Sample_stream_view* view = &(Sample_stream_view){ .start = 0 };
+    ck_assert_msg(wait_for_frames(stream, gen, new_pos + 1, view),
+            "Stream did not continue from the new position");
+    ck_assert_msg(view->start <= new_pos,
+            "Frames at the new position are not available");
+
+    for (int ch = 0; ch < sample->channels; ++ch)
+    {
+        const float expected = get_expected(ch, new_pos);
+        const float actual = view->ring[ch][new_pos & RING_MASK];
+        ck_assert_msg(actual == expected,
+                "Wrong value after skipping"
+                KT_VALUES("%.9f", expected, actual));
+    }
+
+    Sample_streamer_close_stream(streamer, stream, gen);
+}
+END_TEST
+
+
+START_TEST(Underruns_are_accumulated)
+{
+    ck_assert_msg(Sample_streamer_get_underrun_count(streamer) == 0,
+            "New Sample streamer reports underruns");
+
+    Sample_streamer_add_underruns(streamer, 10);
+    Sample_streamer_add_underruns(streamer, 0);
+    Sample_streamer_add_underruns(streamer, 5);
+
+    ck_assert_msg(Sample_streamer_get_underrun_count(streamer) == 15,
+            "Wrong underrun count"
+            KT_VALUES("%lld", 15LL,
+                (long long)Sample_streamer_get_underrun_count(streamer)));
+}
+END_TEST
+
+
+START_TEST(Closed_stream_is_freed_by_refill)
+{
+    int gen = -1;
+    const int stream = Sample_streamer_open_stream(
+            streamer, sample, SAMPLE_LOOP_OFF, 0, 0, PRELOAD_LEN, &gen);
+    ck_assert_msg(stream >= 0, "Could not open a stream");
+
+    Sample_streamer_close_stream(streamer, stream, gen);
+
+    Sample_stream_view* view = &(Sample_stream_view){ .start = 0 };
+    bool is_open = true;
+    for (int i = 0; (i < WAIT_TRIES_MAX) && is_open; ++i)
+    {
+        Sample_streamer_refill(streamer);
+        wait_a_moment();
+        is_open = Sample_streamer_get_view(streamer, stream, gen, view);
+    }
+
+    ck_assert_msg(!is_open, "Closed stream was not freed");
+}
+END_TEST
+
+
+START_TEST(Abandoned_streams_are_reclaimed)
+{
+    // Fill all streams and never access them again
+    int gens[SAMPLE_STREAMER_STREAMS_MAX] = { 0 };
+    for (int i = 0; i < SAMPLE_STREAMER_STREAMS_MAX; ++i)
+    {
+        const int stream = Sample_streamer_open_stream(
+                streamer, sample, SAMPLE_LOOP_OFF, 0, 0, PRELOAD_LEN, &gens[i]);
+        ck_assert_msg(stream == i,
+                "Unexpected stream number"
+                KT_VALUES("%d", i, stream));
+    }
+
+    int gen = -1;
+    ck_assert_msg(Sample_streamer_open_stream(
+                streamer, sample, SAMPLE_LOOP_OFF, 0, 0, PRELOAD_LEN, &gen) == -1,
+            "Opened more than the maximum number of streams");
+
+    int stream = -1;
+    for (int i = 0; (i < WAIT_TRIES_MAX) && (stream < 0); ++i)
+    {
+        Sample_streamer_refill(streamer);
+        wait_a_moment();
+        stream = Sample_streamer_open_stream(
+                streamer, sample, SAMPLE_LOOP_OFF, 0, 0, PRELOAD_LEN, &gen);
+    }
+
+    ck_assert_msg(stream >= 0, "Abandoned streams were not reclaimed");
+    ck_assert_msg(gen != gens[stream],
+            "Reclaimed stream was reused with the same generation");
+
+    Sample_stream_view* view = &(Sample_stream_view){ .start = 0 };
+    ck_assert_msg(!Sample_streamer_get_view(streamer, stream, gens[stream], view),
+            "Abandoned stream is still accessible after reclaiming");
+}
+END_TEST
+
+
+static void check_render(
+        Sample_loop loop,
+        int64_t loop_start,
+        int64_t loop_end,
+        int64_t stop_pos,
+        Frame_mapping* get_frame)
+{
+    assert(stop_pos > 0);
+    assert(get_frame != NULL);
+
+    Sample_params* params = Sample_params_init(&(Sample_params){ .mid_freq = 0 });
+    params->loop = loop;
+    params->loop_start = loop_start;
+    params->loop_end = loop_end;
+
+    static int32_t positions[RENDER_LEN + 1] = { 0 };
+    static float positions_rem[RENDER_LEN + 1] = { 0 };
+    static float force_scales[RENDER_LEN] = { 0 };
+    static float bufs[KQT_BUFFERS_MAX][RENDER_LEN] = { { 0 } };
+    float* abufs[KQT_BUFFERS_MAX] = { bufs[0], bufs[1] };
+
+    for (int32_t i = 0; i < RENDER_LEN; ++i)
+        force_scales[i] = 1;
+
+    int stream = -1;
+    int gen = 0;
+
+    // Start from the beginning so that the stream is opened before it is needed
+    int64_t pos = 0;
+    while (pos < stop_pos)
+    {
+        for (int32_t i = 0; i <= RENDER_LEN; ++i)
+            positions[i] = (int32_t)(pos + i);
+
+        if (stream >= 0)
+        {
+            Sample_stream_view* view = &(Sample_stream_view){ .start = 0 };
+            ck_assert_msg(wait_for_frames(
+                        stream, gen, min(pos + RENDER_LEN, SAMPLE_LEN), view),
+                    "Stream did not provide frames up to %lld",
+                    (long long)min(pos + RENDER_LEN, SAMPLE_LEN));
+        }
+
+        const int32_t rendered = Sample_render_streamed(
+                sample,
+                params,
+                loop,
+                &stream,
+                &gen,
+                positions,
+                positions_rem,
+                force_scales,
+                abufs,
+                RENDER_LEN,
+                0.5);
+
+        const int64_t expected_len =
+            (loop == SAMPLE_LOOP_OFF) ? min(SAMPLE_LEN - pos, RENDER_LEN) : RENDER_LEN;
+        ck_assert_msg(rendered == expected_len,
+                "Wrong number of frames rendered at playback position %lld"
+                "\n    Expected: %lld"
+                "\n      Actual: %lld",
+                (long long)pos, (long long)expected_len, (long long)rendered);
+        ck_assert_msg((stream >= 0) || (rendered < RENDER_LEN),
+                "Rendering did not open a stream");
+
+        for (int32_t i = 0; i < rendered; ++i)
+        {
+            const int64_t frame = get_frame(pos + i, loop_start, loop_end);
+            for (int ch = 0; ch < sample->channels; ++ch)
+            {
+                const float expected = get_expected(ch, frame) * 0.5f;
+                const float actual = bufs[ch][i];
+                ck_assert_msg(actual == expected,
+                        "Wrong rendered value at playback position %lld, channel %d"
+                        " (sample frame %lld)"
+                        "\n    Expected: %.9f"
+                        "\n      Actual: %.9f",
+                        (long long)(pos + i), ch, (long long)frame, expected, actual);
+            }
+        }
+
+        pos += rendered;
+        if (rendered < RENDER_LEN)
+            break;
+    }
+
+    ck_assert_msg(Sample_streamer_get_underrun_count(streamer) == 0,
+            "Rendering caused underruns"
+            KT_VALUES("%lld", 0LL, (long long)Sample_streamer_get_underrun_count(streamer)));
+
+    if (loop == SAMPLE_LOOP_OFF)
+    {
+        ck_assert_msg(stream == -1, "Stream was not closed at the end of the Sample");
+
+        for (int32_t i = 0; i <= RENDER_LEN; ++i)
+            positions[i] = (int32_t)(SAMPLE_LEN + i);
+
+        const int32_t rendered = Sample_render_streamed(
+                sample,
+                params,
+                loop,
+                &stream,
+                &gen,
+                positions,
+                positions_rem,
+                force_scales,
+                abufs,
+                RENDER_LEN,
+                0.5);
+        ck_assert_msg(rendered == 0,
+                "Frames were rendered after the end of the Sample"
+                KT_VALUES("%d", 0, (int)rendered));
+    }
+    else
+    {
+        Sample_close_stream(sample, &stream, gen);
+    }
+
+    return;
+}
+
+
+START_TEST(Render_reads_resident_and_streamed_frames)
+{
+    check_render(SAMPLE_LOOP_OFF, 0, 0, SAMPLE_LEN, get_frame_loop_off);
+}
+END_TEST
+
+
+START_TEST(Render_follows_unidirectional_loop)
+{
+    const int64_t loop_start = PRELOAD_LEN + 5000;
+    const int64_t loop_end = loop_start + 7003;
+
+    check_render(
+            SAMPLE_LOOP_UNI,
+            loop_start,
+            loop_end,
+            loop_end + 2 * SAMPLE_STREAMER_RING_LEN,
+            get_frame_loop_uni);
+}
+END_TEST
+
+
+START_TEST(Render_follows_bidirectional_loop_from_resident_part)
+{
+    const int64_t loop_start = PRELOAD_LEN - 300;
+    const int64_t loop_end = PRELOAD_LEN + 400;
+
+    check_render(
+            SAMPLE_LOOP_BI,
+            loop_start,
+            loop_end,
+            loop_end + 2 * SAMPLE_STREAMER_RING_LEN,
+            get_frame_loop_bi);
+}
+END_TEST
+
+
+START_TEST(Render_counts_missing_frames_as_underruns)
+{
+    Sample_params* params = Sample_params_init(&(Sample_params){ .mid_freq = 0 });
+
+    static int32_t positions[RENDER_LEN + 1] = { 0 };
+    static float positions_rem[RENDER_LEN + 1] = { 0 };
+    static float force_scales[RENDER_LEN] = { 0 };
+    static float bufs[KQT_BUFFERS_MAX][RENDER_LEN] = { { 0 } };
+    float* abufs[KQT_BUFFERS_MAX] = { bufs[0], bufs[1] };
+
+    // Jump past the resident part before the stream has been filled
+    const int64_t start_pos = PRELOAD_LEN + 5000;
+    for (int32_t i = 0; i <= RENDER_LEN; ++i)
+        positions[i] = (int32_t)(start_pos + i);
+    for (int32_t i = 0; i < RENDER_LEN; ++i)
+    {
+        force_scales[i] = 1;
+        bufs[0][i] = bufs[1][i] = 1;
+    }
+
+    int stream = -1;
+    int gen = 0;
+    const int32_t rendered = Sample_render_streamed(
+            sample,
+            params,
+            SAMPLE_LOOP_OFF,
+            &stream,
+            &gen,
+            positions,
+            positions_rem,
+            force_scales,
+            abufs,
+            RENDER_LEN,
+            1);
+    ck_assert_msg(rendered == RENDER_LEN,
+            "Wrong number of frames rendered"
+            KT_VALUES("%d", RENDER_LEN, (int)rendered));
+    ck_assert_msg(stream >= 0, "Rendering did not open a stream");
+
+    for (int ch = 0; ch < sample->channels; ++ch)
+    {
+        for (int32_t i = 0; i < RENDER_LEN; ++i)
+            ck_assert_msg(bufs[ch][i] == 0,
+                    "Missing frame %d on channel %d was not rendered as silence",
+                    (int)i, ch);
+    }
+
+    ck_assert_msg(Sample_streamer_get_underrun_count(streamer) == RENDER_LEN,
+            "Wrong underrun count"
+            KT_VALUES("%lld", (long long)RENDER_LEN,
+                (long long)Sample_streamer_get_underrun_count(streamer)));
+
+    Sample_close_stream(sample, &stream, gen);
+}
+END_TEST
+
+
+static Suite* Sample_streamer_suite(void)
+{
+    Suite* s = suite_create("Sample_streamer");
+
+    const int timeout = DEFAULT_TIMEOUT;
+
+    TCase* tc_streams = tcase_create("streams");
+    TCase* tc_reclaim = tcase_create("reclaim");
+    TCase* tc_render = tcase_create("render");
+    suite_add_tcase(s, tc_streams);
+    suite_add_tcase(s, tc_reclaim);
+    suite_add_tcase(s, tc_render);
+    tcase_set_timeout(tc_streams, timeout);
+    tcase_set_timeout(tc_reclaim, timeout);
+    tcase_set_timeout(tc_render, timeout);
+    tcase_add_checked_fixture(tc_streams, setup_streamer, teardown_streamer);
+    tcase_add_checked_fixture(tc_reclaim, setup_streamer, teardown_streamer);
+    tcase_add_checked_fixture(tc_render, setup_streamer, teardown_streamer);
+
+    tcase_add_test(tc_streams, Stream_provides_frames_of_unlooped_sample);
+    tcase_add_test(tc_streams, Stream_follows_unidirectional_loop);
+    tcase_add_test(tc_streams, Stream_follows_bidirectional_loop);
+    tcase_add_test(tc_streams, Stream_loop_may_start_in_resident_part);
+    tcase_add_test(tc_streams, Stream_skips_frames_not_read_in_time);
+    tcase_add_test(tc_streams, Underruns_are_accumulated);
+
+    tcase_add_test(tc_reclaim, Closed_stream_is_freed_by_refill);
+    tcase_add_test(tc_reclaim, Abandoned_streams_are_reclaimed);
+
+    tcase_add_test(tc_render, Render_reads_resident_and_streamed_frames);
+    tcase_add_test(tc_render, Render_follows_unidirectional_loop);
+    tcase_add_test(tc_render, Render_follows_bidirectional_loop_from_resident_part);
+    tcase_add_test(tc_render, Render_counts_missing_frames_as_underruns);
+
+    return s;
+}
+
+
+int main(void)
+{
+    Suite* suite = Sample_streamer_suite();
+    SRunner* sr = srunner_create(suite);
+#ifdef K_MEM_DEBUG
+    srunner_set_fork_status(sr, CK_NOFORK);
+#endif
+    srunner_run_all(sr, CK_NORMAL);
+    int fail_count = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    exit(fail_count > 0);
+}
+
+
@@ -0,0 +1,206 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2019
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <test_common.h>
+
+#include <mathnum/Tstamp.h>
+#include <Pat_inst_ref.h>
+#include <string/serialise.h>
+
+#include <float.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define arr_size(arr) (sizeof(arr) / sizeof(*(arr)))
+
+
+START_TEST(Serialise_bool)
+{
+    char buf[16] = "";
+
+    ck_assert_msg(serialise_bool(buf, sizeof(buf), true) == 4,
+            "Wrong length returned for true");
+    ck_assert_msg(strcmp(buf, "true") == 0,
+            "Serialised true as `%s`", buf);
+
+    ck_assert_msg(serialise_bool(buf, sizeof(buf), false) == 5,
+            "Wrong length returned for false");
+    ck_assert_msg(strcmp(buf, "false") == 0,
+            "Serialised false as `%s`", buf);
+}
+END_TEST
+
+
+START_TEST(Serialise_int)
+{
+    const int64_t nums[] = { 0, 1, -1, 9, 10, -10, 1234567, INT64_MAX, INT64_MIN, };
+
+    for (size_t i = 0; i < arr_size(nums); ++i)
+    {
+        char expected[32] = "";
+        sprintf(expected, "%" PRId64, nums[i]);
+
+        char buf[32] = "";
+        const int length = serialise_int(buf, sizeof(buf), nums[i]);
+        ck_assert_msg(strcmp(buf, expected) == 0,
+                "Serialised %" PRId64 " as `%s`", nums[i], buf);
+        ck_assert_msg(length == (int)strlen(expected),
+                "Wrong length %d returned for %" PRId64, length, nums[i]);
+    }
+}
+END_TEST
+
+
+START_TEST(Serialise_short_floats)
+{
+    const struct
+    {
+        double value;
+        const char* expected;
+    } cases[] =
+    {
+        { 0.0,      "0" },
+        { 1.0,      "1" },
+        { -1.5,     "-1.5" },
+        { 0.1,      "0.1" },
+        { 440.0,    "440" },
+        { 0.0001,   "0.0001" },
+        { 0.00001,  "1e-5" },
+        { 1e15,     "1000000000000000" },
+        { 1e16,     "1e16" },
+        { 0.3,      "0.3" },
+        { 2.0 / 3.0, "0.6666666666666666" },
+        { DBL_MAX,  "1.7976931348623157e308" },
+        { 5e-324,   "5e-324" },
+    };
+
+    for (size_t i = 0; i < arr_size(cases); ++i)
+    {
+        char buf[64] = "";
+        const int length = serialise_float(buf, sizeof(buf), cases[i].value);
+        ck_assert_msg(strcmp(buf, cases[i].expected) == 0,
+                "Serialised %.17g as `%s` instead of `%s`",
+                cases[i].value, buf, cases[i].expected);
+        ck_assert_msg(length == (int)strlen(buf),
+                "Wrong length %d returned for `%s`", length, buf);
+    }
+}
+END_TEST
+
+
+START_TEST(Serialised_floats_are_parsed_back_exactly)
+{
+    uint64_t state = UINT64_C(0x9e3779b97f4a7c15);
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        double value = 0;
+        memcpy(&value, &state, sizeof(value));
+        if (!isfinite(value))
+            continue;
+
+        char buf[64] = "";
+        serialise_float(buf, sizeof(buf), value);
+        ck_assert_msg(strtod(buf, NULL) == value,
+                "%.17g was serialised as `%s`", value, buf);
+    }
+}
+END_TEST
+
+
+START_TEST(Serialise_pairs)
+{
+    char buf[64] = "";
+
+    Tstamp* ts = Tstamp_set(TSTAMP_AUTO, -3, 7);
+    serialise_Tstamp(buf, sizeof(buf), ts);
+    ck_assert_msg(strcmp(buf, "[-3, 7]") == 0,
+            "Serialised Tstamp as `%s`", buf);
+
+    Pat_inst_ref* piref = PAT_INST_REF_AUTO;
+    piref->pat = 12;
+    piref->inst = 0;
+    serialise_Pat_inst_ref(buf, sizeof(buf), piref);
+    ck_assert_msg(strcmp(buf, "[12, 0]") == 0,
+            "Serialised Pattern instance reference as `%s`", buf);
+}
+END_TEST
+
+
+START_TEST(Serialised_output_is_truncated_to_buffer_size)
+{
+    char buf[4] = "";
+
+    ck_assert_msg(serialise_float(buf, sizeof(buf), -1.25) == 3,
+            "Wrong length returned for truncated float");
+    ck_assert_msg(strcmp(buf, "-1.") == 0,
+            "Truncated float was serialised as `%s`", buf);
+
+    ck_assert_msg(serialise_int(buf, sizeof(buf), 123456) == 3,
+            "Wrong length returned for truncated int");
+    ck_assert_msg(strcmp(buf, "123") == 0,
+            "Truncated int was serialised as `%s`", buf);
+
+    ck_assert_msg(serialise_bool(buf, 1, true) == 0,
+            "Wrong length returned for empty buffer");
+    ck_assert_msg(buf[0] == '\0',
+            "Serialisation into a single byte did not produce an empty string");
+}
+END_TEST
+
+
+static Suite* Serialise_suite(void)
+{
+    Suite* s = suite_create("Serialise");
+
+    const int timeout = DEFAULT_TIMEOUT;
+
+    TCase* tc_serialise = tcase_create("serialise");
+    suite_add_tcase(s, tc_serialise);
+    tcase_set_timeout(tc_serialise, timeout);
+
+    tcase_add_test(tc_serialise, Serialise_bool);
+    tcase_add_test(tc_serialise, Serialise_int);
+    tcase_add_test(tc_serialise, Serialise_short_floats);
+    tcase_add_test(tc_serialise, Serialised_floats_are_parsed_back_exactly);
+    tcase_add_test(tc_serialise, Serialise_pairs);
+    tcase_add_test(tc_serialise, Serialised_output_is_truncated_to_buffer_size);
+
+    return s;
+}
+
+
+int main(void)
+{
+    Suite* suite = Serialise_suite();
+    SRunner* sr = srunner_create(suite);
+#ifdef K_MEM_DEBUG
+    srunner_set_fork_status(sr, CK_NOFORK);
+#endif
+    srunner_run_all(sr, CK_NORMAL);
+    int fail_count = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    exit(fail_count > 0);
+}
+
+
@@ -435,6 +435,55 @@ START_TEST(Read_nonzero_float)
 END_TEST
 
 
+START_TEST(Short_decimal_numbers_are_read_exactly)
+{
+    const char* nums[] =
+    {
+        "0.1",
+        "0.3",
+        "-2.675",
+        "440.5",
+        "1e-5",
+        "1.2345e22",
+        "9007199254740991",
+        "0.6666666666666666",
+        "123456.789e-10",
+    };
+
+    for (size_t i = 0; i < arr_size(nums); ++i)
+    {
+        Streader* sr = init_with_cstr(nums[i]);
+        double num = NAN;
+        ck_assert_msg(Streader_read_float(sr, &num),
+                "Could not read float from \"%s\": %s",
+                nums[i], Streader_get_error_desc(sr));
+
+        const double expected = strtod(nums[i], NULL);
+        ck_assert_msg(num == expected,
+                "Streader stored %.17g instead of %.17g from \"%s\"",
+                num, expected, nums[i]);
+    }
+}
+END_TEST
+
+
+START_TEST(Reading_long_string_truncates_result)
+{
+    Streader* sr = init_with_cstr("\"abcdefghijklmnopqrstuvwxyz\" x");
+    char result[11] = "";
+
+    ck_assert_msg(Streader_read_string(sr, (int64_t)sizeof(result), result),
+            "Could not read a long string: %s",
+            Streader_get_error_desc(sr));
+    ck_assert_msg(strcmp(result, "abcdefghij") == 0,
+            "Streader stored `%s` instead of a truncated string",
+            result);
+    ck_assert_msg(Streader_match_char(sr, 'x'),
+            "Streader did not consume a truncated string correctly");
+}
+END_TEST
+
+
 START_TEST(Whitespace_terminates_decimal_number)
 {
     Streader* sr = init_with_cstr("- 1");
@@ -493,6 +542,8 @@ START_TEST(Read_valid_string)
         { "\"\\t\"", "\t" },
         */
         { "\"abc def\"", "abc def" },
+        { "\"abcdefghijklmnopqrstuvwxyz\"", "abcdefghijklmnopqrstuvwxyz" },
+        { "\"abcdefghij\\\"klmnopqrs\\\\tuvwxyz\"", "abcdefghij\"klmnopqrs\\tuvwxyz" },
     };
 
     for (size_t i = 0; i < arr_size(strings); ++i)
@@ -525,6 +576,9 @@ START_TEST(Reading_invalid_string_fails)
         "abc",
         "\"\\z\"",
         "\"\n\"",
+        "\"abcdefghijklmnop\nqrstuvwxyz\"",
+        "\"abcdefghijklmnop\x7fqrstuvwxyz\"",
+        "\"abcdefghijklmnopqrstuvwxyz",
     };
 
     for (size_t i = 0; i < arr_size(data); ++i)
@@ -1172,9 +1226,11 @@ static Suite* Streader_suite(void)
     tcase_add_test(tc_read_float, Read_zero_float);
     tcase_add_test(tc_read_float, Read_nonzero_float);
     tcase_add_test(tc_read_float, Whitespace_terminates_decimal_number);
+    tcase_add_test(tc_read_float, Short_decimal_numbers_are_read_exactly);
 
     tcase_add_test(tc_read_string, Read_valid_string);
     tcase_add_test(tc_read_string, Reading_invalid_string_fails);
+    tcase_add_test(tc_read_string, Reading_long_string_truncates_result);
 
     tcase_add_test(tc_read_tstamp, Read_valid_tstamp);
     tcase_add_test(tc_read_tstamp, Reading_invalid_tstamp_fails);